@@ -0,0 +1,51 @@
+/*
+**      SWISH++
+**      src/CheckpointDir.h
+**
+**      Copyright (C) 2026  Paul J. Lucas
+**
+**      This program is free software; you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation; either version 2 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program; if not, write to the Free Software
+**      Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#ifndef CheckpointDir_H
+#define CheckpointDir_H
+
+// local
+#include "config.h"
+#include "conf_string.h"
+#include "conf_var.h"
+
+// standard
+#include <string>
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A %CheckpointDir is-a conf&lt;string&gt; containing the name of the
+ * directory where index records checkpoints so an interrupted run can be
+ * resumed.  If empty, no checkpoints are recorded.
+ *
+ * This is the same as index's -k command-line option.
+ */
+class CheckpointDir : public conf<std::string> {
+public:
+  CheckpointDir() : conf<std::string>{ "CheckpointDir" } { }
+  CONF_STRING_ASSIGN_OPS( CheckpointDir )
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif /* CheckpointDir_H */
+/* vim:set et sw=2 ts=2: */
@@ -0,0 +1,52 @@
+/*
+**      SWISH++
+**      src/CompressPartials.h
+**
+**      Copyright (C) 2026  Paul J. Lucas
+**
+**      This program is free software; you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation; either version 2 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program; if not, write to the Free Software
+**      Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#ifdef HAVE_LIBZ
+
+#ifndef CompressPartials_H
+#define CompressPartials_H
+
+// local
+#include "config.h"
+#include "conf_bool.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A %CompressPartials is-a conf&lt;bool&gt; containing the Boolean value
+ * indicating whether to compress partial indices written to temporary files.
+ *
+ * This is the same as index's \c -z command-line option.
+ */
+class CompressPartials : public conf<bool> {
+public:
+  CompressPartials() : conf<bool>{ "CompressPartials", false } { }
+  CONF_BOOL_ASSIGN_OPS( CompressPartials )
+};
+
+extern CompressPartials compress_partials;
+
+#endif /* CompressPartials_H */
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif /* HAVE_LIBZ */
+/* vim:set et sw=2 ts=2: */
@@ -0,0 +1,61 @@
+/*
+**      SWISH++
+**      src/NamedIndex.cpp
+**
+**      Copyright (C) 2000-2026  Paul J. Lucas
+**
+**      This program is free software; you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation; either version 2 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program; if not, write to the Free Software
+**      Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+// local
+#include "config.h"
+#include "NamedIndex.h"
+#include "exit_codes.h"
+
+// standard
+#include <cstdlib>                      /* for exit(3) */
+#include <cstring>
+#include <ostream>
+
+using namespace std;
+
+///////////////////////////////////////////////////////////////////////////////
+
+void NamedIndex::parse_value( char *line ) {
+  char const *const name = ::strtok( line, " \r\t" );
+  if ( !name ) {
+    error() << "no index name\n";
+    ::exit( Exit_Config_File );
+  }
+  if ( ::strchr( name, ',' ) ) {
+    error() << "index name \"" << name << "\" may not contain ','\n";
+    ::exit( Exit_Config_File );
+  }
+  vector<string> paths;
+  while ( char const *const path = ::strtok( nullptr, " \r\t" ) )
+    paths.push_back( path );
+  if ( paths.empty() ) {
+    error() << "no index file for \"" << name << "\"\n";
+    ::exit( Exit_Config_File );
+  }
+  (*this)[ name ] = std::move( paths );
+}
+
+void NamedIndex::reset() {
+  clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/* vim:set et sw=2 ts=2: */
@@ -0,0 +1,64 @@
+/*
+**      SWISH++
+**      src/NamedIndex.h
+**
+**      Copyright (C) 2026  Paul J. Lucas
+**
+**      This program is free software; you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation; either version 2 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program; if not, write to the Free Software
+**      Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#ifndef NamedIndex_H
+#define NamedIndex_H
+
+// local
+#include "config.h"
+#include "conf_var.h"
+
+// standard
+#include <map>
+#include <string>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A %NamedIndex is-a conf_var and a map containing the set of additional
+ * indices (by name) that \c search loads upon starting and that a request can
+ * select via the \c -i option.  The value is the name followed by the paths of
+ * one or more index files.  When more than one, each is a shard of a single
+ * logical index, e.g.:
+ * \code
+ *    NamedIndex  manuals  /var/lib/swish++/manuals.index
+ *    NamedIndex  mail     /var/lib/swish++/mail1.index /var/lib/swish++/mail2.index
+ * \endcode
+ */
+class NamedIndex :
+  public conf_var, public std::map<std::string,std::vector<std::string>> {
+public:
+  NamedIndex() : conf_var{ "NamedIndex" } { }
+  CONF_VAR_ASSIGN_OPS( NamedIndex )
+
+  void parse_value( char *line ) override;
+
+private:
+  void reset() override;
+};
+
+extern NamedIndex named_indices;
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif /* NamedIndex_H */
+/* vim:set et sw=2 ts=2: */
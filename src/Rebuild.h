@@ -0,0 +1,50 @@
+/*
+**      SWISH++
+**      src/Rebuild.h
+**
+**      Copyright (C) 2026  Paul J. Lucas
+**
+**      This program is free software; you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation; either version 2 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program; if not, write to the Free Software
+**      Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#ifndef Rebuild_H
+#define Rebuild_H
+
+// local
+#include "config.h"
+#include "conf_bool.h"
+#include "conf_var.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A Rebuild is-a conf<bool> containing the Boolean value indicating
+ * whether to rebuild an index copying the entries of unchanged files from
+ * the existing index.
+ *
+ * This is the same as index's \c -R command-line option.
+ */
+class Rebuild : public conf<bool> {
+public:
+  Rebuild() : conf<bool>{ "Rebuild", false } { }
+  CONF_BOOL_ASSIGN_OPS( Rebuild )
+};
+
+extern Rebuild rebuild;
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif /* Rebuild_H */
+/* vim:set et sw=2 ts=2: */
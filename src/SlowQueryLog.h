@@ -0,0 +1,52 @@
+/*
+**      SWISH++
+**      src/SlowQueryLog.h
+**
+**      Copyright (C) 2026  Paul J. Lucas
+**
+**      This program is free software; you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation; either version 2 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program; if not, write to the Free Software
+**      Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#ifndef SlowQueryLog_H
+#define SlowQueryLog_H
+
+// local
+#include "config.h"
+#include "conf_string.h"
+#include "conf_var.h"
+
+// standard
+#include <string>
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A %SlowQueryLog is-a conf&lt;string&gt; containing the name of the file the
+ * search daemon logs slow queries to.  If empty, no queries are logged.
+ *
+ * This is the same as search's \c -l command-line option.
+ */
+class SlowQueryLog : public conf<std::string> {
+public:
+  SlowQueryLog() : conf<std::string>{ "SlowQueryLog" } { }
+  CONF_STRING_ASSIGN_OPS( SlowQueryLog )
+};
+
+extern SlowQueryLog slow_query_log_name;
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif /* SlowQueryLog_H */
+/* vim:set et sw=2 ts=2: */
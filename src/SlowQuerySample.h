@@ -0,0 +1,52 @@
+/*
+**      SWISH++
+**      src/SlowQuerySample.h
+**
+**      Copyright (C) 2026  Paul J. Lucas
+**
+**      This program is free software; you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation; either version 2 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program; if not, write to the Free Software
+**      Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#ifndef SlowQuerySample_H
+#define SlowQuerySample_H
+
+// local
+#include "config.h"
+#include "conf_unsigned.h"
+#include "conf_var.h"
+#include "swishxx-config.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A %SlowQuerySample is-a conf&lt;unsigned&gt; containing the percentage of
+ * slow queries that are actually logged.  Sampling keeps the log from growing
+ * too quickly when many queries are slow.
+ *
+ * This is the same as search's \c -Q command-line option.
+ */
+class SlowQuerySample : public conf<unsigned> {
+public:
+  SlowQuerySample() :
+    conf<unsigned>{ "SlowQuerySample", SlowQuerySample_Default, 1, 100 } { }
+  CONF_INT_ASSIGN_OPS( SlowQuerySample )
+};
+
+extern SlowQuerySample slow_query_sample;
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif /* SlowQuerySample_H */
+/* vim:set et sw=2 ts=2: */
@@ -0,0 +1,52 @@
+/*
+**      SWISH++
+**      src/SlowQueryTime.h
+**
+**      Copyright (C) 2026  Paul J. Lucas
+**
+**      This program is free software; you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation; either version 2 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program; if not, write to the Free Software
+**      Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#ifndef SlowQueryTime_H
+#define SlowQueryTime_H
+
+// local
+#include "config.h"
+#include "conf_unsigned.h"
+#include "conf_var.h"
+#include "swishxx-config.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A %SlowQueryTime is-a conf&lt;unsigned&gt; containing the number of
+ * milliseconds a request must take to service before it is considered slow
+ * and logged to the SlowQueryLog.
+ *
+ * This is the same as search's \c -L command-line option.
+ */
+class SlowQueryTime : public conf<unsigned> {
+public:
+  SlowQueryTime() :
+    conf<unsigned>{ "SlowQueryTime", SlowQueryTime_Default } { }
+  CONF_INT_ASSIGN_OPS( SlowQueryTime )
+};
+
+extern SlowQueryTime slow_query_time;
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif /* SlowQueryTime_H */
+/* vim:set et sw=2 ts=2: */
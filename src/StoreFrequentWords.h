@@ -0,0 +1,51 @@
+/*
+**      SWISH++
+**      src/StoreFrequentWords.h
+**
+**      Copyright (C) 2026  Paul J. Lucas
+**
+**      This program is free software; you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation; either version 2 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program; if not, write to the Free Software
+**      Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#ifndef StoreFrequentWords_H
+#define StoreFrequentWords_H
+
+// local
+#include "config.h"
+#include "conf_bool.h"
+#include "conf_var.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A StoreFrequentWords is-a conf<bool> containing the Boolean value
+ * indicating whether to store the files of words that are too frequent in the
+ * index so that, when the index is later rebuilt or merged, whether they're
+ * too frequent can be determined anew.
+ *
+ * This is the same as index's \c -Q command-line option.
+ */
+class StoreFrequentWords : public conf<bool> {
+public:
+  StoreFrequentWords() : conf<bool>{ "StoreFrequentWords", false } { }
+  CONF_BOOL_ASSIGN_OPS( StoreFrequentWords )
+};
+
+extern StoreFrequentWords store_frequent_words;
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif /* StoreFrequentWords_H */
+/* vim:set et sw=2 ts=2: */
@@ -0,0 +1,147 @@
+/*
+**      SWISH++
+**      src/charset_bench.cpp
+**
+**      Copyright (C) 2026  Paul J. Lucas
+**
+**      This program is free software; you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation; either version 2 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program; if not, write to the Free Software
+**      Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+//
+// A micro-benchmark comparing transcoding UTF-8 and UTF-16 text a character
+// at a time via encoded_char_range::const_iterator against transcoding it in
+// bulk.  Build it with "make charset_bench" and run it as:
+//
+//    charset_bench [megabytes]
+//
+
+// local
+#include "config.h"
+#include "charsets/charsets.h"
+#include "encoded_char.h"
+
+// standard
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+#if defined( WITH_UTF8 ) || defined( WITH_UTF16 )
+
+/**
+ * Makes mostly-ASCII UTF-8 text: every 40th character is a 2- or 3-byte one.
+ *
+ * @param size The approximate size of the text in bytes.
+ * @return Returns said text.
+ */
+static string make_utf8( size_t size ) {
+  static char const *const words[] = {
+    "the ", "quick ", "brown ", "fox ", "jumps ", "over ", "lazy ", "dog. ",
+    "caf\xC3\xA9 ", "r\xC3\xA9sum\xC3\xA9 ", "na\xC3\xAFve ", "\xE2\x82\xAC" "5 "
+  };
+  string s;
+  s.reserve( size + 16 );
+  for ( unsigned i = 0; s.size() < size; ++i )
+    s += words[ i % 40 == 39 ? 8 + i / 40 % 4 : i % 8 ];
+  return s;
+}
+
+/**
+ * Makes UTF-16 text from ISO 8859-1 text (good enough for a benchmark).
+ *
+ * @param s The text.
+ * @param big_endian If \c true, makes big-endian text.
+ * @return Returns said text.
+ */
+static string make_utf16( string const &s, bool big_endian ) {
+  string u;
+  u.reserve( s.size() * 2 );
+  for ( char const c : s ) {
+    if ( big_endian )
+      u += '\0', u += c;
+    else
+      u += c, u += '\0';
+  } // for
+  return u;
+}
+
+/**
+ * Times transcoding text both ways and checks that the results are the same.
+ *
+ * @param name The name of the character set.
+ * @param text The text.
+ * @param charset The character set's per-character function.
+ * @param transcode The character set's bulk function.
+ * @return Returns \c true only if the results are the same.
+ */
+static bool bench( char const *name, string const &text,
+                   encoded_char_range::charset_type charset,
+                   char* (*transcode)( char const*, char const*, char* ) ) {
+  using clock = chrono::steady_clock;
+  char const *const begin = text.data();
+  char const *const end = begin + text.size();
+
+  auto t0 = clock::now();
+  string per_char;
+  per_char.reserve( text.size() );
+  encoded_char_range::decoder_state state;
+  encoded_char_range const e( begin, end, charset, nullptr, &state );
+  for ( auto c = e.begin(); !c.at_end(); ++c )
+    per_char += *c;
+  auto t1 = clock::now();
+
+  string bulk( text.size() + 1, '\0' );
+  bulk.resize( (*transcode)( begin, end, bulk.data() ) - bulk.data() );
+  auto t2 = clock::now();
+
+  auto const mb_per_sec = [&]( clock::duration d ) {
+    return text.size() / 1e6 / chrono::duration<double>( d ).count();
+  };
+  bool const same = per_char == bulk;
+  cout << name << ": per-char " << mb_per_sec( t1 - t0 ) << " MB/s, bulk "
+       << mb_per_sec( t2 - t1 ) << " MB/s"
+       << (same ? "" : " (RESULTS DIFFER)") << endl;
+  return same;
+}
+
+#endif /* WITH_UTF8 || WITH_UTF16 */
+
+int main( int argc, char *argv[] ) {
+#if defined( WITH_UTF8 ) || defined( WITH_UTF16 )
+  size_t const size = (argc > 1 ? ::atoi( argv[1] ) : 16) * 1000000uL;
+  string const utf8 = make_utf8( size );
+  bool ok = true;
+#ifdef WITH_UTF8
+  ok = bench( "UTF-8", utf8, charset_utf8, transcode_utf8 ) && ok;
+#endif /* WITH_UTF8 */
+#ifdef WITH_UTF16
+  string const latin1 = utf8.substr( 0, size / 2 );
+  ok = bench( "UTF-16BE", make_utf16( latin1, true ), charset_utf16be,
+              transcode_utf16be ) && ok;
+  ok = bench( "UTF-16LE", make_utf16( latin1, false ), charset_utf16le,
+              transcode_utf16le ) && ok;
+#endif /* WITH_UTF16 */
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+#else
+  (void)argc;
+  cerr << argv[0] << ": neither UTF-8 nor UTF-16 support compiled in" << endl;
+  return EXIT_FAILURE;
+#endif /* WITH_UTF8 || WITH_UTF16 */
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/* vim:set et sw=2 ts=2: */
@@ -41,6 +41,7 @@ encoded_char_range::charset_type const     CHARSET_UNKNOWN  =
  * @param pos A pointer marking the position of the character to decode.  It is
  * left after the decoded character.
  * @param end A pointer marking the end of the entire encoded range.
+ * @param state The decoders' state for the file.  It must not be null.
  * @return Returns the decoded character or ' ' upon error.
  *
  * @sa The Unicode Consortium.  "Encoding Forms," The Unicode Standard 3.0,
@@ -58,7 +59,8 @@ encoded_char_range::charset_type const     CHARSET_UNKNOWN  =
 encoded_char_range::value_type charset_utf7(
   encoded_char_range::const_pointer begin,
   encoded_char_range::const_pointer &pos,
-  encoded_char_range::const_pointer end
+  encoded_char_range::const_pointer end,
+  encoded_char_range::decoder_state *state
 );
 #endif /* WITH_UTF7 */
 
@@ -70,6 +72,7 @@ encoded_char_range::value_type charset_utf7(
  * @param pos A pointer marking the position of the character to decode.  It is
  * left after the decoded character.
  * @param end A pointer marking the end of the entire encoded range.
+ * @param state Not used.
  * @return Returns the decoded character or ' ' upon error.
  *
  * @sa The Unicode Consortium.  "Encoding Forms," The Unicode Standard 3.0,
@@ -82,8 +85,22 @@ encoded_char_range::value_type charset_utf7(
 encoded_char_range::value_type charset_utf8(
   encoded_char_range::const_pointer begin,
   encoded_char_range::const_pointer &pos,
-  encoded_char_range::const_pointer end
+  encoded_char_range::const_pointer end,
+  encoded_char_range::decoder_state *state
 );
+
+/**
+ * Transcodes an entire range of UTF-8-encoded text to ASCII in one shot.  The
+ * result is the same as calling charset_utf8() repeatedly, but runs of ASCII
+ * characters (that are most of the characters in most text) are copied as-is.
+ *
+ * @param begin A pointer marking the beginning of the encoded range.
+ * @param end A pointer marking the end of the encoded range.
+ * @param buf The buffer to transcode into.  It must be at least \a end - \a
+ * begin bytes.  It may be \a begin to transcode in place.
+ * @return Returns a pointer to one past the last transcoded byte in \a buf.
+ */
+char* transcode_utf8( char const *begin, char const *end, char *buf );
 #endif /* WITH_UTF8 */
 
 #ifdef WITH_UTF16
@@ -95,6 +112,7 @@ encoded_char_range::value_type charset_utf8(
  * @param pos A pointer marking the position of the character to decode.  It is
  * left after the decoded character.
  * @param end A pointer marking the end of the entire encoded range.
+ * @param state Not used.
  *
  * @sa The Unicode Consortium.  "Encoding Forms," The Unicode Standard
  * 3.0, section 2.3, Addison-Wesley, 2000.
@@ -102,7 +120,8 @@ encoded_char_range::value_type charset_utf8(
 encoded_char_range::value_type charset_utf16be(
   encoded_char_range::const_pointer begin,
   encoded_char_range::const_pointer &pos,
-  encoded_char_range::const_pointer end
+  encoded_char_range::const_pointer end,
+  encoded_char_range::decoder_state *state
 );
 
 /**
@@ -113,6 +132,7 @@ encoded_char_range::value_type charset_utf16be(
  * @param pos A pointer marking the position of the character to decode.  It is
  * left after the decoded character.
  * @param end A pointer marking the end of the entire encoded range.
+ * @param state Not used.
  *
  * @sa The Unicode Consortium.  "Encoding Forms," The Unicode Standard
  * 3.0, section 2.3, Addison-Wesley, 2000.
@@ -120,8 +140,35 @@ encoded_char_range::value_type charset_utf16be(
 encoded_char_range::value_type charset_utf16le(
   encoded_char_range::const_pointer begin,
   encoded_char_range::const_pointer &pos,
-  encoded_char_range::const_pointer end
+  encoded_char_range::const_pointer end,
+  encoded_char_range::decoder_state *state
 );
+
+/**
+ * Transcodes an entire range of UTF-16 big-endian encoded text to ASCII in one
+ * shot.  The result is the same as calling charset_utf16be() repeatedly, but
+ * runs of ASCII characters are narrowed several at a time.
+ *
+ * @param begin A pointer marking the beginning of the encoded range.
+ * @param end A pointer marking the end of the encoded range.
+ * @param buf The buffer to transcode into.  It must be at least (\a end - \a
+ * begin) / 2 + 1 bytes.  It may be \a begin to transcode in place.
+ * @return Returns a pointer to one past the last transcoded byte in \a buf.
+ */
+char* transcode_utf16be( char const *begin, char const *end, char *buf );
+
+/**
+ * Transcodes an entire range of UTF-16 little-endian encoded text to ASCII in
+ * one shot.  The result is the same as calling charset_utf16le() repeatedly,
+ * but runs of ASCII characters are narrowed several at a time.
+ *
+ * @param begin A pointer marking the beginning of the encoded range.
+ * @param end A pointer marking the end of the encoded range.
+ * @param buf The buffer to transcode into.  It must be at least (\a end - \a
+ * begin) / 2 + 1 bytes.  It may be \a begin to transcode in place.
+ * @return Returns a pointer to one past the last transcoded byte in \a buf.
+ */
+char* transcode_utf16le( char const *begin, char const *end, char *buf );
 #endif /* WITH_UTF16 */
 
 ///////////////////////////////////////////////////////////////////////////////
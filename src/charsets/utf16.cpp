@@ -24,15 +24,81 @@
 #include "encoded_char.h"
 #include "unicode.h"
 
+// standard
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif /* __SSE2__ */
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Gets a UTF-16 code unit.
+ *
+ * @tparam BigEndian If \c true, the unit is big-endian; otherwise
+ * little-endian.
+ * @param c A pointer to the unit.
+ * @return Returns said unit.
+ */
+template<bool BigEndian>
+inline ucs4 utf16_unit( char const *c ) {
+  auto const b0 = static_cast<unsigned char>( c[ !BigEndian ] );
+  auto const b1 = static_cast<unsigned char>( c[ BigEndian ] );
+  return static_cast<ucs4>( b0 ) << 8 | b1;
+}
+
+/**
+ * Transcodes an entire range of UTF-16 encoded text to ASCII.
+ *
+ * @tparam BigEndian If \c true, the text is big-endian; otherwise
+ * little-endian.
+ * @param begin A pointer marking the beginning of the encoded range.
+ * @param end A pointer marking the end of the encoded range.
+ * @param buf The buffer to transcode into.
+ * @return Returns a pointer to one past the last transcoded byte in \a buf.
+ */
+template<bool BigEndian>
+static char* transcode_utf16( char const *begin, char const *end, char *buf ) {
+  char const *c = begin;
+#ifdef __SSE2__
+  for ( ; end - c >= 16; c += 16, buf += 8 ) {
+    //
+    // Narrow 8 units at a time as long as they're all ASCII.
+    //
+    __m128i units = _mm_loadu_si128( reinterpret_cast<__m128i const*>( c ) );
+    if constexpr ( BigEndian )
+      units = _mm_or_si128( _mm_slli_epi16( units, 8 ),
+                            _mm_srli_epi16( units, 8 ) );
+    __m128i const non_ascii = _mm_and_si128( units, _mm_set1_epi16( ~0x7F ) );
+    if ( _mm_movemask_epi8(
+           _mm_cmpeq_epi16( non_ascii, _mm_setzero_si128() ) ) != 0xFFFF ) {
+      for ( int i = 0; i < 8; ++i )
+        buf[i] = unicode_to_ascii( utf16_unit<BigEndian>( c + 2 * i ) );
+      continue;
+    }
+    _mm_storel_epi64(
+      reinterpret_cast<__m128i*>( buf ), _mm_packus_epi16( units, units )
+    );
+  } // for
+#endif /* __SSE2__ */
+  for ( ; end - c >= 2; c += 2 )
+    *buf++ = unicode_to_ascii( utf16_unit<BigEndian>( c ) );
+  if ( c != end )                       // odd trailing byte: malformed
+    *buf++ = ' ';
+  return buf;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 encoded_char_range::value_type
 charset_utf16be( encoded_char_range::const_pointer,
                  encoded_char_range::const_pointer &c,
-                 encoded_char_range::const_pointer end ) {
-  if ( c == end || c+1 == end )
+                 encoded_char_range::const_pointer end,
+                 encoded_char_range::decoder_state* ) {
+  if ( c == end || c+1 == end ) {
+    c = end;
     return ' ';
-  ucs4 const u = (static_cast<ucs4>( c[0] ) << 8) | c[1];
+  }
+  ucs4 const u = utf16_unit<true>( c );
   c += 2;
   return unicode_to_ascii( u );
 }
@@ -40,13 +106,24 @@ charset_utf16be( encoded_char_range::const_pointer,
 encoded_char_range::value_type
 charset_utf16le( encoded_char_range::const_pointer,
                  encoded_char_range::const_pointer &c,
-                 encoded_char_range::const_pointer end ) {
-  if ( c == end || c+1 == end )
+                 encoded_char_range::const_pointer end,
+                 encoded_char_range::decoder_state* ) {
+  if ( c == end || c+1 == end ) {
+    c = end;
     return ' ';
-  ucs4 const u = (static_cast<ucs4>( c[1] ) << 8) | c[0];
+  }
+  ucs4 const u = utf16_unit<false>( c );
   c += 2;
   return unicode_to_ascii( u );
 }
 
+char* transcode_utf16be( char const *begin, char const *end, char *buf ) {
+  return transcode_utf16<true>( begin, end, buf );
+}
+
+char* transcode_utf16le( char const *begin, char const *end, char *buf ) {
+  return transcode_utf16<false>( begin, end, buf );
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 /* vim:set et sw=2 ts=2: */
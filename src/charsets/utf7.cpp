@@ -31,29 +31,11 @@ using namespace std;
 
 ///////////////////////////////////////////////////////////////////////////////
 
-namespace {
-
-  class utf7_decoder : public encoded_char_range::decoder {
-  public:
-    unsigned buf_count_;
-    const_pointer prev_c_;
-  private:
-    virtual void reset();
-  };
-
-  void utf7_decoder::reset() {
-    buf_count_ = 0;
-    prev_c_ = 0;
-  }
-
-} // namespace
-
-///////////////////////////////////////////////////////////////////////////////
-
 encoded_char_range::value_type
 charset_utf7( encoded_char_range::const_pointer begin,
               encoded_char_range::const_pointer &c,
-              encoded_char_range::const_pointer end ) {
+              encoded_char_range::const_pointer end,
+              encoded_char_range::decoder_state *state ) {
   //
   // This code is based on the decode_base64() function as part of "encdec 1.1"
   // by Jörgen Hägg <jh@efd.lth.se>, 1993.
@@ -65,8 +47,8 @@ charset_utf7( encoded_char_range::const_pointer begin,
     "abcdefghijklmnopqrstuvwxyz"
     "0123456789+/";                     // '=' is omitted intentionally
 
-  static encoded_char_range::value_type buf[ 3 ]; // group-of-4 -> 3 chars
-  static utf7_decoder decoder;
+  auto &decoder = state->utf7;
+  auto &buf = decoder.buf;              // group-of-4 -> 3 chars
 
   ////////// Return previously decoded character //////////////////////////////
 
@@ -75,9 +57,9 @@ return_decoded_char:
   // See if the pointer is less than a buffer's-worth away from the previous
   // pointer: if so, simply return the already-decoded character.
   //
-  encoded_char_range::difference_type const delta = c - decoder.prev_c_;
-  if ( delta >= 0 && delta < decoder.buf_count_ ) {
-    if ( ++c != end && delta == decoder.buf_count_ - 1 ) {
+  encoded_char_range::difference_type const delta = c - decoder.prev_c;
+  if ( delta >= 0 && delta < decoder.count ) {
+    if ( ++c != end && delta == decoder.count - 1 ) {
       if ( ++c != end && *c == '-' ) {
         //
         // From RFC 2152, Rule 2:
@@ -233,12 +215,12 @@ return_decoded_char:
       buf[ j ] = value & 255;
       value >>= 8;
     }
-    decoder.buf_count_ = 3 - i;
+    decoder.count = 3 - i;
   } else {
     //
     // The encoded sequence was bad, e.g. +6.
     //
-    decoder.buf_count_ = 0;
+    decoder.count = 0;
   }
 
   //
@@ -247,7 +229,7 @@ return_decoded_char:
   // a character in the range [i,i+buf_count), we can simply return the
   // character.
   //
-  decoder.prev_c_ = c = orig_c + 1;
+  decoder.prev_c = c = orig_c + 1;
   goto return_decoded_char;
 }
 
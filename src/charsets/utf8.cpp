@@ -24,12 +24,51 @@
 #include "encoded_char.h"
 #include "unicode.h"
 
+// standard
+#ifdef __SSE2__
+#include <bit>                          /* for countr_zero() */
+#include <emmintrin.h>
+#endif /* __SSE2__ */
+#include <cstring>
+
+using namespace std;
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Skips over a run of ASCII characters.
+ *
+ * @param c A pointer to the first character to check.
+ * @param end A pointer to the end of the range.
+ * @return Returns a pointer to the first non-ASCII character or \a end if
+ * none.
+ */
+static char const* skip_ascii( char const *c, char const *end ) {
+#ifdef __SSE2__
+  for ( ; end - c >= 16; c += 16 ) {
+    //
+    // The high bit of every byte of a 16-byte chunk is gathered into a mask:
+    // any bit set is a non-ASCII byte.
+    //
+    unsigned const mask = _mm_movemask_epi8(
+      _mm_loadu_si128( reinterpret_cast<__m128i const*>( c ) )
+    );
+    if ( mask )
+      return c + countr_zero( mask );
+  } // for
+#endif /* __SSE2__ */
+  while ( c != end && static_cast<unsigned char>( *c ) <= 127u )
+    ++c;
+  return c;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 encoded_char_range::value_type
 charset_utf8( encoded_char_range::const_pointer,
               encoded_char_range::const_pointer &c,
-              encoded_char_range::const_pointer end ) {
+              encoded_char_range::const_pointer end,
+              encoded_char_range::decoder_state* ) {
   //
   // If the byte value is in the ASCII range, we can simply return the
   // character.
@@ -43,14 +82,13 @@ charset_utf8( encoded_char_range::const_pointer,
   // has the bit pattern 11xxxxxx so it's easy to find.
   //
   while ( (static_cast<unsigned char>( *c ) & 0xC0u) != 0xC0u ) {
-    if ( c == end ) {
+    if ( ++c == end ) {
       //
       // We ran into "end" before being able to sync: this is weird.  Return
       // something innocuous like a space since we have to return something.
       //
       return ' ';
     }
-    ++c;
   } // while
   if ( (static_cast<unsigned char>( *c ) & 0xFEu) == 0xFEu ) {
     //
@@ -116,5 +154,16 @@ charset_utf8( encoded_char_range::const_pointer,
   return unicode_to_ascii( u );
 }
 
+char* transcode_utf8( char const *begin, char const *end, char *buf ) {
+  for ( char const *c = begin; c != end; ) {
+    char const *const run_end = skip_ascii( c, end );
+    ::memmove( buf, c, run_end - c );
+    buf += run_end - c;
+    if ( (c = run_end) != end )
+      *buf++ = charset_utf8( begin, c, end, nullptr );
+  } // for
+  return buf;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 /* vim:set et sw=2 ts=2: */
@@ -23,14 +23,14 @@
 #include "config.h"
 #include "classic_formatter.h"
 #include "file_info.h"
-#include "index_segment.h"
 #include "query.h"
 #include "ResultSeparator.h"
 
 // standard
 #include <ostream>
+#include <string>
 
-extern index_segment directories;
+using namespace std;
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -38,6 +38,15 @@ classic_formatter::~classic_formatter() {
   // do nothing
 }
 
+void classic_formatter::explain( string const &explanation ) const {
+  out_ << "# explain:\n";
+  string::size_type line = 0, nl;
+  while ( (nl = explanation.find( '\n', line )) != string::npos ) {
+    out_ << "#   " << explanation.substr( line, nl - line ) << '\n';
+    line = nl + 1;
+  } // while
+}
+
 void classic_formatter::pre( stop_word_set const &stop_words ) const {
   if ( !stop_words.empty() ) {
     out_ << "# ignored:";
@@ -48,9 +57,10 @@ void classic_formatter::pre( stop_word_set const &stop_words ) const {
   out_ << "# results: " << results_ << '\n';
 }
 
-void classic_formatter::result( int rank, file_info const &fi ) const {
+void classic_formatter::result( int rank, char const *dir,
+                                file_info const &fi ) const {
   out_ << rank << result_separator
-       << directories[ fi.dir_index() ] << '/' << fi.file_name()
+       << dir << '/' << fi.file_name()
        << result_separator << fi.size()
        << result_separator << fi.title() << '\n';
 }
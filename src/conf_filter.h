@@ -53,6 +53,13 @@ public:
     return operator[]( key.c_str() );
   }
 
+  /**
+   * Compiles the filename patterns for faster matching.
+   */
+  void compile() {
+    map_.compile();
+  }
+
 protected:
   conf_filter( char const *name ) : conf_var{ name } { }
 
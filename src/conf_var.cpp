@@ -92,6 +92,7 @@ conf_var::map_type& conf_var::map_ref() {
     static char const *const VAR_NAME_TABLE[] = {
       "associatemeta",
       "changedirectory",
+      "checkpointdir",
       "excludefile",
       "excludemeta",
       "extractextension",
@@ -105,18 +106,24 @@ conf_var::map_type& conf_var::map_ref() {
       "includemeta",
       "incremental",
       "indexfile",
+      "namedindex",
+      "rebuild",
       "recursesubdirs",
       "resultsformat",
       "resultseparator",
       "resultsmax",
       "stemwords",
       "stopwordfile",
+      "storefrequentwords",
       "tempdirectory",
       "titlelines",
       "verbosity",
       "wordfilesmax",
       "wordpercentmax",
       "wordthreshold",
+#ifdef HAVE_LIBZ
+      "compresspartials",
+#endif /* HAVE_LIBZ */
 #ifdef WITH_WORD_POS
       "storewordpositions",
       "wordsnear",
@@ -129,6 +136,9 @@ conf_var::map_type& conf_var::map_ref() {
       "pidfile",
       "searchbackground",
       "searchdaemon",
+      "slowquerylog",
+      "slowquerysample",
+      "slowquerytime",
       "socketaddress",
       "socketfile",
       "socketqueuesize",
@@ -0,0 +1,299 @@
+/*
+**      SWISH++
+**      src/decompress.cpp
+**
+**      Copyright (C) 2026  Paul J. Lucas
+**
+**      This program is free software; you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation; either version 2 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program; if not, write to the Free Software
+**      Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+// local
+#include "config.h"
+#include "decompress.h"
+#include "pjl/mmap_file.h"
+
+// standard
+#include <algorithm>                    /* for min(), max() */
+#include <cerrno>
+#include <climits>                      /* for UINT_MAX */
+#include <cstring>
+
+// compression libraries
+#ifdef HAVE_LIBZ
+#include <zlib.h>
+#endif /* HAVE_LIBZ */
+#ifdef HAVE_LIBBZ2
+#include <bzlib.h>
+#endif /* HAVE_LIBBZ2 */
+#ifdef HAVE_LIBLZMA
+#include <lzma.h>
+#endif /* HAVE_LIBLZMA */
+
+using namespace PJL;
+using namespace std;
+
+/**
+ * The minimum number of bytes of room to have in the output buffer before
+ * each call to a decompression library.
+ */
+static size_t const Decompress_Chunk_Size = 256 * 1024;
+
+/**
+ * So a "decompression bomb" (a small file that decompresses to an enormous
+ * size) can't exhaust memory, a file may decompress to at most this many times
+ * its size ...
+ */
+static size_t const Decompress_Ratio_Max = 256;
+
+/**
+ * ... or this many bytes, whichever is greater.
+ */
+static size_t const Decompress_Size_Min = 64 * 1024 * 1024;
+
+////////// local functions ////////////////////////////////////////////////////
+
+/**
+ * Gets the maximum size a file may decompress to.
+ *
+ * @param size The size of the compressed file.
+ * @return Returns said size.
+ */
+inline size_t decompress_size_max( size_t size ) {
+  return max( size * Decompress_Ratio_Max, Decompress_Size_Min );
+}
+
+/**
+ * Ensures there is room in the output buffer past the bytes decompressed so
+ * far, but no more than one byte past the maximum size so that exceeding it
+ * can be detected.
+ *
+ * @param output The buffer to decompress into.
+ * @param used The number of bytes decompressed into it so far.  It must be at
+ * most \a size_max.
+ * @param size_max The maximum number of bytes to decompress.
+ * @return Returns the number of bytes of room capped at what an \c unsigned
+ * can hold since some decompression libraries use that for sizes.
+ */
+static unsigned make_room( vector<char> &output, size_t used,
+                           size_t size_max ) {
+  if ( output.size() - used < Decompress_Chunk_Size )
+    output.resize(
+      min( max( used + Decompress_Chunk_Size, output.size() * 2 ),
+           size_max + 1 )
+    );
+  return static_cast<unsigned>(
+    min( output.size() - used, size_t( UINT_MAX ) )
+  );
+}
+
+/**
+ * Finishes decompressing into the output buffer.
+ *
+ * @param output The buffer decompressed into.
+ * @param used The number of bytes decompressed into it.
+ * @param size_max The maximum number of bytes to decompress.
+ * @param ok Whether decompression was otherwise successful.
+ * @return Returns \c true only if \a ok and \a used is at most \a size_max;
+ * if the latter isn't, sets \c errno to \c EFBIG.
+ */
+static bool finish( vector<char> &output, size_t used, size_t size_max,
+                    bool ok ) {
+  if ( used > size_max ) {
+    output.clear();
+    errno = EFBIG;
+    return false;
+  }
+  output.resize( used );
+  return ok;
+}
+
+#ifdef HAVE_LIBZ
+/**
+ * Decompresses a gzip(1) file.  A file of several concatenated gzip members
+ * is decompressed as one.
+ *
+ * @param file_name The name of the file.
+ * @param output The buffer to decompress into.
+ * @return Returns \c true only if successful.
+ */
+static bool gunzip( char const *file_name, vector<char> &output ) {
+  output.clear();
+  mmap_file const file( file_name );
+  if ( !file )
+    return false;
+  file.behavior( mmap_file::bt_sequential );
+
+  z_stream z;
+  ::memset( &z, 0, sizeof z );
+  if ( ::inflateInit2( &z, 15 + 32 ) != Z_OK )  // 32: detect gzip header
+    return false;
+
+  char const *in = file.begin();
+  size_t const size_max = decompress_size_max( file.size() );
+  size_t used = 0;
+  int z_err;
+  do {
+    if ( !z.avail_in && in != file.end() ) {
+      z.next_in = reinterpret_cast<Bytef*>( const_cast<char*>( in ) );
+      z.avail_in = static_cast<uInt>(
+        min( static_cast<size_t>( file.end() - in ), size_t( UINT_MAX ) )
+      );
+      in += z.avail_in;
+    }
+    unsigned const room = make_room( output, used, size_max );
+    z.next_out = reinterpret_cast<Bytef*>( output.data() + used );
+    z.avail_out = room;
+    z_err = ::inflate( &z, Z_NO_FLUSH );
+    used += room - z.avail_out;
+    //
+    // If another gzip member follows, continue with it; anything else after
+    // the end of a member (e.g., padding) is ignored just as gzip(1) does.
+    //
+    if ( z_err == Z_STREAM_END && z.avail_in >= 2 &&
+         z.next_in[0] == 0x1F && z.next_in[1] == 0x8B ) {
+      z_err = ::inflateReset( &z );
+    }
+  } while ( z_err == Z_OK && used <= size_max );
+
+  ::inflateEnd( &z );
+  return finish( output, used, size_max, z_err == Z_STREAM_END );
+}
+#endif /* HAVE_LIBZ */
+
+#ifdef HAVE_LIBBZ2
+/**
+ * Decompresses a bzip2(1) file.  A file of several concatenated bzip2 streams
+ * is decompressed as one.
+ *
+ * @param file_name The name of the file.
+ * @param output The buffer to decompress into.
+ * @return Returns \c true only if successful.
+ */
+static bool bunzip2( char const *file_name, vector<char> &output ) {
+  output.clear();
+  mmap_file const file( file_name );
+  if ( !file )
+    return false;
+  file.behavior( mmap_file::bt_sequential );
+
+  bz_stream bz;
+  ::memset( &bz, 0, sizeof bz );
+  if ( ::BZ2_bzDecompressInit( &bz, 0, 0 ) != BZ_OK )
+    return false;
+
+  char const *in = file.begin();
+  size_t const size_max = decompress_size_max( file.size() );
+  size_t used = 0;
+  int bz_err;
+  do {
+    if ( !bz.avail_in && in != file.end() ) {
+      bz.next_in = const_cast<char*>( in );
+      bz.avail_in = static_cast<unsigned>(
+        min( static_cast<size_t>( file.end() - in ), size_t( UINT_MAX ) )
+      );
+      in += bz.avail_in;
+    }
+    unsigned const room = make_room( output, used, size_max );
+    bz.next_out = output.data() + used;
+    bz.avail_out = room;
+    bz_err = ::BZ2_bzDecompress( &bz );
+    used += room - bz.avail_out;
+    if ( bz_err == BZ_OK && !bz.avail_in && in == file.end() &&
+         bz.avail_out ) {
+      bz_err = BZ_UNEXPECTED_EOF;       // truncated
+    }
+    //
+    // If another bzip2 stream follows, continue with it.
+    //
+    if ( bz_err == BZ_STREAM_END && bz.avail_in >= 3 &&
+         !::strncmp( bz.next_in, "BZh", 3 ) ) {
+      ::BZ2_bzDecompressEnd( &bz );
+      bz_err = ::BZ2_bzDecompressInit( &bz, 0, 0 );
+    }
+  } while ( bz_err == BZ_OK && used <= size_max );
+
+  ::BZ2_bzDecompressEnd( &bz );
+  return finish( output, used, size_max, bz_err == BZ_STREAM_END );
+}
+#endif /* HAVE_LIBBZ2 */
+
+#ifdef HAVE_LIBLZMA
+/**
+ * Decompresses an xz(1) file.  A file of several concatenated xz streams is
+ * decompressed as one.
+ *
+ * @param file_name The name of the file.
+ * @param output The buffer to decompress into.
+ * @return Returns \c true only if successful.
+ */
+static bool unxz( char const *file_name, vector<char> &output ) {
+  output.clear();
+  mmap_file const file( file_name );
+  if ( !file )
+    return false;
+  file.behavior( mmap_file::bt_sequential );
+
+  lzma_stream xz = LZMA_STREAM_INIT;
+  if ( ::lzma_stream_decoder( &xz, UINT64_MAX, LZMA_CONCATENATED ) != LZMA_OK )
+    return false;
+  xz.next_in = reinterpret_cast<uint8_t const*>( file.begin() );
+  xz.avail_in = file.size();
+
+  size_t const size_max = decompress_size_max( file.size() );
+  size_t used = 0;
+  lzma_ret xz_err;
+  do {
+    unsigned const room = make_room( output, used, size_max );
+    xz.next_out = reinterpret_cast<uint8_t*>( output.data() + used );
+    xz.avail_out = room;
+    xz_err = ::lzma_code( &xz, LZMA_FINISH );
+    used += room - xz.avail_out;
+  } while ( xz_err == LZMA_OK && used <= size_max );
+
+  ::lzma_end( &xz );
+  return finish( output, used, size_max, xz_err == LZMA_STREAM_END );
+}
+#endif /* HAVE_LIBLZMA */
+
+////////// extern functions ///////////////////////////////////////////////////
+
+decompressor find_decompressor( char const *file_name ) {
+  static struct {
+    char const   *ext;
+    decompressor  decompress;
+  } const decompressors[] = {
+#ifdef HAVE_LIBZ
+    { ".gz",  &gunzip  },
+#endif /* HAVE_LIBZ */
+#ifdef HAVE_LIBBZ2
+    { ".bz2", &bunzip2 },
+#endif /* HAVE_LIBBZ2 */
+#ifdef HAVE_LIBLZMA
+    { ".xz",  &unxz    },
+#endif /* HAVE_LIBLZMA */
+    { nullptr, nullptr }
+  };
+
+  char const *const ext = ::strrchr( file_name, '.' );
+  if ( ext && ext != file_name && ext[-1] != '/' ) {
+    for ( auto d = decompressors; d->ext; ++d )
+      if ( !::strcmp( ext, d->ext ) )
+        return d->decompress;
+  }
+  return nullptr;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/* vim:set et sw=2 ts=2: */
@@ -0,0 +1,60 @@
+/*
+**      SWISH++
+**      src/decompress.h
+**
+**      Copyright (C) 2026  Paul J. Lucas
+**
+**      This program is free software; you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation; either version 2 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program; if not, write to the Free Software
+**      Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#ifndef decompress_H
+#define decompress_H
+
+// local
+#include "config.h"
+
+// standard
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A %decompressor decompresses the whole of a compressed file into memory.
+ * So a "decompression bomb" can't exhaust memory, a file is decompressed to at
+ * most 256 times its size (or 64 MB, whichever is greater).
+ *
+ * @param file_name The name of the compressed file.
+ * @param output The buffer to decompress into.  It's cleared first.
+ * @return Returns \c true only if the file was decompressed successfully; if
+ * it would have decompressed to more than the maximum size, sets \c errno to
+ * \c EFBIG.
+ */
+using decompressor = bool (*)( char const *file_name,
+                               std::vector<char> &output );
+
+/**
+ * Finds the built-in decompressor for a file based on its extension:
+ * \c .gz (if built with zlib), \c .bz2 (if built with libbz2), or \c .xz (if
+ * built with liblzma).
+ *
+ * @param file_name The name of the file.
+ * @return Returns said decompressor or null if none.
+ */
+decompressor find_decompressor( char const *file_name );
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif /* decompress_H */
+/* vim:set et sw=2 ts=2: */
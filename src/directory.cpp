@@ -34,21 +34,27 @@
 #include "Verbosity.h"
 
 // standard
+#include <algorithm>
 #include <cstring>
+#include <deque>
 #include <iostream>
-#include <queue>
+#include <string>
+#include <vector>
 #include <sys/types.h>                  /* needed by dirent.h */
 #include <dirent.h>
+#include <fcntl.h>                      /* for open(2) */
+#include <sys/stat.h>                   /* for fstatat(2) */
+#include <unistd.h>                     /* for close(2) */
+#ifdef MULTI_THREADED
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <thread>
+#endif /* MULTI_THREADED */
 
 using namespace PJL;
 using namespace std;
 
-#ifdef SWISHXX_INDEX
-extern void do_file( char const *file_name, int dir_index );
-#else
-extern void do_file( char const *file_name );
-#endif /* SWISHXX_INDEX */
-
 ///////////////////////////////////////////////////////////////////////////////
 
 #ifdef __CYGWIN__
@@ -118,78 +124,311 @@ void do_check_add_file( char const *file_name ) {
 #endif /* SWISHXX_INDEX */
 
 /**
- * Calls \c do_file() for every file in the given directory; it will queue
- * subdirectories encountered and call \c do_directory() on them.  It will not
- * follow symbolic links unless explicitly told to do so.
+ * A %dir_entry is an entry of a directory as read by \c scan_directory().
+ */
+struct dir_entry {
+  string      name;
+  bool        is_link;                  // is a symbolic link
+  struct stat stat_buf;                 // of what the entry refers to
+};
+
+/**
+ * A %dir_scan is the result of reading all the entries of a directory.
+ */
+struct dir_scan {
+  bool              opened = false;     // was the directory opened?
+  vector<dir_entry> entries;
+};
+
+/**
+ * Gets the status of what a directory entry refers to.  If it can't be gotten
+ * (e.g., a dangling symbolic link), the status is left zeroed so the entry is
+ * neither a directory nor a plain file.
+ *
+ * @param dir_fd The file descriptor of the directory containing the entry.
+ * @param entry The entry.
+ * @param check_link If \c true, first check whether the entry is a symbolic
+ * link.
+ */
+static void stat_entry( int dir_fd, dir_entry &entry, bool check_link ) {
+  char const *const name = entry.name.c_str();
+  if ( check_link ) {
+    if ( ::fstatat( dir_fd, name, &entry.stat_buf, AT_SYMLINK_NOFOLLOW ) ) {
+      entry.stat_buf = {};
+      return;
+    }
+    entry.is_link = S_ISLNK( entry.stat_buf.st_mode );
+    if ( !entry.is_link )
+      return;
+  }
+  if ( ::fstatat( dir_fd, name, &entry.stat_buf, 0 ) )
+    entry.stat_buf = {};
+}
+
+/**
+ * Reads all the entries of a directory.  The directory is opened once and
+ * each entry is stat'ed relative to it via \c fstatat(2) so the full path
+ * needn't be resolved per entry.  When the type of an entry is given by
+ * readdir(3) (\c d_type), it's trusted: a directory needs no stat at all and
+ * the symbolic link check needs no \c lstat(2).
+ *
+ * This function touches no global state so it may be called concurrently.
+ *
+ * @param dir_path The full path of the directory.
+ * @return Returns said entries.
+ */
+static dir_scan scan_directory( char const *dir_path ) {
+  dir_scan scan;
+  int const dir_fd = ::open( dir_path, O_RDONLY | O_DIRECTORY | O_CLOEXEC );
+  if ( dir_fd == -1 )
+    return scan;
+  DIR *const dir_p = ::fdopendir( dir_fd );
+  if ( !dir_p ) {
+    ::close( dir_fd );
+    return scan;
+  }
+  scan.opened = true;
+
+  for ( struct dirent const *dir_ent; (dir_ent = ::readdir( dir_p )); ) {
+    //
+    // See if the name is "." or "..": if so, skip it.
+    //
+    if ( dir_ent->d_name[0] == '.' ) {
+      if ( !dir_ent->d_name[1] )
+        continue;
+      if ( dir_ent->d_name[1] == '.' && !dir_ent->d_name[2] )
+        continue;
+    }
+    dir_entry entry;
+    entry.name = dir_ent->d_name;
+    entry.is_link = false;
+    entry.stat_buf = {};
+#ifdef DT_UNKNOWN
+    switch ( dir_ent->d_type ) {
+      case DT_DIR:
+        entry.stat_buf.st_mode = S_IFDIR;
+        break;
+      case DT_UNKNOWN:
+        stat_entry( dir_fd, entry, true );
+        break;
+      case DT_LNK:
+        entry.is_link = true;
+        [[fallthrough]];
+      default:
+        stat_entry( dir_fd, entry, false );
+    } // switch
+#else
+    stat_entry( dir_fd, entry, true );
+#endif /* DT_UNKNOWN */
+    scan.entries.push_back( std::move( entry ) );
+  } // for
+
+  ::closedir( dir_p );
+  return scan;
+}
+
+#ifdef MULTI_THREADED
+/**
+ * A %dir_scanner is a pool of threads that scan directories ahead of when
+ * they're needed.
+ */
+class dir_scanner {
+public:
+  /**
+   * Constructs a %dir_scanner.
+   *
+   * @param num_threads The number of threads to scan with.
+   */
+  explicit dir_scanner( unsigned num_threads ) {
+    for ( unsigned i = 0; i < num_threads; ++i )
+      threads_.emplace_back( &dir_scanner::run, this );
+  }
+
+  ~dir_scanner() {
+    {
+      lock_guard<mutex> const lock( mutex_ );
+      done_ = true;
+    }
+    cv_.notify_all();
+    for ( auto &t : threads_ )
+      t.join();
+  }
+
+  dir_scanner( dir_scanner const& ) = delete;
+  dir_scanner& operator=( dir_scanner const& ) = delete;
+
+  /**
+   * Schedules the scan of a directory.
+   *
+   * @param dir_path The full path of the directory.  The string must last
+   * until the scan is done.
+   * @return Returns a future for the scan.
+   */
+  future<dir_scan> scan( char const *dir_path ) {
+    packaged_task<dir_scan()> task{ [dir_path]() {
+      return scan_directory( dir_path );
+    } };
+    future<dir_scan> result = task.get_future();
+    {
+      lock_guard<mutex> const lock( mutex_ );
+      tasks_.push_back( std::move( task ) );
+    }
+    cv_.notify_one();
+    return result;
+  }
+
+private:
+  void run() {
+    for (;;) {
+      packaged_task<dir_scan()> task;
+      {
+        unique_lock<mutex> lock( mutex_ );
+        cv_.wait( lock, [this]{ return done_ || !tasks_.empty(); } );
+        if ( tasks_.empty() )
+          return;
+        task = std::move( tasks_.front() );
+        tasks_.pop_front();
+      }
+      task();
+    } // for
+  }
+
+  mutex                             mutex_;
+  condition_variable                cv_;
+  deque<packaged_task<dir_scan()>>  tasks_;
+  bool                              done_ = false;
+  vector<thread>                    threads_;
+};
+
+/**
+ * The maximum number of threads to scan directories with.  Scanning is mostly
+ * waiting on the file system, so more threads than CPUs can help, especially
+ * over NFS.
+ */
+unsigned const Dir_Scan_Threads_Max = 8;
+
+/**
+ * The number of directories scanned ahead of the one being processed per
+ * scanning thread.
+ */
+unsigned const Dir_Scan_Ahead_Per_Thread = 4;
+#endif /* MULTI_THREADED */
+
+/**
+ * Calls \c do_file() for every file in the given directory and all its
+ * subdirectories (if recursing).  It will not follow symbolic links unless
+ * explicitly told to do so.
  *
- * This function uses a queue and recurses only once so as not to have too many
+ * Directories are processed from a queue so as not to have too many
  * directories open concurrently.  This has the side-effect of indexing in a
- * breadth-first order rather than depth-first.
+ * breadth-first order rather than depth-first.  Directories in the queue are
+ * scanned ahead by a pool of threads, but they're always processed in queue
+ * order so the order of files is the same as if scanned serially.
  *
  * @param dir_path The full path of the directory of the files and
  * subdirectories to index.  The string must point to storage that will last
  * for the duration of the program.
  */
 void do_directory( char const *dir_path ) {
-  using dir_queue_type = queue<char const*>;
-  static dir_queue_type dir_queue;
-  static int recursion;
+  /**
+   * A %queued_dir is a directory waiting to be processed.
+   */
+  struct queued_dir {
+    queued_dir( char const *p, bool l ) : path{ p }, is_link{ l } { }
 
-  if ( verbosity > 1 ) {
-    if ( verbosity > 2 ) cout << '\n';
-    cout << dir_path << flush;
-  }
+    char const       *path;
+    bool              is_link;
+#ifdef MULTI_THREADED
+    future<dir_scan>  scan;
+#endif /* MULTI_THREADED */
+  };
+  deque<queued_dir> dir_queue;
 
 #ifndef PJL_NO_SYMBOLIC_LINKS
-  if ( is_symbolic_link( dir_path ) && !follow_symbolic_links ) {
-    if ( verbosity > 3 )
-      cout << " (skipped: symbolic link)";
-    if ( verbosity > 1 )
-      cout << '\n';
-    return;
-  }
-#endif
+  dir_queue.emplace_back( dir_path, is_symbolic_link( dir_path ) );
+#else
+  dir_queue.emplace_back( dir_path, false );
+#endif /* PJL_NO_SYMBOLIC_LINKS */
 
-  DIR *const dir_p = ::opendir( dir_path );
-  if ( !dir_p ) {
-    if ( verbosity > 3 )
-      cout << " (skipped: can not open)";
-    if ( verbosity > 1 )
-      cout << '\n';
-    return;
-  }
+#ifdef MULTI_THREADED
+  unsigned const num_threads = recurse_subdirectories ?
+    max( 1u, min( thread::hardware_concurrency(), Dir_Scan_Threads_Max ) ) :
+    0;
+  dir_scanner scanner( num_threads );
+  size_t const scan_ahead = num_threads * Dir_Scan_Ahead_Per_Thread;
+  size_t num_scanning = 0;              // from the front of dir_queue
+#endif /* MULTI_THREADED */
 
-  if ( verbosity > 1 ) {
-    if ( verbosity > 2 ) cout << ':';
-    cout << '\n';
-  }
+  while ( !dir_queue.empty() ) {
+#ifdef MULTI_THREADED
+    //
+    // Keep the threads busy scanning the directories next in the queue.
+    //
+    for ( ; num_scanning < dir_queue.size() && num_scanning < scan_ahead;
+          ++num_scanning ) {
+      queued_dir &next = dir_queue[ num_scanning ];
+      if ( !next.is_link || follow_symbolic_links )
+        next.scan = scanner.scan( next.path );
+    } // for
+#endif /* MULTI_THREADED */
+    queued_dir dir = std::move( dir_queue.front() );
+    dir_queue.pop_front();
+#ifdef MULTI_THREADED
+    if ( num_scanning )
+      --num_scanning;
+#endif /* MULTI_THREADED */
+
+    if ( verbosity > 1 ) {
+      if ( verbosity > 2 ) cout << '\n';
+      cout << dir.path << flush;
+    }
+
+#ifndef PJL_NO_SYMBOLIC_LINKS
+    if ( dir.is_link && !follow_symbolic_links ) {
+      if ( verbosity > 3 )
+        cout << " (skipped: symbolic link)";
+      if ( verbosity > 1 )
+        cout << '\n';
+      continue;
+    }
+#endif /* PJL_NO_SYMBOLIC_LINKS */
+
+#ifdef MULTI_THREADED
+    dir_scan const scan = dir.scan.valid() ?
+      dir.scan.get() : scan_directory( dir.path );
+#else
+    dir_scan const scan = scan_directory( dir.path );
+#endif /* MULTI_THREADED */
+    if ( !scan.opened ) {
+      if ( verbosity > 3 )
+        cout << " (skipped: can not open)";
+      if ( verbosity > 1 )
+        cout << '\n';
+      continue;
+    }
+
+    if ( verbosity > 1 ) {
+      if ( verbosity > 2 ) cout << ':';
+      cout << '\n';
+    }
 
 #ifdef SWISHXX_INDEX
-  int const dir_index = check_add_directory( dir_path );
+    int const dir_index = check_add_directory( dir.path );
 #endif /* SWISHXX_INDEX */
-  //
-  // Have a buffer for the full path to a file in a directory.  For each file,
-  // simply strcpy() the file name into place one character past the '/'.
-  //
-  char path[ PATH_MAX + 1 ];
-  ::strcpy( path, dir_path );
-  char *file = path + ::strlen( path );
-  *file++ = Dir_Sep_Char;
-
-  for ( struct dirent const *dir_ent; (dir_ent = ::readdir( dir_p )); ) {
     //
-    // See if the name is "." or "..": if so, skip it.
+    // Have a buffer for the full path to a file in a directory.  For each
+    // file, simply append the file name one character past the '/'.
     //
-    if ( dir_ent->d_name[0] == '.' ) {
-      if ( !dir_ent->d_name[1] )
-        continue;
-      if ( dir_ent->d_name[1] == '.' && !dir_ent->d_name[2] )
+    string path( dir.path );
+    path += Dir_Sep_Char;
+    string::size_type const file_pos = path.size();
+
+    for ( auto const &entry : scan.entries ) {
+      path.replace( file_pos, string::npos, entry.name );
+      if ( S_ISDIR( entry.stat_buf.st_mode ) && recurse_subdirectories ) {
+        dir_queue.emplace_back( new_strdup( path.c_str() ), entry.is_link );
         continue;
-    }
-    ::strcpy( file, dir_ent->d_name );
-    if ( is_directory( path ) && recurse_subdirectories )
-      dir_queue.push( new_strdup( path ) );
-    else {
+      }
       //
       // Note that do_file() is called in the case where 'path' is a directory
       // and recurse_subdirectories is false.  This is OK since do_file()
@@ -197,26 +436,16 @@ void do_directory( char const *dir_path ) {
       // do_file() so we don't have to repeat the code to print verbose
       // information for 'path'.
       //
+      // The zero-argument file test functions that do_file() uses operate on
+      // stat_buf, so set it to the entry's status.
+      //
+      stat_buf = entry.stat_buf;
 #ifdef SWISHXX_INDEX
-      do_file( path, dir_index );
+      do_file( path.c_str(), dir_index, entry.is_link );
 #else
-      do_file( path );
+      do_file( path.c_str(), entry.is_link );
 #endif /* SWISHXX_INDEX */
-    }
-  } // for
-
-  ::closedir( dir_p );
-  if ( recursion )
-    return;
-
-  ////////// Do all subdirectories ////////////////////////////////////////////
-
-  while ( !dir_queue.empty() ) {
-    char const *const dir_path = dir_queue.front();
-    dir_queue.pop();
-    ++recursion;
-    do_directory( dir_path );
-    --recursion;
+    } // for
   } // while
 }
 
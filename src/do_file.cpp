@@ -32,11 +32,262 @@
 #ifdef SWISHXX_EXTRACT
 #include <fstream>
 #endif /* SWISHXX_EXTRACT */
+#include <cerrno>
+#include <optional>
 #include <string>
 #include <vector>
+#if defined( SWISHXX_INDEX ) && defined( MULTI_THREADED )
+#include <algorithm>                    /* for min(), max() */
+#include <deque>
+#include <future>
+#include <memory>
+#include <thread>
+#endif /* SWISHXX_INDEX && MULTI_THREADED */
 
 ///////////////////////////////////////////////////////////////////////////////
 
+using filter_list_type = vector<filter>;
+
+/**
+ * Executes the filter(s) on a file in order.  The output of the last filter is
+ * read through a pipe into a buffer rather than written to its target file,
+ * if possible.
+ *
+ * @param filter_list The filters to execute.
+ * @param file_name Set to the name of the filtered file or to null if the
+ * filtered file is instead in \a output.  It's left as-is if there are no
+ * filters.
+ * @param output The buffer to read the last filter's output into.
+ * @return Returns \c true only if all the filters succeeded.
+ */
+static bool exec_filters( filter_list_type const &filter_list,
+                          char const *&file_name, vector<char> &output ) {
+  errno = 0;
+  for ( auto f = filter_list.begin(); f != filter_list.end(); ++f ) {
+    if ( f + 1 == filter_list.end() && f->pipes() ) {
+      file_name = nullptr;
+      return f->exec( output );
+    }
+    if ( !(file_name = f->exec()) )
+      return false;
+  } // for
+  return true;
+}
+
+/**
+ * Gets why executing the filter(s) on a file failed for verbose output.
+ *
+ * @param err The value of \c errno after \c exec_filters() failed.
+ * @return Returns said reason.
+ */
+static char const* filter_failure( int err ) {
+  return err == EFBIG ? "decompressed size too large" : "could not filter";
+}
+
+#ifdef SWISHXX_INDEX
+/**
+ * Indexes a single document: either an entire file or one of several
+ * documents within a file.
+ *
+ * @param path_name The path name of the document.
+ * @param dir_index The numerical index of the file's directory.
+ * @param orig_stat The status of the original (non-filtered) file.
+ * @param i The indexer to use.
+ * @param doc The document to index.
+ * @param size The size of the document as recorded in the index.
+ * @return Returns the number of words indexed.
+ */
+static unsigned long index_document( char const *path_name, int dir_index,
+                                     struct stat const &orig_stat, indexer *i,
+                                     mmap_file const &doc, size_t size ) {
+  index_context ctx( words, file_info::num_files() );
+  i->index_file( ctx, doc );
+  //
+  // Most indexing modules report the title of the file as a side effect of
+  // indexing it; only if one didn't is the file scanned for its title.
+  //
+  new file_info(
+    path_name, dir_index, size, orig_stat.st_mtime, orig_stat.st_ino,
+    ctx.title_reported() ? ctx.title() : i->find_title( ctx, doc ),
+    ctx.num_indexed_words()
+  );
+  num_total_words += ctx.num_total_words();
+  num_indexed_words += ctx.num_indexed_words();
+  return ctx.num_indexed_words();
+}
+
+/**
+ * Indexes a file that has been opened (and possibly filtered).  If the file
+ * contains several documents, e.g., it's an mbox file, each is indexed
+ * separately in place as \c path#offset.
+ *
+ * @param orig_file_name The original (non-filtered) name of the file.
+ * @param dir_index The numerical index of the file's directory.
+ * @param orig_stat The status of the original (non-filtered) file.
+ * @param i The indexer to use.
+ * @param file The (possibly filtered) file to index.
+ */
+static void index_mapped_file( char const *orig_file_name, int dir_index,
+                               struct stat const &orig_stat, indexer *i,
+                               mmap_file const &file ) {
+  if ( file.empty() ) {
+    //
+    // Don't waste a file_info entry on it.
+    //
+    if ( verbosity > 2 )
+      cout << " (0 words)\n";
+    return;
+  }
+
+  vector<size_t> doc_offsets;
+  if ( !i->find_documents( file, doc_offsets ) ) {
+    unsigned long const num_words = index_document(
+      orig_file_name, dir_index, orig_stat, i, file, orig_stat.st_size
+    );
+    if ( verbosity > 2 )
+      cout << " (" << num_words << " words)\n";
+  } else {
+    unsigned long num_words = 0;
+    string path_name;
+    for ( size_t d = 0; d < doc_offsets.size(); ++d ) {
+      size_t const offset = doc_offsets[ d ];
+      size_t const size =
+        (d + 1 < doc_offsets.size() ? doc_offsets[ d + 1 ] : file.size())
+        - offset;
+      path_name = orig_file_name;
+      path_name += file_info::Document_Offset_Separator;
+      path_name += ltoa( static_cast<long>( offset ) );
+      num_words += index_document(
+        path_name.c_str(), dir_index, orig_stat, i,
+        mmap_file( file.begin() + offset, size ), size
+      );
+    } // for
+    if ( verbosity > 2 )
+      cout << " (" << doc_offsets.size() << " documents, "
+           << num_words << " words)\n";
+  }
+
+  if ( words.size() >= word_threshold )
+    write_partial_index();
+}
+
+#ifdef MULTI_THREADED
+/**
+ * A %filtered_file is a file whose filter(s) are being executed in the
+ * background.
+ */
+struct filtered_file {
+  string            orig_file_name;
+  int               dir_index;
+  struct stat       orig_stat;
+  indexer          *file_indexer;
+  filter_list_type  filter_list;
+  char const       *file_name;          // of the filtered file, if any
+  vector<char>      output;             // of the last filter, if piped
+  future<bool>      filtered;
+  int               filter_errno;       // errno if filtering failed
+};
+
+/**
+ * Files whose filter(s) are being executed in the background in the order the
+ * files were encountered.
+ */
+static deque<unique_ptr<filtered_file>> filtered_files;
+
+/**
+ * Output buffers of filtered files that have been indexed that are reused.
+ */
+static vector<vector<char>> spare_filter_outputs;
+
+/**
+ * The maximum number of files to execute filter(s) on concurrently.
+ */
+unsigned const Filter_Threads_Max = 8;
+#endif /* MULTI_THREADED */
+
+/**
+ * Waits for files being filtered in the background to finish, indexing each
+ * in the order they were encountered, until at most a given number remain.
+ * Files are only ever waited for when too many are being filtered (or at the
+ * end) so that the order of all files, hence the index, doesn't depend on how
+ * long filters take.
+ *
+ * @param max_pending The maximum number that may remain.
+ */
+static void wait_filtered_files( [[maybe_unused]] size_t max_pending ) {
+#ifdef MULTI_THREADED
+  while ( filtered_files.size() > max_pending ) {
+    unique_ptr<filtered_file> const f = std::move( filtered_files.front() );
+    filtered_files.pop_front();
+    char const *const orig_base_name =
+      pjl_basename( f->orig_file_name.c_str() );
+
+    if ( !f->filtered.get() ) {
+      if ( verbosity > 3 )
+        cout << "  " << orig_base_name
+             << " (skipped: " << filter_failure( f->filter_errno ) << ")\n";
+    } else {
+      mmap_file const file = f->file_name ?
+        mmap_file( f->file_name ) :
+        mmap_file( f->output.data(), f->output.size() );
+      if ( !file ) {
+        if ( verbosity > 3 )
+          cout << "  " << orig_base_name << " (skipped: can not open)\n";
+      } else {
+        file.behavior( mmap_file::bt_sequential );
+        if ( verbosity > 2 )
+          cout << "  " << orig_base_name << flush;
+        index_mapped_file(
+          f->orig_file_name.c_str(), f->dir_index, f->orig_stat,
+          f->file_indexer, file
+        );
+      }
+    }
+
+    f->output.clear();
+    spare_filter_outputs.push_back( std::move( f->output ) );
+  } // while
+#endif /* MULTI_THREADED */
+}
+
+#ifdef MULTI_THREADED
+/**
+ * Executes the filter(s) on a file in the background.  The file is indexed by
+ * \c wait_filtered_files() once they finish.
+ *
+ * @param orig_file_name The original (non-filtered) name of the file.
+ * @param dir_index The numerical index of the file's directory.
+ * @param orig_stat The status of the original (non-filtered) file.
+ * @param i The indexer to use.
+ * @param filter_list The filters to execute.
+ */
+static void filter_file( char const *orig_file_name, int dir_index,
+                         struct stat const &orig_stat, indexer *i,
+                         filter_list_type &&filter_list ) {
+  static size_t const max_pending =
+    max( 1u, min( thread::hardware_concurrency(), Filter_Threads_Max ) );
+  wait_filtered_files( max_pending - 1 );
+
+  unique_ptr<filtered_file> f( new filtered_file{
+    orig_file_name, dir_index, orig_stat, i, std::move( filter_list ),
+    nullptr, { }, { }, 0
+  } );
+  if ( !spare_filter_outputs.empty() ) {
+    f->output = std::move( spare_filter_outputs.back() );
+    spare_filter_outputs.pop_back();
+  }
+  filtered_file *const p = f.get();
+  p->filtered = async( launch::async, [p]() {
+    if ( exec_filters( p->filter_list, p->file_name, p->output ) )
+      return true;
+    p->filter_errno = errno;
+    return false;
+  } );
+  filtered_files.push_back( std::move( f ) );
+}
+#endif /* MULTI_THREADED */
+#endif /* SWISHXX_INDEX */
+
 /**
  * Either index or extract text from the given file, but only if its extension
  * is among (not among) the specified set.  It will not follow symbolic links
@@ -48,11 +299,14 @@
  * Encapsulated PostScript and raw hex data.
  *
  * @param file_name The file to process.
+ * @param is_link Whether \a file_name is a symbolic link, if already known.
  */
 #ifdef SWISHXX_INDEX
-void do_file( char const *file_name, int dir_index ) {
+void do_file( char const *file_name, int dir_index,
+              [[maybe_unused]] optional<bool> is_link = nullopt ) {
 #else
-void do_file( char const *file_name ) {
+void do_file( char const *file_name,
+              [[maybe_unused]] optional<bool> is_link = nullopt ) {
 #endif /* SWISHXX_INDEX */
   char const *const orig_base_name = pjl_basename( file_name );
 
@@ -66,7 +320,7 @@ void do_file( char const *file_name ) {
     //
     // We're able to use the zero-argument form of is_plain_file() because the
     // stat_buf is cached by the call to file_exists() in both index.c and
-    // extract.c just before the call to do_file().
+    // extract.c, or set by do_directory(), just before the call to do_file().
     //
     if ( verbosity > 3 )
       cout << " (skipped: not plain file)\n";
@@ -75,18 +329,20 @@ void do_file( char const *file_name ) {
 
 #ifdef SWISHXX_INDEX
   //
-  // Record the size of the original (non-filtered) file here before we call
-  // is_symbolic_link() below.  This is the size that is stored in the index.
+  // Record the status (notably the size) of the original (non-filtered) file
+  // here before we call is_symbolic_link() below.  This is the size that is
+  // stored in the index.
   //
-  off_t const orig_file_size = file_size();
+  struct stat const orig_stat = stat_buf;
 #endif /* SWISHXX_INDEX */
 
 #ifndef PJL_NO_SYMBOLIC_LINKS
-  if ( is_symbolic_link( file_name ) && !follow_symbolic_links ) {
+  if ( !follow_symbolic_links &&
+       (is_link ? *is_link : is_symbolic_link( file_name )) ) {
     //
     // Despite the above comment for is_plain_file(), we have to use the
     // one-argument form is is_symbolic_link() because we need to call lstat(2)
-    // rather than stat(2).
+    // rather than stat(2) -- unless the caller already knows.
     //
     if ( verbosity > 3 )
       cout << " (skipped: symbolic link)\n";
@@ -96,10 +352,10 @@ void do_file( char const *file_name ) {
 
 #ifdef SWISHXX_INDEX
   //
-  // If incrementally indexing, it's possible that we've encountered the file
-  // before.
+  // If incrementally indexing or resuming, it's possible that we've
+  // encountered the file before.
   //
-  if ( incremental && file_info::seen_file( file_name ) ) {
+  if ( (incremental || resuming) && file_info::seen_file( file_name ) ) {
     if ( verbosity > 3 )
       cout << " (skipped: encountered before)\n";
     return;
@@ -108,7 +364,6 @@ void do_file( char const *file_name ) {
 
   ////////// Perform filter name substitution(s) //////////////////////////////
 
-  using filter_list_type = vector<filter>;
   filter_list_type filter_list;
 #ifdef SWISHXX_INDEX
   char const *const orig_file_name = file_name;
@@ -118,12 +373,18 @@ void do_file( char const *file_name ) {
   while ( true ) {
     //
     // Determine if the file needs to be filtered and, if so, set the filename
-    // to what it would become if it were filtered.
+    // to what it would become if it were filtered.  A configured filter takes
+    // precedence over a built-in decompressor.
     //
     FilterFile::const_pointer const f = file_filters[ safe_file_name ];
-    if ( !f )
-      break;
-    filter_list.push_back( *f );
+    if ( f ) {
+      filter_list.push_back( *f );
+    } else {
+      decompressor const d = find_decompressor( safe_file_name.c_str() );
+      if ( !d )
+        break;
+      filter_list.emplace_back( d );
+    }
     //
     // Because filter_list grows, if file_name were used, it can become
     // invalid, so use safe_file_name instead.
@@ -163,6 +424,21 @@ void do_file( char const *file_name ) {
     return;
   }
 
+#ifdef SWISHXX_INDEX
+  //
+  // If rebuilding or indexing incrementally, the file may be unchanged since
+  // the existing index (or segment) was built: if so, it needn't be indexed.
+  //
+  if ( !old_segments.empty() &&
+       copy_unchanged_file( orig_file_name, dir_index, orig_stat ) ) {
+    if ( verbosity == 3 )
+      cout << "  " << orig_base_name;
+    if ( verbosity > 2 )
+      cout << " (unchanged)\n";
+    return;
+  }
+#endif /* SWISHXX_INDEX */
+
 #ifdef SWISHXX_EXTRACT
   ostream *out;
   ofstream extracted_file;
@@ -203,21 +479,41 @@ void do_file( char const *file_name ) {
   }
 #endif /* SWISHXX_EXTRACT */
 
+#ifdef SWISHXX_INDEX
+  indexer *const i = found_pattern ?
+    include_pattern->second : indexer::text_indexer();
+#ifdef MULTI_THREADED
+  if ( !filter_list.empty() ) {
+    //
+    // Filters are slow, so execute them in the background while indexing
+    // other files.
+    //
+    if ( verbosity > 3 )
+      cout << " (filtering)\n";
+    filter_file(
+      orig_file_name, dir_index, orig_stat, i, std::move( filter_list )
+    );
+    return;
+  }
+#endif /* MULTI_THREADED */
+#endif /* SWISHXX_INDEX */
+
   //
   // Execute the filter(s) on the file.
   //
-  for ( auto const &f : filter_list ) {
-    if ( !( file_name = f.exec() ) ) {
-      if ( verbosity > 3 )
-        cout << " (skipped: could not filter)\n";
-      return;
-    }
-  } // for
+  static vector<char> filter_output;    // reused for every file
+  if ( !exec_filters( filter_list, file_name, filter_output ) ) {
+    if ( verbosity > 3 )
+      cout << " (skipped: " << filter_failure( errno ) << ")\n";
+    return;
+  }
 
   //
   // We can (finally!) open the (possibly post-filtered) file.
   //
-  mmap_file const file( file_name );
+  mmap_file const file = file_name ?
+    mmap_file( file_name ) :
+    mmap_file( filter_output.data(), filter_output.size() );
   if ( !file ) {
     if ( verbosity > 3 )
       cout << " (skipped: can not open)\n";
@@ -229,35 +525,9 @@ void do_file( char const *file_name ) {
       cout << "  " << orig_base_name << flush;
 
 #ifdef SWISHXX_INDEX
-  if ( file.empty() ) {
-    //
-    // Don't waste a file_info entry on it.
-    //
-    if ( verbosity > 2 )
-      cout << " (0 words)\n";
-    return;
-  }
-
   ////////// Index the file /////////////////////////////////////////////////
 
-#ifdef WITH_DECODING
-  encoded_char_range::decoder::reset_all();
-#endif /* WITH_DECODING */
-  indexer *const i = found_pattern ?
-    include_pattern->second : indexer::text_indexer();
-  file_info *const fi = new file_info(
-    orig_file_name, dir_index, orig_file_size, i->find_title( file )
-  );
-#ifdef WITH_WORD_POS
-  word_pos = 0;
-#endif /* WITH_WORD_POS */
-  i->index_file( file );
-
-  if ( verbosity > 2 )
-    cout << " (" << fi->num_words() << " words)\n";
-
-  if ( words.size() >= word_threshold )
-    write_partial_index();
+  index_mapped_file( orig_file_name, dir_index, orig_stat, i, file );
 #endif /* SWISHXX_INDEX */
 
 #ifdef SWISHXX_EXTRACT
@@ -29,21 +29,10 @@
 #include <cctype>
 #include <cstddef>
 
-encoded_char_range::decoder::set_type encoded_char_range::decoder::decoders_;
-
 ///////////////////////////////////////////////////////////////////////////////
 
-encoded_char_range::decoder::~decoder() {
-  // do nothing
-}
-
-void encoded_char_range::decoder::reset_all() {
-  for ( auto &d : decoders_ )
-    d->reset();
-}
-
 char* to_lower( encoded_char_range const &range ) {
-  extern PJL::char_buffer_pool<128,5> lower_buf;
+  extern thread_local PJL::char_buffer_pool<128,5> lower_buf;
   char *p = lower_buf.next();
   for ( auto c = range.begin(); !c.at_end(); ++c )
     *p++ = to_lower( *c );
@@ -29,7 +29,6 @@
 // standard
 #include <cstddef>
 #include <limits>
-#include <unordered_set>
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -44,6 +43,10 @@
  * every single character examined.  Hence, the code is #ifdef'd for \c
  * WITH_DECODING: if it's not defined, there's no need for any special
  * decoding.
+ *
+ * Decoders that need to keep state between calls keep it in a decoder_state
+ * that's associated with the range rather than in static variables so that
+ * different files can be decoded simultaneously.
  */
 class encoded_char_range {
 public:
@@ -51,12 +54,27 @@ public:
   using value_type = char;
   using const_pointer = value_type const*;
   class const_iterator;
+#ifdef WITH_DECODING
+  struct decoder_state;
+#else
+  using decoder_state = void;
+#endif /* WITH_DECODING */
+
+  using charset_type = value_type (*)(
+    const_pointer, const_pointer&, const_pointer, decoder_state*
+  );
 
-  using charset_type =
-    value_type (*)(const_pointer, const_pointer&, const_pointer);
+  using encoding_type = value_type (*)(
+    const_pointer, const_pointer&, const_pointer, decoder_state*
+  );
 
-  using encoding_type =
-    value_type (*)(const_pointer, const_pointer&, const_pointer);
+  /**
+   * Either a charset_type or an encoding_type since they're the same.
+   */
+  using decoder_type = charset_type;
+
+  template<decoder_type Decoder>
+  class fixed_iterator;
 
   /**
    * Constructs an %encoded_char_range.
@@ -66,10 +84,13 @@ public:
    * @param charset A pointer to the character set transcoder function, if any.
    * @param encoding A pointer to the character encoding decoder function, if
    * any.
+   * @param state The state for \a charset or \a encoding to use.  It may be
+   * null only if neither needs state.
    */
   encoded_char_range( const_pointer begin, const_pointer end,
                       charset_type charset = nullptr,
-                      encoding_type encoding = nullptr );
+                      encoding_type encoding = nullptr,
+                      decoder_state *state = nullptr );
 
   /**
    * Constructs an %encoded_char_range.
@@ -98,6 +119,30 @@ public:
   void            end_pos( const_pointer p )      { end_ = p; }
   void            end_pos( const_iterator const& );
 
+  /**
+   * Gets the function used to decode the characters in this range: the
+   * encoding, if any, since it takes precedence; otherwise the character set.
+   *
+   * @return Returns said function or null if none.
+   */
+  decoder_type decoder() const {
+#ifdef WITH_DECODING
+    return encoding_ ? encoding_ : charset_;
+#else
+    return nullptr;
+#endif /* WITH_DECODING */
+  }
+
+  /**
+   * Gets whether the characters in this range need decoding, i.e., whether
+   * the range has either a character set or an encoding.
+   *
+   * @return Returns \c true only if they do.
+   */
+  bool needs_decoding() const {
+    return decoder() != nullptr;
+  }
+
   /**
    * Gets whether this iterator has been associated with an actual range.
    *
@@ -107,10 +152,6 @@ public:
     return begin_ != nullptr;
   }
 
-#ifdef WITH_DECODING
-  class decoder;
-#endif /* WITH_DECODING */
-
 protected:
   encoded_char_range();
 
@@ -119,6 +160,7 @@ protected:
 #ifdef WITH_DECODING
   charset_type  charset_;
   encoding_type encoding_;
+  decoder_state *state_;
 #endif /* WITH_DECODING */
   friend class const_iterator;
 };
@@ -140,7 +182,8 @@ public:
 
   const_iterator();
   const_iterator( const_pointer begin, const_pointer end,
-                  charset_type = nullptr, encoding_type = nullptr );
+                  charset_type = nullptr, encoding_type = nullptr,
+                  decoder_state* = nullptr );
 
   const_iterator( const_iterator const& ) = default;
   const_iterator& operator=( const_iterator const& ) = default;
@@ -185,6 +228,9 @@ private:
   const_iterator( encoded_char_range const*, const_pointer start_pos );
   friend class encoded_char_range;      // for access to c'tor above
 
+  template<decoder_type>
+  friend class encoded_char_range::fixed_iterator;
+
 #ifdef WITH_DECODING
   void decode() const;
 #endif /* WITH_DECODING */
@@ -192,31 +238,159 @@ private:
 
 ///////////////////////////////////////////////////////////////////////////////
 
-#ifdef WITH_DECODING
 /**
- * An %encoded_char_range::decoder is used to keep decoders' state between
- * calls and reset state between files to their initial states just before
- * starting to index a file.
+ * An %encoded_char_range::fixed_iterator is like a const_iterator except that
+ * the function used to decode characters, if any, is fixed at compile-time.
+ * A loop over characters that's a template on its iterator type can be
+ * instantiated for every decoder and the right one selected once per range
+ * (see dispatch_decoder()) rather than once per character.  For no decoder,
+ * it's just a pointer.
+ *
+ * It can be converted to and from a const_iterator to call functions that
+ * take one.
+ *
+ * @tparam Decoder The encoding or character set decoder or null for none.
  */
-class encoded_char_range::decoder {
+template<encoded_char_range::decoder_type Decoder>
+class encoded_char_range::fixed_iterator {
 public:
   using value_type = encoded_char_range::value_type;
   using const_pointer = encoded_char_range::const_pointer;
 
-  virtual ~decoder();
+  /**
+   * Constructs a %fixed_iterator positioned at the beginning of a range.
+   *
+   * @param e The range to iterate over.  Its decoder must be \a Decoder.
+   */
+  explicit fixed_iterator( encoded_char_range const &e ) :
+    begin_( e.begin_ ), end_( e.end_ ), pos_( e.begin_ ), prev_( nullptr )
+#ifdef WITH_DECODING
+    , state_( e.state_ )
+#endif /* WITH_DECODING */
+  {
+  }
+
+  value_type operator*() const {
+    if constexpr ( Decoder == nullptr ) {
+      return iso8859_1_to_ascii( *pos_ );
+    } else {
+      decode();
+      return ch_;
+    }
+  }
 
-  static void reset_all();
+  fixed_iterator& operator++() {
+    prev_ = pos_;
+    if constexpr ( Decoder == nullptr ) {
+      ++pos_;
+    } else {
+      decode();
+      pos_ = next_;
+      next_ = nullptr;
+    }
+    return *this;
+  }
 
-protected:
-  decoder() {
-    decoders_.insert( this );
+  fixed_iterator operator++(int) {
+    fixed_iterator const temp = *this;
+    return ++*this, temp;
+  }
+
+  bool at_end() const {
+    return pos_ == end_;
   }
 
-  virtual void reset() = 0;
+  /**
+   * Performs a dereference but only if it's not at the end.
+   *
+   * @return Returns the decoded character or \c NUL if at the end.
+   */
+  value_type safe_deref() const {
+    return at_end() ? '\0' : operator*();
+  }
+
+  const_pointer pos() const       { return pos_; }
+  const_pointer prev_pos() const  { return prev_; }
+  const_pointer end_pos() const   { return end_; }
+
+  /**
+   * Converts this %fixed_iterator to a const_iterator at the same position.
+   */
+  explicit operator const_iterator() const {
+#ifdef WITH_DECODING
+    const_iterator i( begin_, end_, nullptr, Decoder, state_ );
+#else
+    const_iterator i( begin_, end_ );
+#endif /* WITH_DECODING */
+    i.pos_ = pos_;
+    i.prev_ = prev_;
+    return i;
+  }
+
+  /**
+   * Repositions this %fixed_iterator to the position of a const_iterator over
+   * the same range.
+   *
+   * @param i The const_iterator.
+   * @return Returns \c *this.
+   */
+  fixed_iterator& operator=( const_iterator const &i ) {
+    pos_ = i.pos_;
+    prev_ = i.prev_;
+    next_ = nullptr;
+    return *this;
+  }
 
 private:
-  using set_type = std::unordered_set<decoder*>;
-  static set_type decoders_;
+  const_pointer         begin_, end_;
+  const_pointer         pos_, prev_;
+#ifdef WITH_DECODING
+  decoder_state        *state_;
+#endif /* WITH_DECODING */
+  mutable value_type    ch_;
+  mutable const_pointer next_ = nullptr;  // null if not decoded yet
+
+  /**
+   * Decodes the character at the current position, if not decoded already.
+   */
+  void decode() const {
+#ifdef WITH_DECODING
+    if ( !next_ ) {
+      const_pointer c = pos_;
+      ch_ = (*Decoder)( begin_, c, end_, state_ );
+      next_ = c;
+    }
+#endif /* WITH_DECODING */
+  }
+};
+
+#ifdef WITH_DECODING
+/**
+ * An %encoded_char_range::decoder_state holds the state that decoders keep
+ * between calls while decoding a file.  It must be reset before decoding
+ * ranges of another file.
+ */
+struct encoded_char_range::decoder_state {
+  /**
+   * A %group holds the characters decoded from a group of encoded characters
+   * (e.g., 3 characters from 4 Base64 characters) so each can be returned
+   * without decoding the group again.
+   */
+  struct group {
+    const_pointer prev_c = nullptr;     // start of the group's characters
+    unsigned      count = 0;            // number of decoded characters
+    value_type    buf[ 3 ];
+  };
+
+  group base64;
+  group utf7;
+
+  /**
+   * Resets the state to its initial state.
+   */
+  void reset() {
+    *this = decoder_state{};
+  }
 };
 #endif /* WITH_DECODING */
 
@@ -232,14 +406,17 @@ inline ECR::ECR() {
 #if WITH_DECODING
   charset_ = nullptr;
   encoding_ = nullptr;
+  state_ = nullptr;
 #endif /* WITH_DECODING */
 }
 
-inline ECR::ECR( const_pointer begin, const_pointer end, charset_type charset,
-                 encoding_type encoding ) :
+inline ECR::ECR( const_pointer begin, const_pointer end,
+                 [[maybe_unused]] charset_type charset,
+                 [[maybe_unused]] encoding_type encoding,
+                 [[maybe_unused]] decoder_state *state ) :
   begin_( begin ), end_( end )
 #ifdef WITH_DECODING
-  , charset_( charset ), encoding_( encoding )
+  , charset_( charset ), encoding_( encoding ), state_( state )
 #endif /* WITH_DECODING */
 {
 }
@@ -247,7 +424,7 @@ inline ECR::ECR( const_pointer begin, const_pointer end, charset_type charset,
 inline ECR::ECR( const_iterator const &i ) :
   begin_( i.pos_ ), end_( i.end_ )
 #ifdef WITH_DECODING
-  , charset_( i.charset_ ), encoding_( i.encoding_ )
+  , charset_( i.charset_ ), encoding_( i.encoding_ ), state_( i.state_ )
 #endif /* WITH_DECODING */
 {
 }
@@ -255,7 +432,8 @@ inline ECR::ECR( const_iterator const &i ) :
 inline ECR::ECR( const_iterator const &begin, const_iterator const &end ) :
   begin_( begin.pos_ ), end_( end.pos_ )
 #ifdef WITH_DECODING
-  , charset_( begin.charset_ ), encoding_( begin.encoding_ )
+  , charset_( begin.charset_ ), encoding_( begin.encoding_ ),
+  state_( begin.state_ )
 #endif /* WITH_DECODING */
 {
 }
@@ -282,8 +460,9 @@ inline ECR_CI::const_iterator() : pos_( nullptr ) {
 }
 
 inline ECR_CI::const_iterator( const_pointer begin, const_pointer end,
-                               charset_type charset, encoding_type encoding ) :
-  encoded_char_range( begin, end, charset, encoding ), pos_( begin )
+                               charset_type charset, encoding_type encoding,
+                               decoder_state *state ) :
+  encoded_char_range( begin, end, charset, encoding, state ), pos_( begin )
 #ifdef WITH_DECODING
   , decoded_( false )
 #endif /* WITH_DECODING */
@@ -294,7 +473,7 @@ inline ECR_CI::const_iterator( ECR const *ecr, const_pointer start_pos ) :
   encoded_char_range(
     start_pos, ecr->end_
 #ifdef WITH_DECODING
-    , ecr->charset_, ecr->encoding_
+    , ecr->charset_, ecr->encoding_, ecr->state_
 #endif /* WITH_DECODING */
   ),
   pos_( start_pos )
@@ -332,9 +511,9 @@ inline void ECR_CI::decode() const {
   // If it does, the encoding takes precedence.
   //
   if ( encoding_ )
-    ch_ = (*encoding_)( begin_, c, end_ );
+    ch_ = (*encoding_)( begin_, c, end_, state_ );
   else if ( charset_ )
-    ch_ = (*charset_)( begin_, c, end_ );
+    ch_ = (*charset_)( begin_, c, end_, state_ );
   else
     ch_ = iso8859_1_to_ascii( *c++ );
   delta_ = c - pos_;
@@ -0,0 +1,81 @@
+/*
+**      SWISH++
+**      src/encoded_char_dispatch.h
+**
+**      Copyright (C) 2026  Paul J. Lucas
+**
+**      This program is free software; you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation; either version 2 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program; if not, write to the Free Software
+**      Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#ifndef encoded_char_dispatch_H
+#define encoded_char_dispatch_H
+
+// local
+#include "config.h"
+#include "charsets/charsets.h"
+#include "encoded_char.h"
+#include "encodings/encodings.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Calls a function with an iterator positioned at the beginning of an
+ * encoded_char_range.  If the range's decoder is one of the built-in
+ * encodings or character sets (or none), the iterator is a
+ * %encoded_char_range::fixed_iterator for it so that a loop over characters
+ * in \a f that's a template on its iterator type is instantiated for that
+ * decoder; otherwise it's an ordinary %encoded_char_range::const_iterator.
+ *
+ * @tparam Func The type of the function: it must have an overloaded or
+ * template function call operator that takes any of the iterator types.
+ * @param e The encoded_char_range to iterate over.
+ * @param f The function to call.
+ */
+template<typename Func>
+void dispatch_decoder( encoded_char_range const &e, Func &&f ) {
+  using ECR = encoded_char_range;
+  auto const decoder = e.decoder();
+
+  if ( !decoder )
+    return f( ECR::fixed_iterator<nullptr>( e ) );
+#ifdef WITH_BASE64
+  if ( decoder == &encoding_base64 )
+    return f( ECR::fixed_iterator<&encoding_base64>( e ) );
+#endif /* WITH_BASE64 */
+#ifdef WITH_QUOTED_PRINTABLE
+  if ( decoder == &encoding_quoted_printable )
+    return f( ECR::fixed_iterator<&encoding_quoted_printable>( e ) );
+#endif /* WITH_QUOTED_PRINTABLE */
+#ifdef WITH_UTF7
+  if ( decoder == &charset_utf7 )
+    return f( ECR::fixed_iterator<&charset_utf7>( e ) );
+#endif /* WITH_UTF7 */
+#ifdef WITH_UTF8
+  if ( decoder == &charset_utf8 )
+    return f( ECR::fixed_iterator<&charset_utf8>( e ) );
+#endif /* WITH_UTF8 */
+#ifdef WITH_UTF16
+  if ( decoder == &charset_utf16be )
+    return f( ECR::fixed_iterator<&charset_utf16be>( e ) );
+  if ( decoder == &charset_utf16le )
+    return f( ECR::fixed_iterator<&charset_utf16le>( e ) );
+#endif /* WITH_UTF16 */
+  f( e.begin() );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif /* encoded_char_dispatch_H */
+/* vim:set et sw=2 ts=2: */
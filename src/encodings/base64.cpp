@@ -26,50 +26,271 @@
 
 // standard
 #include <cctype>
+#include <cstdint>
 #include <cstring>
+#ifdef __SSE2__
+#include <bit>                          /* for byteswap(), countr_one() */
+#include <emmintrin.h>
+#endif /* __SSE2__ */
 
 using namespace std;
 
-///////////////////////////////////////////////////////////////////////////////
+/**
+ * The number of bits encoded by a single Base64 character.
+ */
+int const Bits_Per_Char = 6;
 
-namespace {
+/**
+ * A table of the 6-bit values of the characters of the Base64 alphabet
+ * indexed by character; other characters map to -1.
+ */
+static constexpr auto const Base64_Value = []() {
+  struct { signed char value[ 256 ]; } t{};
+  constexpr char alphabet[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  for ( auto &v : t.value )
+    v = -1;
+  for ( int i = 0; alphabet[i]; ++i )
+    t.value[ static_cast<unsigned char>( alphabet[i] ) ] = i;
+  return t;
+}();
 
-  class base64_decoder : public encoded_char_range::decoder {
-  public:
-    const_pointer prev_c_;
+/**
+ * Gets the 6-bit value of a Base64 character.
+ *
+ * @param c The character.
+ * @return Returns said value or -1 if \a c isn't in the Base64 alphabet.
+ */
+inline int base64_value( char c ) {
+  return Base64_Value.value[ static_cast<unsigned char>( c ) ];
+}
 
-  private:
-    virtual void reset();
-  };
+/**
+ * Outputs the whole 8-bit characters of a group-of-4.  A partial group ends
+ * early either because of padding or the end of the text: 2 Base64 characters
+ * encode 1 character and 3 encode 2.
+ *
+ * @param value The combined value of the encoded 6-bit characters.
+ * @param n The number of encoded characters in the group.
+ * @param buf The buffer to output into.  It is left after the last character.
+ */
+inline void flush_group( unsigned value, int n, char *&buf ) {
+  if ( n == 4 ) {
+    *buf++ = static_cast<char>( value >> 16 );
+    *buf++ = static_cast<char>( value >> 8 );
+    *buf++ = static_cast<char>( value );
+    return;
+  }
+  if ( n == 2 ) {
+    *buf++ = static_cast<char>( value >> 4 );
+  } else if ( n == 3 ) {
+    *buf++ = static_cast<char>( value >> 10 );
+    *buf++ = static_cast<char>( value >> 2 );
+  }
+}
+
+#ifdef __SSE2__
+/**
+ * Checks whether each of the characters in a vector is in the range [lo,hi].
+ * Characters having the high bit set are never in range.
+ *
+ * @param v The vector of characters.
+ * @param lo The lowest character in the range.
+ * @param hi The highest character in the range.
+ * @return Returns a vector having each character set to all 1 bits only if
+ * the corresponding character is in range.
+ */
+inline __m128i in_range( __m128i v, char lo, char hi ) {
+  return _mm_and_si128( _mm_cmpgt_epi8( v, _mm_set1_epi8( lo - 1 ) ),
+                        _mm_cmpgt_epi8( _mm_set1_epi8( hi + 1 ), v ) );
+}
 
-  void base64_decoder::reset() {
-    prev_c_ = 0;
+/**
+ * Decodes up to 16 Base64 characters into 12 at once: only the whole groups-
+ * of-4 before the first character not in the Base64 alphabet (e.g., padding or
+ * a newline) are decoded.  If there are none, characters that are to be
+ * ignored (e.g., a newline) are skipped instead.  SSE2 has no byte shuffle, so
+ * the 6-bit values are combined within each 32-bit lane and each lane's 3
+ * characters are output from there.
+ *
+ * @param c A pointer to the 16 characters.
+ * @param buf The buffer to output into.  It is left after the last character.
+ * @return Returns the number of characters either decoded or skipped.
+ */
+static int decode_16( char const *c, char *&buf ) {
+  __m128i const v = _mm_loadu_si128( reinterpret_cast<__m128i const*>( c ) );
+  __m128i const upper = in_range( v, 'A', 'Z' );
+  __m128i const lower = in_range( v, 'a', 'z' );
+  __m128i const digit = in_range( v, '0', '9' );
+  __m128i const plus  = _mm_cmpeq_epi8( v, _mm_set1_epi8( '+' ) );
+  __m128i const slash = _mm_cmpeq_epi8( v, _mm_set1_epi8( '/' ) );
+
+  __m128i const valid = _mm_or_si128(
+    _mm_or_si128( upper, lower ),
+    _mm_or_si128( digit, _mm_or_si128( plus, slash ) )
+  );
+  //
+  // Checking for all 16 being in the alphabet first keeps the common case from
+  // depending on counting them so the next 16 can be loaded sooner.
+  //
+  unsigned const valid_mask = _mm_movemask_epi8( valid );
+  int const groups_n = valid_mask == 0xFFFF ? 4 : countr_one( valid_mask ) / 4;
+  if ( !groups_n ) {
+    //
+    // From RFC 2045, section 6.8:
+    //
+    //    Any characters outside of the base64 alphabet are to be ignored in
+    //    base64-encoded data.
+    //
+    // Skip them so a line break doesn't go through the slower paths, but not
+    // padding or a partial group since those need them.
+    //
+    unsigned const pad_mask =
+      _mm_movemask_epi8( _mm_cmpeq_epi8( v, _mm_set1_epi8( '=' ) ) );
+    return countr_one( ~(valid_mask | pad_mask) & 0xFFFFu );
   }
 
-} // namespace
+  //
+  // Each range of the alphabet is contiguous, so a character's 6-bit value is
+  // the character plus an offset per range.
+  //
+  __m128i const offset = _mm_or_si128(
+    _mm_or_si128(
+      _mm_and_si128( upper, _mm_set1_epi8( 0 - 'A' ) ),
+      _mm_and_si128( lower, _mm_set1_epi8( 26 - 'a' ) )
+    ),
+    _mm_or_si128(
+      _mm_and_si128( digit, _mm_set1_epi8( 52 - '0' ) ),
+      _mm_or_si128( _mm_and_si128( plus,  _mm_set1_epi8( 62 - '+' ) ),
+                    _mm_and_si128( slash, _mm_set1_epi8( 63 - '/' ) ) )
+    )
+  );
+  __m128i const values = _mm_add_epi8( v, offset );
+
+  //
+  // Combine pairs of 6-bit values into 12-bit values in each 16-bit lane, then
+  // pairs of those into 24-bit values in each 32-bit lane.
+  //
+  __m128i const pairs = _mm_or_si128(
+    _mm_slli_epi16( _mm_and_si128( values, _mm_set1_epi16( 0x00FF ) ), 6 ),
+    _mm_srli_epi16( values, 8 )
+  );
+  __m128i const groups = _mm_or_si128(
+    _mm_slli_epi32( _mm_and_si128( pairs, _mm_set1_epi32( 0xFFFF ) ), 12 ),
+    _mm_srli_epi32( pairs, 16 )
+  );
+
+  //
+  // Output each group's 3 characters by storing all 4 bytes of it byte-swapped
+  // so they're in order: the 4th is overwritten by the next group's or is past
+  // the end.  This is safe since the buffer is at least as long as the encoded
+  // text and 16 encoded characters decode to only 12.
+  //
+  uint32_t group[4];
+  _mm_storeu_si128( reinterpret_cast<__m128i*>( group ), groups );
+  char *out = buf;
+  for ( int i = 0; i < groups_n; ++i, out += 3 ) {
+    uint32_t const bytes = byteswap( group[i] << 8 );
+    ::memcpy( out, &bytes, sizeof bytes );
+  } // for
+  buf = out;
+  return groups_n * 4;
+}
+#endif /* __SSE2__ */
 
 ///////////////////////////////////////////////////////////////////////////////
 
+char* decode_base64( char const *begin, char const *end, char *buf ) {
+  unsigned value = 0;                   // combined value of the group so far
+  int n = 0;                            // number of characters in the group
+
+  for ( char const *c = begin; c != end; ) {
+#ifdef __SSE2__
+    if ( n == 0 && end - c >= 16 ) {
+      //
+      // Advance by a constant in the common cases rather than by the number of
+      // characters used so the CPU can predict where the next 16 are rather
+      // than wait for decode_16() to count them.
+      //
+      int const used_n = decode_16( c, buf );
+      if ( used_n == 16 )
+        c += 16;
+      else if ( used_n == 12 )          // end of a line of 76
+        c += 12;
+      else if ( used_n == 2 )           // CR-LF
+        c += 2;
+      else
+        c += used_n;
+      if ( used_n )
+        continue;
+    }
+#endif /* __SSE2__ */
+    if ( n == 0 && end - c >= 4 ) {
+      //
+      // Fast path: decode an entire group-of-4 at once as long as none of its
+      // characters is either padding or not in the alphabet.
+      //
+      int const v0 = base64_value( c[0] ), v1 = base64_value( c[1] ),
+                v2 = base64_value( c[2] ), v3 = base64_value( c[3] );
+      if ( (v0 | v1 | v2 | v3) >= 0 ) {
+        flush_group( v0 << 18 | v1 << 12 | v2 << 6 | v3, 4, buf );
+        c += 4;
+        continue;
+      }
+    }
+
+    if ( char const ch = *c++; ch == '=' ) {
+      //
+      // Padding: the group ends early.
+      //
+      flush_group( value, n, buf );
+      value = 0;
+      n = 0;
+    } else if ( int const v = base64_value( ch ); v >= 0 ) {
+      value = value << Bits_Per_Char | v;
+      if ( ++n == 4 ) {
+        flush_group( value, n, buf );
+        value = 0;
+        n = 0;
+      }
+    } else {
+      //
+      // From RFC 2045, section 6.8:
+      //
+      //    Any characters outside of the base64 alphabet are to be ignored in
+      //    base64-encoded data.
+      //
+      /* do nothing */;
+    }
+  } // for
+
+  //
+  // The text may have ended in the middle of a group without padding: decode
+  // what we can anyway.
+  //
+  flush_group( value, n, buf );
+  return buf;
+}
+
 encoded_char_range::value_type
 encoding_base64( encoded_char_range::const_pointer begin,
                  encoded_char_range::const_pointer &c,
-                 encoded_char_range::const_pointer end ) {
+                 encoded_char_range::const_pointer end,
+                 encoded_char_range::decoder_state *state ) {
   using difference_type = encoded_char_range::difference_type;
 
   //
   // This code is based on the decode_base64() function as part of "encdec 1.1"
   // by Jörgen Hägg <jh@efd.lth.se>, 1993.
   //
-  int const Bits_Per_Char = 6;          // by definition of Base64 encoding
-
-  static encoded_char_range::value_type buf[ 3 ]; // group-of-4 -> 3 chars
-  static base64_decoder decoder;
+  auto &decoder = state->base64;
+  auto &buf = decoder.buf;              // group-of-4 -> 3 chars
 
   //
   // See if the pointer is less than a buffer's-worth away from the previous
   // pointer: if so, simply return the already-decoded character.
   //
-  difference_type delta = c - decoder.prev_c_;
+  difference_type delta = c - decoder.prev_c;
   if ( delta >= 0 && delta < static_cast<difference_type>( sizeof buf ) ) {
     //
     // We advance the pointer 1 position for the first 2 characters but 2
@@ -177,7 +398,7 @@ reached_end:
   // subsequently are asked to decode a character in the range [i,i+3), we can
   // simply return the character.
   //
-  decoder.prev_c_ = c;
+  decoder.prev_c = c;
   delta -= delta4;
   goto return_decoded_char;
 }
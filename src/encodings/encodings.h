@@ -42,11 +42,8 @@ encoded_char_range::encoding_type const Binary =
  * characters have to be able to be decoded with random access, i.e., wherever
  * the pointer is positioned.
  *
- * An approach other than the one implemented here would have been to decode
- * the entire range into a buffer in one shot, but this could use a lot of
- * memory if the range is large (and the indexer already uses lots of memory).
- * Additionally, mapping the iterator position from encoded space to decoded
- * space would have been tricky and just as much of a pain.
+ * When an entire range is to be decoded front to back, decode_base64() is much
+ * faster.
  *
  * Anywhere a space is returned it's because we've encountered an error
  * condition and the function has to return "something" and a space is
@@ -56,6 +53,7 @@ encoded_char_range::encoding_type const Binary =
  * @param c A pointer marking the position of the character to decode.  It is
  * left after the decoded character.
  * @param end A pointer marking the end of the entire encoded range.
+ * @param state The decoders' state for the file.  It must not be null.
  * @return Returns the decoded character or ' ' upon error.
  *
  * @sa Ned Freed and Nathaniel S. Borenstein.  "RFC 2045: Multipurpose Internet
@@ -66,8 +64,24 @@ encoded_char_range::encoding_type const Binary =
 encoded_char_range::value_type encoding_base64(
   encoded_char_range::const_pointer begin,
   encoded_char_range::const_pointer &pos,
-  encoded_char_range::const_pointer end
+  encoded_char_range::const_pointer end,
+  encoded_char_range::decoder_state *state
 );
+
+/**
+ * Decodes an entire range of base64-encoded text in one shot.  Characters
+ * outside of the Base64 alphabet (e.g., newlines) are ignored as required by
+ * RFC 2045.
+ *
+ * @param begin A pointer marking the beginning of the encoded range.
+ * @param end A pointer marking the end of the encoded range.
+ * @param buf The buffer to decode into.  It must be at least \a end - \a begin
+ * bytes.
+ * @return Returns a pointer to one past the last decoded byte in \a buf.
+ *
+ * @sa encoding_base64()
+ */
+char* decode_base64( char const *begin, char const *end, char *buf );
 #endif /* WITH_BASE64 */
 
 #ifdef WITH_QUOTED_PRINTABLE
@@ -84,6 +98,7 @@ encoded_char_range::value_type encoding_base64(
  * @param c A pointer marking the position of the character to decode.  It is
  * left after the decoded character.
  * @param end A pointer marking the end of the entire encoded range.
+ * @param state Not used.
  * @return Returns the decoded character or ' ' upon error.
  *
  * @sa Ned Freed and Nathaniel S. Borenstein.  "RFC 2045: Multipurpose Internet
@@ -94,8 +109,22 @@ encoded_char_range::value_type encoding_base64(
 encoded_char_range::value_type encoding_quoted_printable(
   encoded_char_range::const_pointer begin,
   encoded_char_range::const_pointer &pos,
-  encoded_char_range::const_pointer end
+  encoded_char_range::const_pointer end,
+  encoded_char_range::decoder_state *state
 );
+
+/**
+ * Decodes an entire range of quoted-printable text in one shot.  The result is
+ * the same as calling encoding_quoted_printable() repeatedly, but runs of
+ * characters that don't need decoding are copied as-is.
+ *
+ * @param begin A pointer marking the beginning of the encoded range.
+ * @param end A pointer marking the end of the encoded range.
+ * @param buf The buffer to decode into.  It must be at least \a end - \a begin
+ * bytes.
+ * @return Returns a pointer to one past the last decoded byte in \a buf.
+ */
+char* decode_quoted_printable( char const *begin, char const *end, char *buf );
 #endif /* WITH_QUOTED_PRINTABLE */
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -25,6 +25,7 @@
 
 // standard
 #include <cctype>
+#include <cstring>
 
 using namespace std;
 
@@ -33,7 +34,8 @@ using namespace std;
 encoded_char_range::value_type
 encoding_quoted_printable( encoded_char_range::const_pointer,
                            encoded_char_range::const_pointer &c,
-                           encoded_char_range::const_pointer end ) {
+                           encoded_char_range::const_pointer end,
+                           encoded_char_range::decoder_state* ) {
   //
   // Check to see if the character at the current position is an '=': if not,
   // the character is an ordinary character; if so, the character is a quoted-
@@ -107,5 +109,21 @@ encoding_quoted_printable( encoded_char_range::const_pointer,
   );
 }
 
+char* decode_quoted_printable( char const *begin, char const *end,
+                               char *buf ) {
+  for ( char const *c = begin; c != end; ) {
+    //
+    // Copy the run of characters up to the next '=' (if any) as-is.
+    //
+    auto const eq = static_cast<char const*>( ::memchr( c, '=', end - c ) );
+    char const *const run_end = eq ? eq : end;
+    ::memcpy( buf, c, run_end - c );
+    buf += run_end - c;
+    if ( (c = run_end) != end )
+      *buf++ = encoding_quoted_printable( begin, c, end, nullptr );
+  } // for
+  return buf;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 /* vim:set et sw=2 ts=2: */
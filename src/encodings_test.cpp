@@ -0,0 +1,144 @@
+/*
+**      SWISH++
+**      src/encodings_test.cpp
+**
+**      Copyright (C) 2026  Paul J. Lucas
+**
+**      This program is free software; you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation; either version 2 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program; if not, write to the Free Software
+**      Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+//
+// Checks that decode_base64() and decode_quoted_printable() decode entire
+// multi-line MIME parts correctly.  It's run by "make check" and exits with a
+// non-zero status if any check fails.
+//
+
+// local
+#include "config.h"
+#include "encodings/encodings.h"
+
+// standard
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+static int failures;
+
+/**
+ * Checks that a decoder decodes some text as expected.
+ *
+ * @param what The name of the decoder.
+ * @param decode The decoder.
+ * @param encoded The encoded text.
+ * @param expected The expected decoded text.
+ */
+static void check( char const *what,
+                   char* (*decode)( char const*, char const*, char* ),
+                   string const &encoded, string const &expected ) {
+  string decoded( encoded.size(), '\0' );
+  char const *const begin = encoded.data();
+  decoded.resize(
+    decode( begin, begin + encoded.size(), &decoded[0] ) - decoded.data()
+  );
+  if ( decoded != expected ) {
+    cerr << what << "(): " << encoded.size() << "-character part: decoded "
+         << decoded.size() << " characters; expected "
+         << expected.size() << " characters\n";
+    ++failures;
+  }
+}
+
+#ifdef WITH_BASE64
+/**
+ * Encodes text in Base64 the way mail software does.
+ *
+ * @param s The text to encode.
+ * @param newline The newline to end each line of 76 characters with.
+ * @return Returns the encoded text.
+ */
+static string encode_base64( string const &s, char const *newline ) {
+  static char const alphabet[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  string encoded;
+  size_t line_len = 0;
+  for ( size_t i = 0; i < s.size(); i += 3 ) {
+    unsigned value = static_cast<unsigned char>( s[i] ) << 16;
+    if ( i + 1 < s.size() )
+      value |= static_cast<unsigned char>( s[i + 1] ) << 8;
+    if ( i + 2 < s.size() )
+      value |= static_cast<unsigned char>( s[i + 2] );
+    encoded += alphabet[ value >> 18 & 63 ];
+    encoded += alphabet[ value >> 12 & 63 ];
+    encoded += i + 1 < s.size() ? alphabet[ value >> 6 & 63 ] : '=';
+    encoded += i + 2 < s.size() ? alphabet[ value & 63 ] : '=';
+    if ( (line_len += 4) == 76 ) {
+      encoded += newline;
+      line_len = 0;
+    }
+  } // for
+  return encoded + newline;
+}
+
+/**
+ * Checks decode_base64() on multi-line parts having every byte value and
+ * every amount of padding.
+ */
+static void check_base64() {
+  string text =
+    "Now is the time for all good men to come to the aid of their party.  "
+    "The quick brown fox jumps over the lazy dog.  ";
+  for ( int b = 0; b < 256; ++b )
+    text += static_cast<char>( b );
+  for ( size_t len = 0; len <= text.size(); ++len ) {
+    string const s = text.substr( 0, len );
+    for ( char const *newline : { "\r\n", "\n" } )
+      check( "decode_base64", &decode_base64, encode_base64( s, newline ), s );
+  } // for
+}
+#endif /* WITH_BASE64 */
+
+#ifdef WITH_QUOTED_PRINTABLE
+/**
+ * Checks decode_quoted_printable() on a multi-line part having soft line
+ * breaks.
+ */
+static void check_quoted_printable() {
+  check( "decode_quoted_printable", &decode_quoted_printable,
+    "This line is longer than 76 characters so it's broken by a soft line =\r\n"
+    "break; so is th=\r\n"
+    "is word, and another=\n"
+    "=3Dsign starts a line after one.\r\n"
+    "Caf=E9 and na=EFve have encoded characters.\r\n",
+    "This line is longer than 76 characters so it's broken by a soft line "
+    "break; so is this word, and another=sign starts a line after one.\r\n"
+    "Caf\xE9 and na\xEFve have encoded characters.\r\n"
+  );
+}
+#endif /* WITH_QUOTED_PRINTABLE */
+
+int main() {
+#ifdef WITH_BASE64
+  check_base64();
+#endif /* WITH_BASE64 */
+#ifdef WITH_QUOTED_PRINTABLE
+  check_quoted_printable();
+#endif /* WITH_QUOTED_PRINTABLE */
+  return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/* vim:set et sw=2 ts=2: */
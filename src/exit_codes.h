@@ -76,6 +76,7 @@ enum {
   Exit_No_Init_Thread_Mutex     = 77,
   Exit_No_User                  = 78,
   Exit_No_Group                 = 79,
+  Exit_No_Write_Slow_Log        = 80,
 #endif /* WITH_SEARCH_DAEMON */
 
   Exit_End_Enum_Marker
@@ -49,7 +49,6 @@
 #include <ctime>
 #include <iomanip>                      /* for setfill(), setw() */
 #include <iostream>
-#include <iterator>
 #include <ostream>
 #include <string>
 #include <sys/resource.h>
@@ -228,6 +227,10 @@ int main( int argc, char *argv[] ) {
     exclude_patterns.clear();
     include_patterns.clear();
   }
+  exclude_patterns.compile();
+  include_patterns.compile();
+  file_filters.compile();
+
   if ( extract_extension_arg )
     extract_extension = extract_extension_arg;
   if ( *extract_extension != '.' )      // prepend '.' if needed
@@ -247,9 +250,8 @@ int main( int argc, char *argv[] ) {
 
   stop_words = new stop_word_set( stop_word_file_name );
   if ( dump_stop_words_opt ) {
-    ::copy( stop_words->begin(), stop_words->end(),
-      ostream_iterator<char const*>( cout, "\n" )
-    );
+    for ( auto const word : stop_words->sorted() )
+      cout << word << '\n';
     ::exit( Exit_Success );
   }
 
@@ -346,13 +348,11 @@ static bool extract_word( char *word, int len, ostream &out ) {
       in_postscript = false;
     return false;
   }
-  static auto const &postscript_comments = postscript::comments();
-  if ( contains( postscript_comments, word ) ) {
+  if ( postscript::is_comment( word ) ) {
     in_postscript = true;
     return false;
   }
-  static auto const &postscript_operators = postscript::operators();
-  if ( contains( postscript_operators, word ) )
+  if ( postscript::is_operator( word ) )
     return false;
 
   ////////// Strip chars not in Word_Begin_Chars/Word_End_Chars ///////////////
@@ -384,8 +384,11 @@ static bool extract_word( char *word, int len, ostream &out ) {
 
   ////////// Stop-word checks /////////////////////////////////////////////////
 
-  if ( !is_ok_word( word ) || contains( *stop_words, to_lower( word ) ) )
+  char lower_word[ Word_Hard_Max_Size + 1 ];
+  if ( !is_ok_word_to_lower( word, len, lower_word ) ||
+       stop_words->contains( lower_word ) ) {
     return false;
+  }
 
   out << word << '\n';
   return true;
@@ -28,6 +28,7 @@
 
 // standard
 #include <cstring>
+#include <string>
 
 using namespace PJL;
 using namespace std;
@@ -40,24 +41,25 @@ FilesReserve              files_reserve;
 ///////////////////////////////////////////////////////////////////////////////
 
 file_info::file_info( char const *path_name, unsigned dir_index,
-                      size_t file_size, char const *title,
-                      unsigned num_words ) :
+                      size_t file_size, time_t mtime, ino_t inode,
+                      char const *title, unsigned num_words ) :
   dir_index_( dir_index ),
-  file_name_(
+  path_name_(
     //
-    // First duplicate the entire path name and put it into the set of files
-    // encountered; then make file_name_ point to the base name inside the same
-    // string, i.e., it shares storage.
+    // Duplicate the entire path name and put it into the set of files
+    // encountered.  The file name is the base name inside the same string,
+    // i.e., it shares storage.
     //
-    pjl_basename( *name_set_.insert( new_strdup( path_name ) ).first )
+    *name_set_.insert( new_strdup( path_name ) ).first
   ),
-  file_size_( file_size ), num_words_( num_words ),
+  file_size_( file_size ), mtime_( mtime ), inode_( inode ),
+  num_words_( num_words ),
   title_(
     //
     // If there was a title given, use that; otherwise the title is the file
     // name.  Note that it too shares storage.
     //
-    title ? new_strdup( title ) : file_name_
+    title ? new_strdup( title ) : pjl_basename( path_name_ )
   )
 {
   if ( list_.empty() )
@@ -67,15 +69,24 @@ file_info::file_info( char const *path_name, unsigned dir_index,
 
 file_info::file_info( unsigned char const *p ) :
   dir_index_( vlq::decode( p ) ),
-  file_name_( reinterpret_cast<char const*>( p ) ),
+  path_name_( reinterpret_cast<char const*>( p ) ),
   file_size_(
     vlq::decode( p += ::strlen( reinterpret_cast<char const*>( p ) ) + 1 )
   ),
+  mtime_( 0 ), inode_( 0 ),
   num_words_( vlq::decode( p ) ),
   title_( reinterpret_cast<char const*>( p ) )
 {
   // do nothing else
 }
 
+bool file_info::seen_file( char const *path_name ) {
+  if ( name_set_.find( path_name ) != name_set_.end() )
+    return true;
+  string const first_document =
+    string( path_name ) + Document_Offset_Separator + '0';
+  return name_set_.find( first_document.c_str() ) != name_set_.end();
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 /* vim:set et sw=2 ts=2: */
@@ -25,10 +25,13 @@
 // local
 #include "config.h"
 #include "pjl/hash.h"
+#include "util.h"                       /* for pjl_basename() */
 
 // standard
 #include <cstddef>                      /* for size_t */
+#include <ctime>                        /* for time_t */
 #include <vector>
+#include <sys/types.h>                  /* for ino_t */
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -44,6 +47,13 @@ public:
   using size_type = size_t;
   using name_set_type = PJL::unordered_char_ptr_set;
 
+  /**
+   * The character separating the path name of a file that contains several
+   * documents (e.g., an mbox file) from the byte offset of a document within
+   * it.  The path name of such a document is \c path#offset.
+   */
+  static constexpr char Document_Offset_Separator = '#';
+
   /**
    * Constructs a %file_info.  If a title is given, use it; otherwise set the
    * title to be (just) the file name (not the path name).
@@ -56,14 +66,18 @@ public:
    * @param path_name The full path name of the file.
    * @param dir_index The numerical index of the directory.
    * @param file_size The size of the file in bytes.
+   * @param mtime     The modification time of the file or 0 if unknown.
+   * @param inode     The i-node number of the file or 0 if unknown.
    * @param title     The title of the file only if not null.
    * @param num_words The number of words in the file.
    */
   file_info( char const *path_name, unsigned dir_index, size_t file_size,
-             char const *title, unsigned num_words = 0 );
+             time_t mtime, ino_t inode, char const *title,
+             unsigned num_words = 0 );
 
   /**
-   * Constructs a %file_info from the raw data inside an index file.
+   * Constructs a %file_info from the raw data inside an index file.  The
+   * modification time and i-node number, if any, are not read.
    *
    * @param p The pointer to the raw file_info data.
    */
@@ -74,13 +88,25 @@ public:
   }
 
   char const* file_name() const {
-    return file_name_;
+    return pjl_basename( path_name_ );
+  }
+
+  ino_t inode() const {
+    return inode_;
+  }
+
+  time_t mtime() const {
+    return mtime_;
   }
 
   unsigned num_words() const {
     return num_words_;
   }
 
+  void num_words( unsigned n ) {
+    num_words_ = n;
+  }
+
   size_type size() const {
     return file_size_;
   }
@@ -101,10 +127,6 @@ public:
     return static_cast<unsigned>( list_.size() - 1 );
   }
 
-  static void inc_words() {
-    ++list_.back()->num_words_;
-  }
-
   static file_info* ith_info( unsigned i ) {
     return list_[i];
   }
@@ -113,14 +135,31 @@ public:
     return list_.size();
   }
 
-  static bool seen_file( char const *file_name ) {
-    return name_set_.find( file_name ) != name_set_.end();
+  /**
+   * Gets the path name of the file as it was given when indexing.  (When read
+   * from an index file, this is the same as the file name.)
+   *
+   * @return Returns said path name.
+   */
+  char const* path_name() const {
+    return path_name_;
   }
 
+  /**
+   * Gets whether a file was encountered before either as a whole or, if it
+   * contains several documents, as its first document.
+   *
+   * @param path_name The full path name of the file.
+   * @return Returns \c true only if it was.
+   */
+  static bool seen_file( char const *path_name );
+
 private:
   unsigned const        dir_index_;
-  char const *const     file_name_;
+  char const *const     path_name_;
   size_type const       file_size_;
+  time_t const          mtime_;
+  ino_t const           inode_;
   unsigned              num_words_;
   char const *const     title_;
 
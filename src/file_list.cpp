@@ -55,6 +55,7 @@ file_list::size_type file_list::calc_size() const {
       //
       switch ( *p++ ) {                 // skip marker
         case Stop_Marker:
+          bytes_ = p - ptr_;
           return size_;
         case Word_Entry_Continues_Marker:
           more_lists = false;
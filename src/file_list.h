@@ -28,7 +28,7 @@
 #include "word_info.h"
 
 // standard
-#include <cstddef>                  /* for ptrdiff_t */
+#include <cstddef>                  /* for ptrdiff_t, size_t */
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -50,8 +50,19 @@ public:
   ////////// constructors /////////////////////////////////////////////////////
 
   file_list( index_segment::const_iterator const &iter ) :
-    ptr_{ reinterpret_cast<byte const*>( *iter ) },
-    size_{ -1 }                         // -1 = "haven't computed yet"
+    file_list( *iter )
+  {
+  }
+
+  /**
+   * Constructs a %file_list from a word entry.
+   *
+   * @param entry A pointer to the word that is followed by its file list.
+   */
+  explicit file_list( char const *entry ) :
+    ptr_{ reinterpret_cast<byte const*>( entry ) },
+    size_{ -1 },                        // -1 = "haven't computed yet"
+    bytes_{ 0 }
   {
     while ( *ptr_++ ) ;                 // skip past word
   }
@@ -100,13 +111,23 @@ public:
   const_iterator  end() const         { return const_iterator( nullptr ); }
   size_type       size() const;
 
+  /**
+   * Gets the number of bytes the file list occupies in the index.
+   *
+   * @return Returns said number of bytes.
+   */
+  size_t bytes() const {
+    return size(), bytes_;
+  }
+
 private:
   byte const       *ptr_;
   mutable size_type size_;
+  mutable size_t    bytes_;
 
   /**
    * Calculates the size of the file list (the number of files the word is in)
-   * and caches the result.
+   * and its size in bytes and caches the results.
    *
    * @return Returns said size.
    */
@@ -27,13 +27,37 @@
 
 // standard
 #include <cassert>
+#include <cerrno>
 #include <cstdlib>                      /* for system(3) */
 #include <cstring>
+#include <fcntl.h>                      /* for O_* */
+#include <csignal>                      /* for signal(3) */
+#include <fstream>
 #include <string>
-#include <unistd.h>                     /* for sleep(3) */
+#include <sys/wait.h>                   /* for waitpid(2) */
+#include <unistd.h>                     /* for pipe(2), read(2), sleep(3) */
+#ifdef HAVE_POSIX_SPAWNP
+#include <poll.h>
+#include <spawn.h>
+#endif /* HAVE_POSIX_SPAWNP */
 
 using namespace std;
 
+#ifdef HAVE_POSIX_SPAWNP
+extern char **environ;
+
+/**
+ * Characters that, when not quoted or escaped, mean a command needs a shell to
+ * execute it.
+ */
+static char const Shell_Special_Chars[] = "!$&()*;?[`{|}";
+
+/**
+ * The number of bytes to read at a time from a filter's pipe.
+ */
+static size_t const Pipe_Read_Size = 64 * 1024;
+#endif /* HAVE_POSIX_SPAWNP */
+
 ////////// local functions ////////////////////////////////////////////////////
 
 /**
@@ -51,6 +75,130 @@ static void escape_filename( string &s ) {
   } // while
 }
 
+#ifdef HAVE_POSIX_SPAWNP
+/**
+ * Creates a pipe whose file descriptors are closed upon exec(2) so that they
+ * aren't inherited by other filters spawned concurrently.
+ *
+ * @param fd The file descriptors of the pipe.
+ * @return Returns \c true only if the pipe was created.
+ */
+static bool make_pipe( int fd[2] ) {
+#ifdef HAVE_PIPE2
+  return ::pipe2( fd, O_CLOEXEC ) == 0;
+#else
+  if ( ::pipe( fd ) == -1 )
+    return false;
+  ::fcntl( fd[0], F_SETFD, FD_CLOEXEC );
+  ::fcntl( fd[1], F_SETFD, FD_CLOEXEC );
+  return true;
+#endif /* HAVE_PIPE2 */
+}
+
+/**
+ * Reads everything from a file descriptor until end-of-file.
+ *
+ * @param fd The file descriptor to read from.
+ * @param output The buffer to append to.
+ * @return Returns \c true only if everything was read.
+ */
+static bool read_all( int fd, vector<char> &output ) {
+  size_t n = output.size();
+  while ( true ) {
+    if ( output.size() - n < Pipe_Read_Size )
+      output.resize( n + Pipe_Read_Size );
+    ssize_t const bytes_read = ::read( fd, &output[ n ], output.size() - n );
+    if ( bytes_read > 0 ) {
+      n += bytes_read;
+      continue;
+    }
+    if ( bytes_read == -1 && errno == EINTR )
+      continue;
+    output.resize( n );
+    return bytes_read == 0;
+  } // while
+}
+
+/**
+ * Writes all of the input to one file descriptor while reading everything from
+ * another until end-of-file.  Both are done at the same time so that neither
+ * the filter nor we block forever on a full pipe.
+ *
+ * @param in_fd The file descriptor to write to.  It's closed once either all
+ * the input has been written or the filter stops reading it.
+ * @param input A pointer to the input.
+ * @param size The size of the input in bytes.
+ * @param out_fd The file descriptor to read from.
+ * @param output The buffer to append to.
+ * @return Returns \c true only if everything was read.
+ */
+static bool write_read_all( int in_fd, char const *input, size_t size,
+                            int out_fd, vector<char> &output ) {
+  ::fcntl( in_fd, F_SETFL, O_NONBLOCK );
+  size_t n = output.size();
+  bool got_eof = false;
+  while ( true ) {
+    if ( in_fd != -1 && !size ) {
+      ::close( in_fd );                 // so the filter gets EOF
+      in_fd = -1;
+    }
+    pollfd fds[2] = { { out_fd, POLLIN, 0 }, { in_fd, POLLOUT, 0 } };
+    if ( ::poll( fds, in_fd != -1 ? 2 : 1, -1 ) == -1 ) {
+      if ( errno == EINTR )
+        continue;
+      break;
+    }
+
+    if ( in_fd != -1 && fds[1].revents ) {
+      ssize_t const bytes_written = ::write( in_fd, input, size );
+      if ( bytes_written > 0 ) {
+        input += bytes_written;
+        size -= bytes_written;
+      } else if ( errno != EAGAIN && errno != EINTR ) {
+        //
+        // The filter stopped reading its input (EPIPE) which is its business:
+        // it either has all it needs or it failed, in which case its exit
+        // status will say so.
+        //
+        size = 0;
+      }
+    }
+
+    if ( fds[0].revents ) {
+      if ( output.size() - n < Pipe_Read_Size )
+        output.resize( n + Pipe_Read_Size );
+      ssize_t const bytes_read =
+        ::read( out_fd, &output[ n ], output.size() - n );
+      if ( bytes_read > 0 )
+        n += bytes_read;
+      else if ( bytes_read == 0 || errno != EINTR ) {
+        got_eof = bytes_read == 0;
+        break;
+      }
+    }
+  } // while
+
+  if ( in_fd != -1 )
+    ::close( in_fd );
+  output.resize( n );
+  return got_eof;
+}
+
+/**
+ * Waits for a child process to exit.
+ *
+ * @param pid The process ID of the child.
+ * @return Returns \c true only if the child exited successfully.
+ */
+static bool wait_for( pid_t pid ) {
+  int status;
+  while ( ::waitpid( pid, &status, 0 ) == -1 )
+    if ( errno != EINTR )
+      return false;
+  return WIFEXITED( status ) && !WEXITSTATUS( status );
+}
+#endif /* HAVE_POSIX_SPAWNP */
+
 /**
  * Unescapes all \c '\' characters in a filename for not passing to a shell.
  *
@@ -66,8 +214,27 @@ static void unescape_filename( string &s ) {
 ////////// member functions ///////////////////////////////////////////////////
 
 char const* filter::exec() const {
+  created_ = true;
+
+  if ( decompressor_ ) {
+    vector<char> output;
+    if ( !decompressor_( source_file_name_.c_str(), output ) )
+      return nullptr;
+    ofstream target( target_file_name_, ios::out | ios::binary );
+    target.write( output.data(), output.size() );
+    return target.flush() ? target_file_name_.c_str() : nullptr;
+  }
+
   assert( !command_.empty() );
 
+#ifdef HAVE_POSIX_SPAWNP
+  if ( !argv_.empty() ) {
+    pid_t pid;
+    return spawn( -1, -1, &pid ) && wait_for( pid ) ?
+      target_file_name_.c_str() : nullptr;
+  }
+#endif /* HAVE_POSIX_SPAWNP */
+
   unsigned attempt_count = 0;
   int exit_code;
 
@@ -82,7 +249,270 @@ char const* filter::exec() const {
   return exit_code ? nullptr : target_file_name_.c_str();
 }
 
+bool filter::exec( [[maybe_unused]] vector<char> &output ) const {
+  if ( decompressor_ )
+    return decompressor_( source_file_name_.c_str(), output );
+
+  assert( redirects_ );
+#ifdef HAVE_POSIX_SPAWNP
+  output.clear();
+  int fd[2];
+  if ( !make_pipe( fd ) )
+    return false;
+  pid_t pid;
+  bool const spawned = spawn( -1, fd[1], &pid );
+  ::close( fd[1] );                     // so we get EOF when the child exits
+  bool const read = spawned && read_all( fd[0], output );
+  ::close( fd[0] );
+  return spawned && wait_for( pid ) && read;
+#else
+  return false;
+#endif /* HAVE_POSIX_SPAWNP */
+}
+
+bool filter::exec( [[maybe_unused]] char const *input,
+                   [[maybe_unused]] size_t size,
+                   [[maybe_unused]] vector<char> &output ) const {
+  assert( pipes_input() );
+#ifdef HAVE_POSIX_SPAWNP
+  //
+  // A filter that exits without reading all of its input would otherwise kill
+  // us with SIGPIPE when we write the rest of it.  (Spawned filters get the
+  // default action back.)
+  //
+  [[maybe_unused]]
+  static bool const ignored_sigpipe = ::signal( SIGPIPE, SIG_IGN ) != SIG_ERR;
+
+  output.clear();
+  int in[2], out[2];
+  if ( !make_pipe( in ) )
+    return false;
+  if ( !make_pipe( out ) ) {
+    ::close( in[0] );
+    ::close( in[1] );
+    return false;
+  }
+  pid_t pid;
+  bool const spawned = spawn( in[0], out[1], &pid );
+  ::close( in[0] );
+  ::close( out[1] );                    // so we get EOF when the child exits
+  bool const read = spawned &&
+    write_read_all( in[1], input, size, out[0], output );
+  if ( !spawned )
+    ::close( in[1] );
+  ::close( out[0] );
+  return spawned && wait_for( pid ) && read;
+#else
+  return false;
+#endif /* HAVE_POSIX_SPAWNP */
+}
+
+#ifdef HAVE_POSIX_SPAWNP
+/**
+ * Parses the substituted command into the arguments to execute it with
+ * directly, but only if it uses no shell features other than quoting,
+ * escaping, redirecting its standard output to the target file, and
+ * redirecting its standard input from the source file.
+ *
+ * @return Returns \c true only if the command can be executed directly.
+ */
+bool filter::parse_command() {
+  argv_.clear();
+  redirects_ = redirects_input_ = false;
+
+  string arg;
+  bool in_arg = false;                  // distinguishes "" from no argument
+  bool redirecting = false;             // just encountered a '>'
+  bool redirecting_input = false;       // just encountered a '<'
+
+  auto const end_arg = [&]() {
+    if ( !in_arg )
+      return true;
+    if ( redirecting ) {
+      if ( arg != target_file_name_ )
+        return false;
+      redirecting = false;
+      redirects_ = true;
+    } else if ( redirecting_input ) {
+      if ( arg != source_file_name_ )
+        return false;
+      redirecting_input = false;
+      redirects_input_ = true;
+    } else {
+      argv_.push_back( arg );
+    }
+    arg.clear();
+    in_arg = false;
+    return true;
+  };
+
+  for ( string::size_type i = 0; i < command_.length(); ++i ) {
+    char const c = command_[i];
+    switch ( c ) {
+      case ' ':
+      case '\t':
+      case '\n':
+        if ( !end_arg() )
+          goto needs_shell;
+        break;
+
+      case '\\':
+        if ( ++i == command_.length() )
+          goto needs_shell;
+        arg += command_[i];
+        in_arg = true;
+        break;
+
+      case '\'': {
+        string::size_type const quote = command_.find( '\'', i + 1 );
+        if ( quote == string::npos )
+          goto needs_shell;
+        arg.append( command_, i + 1, quote - i - 1 );
+        i = quote;
+        in_arg = true;
+        break;
+      }
+
+      case '"':
+        for ( ++i; i < command_.length() && command_[i] != '"'; ++i ) {
+          if ( command_[i] == '$' || command_[i] == '`' )
+            goto needs_shell;
+          if ( command_[i] == '\\' && i + 1 < command_.length() &&
+               ::strchr( "\"\\", command_[ i + 1 ] ) ) {
+            ++i;
+          }
+          arg += command_[i];
+        } // for
+        if ( i == command_.length() )
+          goto needs_shell;
+        in_arg = true;
+        break;
+
+      case '>':
+        //
+        // Only a single redirection of standard output, i.e., not something
+        // like 2> or >>, can be done without a shell.
+        //
+        if ( in_arg || redirecting || redirecting_input || redirects_ )
+          goto needs_shell;
+        redirecting = true;
+        break;
+
+      case '<':
+        //
+        // Likewise, only a single redirection of standard input from the
+        // source file, i.e., not something like << or <>.
+        //
+        if ( in_arg || redirecting || redirecting_input || redirects_input_ )
+          goto needs_shell;
+        redirecting_input = true;
+        break;
+
+      case '#':
+      case '~':
+        if ( !in_arg )
+          goto needs_shell;
+        arg += c;
+        break;
+
+      default:
+        if ( ::strchr( Shell_Special_Chars, c ) )
+          goto needs_shell;
+        arg += c;
+        in_arg = true;
+    } // switch
+  } // for
+
+  if ( !end_arg() || redirecting || redirecting_input || argv_.empty() ||
+       argv_.front().find( '=' ) != string::npos ) {
+    goto needs_shell;
+  }
+  return true;
+
+needs_shell:
+  argv_.clear();
+  redirects_ = redirects_input_ = false;
+  return false;
+}
+#endif /* HAVE_POSIX_SPAWNP */
+
+/**
+ * Spawns the command directly (without a shell).
+ *
+ * @param in_fd The file descriptor to make the command's standard input or -1
+ * to leave it as-is (or redirected from the source file if the command does
+ * so).
+ * @param out_fd The file descriptor to make the command's standard output or
+ * -1 to leave it as-is (or redirected to the target file if the command does
+ * so).
+ * @param pid The process ID of the spawned command.
+ * @return Returns \c true only if the command was spawned.
+ */
+bool filter::spawn( [[maybe_unused]] int in_fd,
+                    [[maybe_unused]] int out_fd,
+                    [[maybe_unused]] pid_t *pid ) const {
+#ifdef HAVE_POSIX_SPAWNP
+  vector<char*> argv;
+  for ( auto const &arg : argv_ )
+    argv.push_back( const_cast<char*>( arg.c_str() ) );
+  argv.push_back( nullptr );
+
+  posix_spawn_file_actions_t actions;
+  ::posix_spawn_file_actions_init( &actions );
+  if ( in_fd != -1 )
+    ::posix_spawn_file_actions_adddup2( &actions, in_fd, STDIN_FILENO );
+  else if ( redirects_input_ )
+    ::posix_spawn_file_actions_addopen(
+      &actions, STDIN_FILENO, source_file_name_.c_str(), O_RDONLY, 0
+    );
+  if ( out_fd != -1 )
+    ::posix_spawn_file_actions_adddup2( &actions, out_fd, STDOUT_FILENO );
+  else if ( redirects_ )
+    ::posix_spawn_file_actions_addopen(
+      &actions, STDOUT_FILENO, target_file_name_.c_str(),
+      O_WRONLY | O_CREAT | O_TRUNC, 0666
+    );
+
+  //
+  // In case SIGPIPE is being ignored (see exec()), restore its default action
+  // for the command.
+  //
+  posix_spawnattr_t attr;
+  ::posix_spawnattr_init( &attr );
+  sigset_t sigs;
+  ::sigemptyset( &sigs );
+  ::sigaddset( &sigs, SIGPIPE );
+  ::posix_spawnattr_setsigdefault( &attr, &sigs );
+  ::posix_spawnattr_setflags( &attr, POSIX_SPAWN_SETSIGDEF );
+
+  unsigned attempt_count = 0;
+  int err;
+  while ( (err = ::posix_spawnp( pid, argv[0], &actions, &attr,
+                                 argv.data(), environ )) == EAGAIN ) {
+    //
+    // Try a few times before giving up in case the system is temporarily busy.
+    //
+    if ( ++attempt_count > Fork_Attempts )
+      break;
+    ::sleep( Fork_Sleep );
+  } // while
+
+  ::posix_spawnattr_destroy( &attr );
+  ::posix_spawn_file_actions_destroy( &actions );
+  return !err;
+#else
+  return false;
+#endif /* HAVE_POSIX_SPAWNP */
+}
+
 char const *filter::substitute( char const *file_name ) {
+  source_file_name_ = file_name;
+  if ( decompressor_ ) {
+    target_file_name_ = file_name;
+    target_file_name_.erase( target_file_name_.rfind( '.' ) );
+    return target_file_name_.c_str();
+  }
+
   string esc_file_name{ file_name };
   escape_filename( esc_file_name );
   //
@@ -209,6 +639,9 @@ char const *filter::substitute( char const *file_name ) {
   // final file-name.
   //
   unescape_filename( target_file_name_ );
+#ifdef HAVE_POSIX_SPAWNP
+  parse_command();
+#endif /* HAVE_POSIX_SPAWNP */
   return target_file_name_.c_str();
 }
 
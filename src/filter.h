@@ -24,10 +24,13 @@
 
 // local
 #include "config.h"
+#include "decompress.h"
 
 // standard
 #include <string>
+#include <sys/types.h>                  /* for pid_t */
 #include <unistd.h>                     /* for unlink(2) */
+#include <vector>
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -35,10 +38,23 @@
  * A %filter is a light-weight class that contains a Unix command-line and
  * knows how to execute itself on a file to create a filtered file.  The
  * destructor deletes the filtered file.
+ *
+ * A command that uses no shell features other than quoting and redirecting
+ * its standard output to the target file (and, optionally, its standard input
+ * from the source file) is executed directly via posix_spawn(3) rather than
+ * via a shell.  Such a command's output can also be read through a pipe
+ * rather than being written to the target file and, if it redirects its
+ * standard input, its input can be written through a pipe rather than being
+ * read from the source file.
+ *
+ * A %filter can instead use a built-in decompressor (see find_decompressor())
+ * in which case the target file's name is the file's name minus its last
+ * extension and its contents are decompressed in-process.
  */
 class filter {
 public:
   explicit filter( char const *command ) : command_template_{ command } { }
+  explicit filter( decompressor d ) : decompressor_{ d } { }
   filter( filter const& ) = default;
   filter( filter&& ) = default;
   filter& operator=( filter const& ) = default;
@@ -47,18 +63,76 @@ public:
 
   char const* substitute( char const *file_name );
   char const* substitute( std::string const &file_name );
+
+  /**
+   * Executes the filter to create the target file.
+   *
+   * @return Returns the name of the target file or null if the filter failed.
+   */
   char const* exec() const;
 
+  /**
+   * Executes the filter reading what would be the target file's contents
+   * through a pipe.  This can be done only if \c pipes() returns \c true.
+   *
+   * @param output The buffer to read into.  It's cleared first.
+   * @return Returns \c true only if the filter succeeded.
+   */
+  bool exec( std::vector<char> &output ) const;
+
+  /**
+   * Executes the filter writing what would be the source file's contents and
+   * reading what would be the target file's contents through pipes.  This can
+   * be done only if \c pipes_input() returns \c true.
+   *
+   * @param input A pointer to the input.
+   * @param size The size of the input in bytes.
+   * @param output The buffer to read into.  It's cleared first.
+   * @return Returns \c true only if the filter succeeded.
+   */
+  bool exec( char const *input, size_t size, std::vector<char> &output ) const;
+
+  /**
+   * Gets whether the filter's output can be read through a pipe, i.e., the
+   * command writes the target file only by redirecting its standard output,
+   * or it's a built-in decompressor.
+   *
+   * @return Returns \c true only if it can.
+   */
+  bool pipes() const {
+    return decompressor_ || redirects_;
+  }
+
+  /**
+   * Gets whether the filter's input can also be written through a pipe, i.e.,
+   * the command additionally reads the source file only by redirecting its
+   * standard input.
+   *
+   * @return Returns \c true only if it can.
+   */
+  bool pipes_input() const {
+    return redirects_ && redirects_input_;
+  }
+
 private:
-  char const *command_template_;
+  bool parse_command();
+  bool spawn( int in_fd, int out_fd, pid_t *pid ) const;
+
+  char const *command_template_ = nullptr;
+  decompressor decompressor_ = nullptr;
   std::string command_;
+  std::string source_file_name_;
   std::string target_file_name_;
+  std::vector<std::string> argv_;       // empty if a shell is needed
+  bool redirects_ = false;              // standard output to target file?
+  bool redirects_input_ = false;        // standard input from source file?
+  mutable bool created_ = false;        // did exec() create target file?
 };
 
 ////////// Inlines ////////////////////////////////////////////////////////////
 
 inline filter::~filter() {
-  if ( !target_file_name_.empty() )
+  if ( created_ )
     ::unlink( target_file_name_.c_str() );
 }
 
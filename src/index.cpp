@@ -23,6 +23,10 @@
 #include "config.h"
 #include "AssociateMeta.h"
 #include "ChangeDirectory.h"
+#include "CheckpointDir.h"
+#ifdef HAVE_LIBZ
+#include "CompressPartials.h"
+#endif /* HAVE_LIBZ */
 #include "conf_var.h"
 #include "ExcludeFile.h"
 #include "ExcludeMeta.h"
@@ -40,15 +44,20 @@
 #include "Incremental.h"
 #include "indexer.h"
 #include "IndexFile.h"
+#include "index_context.h"
+#include "index_manifest.h"
 #include "index_segment.h"
 #include "meta_id.h"
+#include "partial_index.h"
 #include "pjl/itoa.h"
 #include "pjl/mmap_file.h"
 #include "pjl/option_stream.h"
 #include "pjl/vlq.h"
+#include "Rebuild.h"
 #include "RecurseSubdirs.h"
 #include "StopWordFile.h"
 #include "stop_words.h"
+#include "StoreFrequentWords.h"
 #ifdef WITH_WORD_POS
 #include "StoreWordPositions.h"
 #endif /* WITH_WORD_POS */
@@ -64,23 +73,33 @@
 #include "WordThreshold.h"
 
 // standard
-#include <algorithm>                    /* for std::copy */
+#include <algorithm>                    /* for sort() */
+#include <cerrno>
 #include <cmath>                        /* for log(3) */
+#include <cstdio>                       /* for rename(2) */
 #include <cstdlib>                      /* for getenv(3), exit(3) */
 #include <cstring>
 #include <fstream>
 #include <iomanip>                      /* for setfill(), setw() */
 #include <ios>
 #include <iostream>
-#include <iterator>
+#include <map>
 #include <ostream>
+#include <sstream>
 #include <string>
 #include <time.h>
 #include <sys/time.h>                   /* needed by FreeBSD systems */
 #include <sys/resource.h>               /* for RLIMIT_* */
 #include <sys/types.h>
 #include <unistd.h>                     /* for unlink(2) */
+#include <unordered_map>
 #include <vector>
+#ifdef MULTI_THREADED
+#include <chrono>
+#include <deque>
+#include <future>
+#include <memory>
+#endif /* MULTI_THREADED */
 
 using namespace PJL;
 using namespace std;
@@ -93,6 +112,7 @@ using namespace std;
 static constexpr long Rank_Factor = 10000000;
 
 AssociateMeta         associate_meta;
+CheckpointDir         checkpoint_dir;     // where to record checkpoints
 ExcludeFile           exclude_patterns;   // do not index these
 IncludeFile           include_patterns;   // do index these
 ExcludeMeta           exclude_meta_names; // meta names not to index
@@ -109,7 +129,10 @@ unsigned long         num_total_words;    // over all files indexed
 unsigned long         num_indexed_words;  // over all files indexed
 static unsigned long  num_unique_words;   // over all files indexed
 static vector<string> partial_index_file_names;
+Rebuild               rebuild;
+static bool           resuming;           // resuming from a checkpoint?
 RecurseSubdirs        recurse_subdirectories;
+StoreFrequentWords    store_frequent_words;
 string                temp_file_name_prefix;
 Verbosity             verbosity;          // how much to print
 word_map              words;              // the index being generated
@@ -119,23 +142,170 @@ WordThreshold         word_threshold;
 
 #ifdef WITH_WORD_POS
 StoreWordPositions    store_word_positions;
-int                   word_pos;           // ith word in file
 #endif /* WITH_WORD_POS */
 
+#ifdef HAVE_LIBZ
+CompressPartials      compress_partials;
+#endif /* HAVE_LIBZ */
+
+/**
+ * When rebuilding or indexing incrementally, an %old_file is a live file in an
+ * existing index or segment.
+ */
+struct old_file {
+  int       segment;                    // index into old_segments
+  int       index;                      // file index in the segment
+  size_t    size;
+  time_t    mtime;                      // 0 = unknown
+  ino_t     inode;                      // 0 = unknown
+  unsigned  num_words;
+  string    title;
+  bool      seen;                       // encountered while indexing?
+};
+
+/**
+ * The live files in all old segments keyed by path.
+ */
+using old_file_map = unordered_map<string,old_file>;
+static old_file_map old_files_by_path;
+
+/**
+ * When rebuilding or indexing incrementally, an %old_segment is an existing
+ * index (or a segment of a segmented index).  A segment is either \e merged,
+ * i.e., its live files are copied into the index being generated (and it is
+ * then removed), or kept as-is except for new tombstones.
+ */
+struct old_segment {
+  string        file;                   // relative to the manifest, if any
+  string        tombstones_file;        // ditto
+  tombstone_set tombstones;
+  bool          tombstones_changed;
+  int           partial;                // partial index number if merged
+  vector<old_file_map::value_type*> files; // live files in file index order
+};
+
+static vector<old_segment> old_segments;
+
+/**
+ * The number of live files in old segments that are not merged.  These count
+ * toward the total number of files for \c is_too_frequent().
+ */
+static size_t num_kept_files;
+
+/**
+ * For a merged old segment, maps the file index of every file in it to its
+ * file index in the new index or -1 if the file was dropped because it was
+ * changed, deleted, or already had a tombstone.  It's indexed by partial index
+ * number; partial indices that are not old segments have no map.
+ */
+static vector<vector<int>> partial_file_maps;
+
+/**
+ * When merging independently built indices, maps the meta-name ID of every
+ * meta name in each to its ID in the new index.  It's indexed by partial index
+ * number like \c partial_file_maps.
+ */
+static vector<vector<meta_id_type>> partial_meta_maps;
+
+/**
+ * The files of every word that occurs too frequently when \c
+ * store_frequent_words is set.  They're written after the word in the
+ * stop-word index so that, when old segments are merged, whether the word is
+ * still too frequent can be recomputed.
+ */
+static map<string,vector<word_info::file>> too_frequent_words;
+
+/**
+ * The words that occur too frequently in old segments that are kept.  They're
+ * indexed (so their files are known should the segments be merged later), but
+ * they're also considered too frequent in the index being generated.
+ */
+static unordered_char_ptr_set kept_too_frequent_words;
+
+/**
+ * The number of segments of about the same size that are merged into one when
+ * indexing incrementally.
+ */
+static constexpr size_t Segment_Merge_Factor = 4;
+
+/**
+ * Segments smaller than this many bytes are all considered to be about the
+ * same size.
+ */
+static constexpr off_t Segment_Tier_Size_Min = 1024 * 1024;
+
+/**
+ * A %checkpoint is the state recorded by \c write_checkpoint() once a partial
+ * index has been written.
+ */
+struct checkpoint {
+  int           num_partials;           // partial indices written
+  size_t        num_files;              // files whose words are all in them
+  unsigned long num_total_words;
+  unsigned long num_indexed_words;
+};
+
+#ifdef MULTI_THREADED
+/**
+ * A %pending_partial_index is a partial index being written by a background
+ * thread.
+ */
+struct pending_partial_index {
+  future<void>  written;
+  checkpoint    state;                  // to record once written
+};
+
+/**
+ * The partial indices being written in the background, oldest first.
+ */
+static deque<pending_partial_index> pending_partial_indices;
+
+/**
+ * The maximum number of partial indices that may be being written in the
+ * background at once.  Each holds an entire word map, so this bounds memory
+ * usage to (about) this many more times that of a single word map.
+ */
+static constexpr size_t Partial_Writes_Max = 2;
+#endif /* MULTI_THREADED */
+
 // local functions
-static void           load_old_index( char const *index_file_name );
+static void           collect_files( size_t, char const*,
+                                     vector<word_info::file>& );
+static void           copy_old_file( char const*, unsigned, old_file const& );
+static void           copy_unseen_files();
+static void           drop_deleted_files();
+static bool           copy_unchanged_documents( char const*, unsigned,
+                                                struct stat const& );
+static bool           copy_unchanged_file( char const*, unsigned,
+                                           struct stat const& );
+static void           load_merged_indices( char const *const* );
+static void           load_old_segment( char const*, int, char const*,
+                                        bool newest );
+static void           load_segments( char const*, index_manifest&,
+                                     bool merge_all );
+static void           remove_old_segments( index_manifest const& );
 static void           max_out_limits();
 static void           merge_indicies( ostream& );
 static void           rank_full_index();
+static bool           read_checkpoint();
+static void           remove_checkpoint();
+static void           reserve_old_files();
 extern "C" void       remove_temp_files( void );
 static ostream&       usage( ostream& = cerr );
+static void           write_checkpoint( checkpoint const& );
 static void           write_dir_index( ostream&, off_t* );
+static void           write_file_entries( ostream&, vector<word_info::file>& );
 static void           write_file_index( ostream&, off_t* );
 static void           write_full_index( ostream& );
+static void           write_manifest( char const*, index_manifest&,
+                                      string const& );
 static void           write_meta_name_index( ostream&, off_t* );
 static void           write_partial_index();
+static void           write_partial_words( ostream&, word_map const& );
+static void           wait_partial_indices( size_t );
 static void           write_stop_word_index( ostream&, off_t* );
-static void           write_word_index( ostream&, off_t* );
+static void           write_word_entry( ostream&, word_map::value_type const& );
+static void           write_word_index( ostream&, word_map const&, off_t* );
 
 #define SWISHXX_INDEX
 #include "do_file.cpp"
@@ -206,16 +376,22 @@ int main( int argc, char *argv[] ) {
     { "files-reserve",  1, 'F', "", "" },
     { "files-grow",     1, 'g', "", "" },
     { "index-file",     1, 'i', "", "" },
-    { "incremental",    0, 'I', "", "" },
+    { "incremental",    0, 'I', "JR", "" },
 #ifndef PJL_NO_SYMBOLIC_LINKS
     { "follow-links",   0, 'l', "", "" },
 #endif
+    { "merge",          0, 'J', "IOR", "" },
+    { "checkpoint-dir", 1, 'k', "", "" },
+    { "resume",         0, 'K', "", "" },
     { "meta",           1, 'm', "A", "" },
     { "no-meta",        1, 'M', "A", "" },
+    { "optimize",       0, 'O', "J", "" },
     { "percent-max",    1, 'p', "", "" },
 #ifdef WITH_WORD_POS
     { "no-pos-data",    0, 'P', "", "" },
 #endif /* WITH_WORD_POS */
+    { "store-frequent", 0, 'Q', "", "" },
+    { "rebuild",        0, 'R', "IJ", "" },
     { "no-recurse",     0, 'r', "", "" },
     { "stop-file",      1, 's', "", "" },
     { "dump-stop",      0, 'S', option_stream::arg_lone, "" },
@@ -224,11 +400,18 @@ int main( int argc, char *argv[] ) {
     { "verbosity",      1, 'v', "", "" },
     { "version",        0, 'V', option_stream::arg_lone, "" },
     { "word-threshold", 1, 'W', "", "" },
+#ifdef HAVE_LIBZ
+    { "compress-partials", 0, 'z', "", "" },
+#endif /* HAVE_LIBZ */
     { nullptr,          0,'\0', "", "" }
   };
 
   ChangeDirectory change_directory;
   char const     *change_directory_arg = nullptr;
+  char const     *checkpoint_dir_arg = nullptr;
+#ifdef HAVE_LIBZ
+  bool            compress_partials_opt = false;
+#endif /* HAVE_LIBZ */
   char const     *config_file_name_arg = ConfigFile_Default;
   bool            dump_stop_words_opt = false;
   char const     *files_grow_arg = nullptr;
@@ -239,13 +422,18 @@ int main( int argc, char *argv[] ) {
   bool            incremental_opt = false;
   IndexFile       index_file_name;
   char const     *index_file_name_arg = nullptr;
+  bool            merge_opt = false;
   bool            no_associate_meta_opt = false;
   bool            no_word_pos_opt = false;
   char const     *num_title_lines_arg = nullptr;
+  bool            optimize_opt = false;
   bool            print_help_opt = false;
   bool            print_version_opt = false;
+  bool            rebuild_opt = false;
   bool            recurse_subdirectories_opt = false;
+  bool            resume_opt = false;
   StopWordFile    stop_word_file_name;
+  bool            store_frequent_words_opt = false;
   char const     *stop_word_file_name_arg = nullptr;
   TempDirectory   temp_directory;
   char const     *temp_directory_arg = nullptr;
@@ -316,6 +504,18 @@ int main( int argc, char *argv[] ) {
         incremental_opt = true;
         break;
 
+      case 'J': // Merge indices.
+        merge_opt = true;
+        break;
+
+      case 'k': // Specify checkpoint directory.
+        checkpoint_dir_arg = opt.arg();
+        break;
+
+      case 'K': // Resume from checkpoint.
+        resume_opt = true;
+        break;
+
 #ifndef PJL_NO_SYMBOLIC_LINKS
       case 'l': // Follow symbolic links during indexing.
         follow_symbolic_links_opt = true;
@@ -329,6 +529,10 @@ int main( int argc, char *argv[] ) {
         exclude_meta_names.insert( to_lower( opt.arg() ) );
         break;
 
+      case 'O': // Merge all segments.
+        optimize_opt = true;
+        break;
+
       case 'p': // Specify the word/file percentage.
         word_percent_max_arg = opt.arg();
         break;
@@ -339,10 +543,18 @@ int main( int argc, char *argv[] ) {
         break;
 #endif /* WITH_WORD_POS */
 
+      case 'Q': // Store the files of too-frequent words.
+        store_frequent_words_opt = true;
+        break;
+
       case 'r': // Specify whether to index recursively.
         recurse_subdirectories_opt = true;
         break;
 
+      case 'R': // Specify rebuilding.
+        rebuild_opt = true;
+        break;
+
       case 's': // Specify stop-word list.
         stop_word_file_name_arg = opt.arg();
         break;
@@ -371,6 +583,12 @@ int main( int argc, char *argv[] ) {
         word_threshold_arg = opt.arg();
         break;
 
+#ifdef HAVE_LIBZ
+      case 'z': // Compress partial indices.
+        compress_partials_opt = true;
+        break;
+#endif /* HAVE_LIBZ */
+
       default: // Any indexing module claim the option?
         if ( !indexer::any_mod_claims_option( opt ) )
           cerr << usage;
@@ -396,6 +614,12 @@ int main( int argc, char *argv[] ) {
   //
   conf_var::parse_file( config_file_name_arg );
 
+  if ( checkpoint_dir_arg )
+    checkpoint_dir = checkpoint_dir_arg;
+#ifdef HAVE_LIBZ
+  if ( compress_partials_opt )
+    compress_partials = true;
+#endif /* HAVE_LIBZ */
   if ( files_grow_arg )
     files_grow = files_grow_arg;
   if ( files_reserve_arg )
@@ -416,10 +640,36 @@ int main( int argc, char *argv[] ) {
 #endif /* WITH_WORD_POS */
   if ( num_title_lines_arg )
     num_title_lines = num_title_lines_arg;
+  if ( rebuild_opt )
+    rebuild = true;
+  if ( incremental && rebuild ) {
+    error() << "incremental indexing and rebuilding are mutually exclusive\n";
+    ::exit( Exit_Usage );
+  }
+  if ( merge_opt && (incremental || rebuild) ) {
+    error() << "merging can not be done when "
+            << (incremental ? "incrementally indexing\n" : "rebuilding\n");
+    ::exit( Exit_Usage );
+  }
+  if ( *checkpoint_dir &&
+       (incremental || rebuild || merge_opt || optimize_opt) ) {
+    error() << "checkpoints can be recorded only for full indexing\n";
+    ::exit( Exit_Usage );
+  }
+  if ( resume_opt && !*checkpoint_dir ) {
+    error() << "resuming requires a checkpoint directory\n";
+    ::exit( Exit_Usage );
+  }
   if ( recurse_subdirectories_opt )
     recurse_subdirectories = false;
   if ( stop_word_file_name_arg )
     stop_word_file_name = stop_word_file_name_arg;
+  //
+  // A new segment always stores the files of too-frequent words since it's
+  // merged with other segments later.
+  //
+  if ( store_frequent_words_opt || (incremental && !optimize_opt) )
+    store_frequent_words = true;
   if ( temp_directory_arg )
     temp_directory = temp_directory_arg;
   if ( verbosity_arg )
@@ -431,49 +681,99 @@ int main( int argc, char *argv[] ) {
   if ( word_threshold_arg )
     word_threshold = word_threshold_arg;
 
+  exclude_patterns.compile();
+  include_patterns.compile();
+  file_filters.compile();
   indexer::all_mods_post_options();
 
   /////////// Dump stuff if requested /////////////////////////////////////////
 
   if ( dump_stop_words_opt ) {
     stop_words = new stop_word_set();
-    ::copy( stop_words->begin(), stop_words->end(),
-      ostream_iterator<char const*>( cout, "\n" )
-    );
+    for ( auto const word : stop_words->sorted() )
+      cout << word << '\n';
     ::exit( Exit_Success );
   }
 
   /////////// Index specified directories and files ///////////////////////////
 
-  temp_file_name_prefix = temp_directory;
-  if ( *temp_file_name_prefix.rbegin() != '/' )
-    temp_file_name_prefix += '/';
-  temp_file_name_prefix += string( itoa( ::getpid() ) ) + string( "." );
+  if ( *checkpoint_dir ) {
+    //
+    // When recording checkpoints, partial indices are written to the
+    // checkpoint directory instead and aren't tied to the process ID so a
+    // later run can resume with them.
+    //
+    temp_file_name_prefix = checkpoint_dir;
+    if ( *temp_file_name_prefix.rbegin() != '/' )
+      temp_file_name_prefix += '/';
+    temp_file_name_prefix += "partial.";
+  } else {
+    temp_file_name_prefix = temp_directory;
+    if ( *temp_file_name_prefix.rbegin() != '/' )
+      temp_file_name_prefix += '/';
+    temp_file_name_prefix += string( itoa( ::getpid() ) ) + string( "." );
+  }
 
   bool const using_stdin = *argv && (*argv)[0] == '-' && !(*argv)[1];
-  if ( !using_stdin && include_patterns.empty() && exclude_patterns.empty() )
-    error() << "filename patterns must be specified "
-               "when not using standard input\n" << usage;
+  if ( merge_opt ) {
+    if ( !argc )
+      cerr << usage;
+  } else if ( !optimize_opt ) {
+    if ( !using_stdin && include_patterns.empty() && exclude_patterns.empty() )
+      error() << "filename patterns must be specified "
+                 "when not using standard input\n" << usage;
+    if ( !argc )
+      cerr << usage;
+  }
 
-  if ( !argc )
-    cerr << usage;
+  //
+  // When rebuilding or optimizing, the new index is written alongside the
+  // existing one and replaces it only when complete.  When indexing
+  // incrementally, the new index is a new segment of the existing one.
+  //
+  index_manifest manifest;
+  bool segmented = false;
+  string new_segment_name;
+  string out_file_name( index_file_name );
 
-  if ( incremental ) {
-    load_old_index( index_file_name );
-    index_file_name += ".new";
+  //
+  // Even when old segments are merged, the stop words are the configured ones:
+  // whether words are too frequent is recomputed for the new index.
+  //
+  stop_words = new stop_word_set( stop_word_file_name );
+
+  if ( merge_opt ) {
+    load_merged_indices( argv );
+    out_file_name += ".new";
+  } else if ( incremental || optimize_opt ||
+              (rebuild && file_exists( index_file_name )) ) {
+    segmented = index_manifest::is_manifest( index_file_name );
+    load_segments(
+      index_file_name, manifest, optimize_opt || rebuild
+    );
+    if ( incremental && !optimize_opt ) {
+      new_segment_name = manifest.new_file_name();
+      out_file_name = manifest.path_of( new_segment_name );
+    } else {
+      out_file_name += ".new";
+    }
   } else {
-    stop_words = new stop_word_set( stop_word_file_name );
-    //
-    // In the case where several files (and no directories) are indexed, there
-    // would be no directory; however, every file must be in a directory, so
-    // add the directory "." here and now to the list of directories.
-    //
-    check_add_directory( "." );
+    if ( resume_opt ) {
+      resuming = read_checkpoint();
+      if ( !resuming && verbosity )
+        cout << me << ": no checkpoint to resume from\n";
+    }
   }
+  //
+  // In the case where several files (and no directories) are indexed, there
+  // would be no directory; however, every file must be in a directory, so add
+  // the directory "." here and now to the list of directories.
+  //
+  check_add_directory( "." );
 
-  ofstream out( index_file_name, ios::out | ios::binary );
+  ofstream out( out_file_name, ios::out | ios::binary );
   if ( !out ) {
-    error() << "can not write index to \"" << index_file_name << "\"\n";
+    error() << "can not write index to \"" << out_file_name << "\"\n";
     ::exit( Exit_No_Write_Index );
   }
 
@@ -482,7 +782,11 @@ int main( int argc, char *argv[] ) {
 
   time_t time = ::time( nullptr );      // Go!
 
-  if ( using_stdin ) {
+  if ( merge_opt ) {
+    //
+    // The arguments are the indices to merge: they were loaded above.
+    //
+  } else if ( using_stdin ) {
     //
     // Read file/directory names from standard input.
     //
@@ -514,6 +818,12 @@ int main( int argc, char *argv[] ) {
         do_check_add_file( *argv );
     } // for
   }
+  wait_filtered_files( 0 );
+
+  if ( incremental || optimize_opt )
+    drop_deleted_files();
+  if ( incremental || optimize_opt || merge_opt )
+    copy_unseen_files();
 
   if ( partial_index_file_names.empty() ) {
     rank_full_index();
@@ -526,11 +836,27 @@ int main( int argc, char *argv[] ) {
       //
       write_partial_index();
     }
+    wait_partial_indices( 0 );
     merge_indicies( out );
   }
 
   out.close();
 
+  if ( !new_segment_name.empty() ) {
+    write_manifest( index_file_name, manifest, new_segment_name );
+  } else if ( out_file_name != index_file_name ) {
+    if ( ::rename( out_file_name.c_str(), index_file_name ) == -1 ) {
+      error() << "can not replace \"" << index_file_name << '"'
+              << error_string( errno );
+      ::exit( Exit_No_Write_Index );
+    }
+    if ( segmented )
+      remove_old_segments( manifest );
+  }
+
+  if ( *checkpoint_dir )
+    remove_checkpoint();
+
   if ( verbosity ) {
     time = ::time( nullptr ) - time;    // Stop!
 
@@ -572,7 +898,9 @@ bool is_too_frequent( char const *word, unsigned file_count ) {
     return true;
   }
   auto const wfp =
-    static_cast<unsigned>( file_count * 100 / file_info::num_files() );
+    static_cast<unsigned>(
+      file_count * 100 / (file_info::num_files() + num_kept_files)
+    );
   if ( wfp >= word_percent_max ) {
     if ( verbosity > 2 )
       cout << "\n  \"" << word << "\" discarded (" << wfp << "%)" << flush;
@@ -582,64 +910,502 @@ bool is_too_frequent( char const *word, unsigned file_count ) {
 }
 
 /**
- * Load the stop-word, file, directory, and meta-name indicies from an existing
- * index file.
+ * When merging old segments, appends the files of a word's file list in a
+ * partial index to a list.  The file indices of the files in a merged old
+ * segment are mapped to those in the new index; files that were dropped are
+ * skipped.
+ *
+ * @param partial The number of the partial index.
+ * @param word The word entry in the partial index.
+ * @param files The list to append to.
+ */
+static void collect_files( size_t partial, char const *word,
+                           vector<word_info::file> &files ) {
+  vector<int> const *const file_map =
+    partial < partial_file_maps.size() && !partial_file_maps[ partial ].empty()
+    ? &partial_file_maps[ partial ] : nullptr;
+  vector<meta_id_type> const *const meta_map =
+    partial < partial_meta_maps.size() && !partial_meta_maps[ partial ].empty()
+    ? &partial_meta_maps[ partial ] : nullptr;
+  for ( auto const &file : file_list( word ) ) {
+    if ( !file_map ) {
+      files.push_back( file );
+      continue;
+    }
+    int const new_index = (*file_map)[ file.index_ ];
+    if ( new_index == -1 )
+      continue;
+    files.push_back( file );
+    word_info::file &new_file = files.back();
+    new_file.index_ = static_cast<unsigned>( new_index );
+    if ( meta_map && !new_file.meta_ids_.empty() ) {
+      word_info::file::meta_id_set meta_ids;
+      for ( auto const meta_id : new_file.meta_ids_ )
+        meta_ids.insert( (*meta_map)[ meta_id ] );
+      new_file.meta_ids_.swap( meta_ids );
+    }
+  } // for
+}
+
+/**
+ * Copies the entry of a file in a merged old segment into the index being
+ * generated and maps its file index so its words will be copied too.
+ *
+ * @param path The full path of the file.
+ * @param dir_index The numerical index of the file's directory.
+ * @param f The old file.
+ */
+static void copy_old_file( char const *path, unsigned dir_index,
+                           old_file const &f ) {
+  new file_info(
+    path, dir_index, f.size, f.mtime, f.inode, f.title.c_str(), f.num_words
+  );
+  partial_file_maps[ old_segments[ f.segment ].partial ][ f.index ] =
+    static_cast<int>( file_info::current_index() );
+}
+
+/**
+ * Marks a file in an old segment as encountered while indexing.  If it's
+ * unchanged and its segment is being merged, its entry is copied; if it
+ * changed and its segment is being kept, it gets a tombstone.
+ *
+ * @param path The full path of the file.
+ * @param dir_index The numerical index of the file's directory.
+ * @param f The old file.
+ * @param unchanged Whether the file is unchanged.
+ * @return Returns \a unchanged.
+ */
+static bool see_old_file( char const *path, unsigned dir_index, old_file &f,
+                          bool unchanged ) {
+  f.seen = true;
+  old_segment &segment = old_segments[ f.segment ];
+  if ( !unchanged ) {
+    if ( segment.partial == -1 ) {
+      segment.tombstones[ f.index ] = true;
+      segment.tombstones_changed = true;
+      --num_kept_files;
+    }
+    return false;
+  }
+  if ( segment.partial != -1 )
+    copy_old_file( path, dir_index, f );
+  return true;
+}
+
+/**
+ * When rebuilding or indexing incrementally, checks whether a file is
+ * unchanged since the old segment it's in was built, i.e., it has the same
+ * size, modification time, and i-node number.  If it's unchanged and its
+ * segment is being merged, its entry is copied; if it changed and its segment
+ * is being kept, it gets a tombstone.
  *
- * @param index_file_name The name of the index file to load.
+ * @param path The full path of the file.
+ * @param dir_index The numerical index of the file's directory.
+ * @param st The status of the file.
+ * @return Returns \c true only if the file is unchanged.
  */
-void load_old_index( char const *index_file_name ) {
-  mmap_file const index_file( index_file_name );
+static bool copy_unchanged_file( char const *path, unsigned dir_index,
+                                 struct stat const &st ) {
+  auto const found = old_files_by_path.find( path );
+  if ( found == old_files_by_path.end() )
+    return copy_unchanged_documents( path, dir_index, st );
+  old_file &f = found->second;
+  if ( f.seen )                         // encountered before
+    return true;
+  return see_old_file(
+    path, dir_index, f,
+    f.mtime && f.mtime == st.st_mtime && f.inode == st.st_ino &&
+    f.size == static_cast<size_t>( st.st_size )
+  );
+}
+
+/**
+ * Same as copy_unchanged_file(), but for a file that contains several
+ * documents (e.g., an mbox file) each of which has its own entry as
+ * \c path#offset.  Since the documents are contiguous, the offset of each is
+ * the offset of the previous plus its size.  Either all the documents are
+ * unchanged or none are.
+ *
+ * @param path The full path of the file.
+ * @param dir_index The numerical index of the file's directory.
+ * @param st The status of the file.
+ * @return Returns \c true only if the file is unchanged.
+ */
+static bool copy_unchanged_documents( char const *path, unsigned dir_index,
+                                      struct stat const &st ) {
+  string const prefix = string( path ) + file_info::Document_Offset_Separator;
+  vector<old_file_map::value_type*> docs;
+  size_t offset = 0;
+  for ( old_file_map::iterator found;
+        (found = old_files_by_path.find( prefix + ltoa( offset ) )) !=
+          old_files_by_path.end();
+        offset += found->second.size ) {
+    docs.push_back( &*found );
+    if ( !found->second.size )          // shouldn't happen, but be safe
+      break;
+  } // for
+  if ( docs.empty() )
+    return false;
+
+  old_file const &first = docs.front()->second;
+  if ( first.seen )                     // encountered before
+    return true;
+  bool const unchanged =
+    first.mtime && first.mtime == st.st_mtime && first.inode == st.st_ino &&
+    offset == static_cast<size_t>( st.st_size );
+  for ( auto *const doc : docs )
+    see_old_file( doc->first.c_str(), dir_index, doc->second, unchanged );
+  return unchanged;
+}
+
+/**
+ * Loads independently built indices to be merged into one.  Every segment of
+ * every index is merged and their meta names are reconciled.
+ *
+ * @param paths The null-terminated list of the full paths of the indices.
+ */
+static void load_merged_indices( char const *const *paths ) {
+  index_manifest::segment_list inputs;
+  for ( ; *paths; ++paths ) {
+    if ( !index_manifest::is_manifest( *paths ) ) {
+      inputs.push_back( { *paths, "" } );
+      continue;
+    }
+    index_manifest manifest;
+    if ( !manifest.read( *paths ) ) {
+      error() << "could not read index manifest from \"" << *paths << "\"\n";
+      ::exit( Exit_No_Read_Index );
+    }
+    for ( auto const &segment : manifest.segments ) {
+      inputs.push_back( {
+        manifest.path_of( segment.file ),
+        segment.tombstones.empty() ? "" :
+          manifest.path_of( segment.tombstones )
+      } );
+    } // for
+  } // for
+
+  size_t const n = inputs.size();
+  old_segments.resize( n );
+  partial_file_maps.resize( n );
+  partial_meta_maps.resize( n );
+  for ( size_t i = 0; i < n; ++i ) {
+    old_segment &s = old_segments[i];
+    s.file = inputs[i].file;
+    s.tombstones_changed = false;
+    s.partial = static_cast<int>( i );
+  } // for
+
+  for ( size_t i = 0; i < n; ++i ) {
+    load_old_segment(
+      inputs[i].file.c_str(), static_cast<int>( i ),
+      inputs[i].tombstones.c_str(), false
+    );
+  } // for
+  reserve_old_files();
+}
+
+/**
+ * Loads the files from an old segment.  If it's the newest segment, its meta
+ * names are loaded also; if independent indices are being merged, its meta
+ * names are reconciled.  If the segment is being merged, it's added to the
+ * list of partial indices.
+ *
+ * The stop words of the segment that were too frequent have their file lists
+ * (if it was written with \c store_frequent_words), so, if the segment is
+ * being merged, they're merged like any other words and whether they're still
+ * too frequent is recomputed.  If it's being kept, all its stop words that
+ * aren't configured ones remain too frequent whether or not they have file
+ * lists.  A merged segment's other stop words remain stop words since the
+ * files they're in can't be known.
+ *
+ * @param path The full path of the segment's index file.
+ * @param segment The index into \c old_segments of the segment.
+ * @param tombstones_path The full path of the segment's tombstone file, if
+ * any.
+ * @param newest If \c true, this is the newest segment.
+ */
+static void load_old_segment( char const *path, int segment,
+                              char const *tombstones_path, bool newest ) {
+  mmap_file const index_file( path );
   if ( !index_file ) {
-    error() << "could not read index from \"" << index_file_name
+    error() << "could not read index from \"" << path
             << '"' << error_string( index_file.error() );
     ::exit( Exit_No_Read_Index );
   }
 
-  ////////// Load old stop words //////////////////////////////////////////////
-
-  stop_words = new stop_word_set( index_file );
+  index_segment old_dirs( index_file, index_segment::isi_dir );
+  index_segment old_files( index_file, index_segment::isi_file );
+  index_segment old_meta_names( index_file, index_segment::isi_meta_name );
+  index_segment old_stop_words( index_file, index_segment::isi_stop_word );
 
-  ////////// Load old directories /////////////////////////////////////////////
+  old_segment &s = old_segments[ segment ];
 
-  index_segment old_dirs( index_file, index_segment::isi_dir );
-  for ( auto const &d : old_dirs )
-    check_add_directory( new_strdup( d ) );
+  for ( size_t i = 0; i < old_stop_words.size(); ++i ) {
+    char const *const word = old_stop_words[i];
+    if ( stop_words->contains( word ) )
+      continue;
+    if ( s.partial != -1 ) {
+      if ( !has_file_list( index_file, old_stop_words, i ) )
+        stop_words->insert( new_strdup( word ) );
+    } else if ( !contains( kept_too_frequent_words, word ) ) {
+      kept_too_frequent_words.insert( new_strdup( word ) );
+    }
+  } // for
 
-  ////////// Load old files ///////////////////////////////////////////////////
+  if ( newest ) {
+    FOR_EACH( old_meta_names, m ) {
+      unsigned char const* p = reinterpret_cast<unsigned char const*>( *m );
+      while ( *p++ ) ;                  // skip past meta name
+      meta_name_id_map[ new_strdup( *m ) ] = vlq::decode( p );
+    } // for
+  }
 
-  index_segment old_files( index_file, index_segment::isi_file );
-  if ( files_reserve <= old_files.size() ) {
-    //
-    // Add the FilesGrow configuration variable to the FilesReserve
-    // configuration variable to allow room for growth.
-    //
-    files_reserve = files_grow( static_cast<int>( old_files.size() ) );
+  if ( s.partial != -1 &&
+       static_cast<size_t>( s.partial ) < partial_meta_maps.size() ) {
+    vector<meta_id_type> &meta_map = partial_meta_maps[ s.partial ];
+    FOR_EACH( old_meta_names, m ) {
+      unsigned char const* p = reinterpret_cast<unsigned char const*>( *m );
+      while ( *p++ ) ;                  // skip past meta name
+      auto const old_id = static_cast<size_t>( vlq::decode( p ) );
+      auto const found = meta_name_id_map.find( *m );
+      meta_id_type new_id;
+      if ( found != meta_name_id_map.end() ) {
+        new_id = found->second;
+      } else {
+        new_id = static_cast<meta_id_type>( meta_name_id_map.size() );
+        meta_name_id_map[ new_strdup( *m ) ] = new_id;
+      }
+      if ( meta_map.size() <= old_id )
+        meta_map.resize( old_id + 1, Meta_ID_None );
+      meta_map[ old_id ] = new_id;
+    } // for
   }
-  FOR_EACH( old_files, f ) {
-    unsigned char const *u = reinterpret_cast<unsigned char const*>( *f );
+  if ( *tombstones_path ) {
+    if ( !read_tombstones( tombstones_path, old_files.size(), s.tombstones ) ) {
+      error() << "could not read tombstones from \"" << tombstones_path
+              << '"' << error_string( errno );
+      ::exit( Exit_No_Read_Index );
+    }
+  } else {
+    s.tombstones.assign( old_files.size(), false );
+  }
+  if ( s.partial != -1 ) {
+    partial_file_maps[ s.partial ].assign( old_files.size(), -1 );
+    partial_index_file_names.push_back( path );
+  }
+
+  for ( size_t i = 0; i < old_files.size(); ++i ) {
+    if ( s.tombstones[i] )
+      continue;
+    unsigned char const *u =
+      reinterpret_cast<unsigned char const*>( old_files[i] );
     int const dir_index = vlq::decode( u );
     auto const file_name = reinterpret_cast<char const*>(u);
     while ( *u++ ) ;                    // skip past filename
     size_t const size = vlq::decode( u );
     int const num_words = vlq::decode( u );
     auto const title = reinterpret_cast<char const*>( u );
+    while ( *u++ ) ;                    // skip past title
+    //
+    // Indices written by older versions don't have the modification time and
+    // i-node number following the title.  Since file entries are written
+    // contiguously and are followed by the meta names (if any), an entry has
+    // them only if it doesn't end right after the title.
+    //
+    auto const entry_end = reinterpret_cast<unsigned char const*>(
+      i + 1 < old_files.size() ? old_files[ i + 1 ] :
+      old_meta_names.size() ? old_meta_names[0] :
+      index_file.end()
+    );
+    time_t mtime = 0;
+    ino_t inode = 0;
+    if ( u < entry_end ) {
+      mtime = static_cast<time_t>( vlq::decode( u ) );
+      inode = static_cast<ino_t>( vlq::decode( u ) );
+    }
 
     string const dir_str( old_dirs[ dir_index ] );
-    string const path( dir_str + '/' + file_name );
+    auto const p = old_files_by_path.emplace(
+      dir_str + '/' + file_name, old_file{
+        segment, static_cast<int>( i ), size, mtime, inode,
+        static_cast<unsigned>( num_words ), title, false
+      }
+    );
+    if ( !p.second ) {
+      //
+      // This can happen only when merging independently built indices whose
+      // files overlap: the file is taken from the first index it's in.
+      //
+      warning() << '"' << p.first->first << "\" is in both \""
+                << old_segments[ p.first->second.segment ].file << "\" and \""
+                << s.file << "\"; using the former\n";
+      continue;
+    }
+    s.files.push_back( &*p.first );
+    if ( s.partial == -1 )
+      ++num_kept_files;
+  } // for
+}
+
+/**
+ * Loads the segments of an existing index.  An index that isn't segmented
+ * becomes the first segment.  Either all segments are merged into the index
+ * being generated or, using a size-tiered policy, only the newest segments
+ * when there are enough of about the same size.
+ *
+ * @param path The full path of the existing index.
+ * @param manifest The manifest to read the index's segments into.
+ * @param merge_all If \c true, merge all segments.
+ */
+static void load_segments( char const *path, index_manifest &manifest,
+                           bool merge_all ) {
+  bool const segmented = index_manifest::is_manifest( path );
+  if ( segmented ) {
+    if ( !manifest.read( path ) ) {
+      error() << "could not read index manifest from \"" << path << "\"\n";
+      ::exit( Exit_No_Read_Index );
+    }
+  } else {
+    if ( !file_exists( path ) ) {
+      error() << "could not read index from \"" << path
+              << '"' << error_string( ENOENT );
+      ::exit( Exit_No_Read_Index );
+    }
+    manifest.set_path( path );
+    manifest.segments.push_back( { pjl_basename( path ), "" } );
+  }
 
-    new file_info( path.c_str(), dir_index, size, title, num_words );
+  size_t const n = manifest.segments.size();
+  size_t first_merged = merge_all ? 0 : n;
+  if ( !merge_all && n ) {
+    //
+    // A segment's tier is the base-Segment_Merge_Factor logarithm of its size:
+    // once there are enough segments in the same tier as the newest segment,
+    // they're merged into the new segment that is then (about) one tier up.
+    //
+    auto const tier = [&]( size_t i ) {
+      off_t size = 0;
+      if ( file_exists( manifest.path_of( manifest.segments[i].file ) ) )
+        size = file_size() / Segment_Tier_Size_Min;
+      unsigned t = 0;
+      for ( ; size > 0; size /= Segment_Merge_Factor )
+        ++t;
+      return t;
+    };
+    unsigned const newest_tier = tier( n - 1 );
+    size_t k = n - 1;
+    while ( k > 0 && tier( k - 1 ) == newest_tier )
+      --k;
+    if ( n - k >= Segment_Merge_Factor - 1 )
+      first_merged = k;
+  }
+
+  if ( !segmented && first_merged ) {
+    //
+    // The existing index is being kept as the first segment, but the manifest
+    // will replace it, so give it a new name.
+    //
+    string const name = manifest.new_file_name();
+    if ( ::link( path, manifest.path_of( name ).c_str() ) == -1 ) {
+      error() << "can not link \"" << path << "\" to \""
+              << manifest.path_of( name ) << '"' << error_string( errno );
+      ::exit( Exit_No_Write_Index );
+    }
+    manifest.segments[0].file = name;
+  }
+
+  old_segments.resize( n );
+  int num_merged = 0;
+  for ( size_t i = 0; i < n; ++i ) {
+    old_segment &s = old_segments[i];
+    s.file = manifest.segments[i].file;
+    s.tombstones_file = manifest.segments[i].tombstones;
+    s.tombstones_changed = false;
+    s.partial = i >= first_merged ? num_merged++ : -1;
   } // for
+  partial_file_maps.resize( num_merged );
+
+  for ( size_t i = 0; i < n; ++i ) {
+    old_segment const &s = old_segments[i];
+    string const tombstones_path = s.tombstones_file.empty() ?
+      string() : manifest.path_of( s.tombstones_file );
+    load_old_segment(
+      manifest.path_of( s.file ).c_str(), static_cast<int>( i ),
+      tombstones_path.c_str(), i == n - 1
+    );
+  } // for
+  reserve_old_files();
+}
 
-  ////////// Load old meta names //////////////////////////////////////////////
+/**
+ * Reserves space for the files of the old segments being merged.
+ */
+static void reserve_old_files() {
+  size_t num_merged_files = 0;
+  for ( auto const &s : old_segments )
+    if ( s.partial != -1 )
+      num_merged_files += s.files.size();
+  if ( files_reserve <= num_merged_files ) {
+    //
+    // Add the FilesGrow configuration variable to the FilesReserve
+    // configuration variable to allow room for growth.
+    //
+    files_reserve = files_grow( static_cast<int>( num_merged_files ) );
+  }
+}
 
-  index_segment old_meta_names( index_file, index_segment::isi_meta_name );
-  FOR_EACH( old_meta_names, m ) {
-    unsigned char const* p = reinterpret_cast<unsigned char const*>( *m );
-    while ( *p++ ) ;                    // skip past meta name
-    meta_name_id_map[ new_strdup( *m ) ] = vlq::decode( p );
+/**
+ * When indexing incrementally, drops the files in old segments that weren't
+ * encountered while indexing because they were deleted, i.e., they were in a
+ * directory that was indexed and no longer exist.  If a file's segment is
+ * being kept, the file gets a tombstone.
+ */
+static void drop_deleted_files() {
+  for ( auto &s : old_segments ) {
+    for ( auto *const entry : s.files ) {
+      old_file &f = entry->second;
+      if ( f.seen )
+        continue;
+      string const &path = entry->first;
+      string const dir( path, 0, path.rfind( '/' ) );
+      if ( dir_set.find( dir.c_str() ) == dir_set.end() ||
+           file_exists( path ) ) {
+        continue;
+      }
+      if ( verbosity > 3 )
+        cout << "  " << path << " (deleted)\n";
+      f.seen = true;
+      if ( s.partial == -1 ) {
+        s.tombstones[ f.index ] = true;
+        s.tombstones_changed = true;
+        --num_kept_files;
+      }
+    } // for
   } // for
+}
 
-  partial_index_file_names.push_back( index_file_name );
+/**
+ * Copies the files in old segments being merged that weren't encountered
+ * while indexing (or dropped) into the index being generated.
+ */
+static void copy_unseen_files() {
+  for ( auto const &s : old_segments ) {
+    if ( s.partial == -1 )
+      continue;
+    for ( auto *const entry : s.files ) {
+      old_file &f = entry->second;
+      if ( f.seen )
+        continue;
+      f.seen = true;
+      string const &path = entry->first;
+      string const dir( path, 0, path.rfind( '/' ) );
+      auto const d = dir_set.find( dir.c_str() );
+      int const dir_index = d != dir_set.end() ?
+        d->second : check_add_directory( new_strdup( dir.c_str() ) );
+      copy_old_file( path.c_str(), dir_index, f );
+    } // for
+  } // for
 }
 
 static void max_out_limits() {
@@ -687,26 +1453,64 @@ static void max_out_limits() {
  * @param o The ostream to write the index to.
  */
 void merge_indicies( ostream &o ) {
-  vector<mmap_file> index( partial_index_file_names.size() );
-  vector<index_segment> words( partial_index_file_names.size() );
-  vector<index_segment::const_iterator> word( partial_index_file_names.size() );
+  vector<partial_index> word( partial_index_file_names.size() );
   size_t i, j;
+  size_t num_compressed_bytes = 0;      // of compressed partial indicies
+  size_t num_uncompressed_bytes = 0;    // ...had they not been
+
+  //
+  // When merging old segments, they're the first partial indices and the words
+  // that are only in files dropped from them are skipped.
+  //
+  bool const rebuilding = !partial_file_maps.empty();
+  unordered_char_ptr_set dropped_words;
+
+  /**
+   * Counts the files a word is in within a partial index, not counting files
+   * dropped from an old segment.
+   */
+  auto const count_files = [&]( size_t partial ) {
+    if ( partial >= partial_file_maps.size() ||
+         partial_file_maps[ partial ].empty() ) {
+      return file_list( *word[ partial ] ).size();
+    }
+    vector<int> const &file_map = partial_file_maps[ partial ];
+    file_list::size_type n = 0;
+    for ( auto const &file : file_list( *word[ partial ] ) )
+      if ( file_map[ file.index_ ] != -1 )
+        ++n;
+    return n;
+  };
+
+  /**
+   * Checks whether a word is not to be written.
+   */
+  auto const is_skipped = [&]( char const *word ) {
+    return stop_words->contains( word ) || contains( dropped_words, word );
+  };
 
   ////////// Reopen all the partial indicies //////////////////////////////////
 
   ::atexit( &remove_temp_files );
   i = 0;
   for ( auto const &file_name : partial_index_file_names ) {
-    index[i].open( file_name.c_str() );
-    if ( !index[i] ) {
+    if ( !word[i].open( file_name.c_str(), i < partial_file_maps.size() ) ) {
       error() << "can not reopen temp. file \"" << file_name << '"'
-              << error_string( index[i].error() );
+              << error_string( word[i].error() );
       ::exit( Exit_No_Open_Temp );
     }
-    words[i].set_index_file( index[i], index_segment::isi_word );
+    if ( word[i].compressed() ) {
+      num_compressed_bytes += word[i].file_size();
+      num_uncompressed_bytes += word[i].raw_size();
+    }
     ++i;
   } // for
 
+  if ( verbosity > 1 && num_compressed_bytes )
+    cout << me << ": compressed partial indicies: "
+         << num_compressed_bytes << " bytes written, "
+         << num_uncompressed_bytes - num_compressed_bytes << " bytes saved\n";
+
   ////////// Must determine the number of unique words first //////////////////
 
   if ( verbosity > 1 )
@@ -714,57 +1518,64 @@ void merge_indicies( ostream &o ) {
 
   for ( i = 0; i < partial_index_file_names.size(); ++i ) {
     // Start off assuming that all the words are unique.
-    num_unique_words += words[i].size();
-    word[i] = words[i].begin();
+    num_unique_words += word[i].size();
   } // for
 
+  //
+  // Unlike when merging below, every word is checked, including those
+  // remaining in the last non-exhausted index, since any of them can be too
+  // frequent.
+  //
+  vector<size_t> same;                  // indicies the least word is in
   while ( true ) {
 
-    // Find at least two non-exhausted indicies noting the first.
-    int n = 0;
-    for ( j = 0; j < partial_index_file_names.size(); ++j ) {
-      if ( word[j] != words[j].end() ) {
-        if ( !n++ )
-          i = j;
-        else if ( n >= 2 )
-          break;
-      }
-    } // for
-    if ( n < 2 )                        // couldn't find at least 2
+    // Find the first non-exhausted index.
+    for ( i = 0; i < partial_index_file_names.size(); ++i )
+      if ( !word[i].at_end() )
+        break;
+    if ( i == partial_index_file_names.size() )
       break;
 
     // Find the lexographically least word.
     for ( j = i + 1; j < partial_index_file_names.size(); ++j )
-      if ( word[j] != words[j].end() )
+      if ( !word[j].at_end() )
         if ( ::strcmp( *word[j], *word[i] ) < 0 )
           i = j;
 
-    file_list const list( word[i] );
-    int file_count = list.size();
-
-    // See if there are any duplicates and eliminate them.
+    // See if there are any duplicates and add up their file counts.
+    same.clear();
+    same.push_back( i );
+    int file_count = count_files( i );
     for ( j = i + 1; j < partial_index_file_names.size(); ++j ) {
-      if ( word[j] != words[j].end() && !::strcmp( *word[j], *word[i] ) ) {
-        //
-        // The two words are the same: add the second word's file count to that
-        // of the first.
-        //
+      if ( !word[j].at_end() && !::strcmp( *word[j], *word[i] ) ) {
         --num_unique_words;
-        file_list const list( word[j] );
-        file_count += list.size();
-        ++word[j];
+        same.push_back( j );
+        file_count += count_files( j );
       }
     } // for
 
-    if ( is_too_frequent( *word[i], file_count ) ) {
+    if ( !file_count ) {
+      //
+      // The word is only in files dropped from old segments.
+      //
+      dropped_words.insert( new_strdup( *word[i] ) );
+      --num_unique_words;
+    } else if ( contains( kept_too_frequent_words, *word[i] ) ||
+                is_too_frequent( *word[i], file_count ) ) {
       //
       // The word occurs too frequently: consider it a stop word.
       //
-      stop_words->insert( *word[i] );
+      stop_words->insert( new_strdup( *word[i] ) );
+      if ( store_frequent_words ) {
+        vector<word_info::file> &files = too_frequent_words[ *word[i] ];
+        for ( auto const k : same )
+          collect_files( k, *word[k], files );
+      }
       --num_unique_words;
     }
 
-    ++word[i];
+    for ( auto const k : same )
+      ++word[k];
   } // while
 
   ////////// Write index file header //////////////////////////////////////////
@@ -779,7 +1590,7 @@ void merge_indicies( ostream &o ) {
     cout << '\n' << me << ": merging partial indicies..." << flush;
 
   for ( i = 0; i < partial_index_file_names.size(); ++i )
-    word[i] = words[i].begin();         // reset all iterators
+    word[i].rewind();
   int word_index = 0;
   while ( true ) {
 
@@ -788,10 +1599,10 @@ void merge_indicies( ostream &o ) {
     // Find at least two non-exhausted indicies noting the first.
     int n = 0;
     for ( j = 0; j < partial_index_file_names.size(); ++j ) {
-      for ( ; word[j] != words[j].end(); ++word[j] )
-        if ( !contains( *stop_words, *word[j] ) )
+      for ( ; !word[j].at_end(); ++word[j] )
+        if ( !is_skipped( *word[j] ) )
             break;
-      if ( word[j] != words[j].end() ) {
+      if ( !word[j].at_end() ) {
         if ( !n++ )
           i = j;
         else if ( n >= 2 )
@@ -803,22 +1614,38 @@ void merge_indicies( ostream &o ) {
 
     // Find the lexographically least word.
     for ( j = i + 1; j < partial_index_file_names.size(); ++j )
-      if ( word[j] != words[j].end() )
+      if ( !word[j].at_end() )
         if ( ::strcmp( *word[j], *word[i] ) < 0 )
           i = j;
 
     word_offset[ word_index++ ] = o.tellp();
     o << *word[i] << '\0' << assert_stream;
 
+    if ( rebuilding ) {
+      vector<word_info::file> files;
+      for ( j = i; j < partial_index_file_names.size(); ++j ) {
+        if ( word[j].at_end() )
+          continue;
+        if ( ::strcmp( *word[j], *word[i] ) )
+          continue;
+        collect_files( j, *word[j], files );
+        if ( j != i )
+          ++word[j];
+      } // for
+      write_file_entries( o, files );
+      ++word[i];
+      continue;
+    }
+
     ////////// Calc. total occurrences in all indicies ////////////////////////
 
     int total_occurrences = 0;
     for ( j = i; j < partial_index_file_names.size(); ++j ) {
-      if ( word[j] == words[j].end() )
+      if ( word[j].at_end() )
         continue;
       if ( ::strcmp( *word[j], *word[i] ) )
         continue;
-      for ( auto const &file : file_list( word[j] ) )
+      for ( auto const &file : file_list( *word[ j ] ) )
         total_occurrences += file.occurrences_;
     } // for
     double const factor = (double)Rank_Factor / total_occurrences;
@@ -827,11 +1654,11 @@ void merge_indicies( ostream &o ) {
 
     bool continues = false;
     for ( j = i; j < partial_index_file_names.size(); ++j ) {
-      if ( word[j] == words[j].end() )
+      if ( word[j].at_end() )
         continue;
       if ( ::strcmp( *word[j], *word[i] ) )
         continue;
-      for ( auto const &file : file_list( word[j] ) ) {
+      for ( auto const &file : file_list( *word[ j ] ) ) {
         if ( continues )
           o << Word_Entry_Continues_Marker << assert_stream;
         else
@@ -861,20 +1688,27 @@ void merge_indicies( ostream &o ) {
   ////////// Copy remaining words from last non-exhausted index ///////////////
 
   for ( j = 0; j < partial_index_file_names.size(); ++j ) {
-    if ( word[j] == words[j].end() )
+    if ( word[j].at_end() )
       continue;
 
-    for ( ; word[j] != words[j].end(); ++word[j] ) {
-      if ( contains( *stop_words, *word[j] ) )
+    for ( ; !word[j].at_end(); ++word[j] ) {
+      if ( is_skipped( *word[j] ) )
         continue;
 
       word_offset[ word_index++ ] = o.tellp();
       o << *word[j] << '\0' << assert_stream;
 
+      if ( rebuilding ) {
+        vector<word_info::file> files;
+        collect_files( j, *word[j], files );
+        write_file_entries( o, files );
+        continue;
+      }
+
       ////////// Calc. total occurrences in all indicies //////////////////////
 
       int total_occurrences = 0;
-      file_list const list( word[j] );
+      file_list const list( *word[j] );
       for ( auto const &file : list )
         total_occurrences += file.occurrences_;
       double const factor = (double)Rank_Factor / total_occurrences;
@@ -934,11 +1768,17 @@ void rank_full_index() {
   for ( auto w = words.begin(); w != words.end(); ) {
     word_info &info = w->second;
 
-    if ( is_too_frequent( w->first.c_str(), info.files_.size() ) ) {
+    if ( contains( kept_too_frequent_words, w->first.c_str() ) ||
+         is_too_frequent( w->first.c_str(), info.files_.size() ) ) {
       //
       // The word occurs too frequently: consider it a stop word.
       //
       stop_words->insert( new_strdup( w->first.c_str() ) );
+      if ( store_frequent_words )
+        too_frequent_words[ w->first ].assign(
+          make_move_iterator( info.files_.begin() ),
+          make_move_iterator( info.files_.end() )
+        );
       words.erase( w++ );
       continue;
     } // for
@@ -956,6 +1796,93 @@ void rank_full_index() {
     cout << '\n';
 }
 
+/**
+ * The first line of a checkpoint file that identifies it as such.
+ */
+static char const Checkpoint_Magic[] = "SWISH++ checkpoint";
+
+/**
+ * Gets the full path of the checkpoint file.
+ *
+ * @return Returns said path.
+ */
+static string checkpoint_file_name() {
+  string path( checkpoint_dir );
+  if ( *path.rbegin() != '/' )
+    path += '/';
+  return path + "checkpoint";
+}
+
+/**
+ * Reads the checkpoint recorded by \c write_checkpoint() restoring the
+ * directories, files, meta names, and partial indices so that indexing can
+ * resume.  The files already indexed will be skipped.
+ *
+ * @return Returns \c true only if there was a checkpoint to resume from.
+ */
+static bool read_checkpoint() {
+  string const path = checkpoint_file_name();
+  ifstream in( path.c_str(), ios::in | ios::binary );
+  if ( !in )
+    return false;
+
+  string line;
+  if ( !getline( in, line ) || line != Checkpoint_Magic ) {
+    error() << '"' << path << "\": not a checkpoint file\n";
+    ::exit( Exit_No_Read_Index );
+  }
+
+  size_t num_dirs, num_files, num_meta_names;
+  in >> num_temp_files >> num_total_words >> num_indexed_words;
+
+  in >> num_dirs;
+  in.get();
+  for ( size_t i = 0; i < num_dirs && getline( in, line, '\0' ); ++i )
+    check_add_directory( new_strdup( line.c_str() ) );
+
+  in >> num_meta_names;
+  for ( size_t i = 0; i < num_meta_names; ++i ) {
+    int meta_id;
+    in >> meta_id;
+    in.get();
+    if ( !getline( in, line, '\0' ) )
+      break;
+    meta_name_id_map[ new_strdup( line.c_str() ) ] =
+      static_cast<meta_id_type>( meta_id );
+  } // for
+
+  in >> num_files;
+  if ( files_reserve <= num_files )
+    files_reserve = files_grow( static_cast<int>( num_files ) );
+  for ( size_t i = 0; i < num_files; ++i ) {
+    unsigned dir_index, num_words;
+    size_t size;
+    time_t mtime;
+    ino_t inode;
+    string title;
+    in >> dir_index >> size >> mtime >> inode >> num_words;
+    in.get();
+    if ( !getline( in, line, '\0' ) || !getline( in, title, '\0' ) )
+      break;
+    new file_info(
+      line.c_str(), dir_index, size, mtime, inode, title.c_str(), num_words
+    );
+  } // for
+
+  if ( !in ) {
+    error() << '"' << path << "\": checkpoint file is corrupt\n";
+    ::exit( Exit_No_Read_Index );
+  }
+
+  for ( int i = 0; i < num_temp_files; ++i )
+    partial_index_file_names.push_back( temp_file_name_prefix + itoa( i ) );
+
+  if ( verbosity > 1 )
+    cout << me << ": resuming after " << file_info::num_files()
+         << " files\n";
+  return true;
+}
+
 /**
  * Removes the temporary partial index files.  This function is called via
  * \c atexit(3).
@@ -965,10 +1892,94 @@ void rank_full_index() {
  * linkage.
  */
 void remove_temp_files( void ) {
+  if ( *checkpoint_dir ) {
+    //
+    // Keep the partial indices for resuming; remove_checkpoint() removes
+    // them once the index has been written.
+    //
+    return;
+  }
+  for ( int i = 0; i < num_temp_files; ++i ) {
+    string const temp_file_name = temp_file_name_prefix + itoa( i );
+    ::unlink( temp_file_name.c_str() );
+  } // for
+}
+
+/**
+ * Removes the checkpoint and the partial index files once the index has been
+ * written successfully.
+ */
+static void remove_checkpoint() {
   for ( int i = 0; i < num_temp_files; ++i ) {
     string const temp_file_name = temp_file_name_prefix + itoa( i );
     ::unlink( temp_file_name.c_str() );
   } // for
+  ::unlink( checkpoint_file_name().c_str() );
+}
+
+/**
+ * Removes the files of old segments that were merged, i.e., are no longer
+ * part of the index, including their tombstone files.
+ *
+ * @param manifest The manifest the segments were read from.
+ */
+static void remove_old_segments( index_manifest const &manifest ) {
+  for ( auto const &s : old_segments ) {
+    if ( s.partial == -1 )
+      continue;
+    ::unlink( manifest.path_of( s.file ).c_str() );
+    if ( !s.tombstones_file.empty() )
+      ::unlink( manifest.path_of( s.tombstones_file ).c_str() );
+  } // for
+}
+
+/**
+ * Records a checkpoint just after a partial index has been written: the
+ * directories, files, and meta names so far and the number of partial
+ * indices.  Every file recorded has all its words in the partial indices.  The
+ * checkpoint file is replaced atomically.
+ *
+ * @param state The state to record.
+ */
+static void write_checkpoint( checkpoint const &state ) {
+  string const path = checkpoint_file_name();
+  string const temp_path = path + ".tmp";
+  ofstream o( temp_path.c_str(), ios::out | ios::binary );
+  if ( !o ) {
+    error() << "can not write checkpoint file \"" << temp_path << "\"\n";
+    ::exit( Exit_No_Write_Temp );
+  }
+
+  o << Checkpoint_Magic << '\n'
+    << state.num_partials << ' ' << state.num_total_words << ' '
+    << state.num_indexed_words << '\n';
+
+  vector<char const*> dir_list( dir_set.size() );
+  for ( auto const &dir : dir_set )
+    dir_list[ dir.second ] = dir.first;
+  o << dir_list.size() << '\n';
+  for ( auto const &dir : dir_list )
+    o << dir << '\0';
+
+  o << meta_name_id_map.size() << '\n';
+  for ( auto const &m : meta_name_id_map )
+    o << m.second << ' ' << m.first << '\0';
+
+  o << state.num_files << '\n';
+  for ( size_t i = 0; i < state.num_files; ++i ) {
+    file_info const *const fi = file_info::ith_info( i );
+    o << fi->dir_index() << ' ' << fi->size() << ' '
+      << fi->mtime() << ' ' << fi->inode() << ' '
+      << fi->num_words() << ' '
+      << fi->path_name() << '\0' << fi->title() << '\0';
+  } // for
+
+  o.close();
+  if ( !o || ::rename( temp_path.c_str(), path.c_str() ) == -1 ) {
+    error() << "can not write checkpoint file \"" << path << '"'
+            << error_string( errno );
+    ::exit( Exit_No_Write_Temp );
+  }
 }
 
 /**
@@ -996,8 +2007,54 @@ static void write_dir_index( ostream &o, off_t *offset ) {
   } // for
 }
 
+/**
+ * When merging old segments (or writing a word that occurs too frequently),
+ * writes the merged file list of a word: sorts the files by file index (since
+ * those copied from old segments are interleaved with new ones) and computes
+ * their ranks.
+ *
+ * @param o The ostream to write the index to.
+ * @param files The files the word is in.
+ */
+static void write_file_entries( ostream &o, vector<word_info::file> &files ) {
+  ::sort(
+    files.begin(), files.end(),
+    []( word_info::file const &i, word_info::file const &j ) {
+      return i.index_ < j.index_;
+    }
+  );
+
+  int total_occurrences = 0;
+  for ( auto const &file : files )
+    total_occurrences += file.occurrences_;
+  double const factor = (double)Rank_Factor / total_occurrences;
+
+  bool continues = false;
+  for ( auto const &file : files ) {
+    if ( continues )
+      o << Word_Entry_Continues_Marker << assert_stream;
+    else
+      continues = true;
+
+    o << vlq::encode( file.index_ )
+      << vlq::encode( file.occurrences_ )
+      << vlq::encode( rank_word( file.index_, file.occurrences_, factor ) )
+      << assert_stream;
+
+    if ( !file.meta_ids_.empty() )
+      file.write_meta_ids( o );
+#ifdef WITH_WORD_POS
+    if ( !file.pos_deltas_.empty() )
+      file.write_word_pos( o );
+#endif /* WITH_WORD_POS */
+  } // for
+  o << Stop_Marker << assert_stream;
+}
+
 /**
  * Writes the file index to the given ostream recording the offsets as it goes.
+ * Each entry ends with the file's modification time and i-node number for
+ * rebuilding and incremental indexing.
  *
  * @param o The ostream to write the index to.
  * @param offset A pointer to a built-in vector where to record the offsets.
@@ -1011,6 +2068,8 @@ static void write_file_index( ostream &o, off_t *offset ) {
       << vlq::encode( (*fi)->size() )
       << vlq::encode( (*fi)->num_words() )
       << (*fi)->title() << '\0'
+      << vlq::encode( (*fi)->mtime() )
+      << vlq::encode( (*fi)->inode() )
       << assert_stream;
   } // for
 }
@@ -1033,7 +2092,7 @@ static void write_full_index( ostream &o ) {
 #include "index_header.cpp"
 #undef SWISHXX_WRITE_HEADER
 
-  write_word_index     ( o, word_offset );
+  write_word_index     ( o, words, word_offset );
   write_stop_word_index( o, stop_word_offset );
   write_dir_index      ( o, dir_offset );
   write_file_index     ( o, file_offset );
@@ -1047,6 +2106,63 @@ static void write_full_index( ostream &o ) {
     cout << '\n';
 }
 
+/**
+ * When indexing incrementally, writes the manifest of the index: the old
+ * segments that were kept (with new tombstone files for those that got new
+ * tombstones) followed by the new segment.  Since the manifest is replaced
+ * atomically, searches in progress are unaffected.  The files of old segments
+ * that were merged are then removed.
+ *
+ * @param path The full path of the manifest.
+ * @param manifest The manifest the old segments were read from.
+ * @param new_segment_name The name of the new segment relative to the
+ * manifest.
+ */
+static void write_manifest( char const *path, index_manifest &manifest,
+                            string const &new_segment_name ) {
+  vector<string> obsolete_files;
+  index_manifest::segment_list segments;
+
+  for ( auto &s : old_segments ) {
+    if ( s.partial != -1 )
+      continue;
+    if ( s.tombstones_changed ) {
+      if ( !s.tombstones_file.empty() )
+        obsolete_files.push_back( s.tombstones_file );
+      s.tombstones_file = manifest.new_file_name( ".del" );
+      string const tombstones_path = manifest.path_of( s.tombstones_file );
+      if ( !write_tombstones( tombstones_path.c_str(), s.tombstones ) ) {
+        error() << "can not write tombstones to \"" << tombstones_path
+                << '"' << error_string( errno );
+        ::exit( Exit_No_Write_Index );
+      }
+    }
+    segments.push_back( { s.file, s.tombstones_file } );
+  } // for
+
+  //
+  // The new segment may be empty if no files were added or changed.
+  //
+  string const new_segment_path = manifest.path_of( new_segment_name );
+  if ( file_info::num_files() && file_exists( new_segment_path ) &&
+       file_size() > 0 ) {
+    segments.push_back( { new_segment_name, "" } );
+  } else {
+    obsolete_files.push_back( new_segment_name );
+  }
+
+  manifest.segments = segments;
+  if ( !manifest.write( path ) ) {
+    error() << "can not write index manifest to \"" << path << '"'
+            << error_string( errno );
+    ::exit( Exit_No_Write_Index );
+  }
+
+  for ( auto const &file : obsolete_files )
+    ::unlink( manifest.path_of( file ).c_str() );
+  remove_old_segments( manifest );
+}
+
 /**
  * Writes the meta name index to the given ostream recording the offsets as it
  * goes.
@@ -1070,7 +2186,9 @@ static void write_meta_name_index( ostream &o, off_t *offset ) {
  *    off_t word_offset[ num_words ];
  *          (word index)
  * \endcode
- * The partial word index is in the same format as the complete index.
+ * The partial word index is in the same format as the complete index.  If
+ * compressing partial indices, the format is instead that described for
+ * compressed_partial_writer.
  */
 static void write_partial_index() {
   string const temp_file_name =
@@ -1085,7 +2203,87 @@ static void write_partial_index() {
   if ( verbosity > 1 )
     cout << '\n' << me << ": writing partial index..." << flush;
 
-  long const num_words = words.size();
+  checkpoint const state = {
+    num_temp_files, file_info::num_files(), num_total_words, num_indexed_words
+  };
+
+#ifdef MULTI_THREADED
+  //
+  // Hand the words off to a background thread to write (and free) while
+  // indexing continues into an empty word map, but not too many at once.
+  //
+  wait_partial_indices( Partial_Writes_Max - 1 );
+  unique_ptr<word_map> partial_words( new word_map );
+  partial_words->swap( words );
+  pending_partial_indices.push_back( {
+    async( launch::async,
+      [ o = std::move( o ), partial_words = std::move( partial_words ) ]()
+      mutable {
+        write_partial_words( o, *partial_words );
+        o.close();
+      }
+    ),
+    state
+  } );
+#else
+  write_partial_words( o, words );
+  words.clear();
+  o.close();
+  if ( *checkpoint_dir )
+    write_checkpoint( state );
+#endif /* MULTI_THREADED */
+
+  if ( verbosity > 1 )
+    cout << "\n\n";
+}
+
+/**
+ * Waits for partial indices being written in the background to finish until
+ * at most a given number remain, recording a checkpoint for each one that
+ * finished (if recording checkpoints).
+ *
+ * @param max_pending The maximum number that may remain.
+ */
+static void wait_partial_indices( [[maybe_unused]] size_t max_pending ) {
+#ifdef MULTI_THREADED
+  while ( !pending_partial_indices.empty() ) {
+    pending_partial_index &pending = pending_partial_indices.front();
+    if ( pending_partial_indices.size() <= max_pending &&
+         pending.written.wait_for( chrono::seconds::zero() ) !=
+           future_status::ready ) {
+      break;
+    }
+    pending.written.get();
+    if ( *checkpoint_dir )
+      write_checkpoint( pending.state );
+    pending_partial_indices.pop_front();
+  } // while
+#endif /* MULTI_THREADED */
+}
+
+/**
+ * Writes the words of a partial index, compressed if so configured.
+ *
+ * @param o The ostream to write the partial index to.
+ * @param partial_words The words to write.
+ */
+static void write_partial_words( ostream &o, word_map const &partial_words ) {
+  long const num_words = partial_words.size();
+
+#ifdef HAVE_LIBZ
+  if ( compress_partials ) {
+    compressed_partial_writer writer( o, num_words );
+    ostringstream entry;
+    for ( auto const &w : partial_words ) {
+      entry.str( "" );
+      write_word_entry( entry, w );
+      writer.add( entry.str() );
+    } // for
+    writer.close();
+    return;
+  }
+#endif /* HAVE_LIBZ */
+
   off_t *const word_offset = new off_t[ num_words ];
 
   // Write dummy data as a placeholder until the offsets are computed.
@@ -1093,31 +2291,30 @@ static void write_partial_index() {
   streampos const word_offset_pos = o.tellp();
   my_write( o, word_offset, num_words * sizeof( word_offset[0] ) );
 
-  write_word_index( o, word_offset );
+  write_word_index( o, partial_words, word_offset );
 
   // Go back and write the computed offsets.
   o.seekp( word_offset_pos );
   my_write( o, word_offset, num_words * sizeof( word_offset[0] ) );
 
   delete[] word_offset;
-  words.clear();
-
-  if ( verbosity > 1 )
-    cout << "\n\n";
 }
 
 /**
  * Writes the stop-word index to the given ostream recording the offsets as it
- * goes.
+ * goes.  Each word that occurs too frequently is followed by its file list.
  *
  * @param o The ostream to write the index to.
  * @param offset A pointer to a built-in vector where to record the offsets.
  */
 static void write_stop_word_index( ostream &o, off_t *offset ) {
   int word_index = 0;
-  for ( auto word : *stop_words ) {
+  for ( auto word : stop_words->sorted() ) {
     offset[ word_index++ ] = o.tellp();
     o << word << '\0' << assert_stream;
+    auto const found = too_frequent_words.find( word );
+    if ( found != too_frequent_words.end() )
+      write_file_entries( o, found->second );
   }
 }
 
@@ -1125,34 +2322,46 @@ static void write_stop_word_index( ostream &o, off_t *offset ) {
  * Writes the word index to the given ostream recording the offsets as it goes.
  *
  * @param o The ostream to write the index to.
+ * @param word_table The words to write.
  * @param offset A pointer to a built-in vector where to record the offsets.
  */
-static void write_word_index( ostream &o, off_t *offset ) {
+static void write_word_index( ostream &o, word_map const &word_table,
+                              off_t *offset ) {
   int word_index = 0;
-  for ( auto w : words ) {
+  for ( auto const &w : word_table ) {
     offset[ word_index++ ] = o.tellp();
-    o << w.first << '\0' << assert_stream;
-    bool continues = false;
-    word_info const &info = w.second;
-    for ( auto file : info.files_ ) {
-      if ( continues )
-        o << Word_Entry_Continues_Marker << assert_stream;
-      else
-        continues = true;
-      o << vlq::encode( file.index_ )
-        << vlq::encode( file.occurrences_ )
-        << vlq::encode( file.rank_ )
-        << assert_stream;
-      if ( !file.meta_ids_.empty() )
-        file.write_meta_ids( o );
+    write_word_entry( o, w );
+  }
+}
+
+/**
+ * Writes a single word and its file list to the given ostream.
+ *
+ * @param o The ostream to write the entry to.
+ * @param w The word and its information.
+ */
+static void write_word_entry( ostream &o, word_map::value_type const &w ) {
+  o << w.first << '\0' << assert_stream;
+  bool continues = false;
+  word_info const &info = w.second;
+  for ( auto const &file : info.files_ ) {
+    if ( continues )
+      o << Word_Entry_Continues_Marker << assert_stream;
+    else
+      continues = true;
+    o << vlq::encode( file.index_ )
+      << vlq::encode( file.occurrences_ )
+      << vlq::encode( file.rank_ )
+      << assert_stream;
+    if ( !file.meta_ids_.empty() )
+      file.write_meta_ids( o );
 #ifdef WITH_WORD_POS
-      if ( !file.pos_deltas_.empty() )
-        file.write_word_pos( o );
+    if ( !file.pos_deltas_.empty() )
+      file.write_word_pos( o );
 #endif /* WITH_WORD_POS */
-    } // for
-
-    o << Stop_Marker << assert_stream;
   } // for
+
+  o << Stop_Marker << assert_stream;
 }
 
 /**
@@ -1175,24 +2384,34 @@ static ostream& usage( ostream &o ) {
   "-F n   | --files-reserve n  : Reserve space for number of files [default: " << FilesReserve_Default << "]\n"
   "-g n   | --files-grow n     : Number or percentage to grow by [default: " << FilesGrow_Default << "]\n"
   "-i f   | --index-file f     : Name of index file to use [default: " << IndexFile_Default << "]\n"
-  "-I     | --incremental      : Add files/words to index [default: replace]\n"
+  "-I     | --incremental      : Add a segment to index [default: replace]\n"
+  "-J     | --merge            : Merge the given indices into one\n"
+  "-k d   | --checkpoint-dir d : Record checkpoints in directory [default: none]\n"
+  "-K     | --resume           : Resume from the last checkpoint\n"
 #ifndef PJL_NO_SYMBOLIC_LINKS
   "-l     | --follow-links     : Follow symbolic links [default: don't]\n"
 #endif
   "-m m   | --meta m           : Meta name to index [default: all]\n"
   "-M m   | --no-meta m        : Meta name not to index [default: none]\n"
+  "-O     | --optimize         : Merge all index segments into one\n"
   "-p n   | --word-percent n   : Word/file percentage [default: 100]\n"
 #ifndef WITH_WORD_POS
   "-P     | --no-pos-data      : Don't store word position data [default: do]\n"
 #endif /* WITH_WORD_POS */
+  "-Q     | --store-frequent   : Store files of too-frequent words [default: don't]\n"
   "-r     | --no-recurse       : Don't index subdirectories [default: do]\n"
+  "-R     | --rebuild          : Reindex only changed files [default: all]\n"
   "-s f   | --stop-file f      : Stop-word file to use instead of built-in default\n"
   "-S     | --dump-stop        : Dump built-in stop-words, exit\n"
   "-t n   | --title-lines n    : Lines to look for titles [default: " << TitleLines_Default << "]\n"
   "-T d   | --temp-dir d       : Directory for temporary files [default: " << TempDirectory_Default << "]\n"
   "-v n   | --verbosity n      : Verbosity level [0-4; default: 0]\n"
   "-V     | --version          : Print version number, exit\n"
-  "-W n   | --word-threshold n : Words to make partial indicies [default: " << WordThreshold_Default << "]\n";
+  "-W n   | --word-threshold n : Words to make partial indicies [default: " << WordThreshold_Default << "]\n"
+#ifdef HAVE_LIBZ
+  "-z     | --compress-partials : Compress partial indicies [default: don't]\n"
+#endif /* HAVE_LIBZ */
+  ;
   indexer::all_mods_usage( o );
   ::exit( Exit_Usage );
   return o;                             // just to make the compiler happy
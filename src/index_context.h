@@ -0,0 +1,282 @@
+/*
+**      SWISH++
+**      src/index_context.h
+**
+**      Copyright (C) 2026  Paul J. Lucas
+**
+**      This program is free software; you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation; either version 2 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program; if not, write to the Free Software
+**      Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#ifndef index_context_H
+#define index_context_H
+
+// local
+#include "config.h"
+#include "encoded_char.h"
+#include "indexer.h"
+#include "pjl/mmap_file.h"
+#include "word_info.h"
+
+// standard
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>                      /* for pair */
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * An %index_context holds all the state of indexing a single file: the word
+ * table words are added to, the counts and position of words, decoders'
+ * state, and the state of the indexing modules used for the file.  Since
+ * indexers are singletons, they keep no per-file state of their own; hence
+ * different files can be indexed simultaneously by different threads, each
+ * having its own %index_context (and word table).
+ *
+ * It also holds the title of the file: rather than scanning the beginning of
+ * the file for its title separately, an indexing module can report the title
+ * via title() as a side effect of parsing the file for words.
+ */
+class index_context {
+public:
+  /**
+   * A %module_state is the base class of the per-file state of an indexing
+   * module.
+   */
+  struct module_state {
+    virtual ~module_state() = default;
+  };
+
+  /**
+   * Constructs an %index_context.
+   *
+   * @param words The word table to add words to.
+   * @param file_index The index of the file being indexed.
+   */
+  index_context( word_map &words, unsigned file_index ) :
+    words_( words ), file_index_( file_index )
+  {
+  }
+
+  index_context( index_context const& ) = delete;
+  index_context& operator=( index_context const& ) = delete;
+
+  /**
+   * Gets the index of the file being indexed.
+   *
+   * @return Returns said index.
+   */
+  unsigned file_index() const {
+    return file_index_;
+  }
+
+  /**
+   * Gets the number of words in the file that were indexed.
+   *
+   * @return Returns said number.
+   */
+  unsigned long num_indexed_words() const {
+    return num_indexed_words_;
+  }
+
+  /**
+   * Gets the number of words in the file, indexed or not.
+   *
+   * @return Returns said number.
+   */
+  unsigned long num_total_words() const {
+    return num_total_words_;
+  }
+
+  /**
+   * Gets the decoders' state for the file.
+   *
+   * @return Returns said state or null if decoding isn't compiled in.
+   */
+  encoded_char_range::decoder_state* decoders() {
+#ifdef WITH_DECODING
+    return &decoders_;
+#else
+    return nullptr;
+#endif /* WITH_DECODING */
+  }
+
+  /**
+   * Resets the decoders' state to what it is at the beginning of a file.
+   */
+  void reset_decoders() {
+#ifdef WITH_DECODING
+    decoders_.reset();
+#endif /* WITH_DECODING */
+  }
+
+  /**
+   * Gets the beginning of the file being indexed.
+   *
+   * @return Returns said beginning.
+   */
+  char const* file_begin() const {
+    return file_begin_;
+  }
+
+  /**
+   * Gets the end of the file being indexed.
+   *
+   * @return Returns said end.
+   */
+  char const* file_end() const {
+    return file_end_;
+  }
+
+  /**
+   * Gets the number of newlines from the beginning of the file up to a given
+   * position, but stops counting once there are more than a given maximum.
+   * This is used to check whether a title is within the first TitleLines
+   * lines of the file.
+   *
+   * @param pos The position within the file.
+   * @param max The maximum number of newlines to count.
+   * @return Returns said number or \a max + 1 if there are more.
+   */
+  unsigned newlines_before( char const *pos, unsigned max ) const;
+
+  /**
+   * Gets whether an indexing module should report the title of the file via
+   * title(), i.e., it's the module indexing the whole file and it hasn't
+   * reported the title yet.
+   *
+   * @param mod The indexing module.
+   * @return Returns \c true only if it should.
+   */
+  bool wants_title( indexer const *mod ) const {
+    return mod == title_mod_ && !title_reported_;
+  }
+
+  /**
+   * Reports the title of the file.  Only the first report is used.
+   *
+   * @param title The title (that is copied) or null if the file has none.
+   */
+  void title( char const *title ) {
+    if ( title_reported_ )
+      return;
+    title_reported_ = true;
+    if ( (has_title_ = title != nullptr) )
+      title_ = title;
+  }
+
+  /**
+   * Gets the title of the file.
+   *
+   * @return Returns said title or null if either the file has none or none
+   * was reported.
+   */
+  char const* title() const {
+    return has_title_ ? title_.c_str() : nullptr;
+  }
+
+  /**
+   * Gets whether the title of the file was reported.
+   *
+   * @return Returns \c true only if it was (even if it was null).
+   */
+  bool title_reported() const {
+    return title_reported_;
+  }
+
+  /**
+   * Gets the state of an indexing module for the file, creating it the first
+   * time.
+   *
+   * @tparam StateType The module's state type derived from module_state.
+   * @param mod The indexing module.
+   * @return Returns said state.
+   */
+  template<typename StateType>
+  StateType& state( indexer const *mod );
+
+private:
+  using module_states = std::vector<
+    std::pair<indexer const*,std::unique_ptr<module_state>>
+  >;
+
+  word_map           &words_;
+  unsigned const      file_index_;
+  unsigned long       num_indexed_words_ = 0;
+  unsigned long       num_total_words_ = 0;
+  int                 suspend_indexing_count_ = 0;
+#ifdef WITH_WORD_POS
+  int                 word_pos_ = 0;
+#endif /* WITH_WORD_POS */
+#ifdef WITH_DECODING
+  encoded_char_range::decoder_state decoders_;
+#endif /* WITH_DECODING */
+  module_states       module_states_;   // few, so a vector is fastest
+  char const         *file_begin_ = nullptr;
+  char const         *file_end_ = nullptr;
+  indexer const      *title_mod_ = nullptr;
+  bool                title_reported_ = false;
+  bool                has_title_ = false;
+  std::string         title_;
+
+  friend class indexer;
+};
+
+////////// Inlines ////////////////////////////////////////////////////////////
+
+template<typename StateType>
+StateType& index_context::state( indexer const *mod ) {
+  for ( auto const &s : module_states_ )
+    if ( s.first == mod )
+      return *static_cast<StateType*>( s.second.get() );
+  module_states_.emplace_back( mod, std::make_unique<StateType>() );
+  return *static_cast<StateType*>( module_states_.back().second.get() );
+}
+
+inline unsigned index_context::newlines_before( char const *pos,
+                                                unsigned max ) const {
+  unsigned n = 0;
+  for ( char const *c = file_begin_; n <= max; ++c, ++n ) {
+    c = static_cast<char const*>( std::memchr( c, '\n', pos - c ) );
+    if ( !c )
+      break;
+  } // for
+  return n;
+}
+
+inline void indexer::index_file( index_context &ctx,
+                                 PJL::mmap_file const &file ) {
+  ctx.suspend_indexing_count_ = 0;
+  ctx.file_begin_ = file.begin();
+  ctx.file_end_ = file.end();
+  ctx.title_mod_ = this;
+  encoded_char_range const e( file.begin(), file.end() );
+  index_words( ctx, e );
+}
+
+inline void indexer::suspend_indexing( index_context &ctx ) {
+  ++ctx.suspend_indexing_count_;
+}
+
+inline void indexer::resume_indexing( index_context &ctx ) {
+  if ( ctx.suspend_indexing_count_ )
+    --ctx.suspend_indexing_count_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif /* index_context_H */
+/* vim:set et sw=2 ts=2: */
@@ -0,0 +1,154 @@
+/*
+**      SWISH++
+**      src/index_manifest.cpp
+**
+**      Copyright (C) 2026  Paul J. Lucas
+**
+**      This program is free software; you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation; either version 2 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program; if not, write to the Free Software
+**      Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+// local
+#include "config.h"
+#include "index_manifest.h"
+#include "util.h"                       /* for pjl_basename() */
+
+// standard
+#include <cerrno>
+#include <cstdio>                       /* for rename(2) */
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>                     /* for unlink(2) */
+
+using namespace std;
+
+/**
+ * The first word of a manifest that identifies it as such.
+ */
+static char const Manifest_Magic[] = "SWISH++ segments";
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool index_manifest::is_manifest( char const *path ) {
+  ifstream in( path, ios::in | ios::binary );
+  char buf[ sizeof Manifest_Magic ];
+  return in.read( buf, sizeof buf - 1 ) &&
+         ::memcmp( buf, Manifest_Magic, sizeof buf - 1 ) == 0;
+}
+
+string index_manifest::new_file_name( char const *suffix ) {
+  ostringstream name;
+  name << base_ << '.' << next_generation++ << suffix;
+  return name.str();
+}
+
+string index_manifest::path_of( string const &name ) const {
+  return dir_.empty() ? name : dir_ + '/' + name;
+}
+
+bool index_manifest::read( char const *path ) {
+  set_path( path );
+
+  ifstream in( path );
+  string line;
+  if ( !getline( in, line ) )
+    return false;
+  size_t const magic_len = sizeof Manifest_Magic - 1;
+  if ( line.compare( 0, magic_len, Manifest_Magic ) )
+    return false;
+  istringstream header( line.substr( magic_len ) );
+  if ( !(header >> next_generation) )
+    return false;
+
+  segments.clear();
+  while ( getline( in, line ) ) {
+    if ( line.empty() )
+      continue;
+    segment s;
+    size_t const tab = line.find( '\t' );
+    s.file = line.substr( 0, tab );
+    if ( tab != string::npos )
+      s.tombstones = line.substr( tab + 1 );
+    segments.push_back( s );
+  } // while
+  return !in.bad();
+}
+
+void index_manifest::set_path( char const *path ) {
+  char const *const base = pjl_basename( path );
+  dir_.assign( path, base > path ? base - path - 1 : 0 );
+  base_ = base;
+}
+
+bool index_manifest::write( char const *path ) {
+  set_path( path );
+
+  //
+  // Fields are separated by a tab and segments by a newline, so file names
+  // can contain spaces, but not those.
+  //
+  for ( auto const &s : segments ) {
+    if ( s.file.find_first_of( "\t\n" ) != string::npos ||
+         s.tombstones.find_first_of( "\t\n" ) != string::npos ) {
+      errno = EINVAL;
+      return false;
+    }
+  } // for
+
+  string const temp_path = string( path ) + ".tmp";
+  {
+    ofstream out( temp_path.c_str() );
+    out << Manifest_Magic << ' ' << next_generation << '\n';
+    for ( auto const &s : segments ) {
+      out << s.file;
+      if ( !s.tombstones.empty() )
+        out << '\t' << s.tombstones;
+      out << '\n';
+    } // for
+    if ( !out.flush() ) {
+      ::unlink( temp_path.c_str() );
+      return false;
+    }
+  }
+  return ::rename( temp_path.c_str(), path ) == 0;
+}
+
+bool read_tombstones( char const *path, size_t num_files,
+                      tombstone_set &tombstones ) {
+  tombstones.assign( num_files, false );
+  ifstream in( path, ios::in | ios::binary );
+  if ( !in )
+    return false;
+  size_t i = 0;
+  for ( char c; i < num_files && in.get( c ); )
+    for ( int bit = 0; bit < 8 && i < num_files; ++bit, ++i )
+      tombstones[i] = (c >> bit) & 1;
+  return true;
+}
+
+bool write_tombstones( char const *path, tombstone_set const &tombstones ) {
+  ofstream out( path, ios::out | ios::binary );
+  for ( size_t i = 0; i < tombstones.size(); i += 8 ) {
+    char c = 0;
+    for ( size_t bit = 0; bit < 8 && i + bit < tombstones.size(); ++bit )
+      if ( tombstones[ i + bit ] )
+        c |= static_cast<char>( 1 << bit );
+    out.put( c );
+  } // for
+  return static_cast<bool>( out.flush() );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/* vim:set et sw=2 ts=2: */
@@ -0,0 +1,148 @@
+/*
+**      SWISH++
+**      src/index_manifest.h
+**
+**      Copyright (C) 2026  Paul J. Lucas
+**
+**      This program is free software; you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation; either version 2 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program; if not, write to the Free Software
+**      Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#ifndef index_manifest_H
+#define index_manifest_H
+
+// local
+#include "config.h"
+
+// standard
+#include <string>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A %tombstone_set marks the files of an index segment that have been deleted
+ * (or replaced by a newer version in a later segment): bit \a i is set only if
+ * the \a i-th file was.
+ */
+using tombstone_set = std::vector<bool>;
+
+/**
+ * An %index_manifest lists the segments of a segmented index.  A segmented
+ * index is a small text file (the manifest) in place of an index file that
+ * names one or more immutable index files (the segments) and, for each, an
+ * optional file of tombstones.  Its format is:
+ * \code
+ *    SWISH++ segments next-generation
+ *    segment-file [<tab> tombstone-file]
+ *    ...
+ * \endcode
+ * File names are relative to the directory the manifest is in.  Since fields
+ * are separated by a tab, file names may contain spaces.  A manifest is
+ * only ever replaced atomically, never modified in place.
+ */
+class index_manifest {
+public:
+  /**
+   * A %segment is a single segment of a segmented index.
+   */
+  struct segment {
+    std::string file;                   // the segment's index file
+    std::string tombstones;             // its tombstone file, if any
+  };
+  using segment_list = std::vector<segment>;
+
+  segment_list  segments;
+  unsigned      next_generation = 1;
+
+  /**
+   * Checks whether a file is a manifest.
+   *
+   * @param path The full path of the file.
+   * @return Returns \c true only if the file exists and is a manifest.
+   */
+  static bool is_manifest( char const *path );
+
+  /**
+   * Gets the path of a file of this manifest.
+   *
+   * @param name The name of the file relative to the manifest.
+   * @return Returns said path.
+   */
+  std::string path_of( std::string const &name ) const;
+
+  /**
+   * Sets the path of the manifest.  This must be called (or \c read() or
+   * \c write() must be) before calling \c path_of() or \c new_file_name().
+   *
+   * @param path The full path of the manifest.
+   */
+  void set_path( char const *path );
+
+  /**
+   * Reads a manifest.
+   *
+   * @param path The full path of the manifest.
+   * @return Returns \c true only if the manifest was read successfully.
+   */
+  bool read( char const *path );
+
+  /**
+   * Writes the manifest.  The manifest is written to a temporary file that
+   * then replaces \a path atomically.
+   *
+   * @param path The full path of the manifest.
+   * @return Returns \c true only if the manifest was written successfully.
+   * It's not if a file name contains a tab or newline.
+   */
+  bool write( char const *path );
+
+  /**
+   * Gets the name of a new file for the manifest and increments the
+   * generation.
+   *
+   * @param suffix The suffix to append to the name, if any.
+   * @return Returns said name relative to the manifest.
+   */
+  std::string new_file_name( char const *suffix = "" );
+
+private:
+  std::string dir_;                     // directory the manifest is in
+  std::string base_;                    // base name of the manifest
+};
+
+/**
+ * Reads a set of tombstones.
+ *
+ * @param path The full path of the tombstone file.
+ * @param num_files The number of files in the segment.
+ * @param tombstones The set to read into.
+ * @return Returns \c true only if the tombstones were read successfully.
+ */
+bool read_tombstones( char const *path, size_t num_files,
+                      tombstone_set &tombstones );
+
+/**
+ * Writes a set of tombstones.
+ *
+ * @param path The full path of the tombstone file.
+ * @param tombstones The set to write.
+ * @return Returns \c true only if the tombstones were written successfully.
+ */
+bool write_tombstones( char const *path, tombstone_set const &tombstones );
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif /* index_manifest_H */
+/* vim:set et sw=2 ts=2: */
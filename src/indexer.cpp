@@ -23,9 +23,10 @@
 #include "config.h"
 #include "indexer.h"
 #include "encoded_char.h"
+#include "encoded_char_dispatch.h"
 #include "ExcludeMeta.h"
-#include "file_info.h"
 #include "IncludeMeta.h"
+#include "index_context.h"
 #include "iso8859-1.h"
 #include "meta_id.h"
 #include "pjl/mmap_file.h"
@@ -42,20 +43,16 @@
 #include <cstring>
 #include <memory>
 #include <ostream>
+#include <vector>
+#ifdef MULTI_THREADED
+#include <mutex>
+#endif /* MULTI_THREADED */
 
 using namespace PJL;
 using namespace std;
 
 ///////////////////////////////////////////////////////////////////////////////
 
-extern unsigned long  num_indexed_words;
-extern unsigned long  num_total_words;
-#ifdef WITH_WORD_POS
-extern int            word_pos;
-#endif /* WITH_WORD_POS */
-extern word_map       words;
-
-int                   indexer::suspend_indexing_count_ = 0;
 indexer*              indexer::text_indexer_ = nullptr;
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -129,6 +126,10 @@ bool indexer::claims_option( option_stream::option const& ) {
 }
 
 meta_id_type indexer::find_meta( char const *meta_name ) {
+#ifdef MULTI_THREADED
+  static mutex meta_mutex;
+  lock_guard<mutex> const lock( meta_mutex );
+#endif /* MULTI_THREADED */
   if ( contains( exclude_meta_names, meta_name ) )
     return Meta_ID_None;
 
@@ -158,20 +159,25 @@ meta_id_type indexer::find_meta( char const *meta_name ) {
   return meta_name_id_map[ new_strdup( meta_name ) ] = meta_id;
 }
 
-char const* indexer::find_title( mmap_file const& ) const {
+bool indexer::find_documents( mmap_file const&, vector<size_t>& ) const {
+  return false;
+}
+
+char const* indexer::find_title( index_context&, mmap_file const& ) const {
   return nullptr;
 }
 
-void indexer::index_word( char *word, size_t len, meta_id_type meta_id ) {
-  ++num_total_words;
+void indexer::index_word( index_context &ctx, char *word, size_t len,
+                          meta_id_type meta_id ) {
+  ++ctx.num_total_words_;
 #ifdef WITH_WORD_POS
-  ++word_pos;
+  ++ctx.word_pos_;
 #endif /* WITH_WORD_POS */
 
   if ( len < Word_Hard_Min_Size )
     return;
 
-  if ( suspend_indexing_count_ > 0 ) {
+  if ( ctx.suspend_indexing_count_ > 0 ) {
     //
     // A derived indexer class has called suspend_indexing(), so do nothing
     // more.
@@ -186,39 +192,26 @@ void indexer::index_word( char *word, size_t len, meta_id_type meta_id ) {
 
   ////////// Strip chars not in Word_Begin_Chars/Word_End_Chars ///////////////
 
-  for ( int i = len - 1; i >= 0; --i ) {
-    if ( is_word_end_char( word[ i ] ) )
-      break;
+  while ( len > 0 && !is_word_end_char( word[ len - 1 ] ) )
     --len;
-  } // for
-  if ( len < Word_Hard_Min_Size )
-    return;
-
-  word[ len ] = '\0';
-
-  while ( *word ) {
-    if ( is_word_begin_char( *word ) )
-      break;
+  while ( len > 0 && !is_word_begin_char( *word ) )
     --len, ++word;
-  } // while
   if ( len < Word_Hard_Min_Size )
     return;
 
   ////////// Stop-word checks /////////////////////////////////////////////////
 
-  if ( !is_ok_word( word ) )
+  char lower_word[ Word_Hard_Max_Size + 1 ];
+  if ( !is_ok_word_to_lower( word, len, lower_word ) )
     return;
-
-  char const *const lower_word = to_lower( word );
-  if ( contains( *stop_words, lower_word ) )
+  if ( stop_words->contains( lower_word ) )
     return;
 
   ////////// Add the word /////////////////////////////////////////////////////
 
-  file_info::inc_words();
-  ++num_indexed_words;
+  ++ctx.num_indexed_words_;
 
-  word_info &wi = words[ lower_word ];
+  word_info &wi = ctx.words_[ lower_word ];
   ++wi.occurrences_;
 
   if ( !wi.files_.empty() ) {
@@ -227,7 +220,7 @@ void indexer::index_word( char *word, size_t len, meta_id_type meta_id ) {
     // THIS file, and, if so, increment the number of occurrences.
     //
     word_info::file &last_file = wi.files_.back();
-    if ( last_file.index_ == file_info::current_index() ) {
+    if ( last_file.index_ == ctx.file_index_ ) {
       ++last_file.occurrences_;
       goto skip_push_back;
     }
@@ -236,7 +229,7 @@ void indexer::index_word( char *word, size_t len, meta_id_type meta_id ) {
   //
   // First time word occurred in current file.
   //
-  wi.files_.push_back( word_info::file( file_info::current_index() ) );
+  wi.files_.push_back( word_info::file( ctx.file_index_ ) );
 
 skip_push_back:
   word_info::file &last_file = wi.files_.back();
@@ -244,16 +237,28 @@ skip_push_back:
     last_file.meta_ids_.insert( meta_id );
 #ifdef WITH_WORD_POS
   if ( store_word_positions )
-    last_file.add_word_pos( word_pos );
+    last_file.add_word_pos( ctx.word_pos_ );
 #endif /* WITH_WORD_POS */
 }
 
-void indexer::index_words( encoded_char_range const &e, meta_id_type meta_id ) {
+/**
+ * Indexes the words in a range of encoded text.  This is a template so that
+ * it can be instantiated for each decoder by dispatch_decoder().
+ *
+ * @tparam CharIterator The type of iterator over the encoded characters.
+ * @param ctx The index_context to use.
+ * @param c An iterator positioned at the first character.
+ * @param meta_id The numeric ID of the meta name the words are indexed
+ * under, if any.
+ */
+template<class CharIterator>
+static void index_encoded_words( index_context &ctx, CharIterator c,
+                                 meta_id_type meta_id ) {
   char  word[ Word_Hard_Max_Size + 1 ];
   bool  in_word = false;
   int   len;
 
-  for ( auto c = e.begin(); !c.at_end(); ) {
+  while ( !c.at_end() ) {
     char const ch = iso8859_1_to_ascii( *c++ );
 
     ////////// Collect a word /////////////////////////////////////////////////
@@ -281,17 +286,45 @@ void indexer::index_words( encoded_char_range const &e, meta_id_type meta_id ) {
       // including, it.
       //
       in_word = false;
-      index_word( word, len, meta_id );
+      indexer::index_word( ctx, word, len, meta_id );
     }
-  } // for
+  } // while
 
   if ( in_word ) {
     //
     // We ran into 'end' while still accumulating characters into a word, so
     // just index what we've got.
     //
-    index_word( word, len, meta_id );
+    indexer::index_word( ctx, word, len, meta_id );
+  }
+}
+
+void indexer::index_words( index_context &ctx, encoded_char_range const &e,
+                           meta_id_type meta_id ) {
+  char  word[ Word_Hard_Max_Size + 1 ];
+
+  if ( !e.needs_decoding() ) {
+    //
+    // The characters need no decoding, so find whole words at a time.
+    //
+    char const *const end = e.end_pos();
+    char const *c = e.begin_pos();
+    while ( (c = skip_non_word_chars( c, end )) != end ) {
+      char const *const word_end = skip_word_chars( c, end );
+      size_t const len = word_end - c;
+      if ( len <= Word_Hard_Max_Size ) {  // else too big: skip it
+        for ( size_t i = 0; i < len; ++i )
+          word[ i ] = iso8859_1_to_ascii( c[ i ] );
+        index_word( ctx, word, len, meta_id );
+      }
+      c = word_end;
+    } // while
+    return;
   }
+
+  dispatch_decoder( e, [&ctx,meta_id]( auto c ) {
+    index_encoded_words( ctx, c, meta_id );
+  } );
 }
 
 indexer::map_type& indexer::map_ref() {
@@ -325,7 +358,7 @@ char* indexer::tidy_title( char const *begin, char const *end ) {
   ++end;
 
   // Squeeze/convert multiple whitespace characters to single spaces.
-  static char title[ Title_Max_Size + 1 ];
+  static thread_local char title[ Title_Max_Size + 1 ];
   int consec_spaces = 0, len = 0;
   while ( begin < end ) {
     char c = *begin++;
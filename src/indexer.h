@@ -36,6 +36,9 @@
 #include <memory>
 #include <ostream>
 #include <string>
+#include <vector>
+
+class index_context;
 
 enum {
   Meta_ID_None        = -1,
@@ -50,7 +53,9 @@ enum {
  *
  * The model used is that singleton instances of indexers are created once at
  * program initialization time and NOT that indexers are created and destroyed
- * for every file indexed.
+ * for every file indexed.  Hence, indexers keep no per-file state: all such
+ * state is in the index_context that's passed to every indexing function so
+ * different files can be indexed simultaneously.
  */
 class indexer {
 public:
@@ -99,41 +104,67 @@ public:
   /**
    * Looks up a meta name to get its associated ID; if it doesn't exist, add
    * it.  However, if the name is either among the set of meta names to exclude
-   * or not among the set to include, forget it.
+   * or not among the set to include, forget it.  This is thread-safe.
    *
    * @param meta_name The meta-name to find.
    * @return Returns the associated meta-ID or Meta_ID_None.
    */
   static meta_id_type find_meta( char const *meta_name );
 
+  /**
+   * Some files contain several documents each of which is to be indexed
+   * separately, e.g., an mbox file contains several mail messages.  By
+   * default, a file is a single document.  If a particular file type can
+   * contain several, the derived %indexer class should override this
+   * function.
+   *
+   * @param file The file to be indexed.
+   * @param offsets The byte offsets of the documents within the file are
+   * appended to it.  The first is always 0 and each document extends to the
+   * next one or the end of the file.
+   * @return Returns \c true only if the file contains more than one document.
+   */
+  virtual bool find_documents( PJL::mmap_file const &file,
+                               std::vector<size_t> &offsets ) const;
+
   /**
    * By default, a file has no title, so the file's base name becomes its
    * title.  If a particular file type can have something better for a title,
-   * the derived %indexer class should override this function.
+   * the derived %indexer class should either report it via
+   * index_context::title() while indexing the file (preferably, so the file
+   * is parsed only once) or override this function.  This is called only if
+   * no title was reported.
    *
+   * @param ctx The context of the file being indexed.
    * @param file The file being indexed.
-   * @return Returns a pointer to a title or null if none.
+   * @return Returns a pointer to a title or null if none.  It remains valid
+   * only until the next call to \c find_title() by the same thread.
    */
-  virtual char const* find_title( PJL::mmap_file const &file ) const;
+  virtual char const* find_title( index_context &ctx,
+                                  PJL::mmap_file const &file ) const;
 
   /**
-   * Indexes the fiven file.
+   * Indexes the given file.  Until this %indexer reports the title of the
+   * file via index_context::title(), index_context::wants_title() returns
+   * \c true for it.
    *
+   * @param ctx The context of the file being indexed.
    * @param file The file to index.
    */
-  void index_file( PJL::mmap_file const &file );
+  void index_file( index_context &ctx, PJL::mmap_file const &file );
 
   /**
    * Once a word has been parsed, this is the function to be called from within
    * index_words() to index it, potentially.  This is not \c virtual
    * intentionally for performance.
    *
+   * @param ctx The context of the file being indexed.
    * @param word The candidate word to be indexed.
    * @param len The length of the word since it is not null-terminated.
    * @param meta_id The numeric ID of the meta name the word, if indexed, is to
    * be associated with.
    */
-  static void index_word( char *word, size_t len,
+  static void index_word( index_context &ctx, char *word, size_t len,
                           meta_id_type meta_id = Meta_ID_None );
 
   /**
@@ -141,11 +172,12 @@ public:
    * given meta ID.  The default indexes a run of plain text.  A derived
    * %indexer will override this.
    *
+   * @param ctx The context of the file being indexed.
    * @param e The encoded text to index.
    * @param meta_id The numeric ID of the meta name the words index are to be
    * associated with.
    */
-  virtual void index_words( encoded_char_range const &e,
+  virtual void index_words( index_context &ctx, encoded_char_range const &e,
                             meta_id_type meta_id = Meta_ID_None );
 
   /**
@@ -167,13 +199,17 @@ protected:
    * Suspend indexing words.  This is useful not to indexed selected portions
    * of files while still going through the motions of collecting word
    * statistics.  Suspend/resume calls may nest.
+   *
+   * @param ctx The context of the file being indexed.
    */
-  static void suspend_indexing();
+  static void suspend_indexing( index_context &ctx );
 
   /**
    * Resume indexing words.
+   *
+   * @param ctx The context of the file being indexed.
    */
-  static void resume_indexing();
+  static void resume_indexing( index_context &ctx );
 
   /**
    * See if an indexing module claims an option.  The default doesn't.  A
@@ -211,7 +247,8 @@ protected:
    *
    * @param begin The pointer to the beginning of the title.
    * @param end The pointer to one past the end of the title.
-   * @return Returns said title.
+   * @return Returns said title.  It remains valid only until the next call by
+   * the same thread.
    */
   static char* tidy_title( char const *begin, char const *end );
 
@@ -236,7 +273,6 @@ private:
   indexer( indexer const& ) = delete;
   indexer& operator=( indexer const& ) = delete;
 
-  static int        suspend_indexing_count_;
   static indexer*   text_indexer_;
 
   static void       init_modules();     // generated by init_modules-sh
@@ -249,25 +285,10 @@ inline indexer* indexer::find_indexer( char const *mod_name ) {
   return map_ref()[ to_lower( mod_name ) ];
 }
 
-inline void indexer::index_file( PJL::mmap_file const &file ) {
-  suspend_indexing_count_ = 0;
-  encoded_char_range const e( file.begin(), file.end() );
-  index_words( e );
-}
-
 inline indexer* indexer::text_indexer() {
   return text_indexer_;
 }
 
-inline void indexer::suspend_indexing() {
-  ++suspend_indexing_count_;
-}
-
-inline void indexer::resume_indexing () {
-  if ( suspend_indexing_count_ )
-    --suspend_indexing_count_;
-}
-
 ///////////////////////////////////////////////////////////////////////////////
 
 #endif /* indexer_H */
@@ -24,17 +24,14 @@
 
 // local
 #include "config.h"
-#include "pjl/less.h"
 
 // standard
-#include <map>
+#include <cstring>
 #include <ostream>
-#include <set>
+#include <utility>                      /* for pair */
 
 ///////////////////////////////////////////////////////////////////////////////
 
-class element_map;
-
 /**
  * An %element contains the information we need about HTML elements.  We only
  * need information about:
@@ -43,42 +40,63 @@ class element_map;
  * 2. For elements with optional end tags, what tags, some possibly from other
  *    elements, close them.
  */
-class element {
-public:
+struct element {
   enum end_tag_type {
     et_forbidden,
     et_optional,
     et_required
   };
 
-  std::set<char const*> close_tags;
-  end_tag_type const end_tag;
+  end_tag_type        end_tag;
+  char const *const  *close_tags;       // [close_tags,close_tags_end)
+  char const *const  *close_tags_end;
 
-private:
-  explicit element( end_tag_type t ) : end_tag( t ) { }
-  friend class element_map;
+  /**
+   * Gets whether a tag closes this element.
+   *
+   * @param tag The tag (in lower case).
+   * @return Returns \c true only if it does.
+   */
+  bool is_closed_by( char const *tag ) const {
+    for ( auto t = close_tags; t != close_tags_end; ++t )
+      if ( !std::strcmp( *t, tag ) )
+        return true;
+    return false;
+  }
 };
 
 /**
- * An %element_map is-a map from the character strings for HTML elements to
- * instances of the element class declared above.
- *
- * @remarks
- * @parblock
- * The only reason for having a derived class rather than a `typedef` is so
- * that we can have a custom constructor that initializes itself.
- *
- * The constructor is private, however, to ensure that only instance() can be
- * called to initialize and access a single, static instance.
- * @endparblock
+ * An %element_map maps the character strings for HTML elements to instances
+ * of the element class declared above.  It's built entirely at compile-time
+ * and uses a perfect hash for look-up.
  */
-class element_map : public std::map<char const*,element> {
+class element_map {
 public:
-  static element_map const& instance();
+  using value_type = std::pair<char const*,element>;
+  using const_iterator = value_type const*;
+
+  element_map() = delete;
 
-private:
   /**
-   * Constructs (initializes) an element_map.
+   * Gets an iterator positioned at the first element (in name order).
+   *
+   * @return Returns said iterator.
+   */
+  static const_iterator begin();
+
+  /**
+   * Gets an iterator positioned one past the last element.
+   *
+   * @return Returns said iterator.
+   */
+  static const_iterator end();
+
+  /**
+   * Finds an element.
+   *
+   * @param name The element's name (in lower case).
+   * @return Returns an iterator positioned at the element or end() if not
+   * found.
    *
    * @sa Shane McCarron, et al.  "XHTML 2.0," World Wide Web Consortium,
    * August 2002.  <http://www.w3.org/TR/xhtml2/>
@@ -93,7 +111,7 @@ private:
    * @sa Netscape Communications Corporation.  "HTML Tag Reference," January
    * 1998.  <http://developer.netscape.com/docs/manuals/htmlguid/index.htm>
    */
-  element_map();
+  static const_iterator find( char const *name );
 };
 
 /**
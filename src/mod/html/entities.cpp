@@ -22,52 +22,57 @@
 // local
 #include "config.h"
 #include "entities.h"
+#include "pjl/perfect_hash.h"
+
+// standard
+#include <utility>                      /* for pair */
+
+using namespace PJL;
 
 ///////////////////////////////////////////////////////////////////////////////
 
-char_entity_map::char_entity_map() :
-  map_{
-    { "amp",    '&' },
-    { "apos",  '\'' },                    // apos is in XHTML
-    { "Aacute", 'A' }, { "aacute", 'a' },
-    { "Acirc",  'A' }, { "acirc",  'a' },
-    { "AElig",  'A' }, { "aelig",  'a' },
-    { "Agrave", 'A' }, { "agrave", 'a' },
-    { "Aring",  'A' }, { "aring",  'a' },
-    { "Atilde", 'A' }, { "atilde", 'a' },
-    { "Auml",   'A' }, { "auml",   'a' },
-    { "Ccedil", 'C' }, { "ccedil", 'c' },
-    { "Eacute", 'E' }, { "eacute", 'e' },
-    { "Ecirc",  'E' }, { "ecirc",  'e' },
-    { "Egrave", 'E' }, { "egrave", 'e' },
-    { "ETH",    'D' }, { "eth",    'd' },
-    { "Euml",   'E' }, { "euml",   'e' },
-    { "Iacute", 'I' }, { "iacute", 'i' },
-    { "Icirc",  'I' }, { "icirc",  'i' },
-    { "Igrave", 'E' }, { "igrave", 'i' },
-    { "Iuml",   'I' }, { "iuml",   'i' },
-    { "Ntilde", 'N' }, { "ntilde", 'n' },
-    { "Oacute", 'O' }, { "oacute", 'o' },
-    { "Ocirc",  'O' }, { "ocirc",  'o' },
-    { "Ograve", 'O' }, { "ograve", 'o' },
-    { "Oslash", 'O' }, { "oslash", 'o' },
-    { "Otilde", 'O' }, { "otilde", 'o' },
-    { "Ouml",   'O' }, { "ouml",   'o' },
-    { "Scaron", 'S' }, { "scaron", 's' }, // in XHTML
-    { "szlig",  's' },
-    { "Uacute", 'U' }, { "uacute", 'u' },
-    { "Ucirc",  'U' }, { "ucirc",  'u' },
-    { "Ugrave", 'U' }, { "ugrave", 'u' },
-    { "Uuml",   'U' }, { "uuml",   'u' },
-    { "Yacute", 'Y' }, { "yacute", 'y' },
-    { "Yuml",   'Y' }, { "yuml",   'y' }
-  }
-{
-}
+static constexpr std::pair<char const*,char> char_entity_table[] = {
+  { "amp",    '&' },
+  { "apos",  '\'' },                    // apos is in XHTML
+  { "Aacute", 'A' }, { "aacute", 'a' },
+  { "Acirc",  'A' }, { "acirc",  'a' },
+  { "AElig",  'A' }, { "aelig",  'a' },
+  { "Agrave", 'A' }, { "agrave", 'a' },
+  { "Aring",  'A' }, { "aring",  'a' },
+  { "Atilde", 'A' }, { "atilde", 'a' },
+  { "Auml",   'A' }, { "auml",   'a' },
+  { "Ccedil", 'C' }, { "ccedil", 'c' },
+  { "Eacute", 'E' }, { "eacute", 'e' },
+  { "Ecirc",  'E' }, { "ecirc",  'e' },
+  { "Egrave", 'E' }, { "egrave", 'e' },
+  { "ETH",    'D' }, { "eth",    'd' },
+  { "Euml",   'E' }, { "euml",   'e' },
+  { "Iacute", 'I' }, { "iacute", 'i' },
+  { "Icirc",  'I' }, { "icirc",  'i' },
+  { "Igrave", 'E' }, { "igrave", 'i' },
+  { "Iuml",   'I' }, { "iuml",   'i' },
+  { "Ntilde", 'N' }, { "ntilde", 'n' },
+  { "Oacute", 'O' }, { "oacute", 'o' },
+  { "Ocirc",  'O' }, { "ocirc",  'o' },
+  { "Ograve", 'O' }, { "ograve", 'o' },
+  { "Oslash", 'O' }, { "oslash", 'o' },
+  { "Otilde", 'O' }, { "otilde", 'o' },
+  { "Ouml",   'O' }, { "ouml",   'o' },
+  { "Scaron", 'S' }, { "scaron", 's' }, // in XHTML
+  { "szlig",  's' },
+  { "Uacute", 'U' }, { "uacute", 'u' },
+  { "Ucirc",  'U' }, { "ucirc",  'u' },
+  { "Ugrave", 'U' }, { "ugrave", 'u' },
+  { "Uuml",   'U' }, { "uuml",   'u' },
+  { "Yacute", 'Y' }, { "yacute", 'y' },
+  { "Yuml",   'Y' }, { "yuml",   'y' }
+};
+
+static constexpr perfect_hash_map char_entities{ char_entity_table };
 
-char_entity_map const& char_entity_map::instance() {
-  static char_entity_map const m;
-  return m;
+char_entity_map::value_type char_entity_map::find( key_type key ) {
+  auto const found = char_entities.find( key );
+  return found != char_entities.end() ? found->second : ' ';
 }
 
 ///////////////////////////////////////////////////////////////////////////////
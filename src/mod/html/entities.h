@@ -24,46 +24,32 @@
 
 // local
 #include "config.h"
-#include "pjl/less.h"
-
-// standard
-#include <map>
 
 ///////////////////////////////////////////////////////////////////////////////
 
 /**
  * A %char_entity_map is used to perform fast look-up of a character entity
- * reference.  It uses <code>char const*</code> to point directly to the
- * C-strings in the \c char_entity_table[] vector; no strings are copied.
- *
- * The contructor is private, however, to ensure that only instance() can
- * be called to initialize and access a single, static instance.
+ * reference.  It's built entirely at compile-time and uses a perfect hash.
  */
 class char_entity_map {
 public:
   using key_type = char const*;
   using value_type = char;
 
-  static char_entity_map const& instance();
-
-  value_type operator[]( key_type key ) const {
-    map_type::const_iterator const found = map_.find( key );
-    return found != map_.end() ? found->second : ' ';
-  }
+  char_entity_map() = delete;
 
-private:
   /**
-   * Constructs (initializes) a %char_entity_map.  Any entity that isn't listed
-   * below will convert to a space.  Note that is isn't necessary to convert
-   * "&lt;" and "&gt;" since such entities aren't indexed anyway.  However, it
-   * is necessary to convert "&amp;" (so it can be part of an acronym like
+   * Looks up a character entity reference.  Any entity that isn't known
+   * converts to a space.  Note that is isn't necessary to convert "&lt;" and
+   * "&gt;" since such entities aren't indexed anyway.  However, it is
+   * necessary to convert "&amp;" (so it can be part of an acronym like
    * "AT&T") and "&apos;" (so it can be part of a contracted word like
    * "can't").
+   *
+   * @param key The name of the entity (case matters).
+   * @return Returns the ASCII equivalent of the entity or ' ' (space) if none.
    */
-  char_entity_map();
-
-  using map_type = std::map<key_type,value_type>;
-  map_type map_;
+  static value_type find( key_type key );
 };
 
 ///////////////////////////////////////////////////////////////////////////////
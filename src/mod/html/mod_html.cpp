@@ -26,9 +26,11 @@
 #include "charsets/unicode.h"
 #include "elements.h"
 #include "encoded_char.h"
+#include "encoded_char_dispatch.h"
 #include "entities.h"
 #include "ExcludeClass.h"
 #include "html_config.h"
+#include "index_context.h"
 #include "indexer.h"
 #include "iso8859-1.h"
 #include "TitleLines.h"
@@ -68,16 +70,18 @@ ExcludeClass exclude_class_names;
 //
 using stack_type = vector<pair<element_map::value_type const*,bool>>;
 
+/**
+ * The per-file state of the HTML indexer.
+ */
+struct HTML_state : index_context::module_state {
+  stack_type element_stack;
+};
+
 // local variables
-static bool       dump_html_elements_opt;
-static stack_type element_stack;
+static bool dump_html_elements_opt;
 
 ////////// local functions ////////////////////////////////////////////////////
 
-inline void new_file() {
-  element_stack.clear();
-}
-
 /**
  * Converts aither a numeric or character entity reference to its ASCII
  * character equivalent (if it has one).  A numeric reference is a character
@@ -114,12 +118,14 @@ inline void new_file() {
  *    -- Text and Office Systems -- Standard Generalized Markup Language
  *    (SGML)," 1986.
  *
+ * @tparam CharIterator The type of iterator over the encoded characters.
  * @param c This iterator is to be positioned at the character past the '&'; if
  * an entity is found, it is left after the ';'.
  * @return Returns the ASCII equivalent of the entity or ' ' (space) if either
  * there is no equivalent or the entity is malformed.
  */
-static char entity_to_ascii( encoded_char_range::const_iterator &c ) {
+template<class CharIterator>
+static char entity_to_ascii( CharIterator &c ) {
 
   ////////// See if it's a numeric character reference ////////////////////////
 
@@ -145,10 +151,8 @@ static char entity_to_ascii( encoded_char_range::const_iterator &c ) {
 
   ////////// Look up character entity reference ///////////////////////////////
 
-  if ( !is_num ) {
-    static char_entity_map const &ch = char_entity_map::instance();
-    return ch[ entity_buf ];
-  }
+  if ( !is_num )
+    return char_entity_map::find( entity_buf );
 
   ////////// Parse a numeric character reference //////////////////////////////
 
@@ -346,86 +350,53 @@ bool HTML_indexer::claims_option( option_stream::option const &opt ) {
   } // switch
 }
 
-char const* HTML_indexer::find_title( mmap_file const &file ) const {
-  static char const *const title_tag[] = {  // tag_index
+void HTML_indexer::index_words( index_context &ctx,
+                                encoded_char_range const &e,
+                                meta_id_type meta_id ) {
+  //
+  // Only the range that is the entire file is looked at for the title, not
+  // the values of attributes.
+  //
+  bool const find_title =
+    ctx.wants_title( this ) && e.begin_pos() == ctx.file_begin();
+  dispatch_decoder( e, [this,&ctx,meta_id,find_title]( auto c ) {
+    index_html_words( ctx, c, meta_id, find_title );
+  } );
+}
+
+template<class CharIterator>
+void HTML_indexer::index_html_words( index_context &ctx, CharIterator c,
+                                     meta_id_type meta_id, bool find_title ) {
+  static char const *const title_tag[] = {  // title_tag_index
     "title",                                //  0
     "/title"                                //  1
   };
 
-  new_file();
-
-  int tag_index = 0;
-  unsigned lines = 0;
+  char  word[ Word_Hard_Max_Size + 1 ];
+  bool  in_word = false;
+  int   len;
 
+  int         title_tag_index = 0;
+  unsigned    title_lines = 0;
   //
   // <TITLE>This is a title</TITLE>
-  //        |              |
-  //        after          before
+  //        |
+  //        title_begin
   //
-  // Mark the positions after the closing '>' of the start tag and before the
-  // opening '<' of the end tag.  What's in between is the title.
-  //
-  mmap_file::const_iterator after, before;
+  char const *title_begin = nullptr;
 
-  encoded_char_range::const_iterator c( file.begin(), file.end() );
   while ( !c.at_end() ) {
-    if ( *c == '\n' && ++lines > num_title_lines ) {
+    char ch = iso8859_1_to_ascii( *c++ );
+
+    if ( find_title && ch == '\n' && ++title_lines > num_title_lines ) {
       //
-      // Didn't find <TITLE> within first num_title_lines lines of file: forget
-      // it.
+      // Didn't find <TITLE>...</TITLE> within the first num_title_lines lines
+      // of the file (not counting those within tags): forget it.
       //
-      return nullptr;
+      ctx.title( nullptr );
+      find_title = false;
     }
 
-    if ( *c != '<' ) {                  // not a tag: forget it
-      ++c;
-      continue;
-    }
-
-    //
-    // Found the start of an HTML or XHTML tag: mark the position before it in
-    // case it turns out to be the </TITLE> tag.
-    //
-    before = c.pos();
-
-    if ( is_html_comment( ++c ) )
-      continue;
-
-    //
-    // Is the HTML or XHTML tag a TITLE tag?
-    //
-    bool const found_title_tag =
-      move_if_match( c, title_tag[ tag_index ], true );
-    skip_html_tag( c );                 // skip until '>'
-    if ( !found_title_tag )             // wrong tag
-      continue;
-
-    if ( tag_index == 1 )               // found entire title
-      return tidy_title( after, before );
-
-    //
-    // Found the <TITLE> tag: mark the position after it and begin looking for
-    // the </TITLE> tag.
-    //
-    after = c.pos();
-    ++tag_index;
-  } // while
-
-  //
-  // The file has less than num_title_lines lines and no <TITLE> was found.
-  //
-  return nullptr;
-}
-
-void HTML_indexer::index_words( encoded_char_range const &e,
-                                meta_id_type meta_id ) {
-  char  word[ Word_Hard_Max_Size + 1 ];
-  bool  in_word = false;
-  int   len;
-
-  encoded_char_range::const_iterator c = e.begin();
-  while ( !c.at_end() ) {
-    char ch = iso8859_1_to_ascii( *c++ );
     //
     // If the character is an '&' (the start of a entity reference), convert
     // the entity reference to ASCII.
@@ -458,7 +429,7 @@ void HTML_indexer::index_words( encoded_char_range const &e,
       // including, it.
       //
       in_word = false;
-      index_word( word, len, meta_id );
+      index_word( ctx, word, len, meta_id );
     }
 
     if ( ch == '<' && meta_id == Meta_ID_None ) {
@@ -467,7 +438,30 @@ void HTML_indexer::index_words( encoded_char_range const &e,
       // we're not in the midst of indexing the value of a META element's
       // CONTENT attribute, then parse the HTML or XHTML tag.
       //
-      parse_html_tag( c );
+      encoded_char_range::const_iterator tag_c( c );
+      bool found_title_tag = false;
+      if ( find_title ) {
+        auto name_c = tag_c;
+        found_title_tag =
+          move_if_match( name_c, title_tag[ title_tag_index ], true );
+      }
+      char const *const tag_begin = c.prev_pos();
+      parse_html_tag( ctx, tag_c );
+      c = tag_c;
+
+      if ( found_title_tag ) {
+        if ( title_tag_index == 1 ) {   // found entire title
+          ctx.title( tidy_title( title_begin, tag_begin ) );
+          find_title = false;
+        } else {
+          //
+          // Found the <TITLE> tag: mark the position after it and begin
+          // looking for the </TITLE> tag.
+          //
+          title_begin = c.pos();
+          ++title_tag_index;
+        }
+      }
     }
   } // while
 
@@ -476,11 +470,12 @@ void HTML_indexer::index_words( encoded_char_range const &e,
     // We ran into 'end' while still accumulating characters into a word, so
     // just index what we've got.
     //
-    index_word( word, len, meta_id );
+    index_word( ctx, word, len, meta_id );
   }
 }
 
-void HTML_indexer::parse_html_tag( encoded_char_range::const_iterator &c ) {
+void HTML_indexer::parse_html_tag( index_context &ctx,
+                                   encoded_char_range::const_iterator &c ) {
   if ( c.at_end() )
     return;
 
@@ -497,6 +492,7 @@ void HTML_indexer::parse_html_tag( encoded_char_range::const_iterator &c ) {
   ////////// Deal with elements of a class not to index ///////////////////////
 
   if ( !exclude_class_names.empty() ) {     // else, don't bother
+    stack_type &element_stack = ctx.state<HTML_state>( this ).element_stack;
     char tag_buf[ Tag_Name_Max_Size + 2 ];  // 1 for '/', 1 for null
     { // local scope
     //
@@ -527,8 +523,7 @@ void HTML_indexer::parse_html_tag( encoded_char_range::const_iterator &c ) {
     ////////// Close open element(s) //////////////////////////////////////////
 
     while ( !element_stack.empty() &&
-            contains( element_stack.back().first->second.close_tags,
-                      tag_buf ) ) {
+            element_stack.back().first->second.is_closed_by( tag_buf ) ) {
       //
       // This element closes the currently open element.
       //
@@ -537,7 +532,7 @@ void HTML_indexer::parse_html_tag( encoded_char_range::const_iterator &c ) {
         // The currently open element is a member of one of the classes not
         // being being indexed: resume indexing.
         //
-        resume_indexing();
+        resume_indexing( ctx );
       }
       auto const start_tag = element_stack.back().first->first;
       element_stack.pop_back();
@@ -581,9 +576,8 @@ void HTML_indexer::parse_html_tag( encoded_char_range::const_iterator &c ) {
 
     ////////// Look-up the HTML element ///////////////////////////////////////
 
-    static auto const &elements = element_map::instance();
-    auto const e = elements.find( tag_buf );
-    if ( e != elements.end() ) {
+    auto const e = element_map::find( tag_buf );
+    if ( e != element_map::end() ) {
       //
       // We found the element in our internal table: now do different stuff
       // depending upon whether its end tag is forbidden or not.
@@ -608,7 +602,7 @@ void HTML_indexer::parse_html_tag( encoded_char_range::const_iterator &c ) {
           // A class name in the value of this element's CLASS attribute is
           // among the set not to index: suspend indexing.
           //
-          suspend_indexing();
+          suspend_indexing( ctx );
         }
       }
       if ( is_no_index_class ) {
@@ -639,7 +633,7 @@ void HTML_indexer::parse_html_tag( encoded_char_range::const_iterator &c ) {
 
   encoded_char_range title_att = name;
   if ( find_attribute( title_att, "title" ) )
-    index_words( title_att );
+    index_words( ctx, title_att );
 
   ////////// Look for an ALT attribute ////////////////////////////////////////
 
@@ -648,7 +642,7 @@ void HTML_indexer::parse_html_tag( encoded_char_range::const_iterator &c ) {
        move_if_match( name, "input", true ) ) {
     encoded_char_range alt_att = name;
     if ( find_attribute( alt_att, "alt" ) )
-      index_words( alt_att );
+      index_words( ctx, alt_att );
     return;
   }
 
@@ -675,7 +669,7 @@ void HTML_indexer::parse_html_tag( encoded_char_range::const_iterator &c ) {
       // Index the words in the value of the CONTENT attribute marking them as
       // being associated with the value of NAME attribute.
       //
-      index_words( content_att, meta_id );
+      index_words( ctx, content_att, meta_id );
     }
     return;
   }
@@ -685,7 +679,7 @@ void HTML_indexer::parse_html_tag( encoded_char_range::const_iterator &c ) {
   if ( move_if_match( name, "object", true ) ) {
     encoded_char_range standby_att = name;
     if ( find_attribute( standby_att, "standby" ) )
-      index_words( standby_att );
+      index_words( ctx, standby_att );
     return;
   }
 
@@ -694,7 +688,7 @@ void HTML_indexer::parse_html_tag( encoded_char_range::const_iterator &c ) {
   if ( move_if_match( name, "table", true ) ) {
     encoded_char_range summary_att = name;
     if ( find_attribute( summary_att, "summary" ) )
-      index_words( summary_att );
+      index_words( ctx, summary_att );
     return;
   }
 }
@@ -710,8 +704,7 @@ option_stream::spec const* HTML_indexer::option_spec() const {
 
 void HTML_indexer::post_options() {
   if ( dump_html_elements_opt ) {
-    static auto const &elements = element_map::instance();
-    ::copy( elements.begin(), elements.end(),
+    ::copy( element_map::begin(), element_map::end(),
       ostream_iterator<element_map::value_type>( cout,"\n" )
     );
     ::exit( Exit_Success );
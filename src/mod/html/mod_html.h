@@ -38,11 +38,26 @@ class HTML_indexer : public indexer {
 public:
   HTML_indexer() : indexer( "HTML" ) { }
 
-  char const* find_title( PJL::mmap_file const& ) const override;
-  void index_words( encoded_char_range const&,
+  void index_words( index_context&, encoded_char_range const&,
                     meta_id_type = Meta_ID_None ) override;
 
 private:
+  /**
+   * Indexes the words in a range of HTML or XHTML text.  This is a template
+   * so that it can be instantiated for each decoder by dispatch_decoder().
+   *
+   * @tparam CharIterator The type of iterator over the encoded characters.
+   * @param ctx The index_context to use.
+   * @param c An iterator positioned at the first character.
+   * @param meta_id The numeric ID of the meta name the words are indexed
+   * under, if any.
+   * @param find_title If \c true, also look for the title (the contents of
+   * the TITLE element) and report it.
+   */
+  template<class CharIterator>
+  void index_html_words( index_context &ctx, CharIterator c,
+                         meta_id_type meta_id, bool find_title );
+
   /**
    * This function does everything \c skip_html_tag() does but additionally
    * does extra parsing for certain HTML or XHTML elements:
@@ -71,6 +86,7 @@ private:
    * 6. If the tag is a TABLE element and contains a SUMMARY attribute, it
    *    indexes the words of its value.
    *
+   * @param ctx The context of the file being indexed.
    * @param c The iterator to use.  It must be positioned at the character
    * after the '<'; it is repositioned at the first character after the '>'.
    *
@@ -102,7 +118,8 @@ private:
    * HTML 4.0 Specification, section 13.8, World Wide Web Consortium, April
    * 1998.  <http://www.w3.org/TR/REC-html40/struct/objects.html#h-13.8>
    */
-  void parse_html_tag( encoded_char_range::const_iterator& );
+  void parse_html_tag( index_context &ctx,
+                       encoded_char_range::const_iterator &c );
 
   bool claims_option( PJL::option_stream::option const& ) override;
   PJL::option_stream::spec const* option_spec() const override;
@@ -26,15 +26,16 @@
 #include "charsets/charsets.h"
 #include "encoded_char.h"
 #include "id3v1.h"
+#include "index_context.h"
 #include "indexer.h"
-#include "pjl/less.h"
+#include "pjl/perfect_hash.h"
 #include "util.h"
 #include "word_util.h"
 
 // standard
 #include <cstdlib>
 #include <cstring>
-#include <map>
+#include <utility>                      /* for pair */
 #ifdef DEBUG_id3v2
 #include <iomanip>
 #include <ostream>
@@ -45,6 +46,7 @@
 #include <zlib.h>
 #endif /* HAVE_ZLIB */
 
+using namespace PJL;
 using namespace std;
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -187,8 +189,7 @@ static unsigned unsynchsafe( char const *&c, int bytes = 4 ) {
 ////////// member functions ///////////////////////////////////////////////////
 
 id3v2_frame::parser_ptr id3v2_frame::find_parser( char const *frame_id ) {
-  using map_type = map<char const*,id3v2_frame::parser_ptr>;
-  static map_type const m{
+  static constexpr pair<char const*,parser_ptr> parser_table[] = {
     //
     // ID3v2.4 frame IDs (that we care about indexing).
     //
@@ -249,9 +250,10 @@ id3v2_frame::parser_ptr id3v2_frame::find_parser( char const *frame_id ) {
     { "txx",  &id3v2_frame::parse_text }, // becomes TXXX
     { "ult",  &id3v2_frame::parse_comm }, // becomes USLT
   };
+  static constexpr perfect_hash_map parsers{ parser_table };
 
-  map_type::const_iterator const found = m.find( frame_id );
-  return found != m.end() ? found->second : 0;
+  auto const found = parsers.find( frame_id );
+  return found != parsers.end() ? found->second : nullptr;
 }
 
 id3v2_frame::header_result
@@ -348,16 +350,16 @@ id3v2_frame::parse_header( char const *&c, id3v2_header const &header ) {
   return hr_success;
 }
 
-void id3v2_frame::parse_comm() {
+void id3v2_frame::parse_comm( index_context &ctx ) {
   text_encoding const encoding = parse_text_encoding( content_begin_, 3 );
   if ( encoding == CHARSET_UNKNOWN )
     return;
   content_begin_ += 3;                        // skip language
   encoded_char_range const e( content_begin_, content_end_, encoding );
-  indexer::text_indexer()->index_words( e, meta_id_ );
+  indexer::text_indexer()->index_words( ctx, e, meta_id_ );
 }
 
-void id3v2_frame::parse_sylt() {
+void id3v2_frame::parse_sylt( index_context &ctx ) {
   static char const *const CONTENT_TYPE_TABLE[] = {
     "other",                            // 0 -- we don't use this one
     "lyrics",                           // 1
@@ -392,10 +394,10 @@ void id3v2_frame::parse_sylt() {
   ++content_begin_;                     // skip content type
 
   encoded_char_range const e( content_begin_, content_end_, encoding );
-  indexer::text_indexer()->index_words( e, meta_id_ );
+  indexer::text_indexer()->index_words( ctx, e, meta_id_ );
 }
 
-void id3v2_frame::parse_tcon() {
+void id3v2_frame::parse_tcon( index_context &ctx ) {
   text_encoding const encoding = parse_text_encoding( content_begin_ );
   if ( encoding == CHARSET_UNKNOWN )
     return;
@@ -441,7 +443,7 @@ void id3v2_frame::parse_tcon() {
         ::strcpy( word, g->name );
         len = g->length;
       }
-      indexer::index_word( word, len, meta_id_ );
+      indexer::index_word( ctx, word, len, meta_id_ );
     }
   } // while
 
@@ -455,16 +457,16 @@ void id3v2_frame::parse_tcon() {
       ::strcpy( word, g->name );
       len = g->length;
     }
-    indexer::index_word( word, len, meta_id_ );
+    indexer::index_word( ctx, word, len, meta_id_ );
   }
 }
 
-void id3v2_frame::parse_text() {
+void id3v2_frame::parse_text( index_context &ctx ) {
   text_encoding const encoding = parse_text_encoding( content_begin_ );
   if ( encoding == CHARSET_UNKNOWN )
     return;
   encoded_char_range const e( content_begin_, content_end_, encoding );
-  indexer::text_indexer()->index_words( e, meta_id_ );
+  indexer::text_indexer()->index_words( ctx, e, meta_id_ );
 }
 
 bool id3v2_header::parse( char const *&c, char const *end ) {
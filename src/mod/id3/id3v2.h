@@ -26,6 +26,8 @@
 #include "config.h"
 #include "word_util.h"
 
+class index_context;
+
 ///////////////////////////////////////////////////////////////////////////////
 
 /**
@@ -87,7 +89,7 @@ struct id3v2_frame {
     hr_end_of_frames
   };
 
-  using parser_ptr = void (id3v2_frame::*)();
+  using parser_ptr = void (id3v2_frame::*)( index_context& );
 
   char            id_[5];
   size_type       size_;
@@ -111,10 +113,11 @@ struct id3v2_frame {
    * Parses a COMM ID3v2 frame and index the text in it.  This function is also
    * used to parse USER frames.
    *
+   * @param ctx The context of the file being indexed.   *
    * @sa Martin Nilsson.  "4.10. Comments," ID3 tag version 2.4.0 - Native
    * Frames, November 2000.  <http://www.id3.org/>
    */
-  void parse_comm();
+  void parse_comm( index_context &ctx );
 
   /**
    * Parses an ID3v2 frame header.
@@ -137,14 +140,16 @@ struct id3v2_frame {
   /**
    * Parses a SYLT ID3v2 frame.
    *
+   * @param ctx The context of the file being indexed.   *
    * @sa Martin Nilsson.  "4.9. Synchronized lyrics/text," ID3 tag version 2.4.0
    *  - Native Frames, November 2000.  <http://www.id3.org/>
    */
-  void parse_sylt();
+  void parse_sylt( index_context &ctx );
 
   /**
    * Parses a TCON (genre) ID3v2 frame.
    *
+   * @param ctx The context of the file being indexed.   *
    * @remarks
    * @parblock
    * In ID3v2.x, genres are either strings or references to ID3v1.x numeric
@@ -165,15 +170,16 @@ struct id3v2_frame {
    * @sa ---.  "4.2.3. TCON Content type," ID3 tag version 2.4.0 - Native
    * Frames, November 2000.  <http://www.id3.org/>
    */
-  void parse_tcon();
+  void parse_tcon( index_context &ctx );
 
   /**
    * Parses a TEXT ID3v2 frame.
    *
+   * @param ctx The context of the file being indexed.   *
    * @sa Martin Nilsson.  "4.2. Text information frames," ID3 tag version 2.4.0
    *  - Native Frames, November 2000.  <http://www.id3.org/>
    */
-  void parse_text();
+  void parse_text( index_context &ctx );
 };
 
 /**
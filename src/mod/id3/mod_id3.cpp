@@ -26,6 +26,7 @@
 #include "encoded_char.h"
 #include "id3v1.h"
 #include "id3v2.h"
+#include "index_context.h"
 #include "indexer.h"
 
 // standard
@@ -37,7 +38,8 @@ using namespace std;
 
 ///////////////////////////////////////////////////////////////////////////////
 
-char const* id3_indexer::find_title( mmap_file const &file ) const {
+char const* id3_indexer::find_title( index_context&,
+                                      mmap_file const &file ) const {
   char const *c = file.begin();
 
   id3v2_header header;
@@ -81,7 +83,8 @@ id3v1:
   return nullptr;
 }
 
-void id3_indexer::index_id3v1_tags( char const *c, char const *end ) {
+void id3_indexer::index_id3v1_tags( index_context &ctx, char const *c,
+                                    char const *end ) {
   struct id3v1_field {
     char const *name;
     size_t      length;
@@ -116,16 +119,17 @@ void id3_indexer::index_id3v1_tags( char const *c, char const *end ) {
       //
       if ( id3v1_genre const *const g = find_genre( *c ) ) {
         encoded_char_range const e( g->name, g->name + g->length );
-        indexer::index_words( e, meta_id );
+        indexer::index_words( ctx, e, meta_id );
       }
     } else {
       encoded_char_range const e( c, c + field->length );
-      indexer::index_words( e, meta_id );
+      indexer::index_words( ctx, e, meta_id );
     }
   } // for
 }
 
-bool id3_indexer::index_id3v2_tags( char const *c, char const *end ) {
+bool id3_indexer::index_id3v2_tags( index_context &ctx, char const *c,
+                                    char const *end ) {
   id3v2_header header;
   if ( !header.parse( c, end ) )
     return false;
@@ -143,7 +147,7 @@ bool id3_indexer::index_id3v2_tags( char const *c, char const *end ) {
         id3v2_frame::parser_ptr const parser_ptr =
           id3v2_frame::find_parser( frame.id_ );
         if ( parser_ptr ) {
-          (frame.*parser_ptr)();
+          (frame.*parser_ptr)( ctx );
           indexed_at_least_1_frame = true;
         }
         break;
@@ -156,13 +160,14 @@ bool id3_indexer::index_id3v2_tags( char const *c, char const *end ) {
   return indexed_at_least_1_frame;
 }
 
-void id3_indexer::index_words( encoded_char_range const &e, meta_id_type ) {
+void id3_indexer::index_words( index_context &ctx,
+                               encoded_char_range const &e, meta_id_type ) {
   encoded_char_range::const_iterator c = e.begin();
   //
   // Index the ID3v2 tag if it exists; index the ID3v1 tag only if it doesn't.
   //
-  if ( !index_id3v2_tags( c.pos(), c.end_pos() ) )
-    index_id3v1_tags( c.pos(), c.end_pos() );
+  if ( !index_id3v2_tags( ctx, c.pos(), c.end_pos() ) )
+    index_id3v1_tags( ctx, c.pos(), c.end_pos() );
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -41,13 +41,14 @@ class id3_indexer : public indexer {
 public:
   id3_indexer() : indexer( "ID3" ) { }
 
-  char const* find_title( PJL::mmap_file const& ) const override;
-  void index_words( encoded_char_range const&,
+  char const* find_title( index_context&,
+                          PJL::mmap_file const& ) const override;
+  void index_words( index_context&, encoded_char_range const&,
                     meta_id_type = Meta_ID_None ) override;
 
 private:
-  void index_id3v1_tags( char const*, char const* );
-  bool index_id3v2_tags( char const*, char const* );
+  void index_id3v1_tags( index_context&, char const*, char const* );
+  bool index_id3v2_tags( index_context&, char const*, char const* );
 };
 
 ///////////////////////////////////////////////////////////////////////////////
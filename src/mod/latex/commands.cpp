@@ -22,100 +22,102 @@
 // local
 #include "config.h"
 #include "commands.h"
+#include "pjl/perfect_hash.h"
+
+// standard
+#include <utility>                      /* for pair */
+
+using namespace PJL;
 
 ///////////////////////////////////////////////////////////////////////////////
 
-command_map::command_map() {
-  //
-  // A command maps to an action which is what to do about it when encountered
-  // in a document.  In most cases, the action is simply text to be
-  // substituted.  In cases where the action is either '{' or '[', the
-  // character is to be "balanced" by looking for the closing '}' or ']' and
-  // the words in between are indexed seperately.
-  //
-  static command const command_table[] = {
+//
+// A command maps to an action which is what to do about it when encountered
+// in a document.  In most cases, the action is simply text to be
+// substituted.  In cases where the action is either '{' or '[', the
+// character is to be "balanced" by looking for the closing '}' or ']' and
+// the words in between are indexed seperately.
+//
+static constexpr std::pair<char const*,char const*> command_table[] = {
 
-  //  \name             action
-  //  ----------------  ---------
-    { "\"",             ""        },
-    { "#",              "#"       },
-    { "$",              "$"       },
-    { "%",              "%"       },
-    { "&",              "&"       },
-    { "'",              ""        },
-    { ".",              ""        },
-    { "=",              ""        },
-    { "@",              ""        },
-    { "\\",             "\n"      },
-    { "^",              ""        },
-    { "_",              "_"       },
-    { "`",              ""        },
-    { "{",              " "       },
-    { "}",              " "       },
+//  \name             action
+//  ----------------  ---------
+  { "\"",             ""        },
+  { "#",              "#"       },
+  { "$",              "$"       },
+  { "%",              "%"       },
+  { "&",              "&"       },
+  { "'",              ""        },
+  { ".",              ""        },
+  { "=",              ""        },
+  { "@",              ""        },
+  { "\\",             "\n"      },
+  { "^",              ""        },
+  { "_",              "_"       },
+  { "`",              ""        },
+  { "{",              " "       },
+  { "}",              " "       },
 
-    { "aa",             "a"       },
-    { "AA",             "A"       },
-    { "ae",             "ae"      },
-    { "AE",             "AE"      },
-    { "b",              ""        },
-    { "c",              ""        },
-    { "d",              ""        },
-    { "H",              ""        },
-    { "i",              "i"       },
-    { "j",              "j"       },
-    { "LaTeX",          "LaTeX"   },
-    { "LaTeXe",         "LaTeXe"  },
-    { "l",              "l"       },
-    { "L",              "L"       },
-    { "OE",             "OE"      },
-    { "ss",             "ss"      },
-    { "t",              ""        },
-    { "TeX",            "TeX"     },
-    { "u",              ""        },
-    { "v",              ""        },
+  { "aa",             "a"       },
+  { "AA",             "A"       },
+  { "ae",             "ae"      },
+  { "AE",             "AE"      },
+  { "b",              ""        },
+  { "c",              ""        },
+  { "d",              ""        },
+  { "H",              ""        },
+  { "i",              "i"       },
+  { "j",              "j"       },
+  { "LaTeX",          "LaTeX"   },
+  { "LaTeXe",         "LaTeXe"  },
+  { "l",              "l"       },
+  { "L",              "L"       },
+  { "OE",             "OE"      },
+  { "ss",             "ss"      },
+  { "t",              ""        },
+  { "TeX",            "TeX"     },
+  { "u",              ""        },
+  { "v",              ""        },
 
-    { "author",         "{"       },
-    { "caption",        "{"       },
-    { "chapter",        "{"       },
-    { "copyright",      ""        },
-    { "date",           "{"       },
-    { "emph",           "{"       },
-    { "fbox",           "{"       },
-    { "footnote",       "{"       },
-    { "item",           "["       },
-    { "mbox",           "{"       },
-    { "paragraph",      "{"       },
-    { "part",           "{"       },
-    { "section",        "{"       },
-    { "sout",           "{"       },
-    { "subparagraph",   "{"       },
-    { "subsection",     "{"       },
-    { "subsubsection",  "{"       },
-    { "textbf",         "{"       },
-    { "textit",         "{"       },
-    { "textmd",         "{"       },
-    { "textnormal",     "{"       },
-    { "textrm",         "{"       },
-    { "textsc",         "{"       },
-    { "textsf",         "{"       },
-    { "textsl",         "{"       },
-    { "texttt",         "{"       },
-    { "textup",         "{"       },
-    { "title",          "{"       },
-    { "uline",          "{"       },
-    { "underline",      "{"       },
-    { "uwave",          "{"       },
-    { "xout",           "{"       },
-    { nullptr,          nullptr   }
-  };
+  { "author",         "{"       },
+  { "caption",        "{"       },
+  { "chapter",        "{"       },
+  { "copyright",      ""        },
+  { "date",           "{"       },
+  { "emph",           "{"       },
+  { "fbox",           "{"       },
+  { "footnote",       "{"       },
+  { "item",           "["       },
+  { "mbox",           "{"       },
+  { "paragraph",      "{"       },
+  { "part",           "{"       },
+  { "section",        "{"       },
+  { "sout",           "{"       },
+  { "subparagraph",   "{"       },
+  { "subsection",     "{"       },
+  { "subsubsection",  "{"       },
+  { "textbf",         "{"       },
+  { "textit",         "{"       },
+  { "textmd",         "{"       },
+  { "textnormal",     "{"       },
+  { "textrm",         "{"       },
+  { "textsc",         "{"       },
+  { "textsf",         "{"       },
+  { "textsl",         "{"       },
+  { "texttt",         "{"       },
+  { "textup",         "{"       },
+  { "title",          "{"       },
+  { "uline",          "{"       },
+  { "underline",      "{"       },
+  { "uwave",          "{"       },
+  { "xout",           "{"       },
+};
 
-  for ( auto c = command_table; c->name; ++c )
-    operator[]( c->name ).action = c->action;
-}
+static constexpr perfect_hash_map commands{ command_table };
 
-command_map const& command_map::instance() {
-  static command_map const m;
-  return m;
+char const* command_map::find( char const *name ) {
+  auto const found = commands.find( name );
+  return found != commands.end() ? found->second : nullptr;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -24,40 +24,28 @@
 
 // local
 #include "config.h"
-#include "pjl/less.h"
-
-// standard
-#include <map>
 
 ///////////////////////////////////////////////////////////////////////////////
 
 /**
- * A %command contains the information we need about LaTeX commands.
- */
-struct command {
-  char const *name;
-  char const *action;
-};
-
-/**
- * A %command_map is-a map from the character strings for LaTeX commands to
- * instances of the command class declared above.
- *
- * @remarks
- * @parblock
- * The only reason for having a derived class rather than a `typedef` is so
- * that we can have a custom constructor that initializes itself.
- *
- * The constructor is private, however, to ensure that only instance() can be
- * called to initialize and access a single, static instance.
- * @endparblock
+ * A %command_map maps the character strings for LaTeX commands to their
+ * actions.  It's built entirely at compile-time and uses a perfect hash for
+ * look-up.
  */
-class command_map : public std::map<char const*,command> {
+class command_map {
 public:
-  static command_map const& instance();
-
-private:
-  command_map();
+  command_map() = delete;
+
+  /**
+   * Finds the action of a command.  In most cases, the action is simply text
+   * to be substituted.  In cases where the action is either \c '{' or \c '[',
+   * the character is to be "balanced" by looking for the closing \c '}' or
+   * \c ']' and the words in between are indexed separately.
+   *
+   * @param name The name of the command (without the leading \c '\\').
+   * @return Returns the action or null if the command wasn't found.
+   */
+  static char const* find( char const *name );
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -24,6 +24,8 @@
 #include "mod_latex.h"
 #include "commands.h"
 #include "encoded_char.h"
+#include "encoded_char_dispatch.h"
+#include "index_context.h"
 #include "iso8859-1.h"
 #include "latex_config.h"
 #include "meta_id.h"
@@ -35,6 +37,7 @@
 // standard
 #include <cctype>
 #include <cstddef>
+#include <cstring>
 
 using namespace PJL;
 using namespace std;
@@ -84,52 +87,33 @@ static bool find_match( encoded_char_range::const_iterator &c, char left,
 
 ////////// member functions ///////////////////////////////////////////////////
 
-char const* LaTeX_indexer::find_title( mmap_file const &file ) const {
-  unsigned lines = 0;
-
-  encoded_char_range::const_iterator c( file.begin(), file.end() );
-  while ( !c.at_end() ) {
-    if ( *c == '\n' && ++lines > num_title_lines ) {
-      //
-      // Didn't find \title{...} within first num_title_lines lines of file:
-      // forget it.
-      //
-      return nullptr;
-    }
-
-    if ( *c == '\\' && !(++c).at_end() && move_if_match( c, "title{" ) ) {
-      //
-      // Found the \title{ command.
-      //
-      if ( !c.at_end() ) {
-        for ( auto const start = c.pos(); !c.at_end(); ++c ) {
-          switch ( *c ) {
-            case '}':
-              return tidy_title( start, c.pos() );
-            case '\n':
-              if ( ++lines > num_title_lines )
-                return nullptr;
-          } // switch
-        }
-      }
-      break;
-    }
-  } // while
-
-  //
-  // The file has less than num_title_lines lines and no \title{ was found.
-  //
-  return nullptr;
+void LaTeX_indexer::index_words( index_context &ctx,
+                                 encoded_char_range const &e,
+                                 meta_id_type meta_id ) {
+  dispatch_decoder( e, [this,&ctx,meta_id]( auto c ) {
+    index_latex_words( ctx, c, meta_id );
+  } );
 }
 
-void LaTeX_indexer::index_words( encoded_char_range const &e,
-                                 meta_id_type meta_id ) {
+/**
+ * Indexes the words in a range of LaTeX text.  This is a template so that it
+ * can be instantiated for each decoder by dispatch_decoder().
+ *
+ * @tparam CharIterator The type of iterator over the encoded characters.
+ * @param ctx The index_context to use.
+ * @param c An iterator positioned at the first character.
+ * @param meta_id The numeric ID of the meta name the words are indexed under,
+ * if any.
+ */
+template<class CharIterator>
+void LaTeX_indexer::index_latex_words( index_context &ctx, CharIterator c,
+                                       meta_id_type meta_id ) {
   char        word[ Word_Hard_Max_Size + 1 ];
   bool        in_word = false;
   int         len;
   char const* substitution = nullptr;
 
-  for ( auto c = e.begin(); !c.at_end(); ) {
+  while ( !c.at_end() ) {
     char ch;
 
     if ( substitution ) {
@@ -188,7 +172,9 @@ collect:
         // Parse a LaTeX command: it may return text to be substituted for the
         // command and indexed.
         //
-        substitution = parse_latex_command( c );
+        encoded_char_range::const_iterator command_c( c );
+        substitution = parse_latex_command( ctx, command_c );
+        c = command_c;
         continue;
     } // switch
 
@@ -200,21 +186,22 @@ collect:
       // including, it.
       //
       in_word = false;
-      index_word( word, len, meta_id );
+      index_word( ctx, word, len, meta_id );
     }
-  } // for
+  } // while
 
   if ( in_word ) {
     //
     // We ran into 'end' while still accumulating characters into a word, so
     // just index what we've got.
     //
-    index_word( word, len, meta_id );
+    index_word( ctx, word, len, meta_id );
   }
 }
 
 char const*
-LaTeX_indexer::parse_latex_command( encoded_char_range::const_iterator &c ) {
+LaTeX_indexer::parse_latex_command( index_context &ctx,
+                                    encoded_char_range::const_iterator &c ) {
   if ( c.at_end() )
     return nullptr;
 
@@ -241,18 +228,35 @@ LaTeX_indexer::parse_latex_command( encoded_char_range::const_iterator &c ) {
   } // while
   *to = '\0';
 
+  ////////// Report the title /////////////////////////////////////////////////
+
+  if ( ctx.wants_title( this ) && !::strcmp( command_buf, "title" ) &&
+       !from.at_end() && *from == '{' ) {
+    //
+    // Found the first \title{ command: the title is everything up to the '}'
+    // provided it's within the first num_title_lines lines of the file.
+    //
+    char const *const begin = from.pos() + 1;
+    char const *const end = static_cast<char const*>(
+      ::memchr( begin, '}', c.end_pos() - begin )
+    );
+    ctx.title(
+      end && ctx.newlines_before( end, num_title_lines ) <= num_title_lines ?
+        tidy_title( begin, end ) : nullptr
+    );
+  }
+
   ////////// Look-up command //////////////////////////////////////////////////
 
-  static auto const &commands = command_map::instance();
-  auto const cmd = commands.find( command_buf );
-  if ( cmd == commands.end() )
+  char const *const action = command_map::find( command_buf );
+  if ( !action )
     goto skip;
 
   //
   // We found the command in our internal table: now do different stuff
   // depending upon the action.
   //
-  switch ( *cmd->second.action ) {
+  switch ( *action ) {
     case '{':
     case '[': {
       //
@@ -260,14 +264,14 @@ LaTeX_indexer::parse_latex_command( encoded_char_range::const_iterator &c ) {
       // mean it's actually there: try to find it first.  If not found, forget
       // it.
       //
-      if ( !skip_char( &c, *cmd->second.action, LaTeX_Command_Scan_Open_Max ) )
+      if ( !skip_char( &c, *action, LaTeX_Command_Scan_Open_Max ) )
         goto skip;
       //
       // Find the matching '}' or ']' and index the words in between.
       //
       auto end = c;
-      if ( find_match( end, *cmd->second.action, LaTeX_Command_Scan_Close_Max ) ) {
-        index_words( encoded_char_range( c, end ) );
+      if ( find_match( end, *action, LaTeX_Command_Scan_Close_Max ) ) {
+        index_words( ctx, encoded_char_range( c, end ) );
         c = end;
       }
       return nullptr;
@@ -277,7 +281,7 @@ LaTeX_indexer::parse_latex_command( encoded_char_range::const_iterator &c ) {
       // Substitute the text of the command's "action" as the text to be
       // indexed.
       //
-      return cmd->second.action;
+      return action;
     }
   } // switch
 
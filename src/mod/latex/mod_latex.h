@@ -38,12 +38,15 @@ class LaTeX_indexer : public indexer {
 public:
   LaTeX_indexer() : indexer( "LaTeX" ) { }
 
-  char const* find_title( PJL::mmap_file const& ) const override;
-  void index_words( encoded_char_range const&,
+  void index_words( index_context&, encoded_char_range const&,
                     meta_id_type = Meta_ID_None ) override;
 
 private:
-  char const* parse_latex_command( encoded_char_range::const_iterator& );
+  template<class CharIterator>
+  void index_latex_words( index_context&, CharIterator, meta_id_type );
+
+  char const* parse_latex_command( index_context&,
+                                   encoded_char_range::const_iterator& );
 };
 
 ///////////////////////////////////////////////////////////////////////////////
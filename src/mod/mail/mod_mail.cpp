@@ -28,6 +28,7 @@
 #include "encodings/encodings.h"
 #include "FilterAttachment.h"
 #include "filter.h"
+#include "index_context.h"
 #include "indexer.h"
 #include "meta_id.h"
 #include "pjl/less.h"
@@ -37,23 +38,26 @@
 #include "word_util.h"
 
 // standard
-#include <algorithm>                    /* for copy() */
+#include <algorithm>                    /* for max(), min() */
+#include <atomic>
 #include <cctype>
 #include <cstring>
 #include <fstream>
 #include <ios>
 #include <iostream>
-#include <iterator>
 #include <memory>                       /* for unique_ptr */
 #include <string>
+#include <string_view>
 #include <unistd.h>                     /* for unlink(2) */
+#include <vector>
+#ifdef MULTI_THREADED
+#include <thread>                       /* for hardware_concurrency() */
+#endif /* MULTI_THREADED */
 
 using namespace PJL;
 using namespace std;
 
-FilterAttachment                    attachment_filters;
-mail_indexer::boundary_stack_type   mail_indexer::boundary_stack_;
-bool                                mail_indexer::did_last_header_;
+FilterAttachment attachment_filters;
 
 ////////// local functions ////////////////////////////////////////////////////
 
@@ -70,52 +74,59 @@ inline bool is_newline( char const *c, char const *end ) {
   return (c[0] == '\r' && c+1 != end && c[1] == '\n') || *c == '\n';
 }
 
+#ifdef MULTI_THREADED
 /**
- * Calls an external filter program to convert the encoded character range into
- * plain text that we know how to index.
+ * The maximum number of attachments of a file to execute filters on
+ * concurrently.
+ */
+unsigned const Attachment_Filter_Threads_Max = 8;
+#endif /* MULTI_THREADED */
+
+/**
+ * Executes an attachment's filter to convert the attachment into plain text
+ * that we know how to index.  If the filter command reads its standard input
+ * from and writes its standard output to files (e.g., "cat < %f > @%F.txt"),
+ * the attachment is piped through it; otherwise, the attachment is written to
+ * a temporary file for it.
  *
- * @param f The filter to use.
- * @param e The encoded character range to filter and index.
+ * @param f The filter to execute.
+ * @param input A pointer to the decoded bytes of the attachment.
+ * @param size The number of bytes.
+ * @param output The buffer to read the plain text into.
+ * @return Returns \c true only if the filter succeeded.
  */
-static void index_via_filter( filter *f, encoded_char_range const &e ) {
+static bool exec_filter( filter &f, char const *input, size_t size,
+                         vector<char> &output ) {
   extern string temp_file_name_prefix;
   //
-  // Create a temporary file containing the decoded bytes of an attachment.
+  // Even when no temporary file is created, its name is what's substituted
+  // into the filter command.  Since attachments can be filtered concurrently,
+  // each needs its own name.
   //
-  string const temp_file_name = temp_file_name_prefix + "att";
-  ofstream temp_file( temp_file_name.c_str(), ios::out | ios::binary );
-  if ( !temp_file ) {
-could_not_filter:
-    if ( verbosity > 3 )
-      cout << " (could not filter attachment)";
-    return;
-  }
-  ::copy( e.begin(), e.end(),
-    ostream_iterator<encoded_char_range::value_type>( temp_file )
-  );
+  static atomic<unsigned> attachment_count;
+  string const temp_file_name =
+    temp_file_name_prefix + "att" + to_string( ++attachment_count );
+  f.substitute( temp_file_name );
+  if ( f.pipes_input() )
+    return f.exec( input, size, output );
+
+  ofstream temp_file( temp_file_name, ios::out | ios::binary );
+  bool filtered = temp_file.write( input, size ) && temp_file.flush();
   temp_file.close();
 
-  //
-  // Substitute the temporary file's name into the filter command, execute the
-  // filter creating a text file, and delete the temporary file containing the
-  // original attachment.
-  //
-  f->substitute( temp_file_name );
-  char const *const new_file_name = f->exec();
-  ::unlink( temp_file_name.c_str() );
-
-  if ( new_file_name ) {
-    //
-    // The filter worked, so now index the post-filtered file that is assumed
-    // to be plain text.
-    //
-    static indexer *const text = indexer::find_indexer( "text" );
-    mmap_file const file( new_file_name );
-    if ( file && !file.empty() )
-      text->index_file( file );
-  } else {
-    goto could_not_filter;
+  if ( filtered ) {
+    if ( f.pipes() ) {
+      filtered = f.exec( output );
+    } else if ( char const *const new_file_name = f.exec() ) {
+      mmap_file const file( new_file_name );
+      if ( file && !file.empty() )
+        output.assign( file.begin(), file.end() );
+    } else {
+      filtered = false;
+    }
   }
+  ::unlink( temp_file_name.c_str() );
+  return filtered;
 }
 
 ////////// member functions ///////////////////////////////////////////////////
@@ -129,49 +140,49 @@ bool mail_indexer::boundary_cmp( char const *c, char const *end,
   return !*boundary;
 }
 
-inline void mail_indexer::new_file() {
-  boundary_stack_.clear();
-  did_last_header_ = false;
-}
-
-char const* mail_indexer::find_title( mmap_file const &file ) const {
-  new_file();
-  unsigned lines = 0;
-
-  for ( auto c = file.begin(); c != file.end(); ) {
-    if ( is_newline( c, file.end() ) || ++lines > num_title_lines ) {
-      //
-      // We either ran out of headers or didn't find the Subject header within
-      // first num_title_lines lines of file: forget it.
-      //
-      break;
-    }
-
-    //
-    // Find the newline ending the header and its value and see if it's the
-    // Subject header.
-    //
-    char const *const nl = find_newline( c, file.end() );
-    if ( nl == file.end() )
-      break;
-    if ( move_if_match( c, nl, "subject:", true ) )
-      return tidy_title( c, nl );       // found the Subject
-
-    c = skip_newline( nl, file.end() );
-  } // for
-
+bool mail_indexer::find_documents( mmap_file const &file,
+                                   vector<size_t> &offsets ) const {
   //
-  // The file has less than num_title_lines lines and no Subject was found.
+  // An mbox file is one or more messages each starting with a "From " line
+  // (the envelope).  Lines in bodies that start with "From " are escaped by
+  // prefixing them with a '>' when added to an mbox.
   //
-  return nullptr;
+  string_view const mbox( file.begin(), file.size() );
+  if ( !mbox.starts_with( "From " ) )
+    return false;
+  offsets.push_back( 0 );
+  for ( size_t i = 0; (i = mbox.find( "\nFrom ", i )) != string_view::npos; )
+    offsets.push_back( ++i );
+  return offsets.size() > 1;
 }
 
-mail_indexer::message_type mail_indexer::index_headers( char const *&c,
-                                                        char const *end ) {
+mail_indexer::message_type
+mail_indexer::index_headers( index_context &ctx, char const *&c,
+                             char const *end ) {
   key_value kv;
   message_type type;
 
-  while ( parse_header( c, end, &kv ) ) {
+  while ( parse_header( ctx, c, end, &kv ) ) {
+
+    ////////// Report the title ///////////////////////////////////////////////
+
+    if ( ctx.wants_title( this ) && !::strcmp( kv.key.get(), "subject" ) ) {
+      //
+      // Found the first Subject header of the message: its value (only the
+      // first line if folded) is the title provided it's within the first
+      // num_title_lines lines of the file.
+      //
+      char const *const header_begin =
+        kv.value_begin - (sizeof "subject:" - 1);
+      char const *title = nullptr;
+      if ( ctx.newlines_before( header_begin, num_title_lines ) <
+           num_title_lines ) {
+        title = tidy_title(
+          kv.value_begin, find_newline( kv.value_begin, kv.value_end )
+        );
+      }
+      ctx.title( title );
+    }
 
     ////////// Deal with Content-Transfer-Encoding ////////////////////////////
 
@@ -241,6 +252,12 @@ mail_indexer::message_type mail_indexer::index_headers( char const *&c,
         else if ( !::strncmp( charset, "utf-8", 5 ) )
           type.charset_ = charset_utf8;
 #endif /* WITH_UTF8 */
+#ifdef WITH_UTF16
+        else if ( !::strncmp( charset, "utf-16le", 8 ) )
+          type.charset_ = charset_utf16le;
+        else if ( !::strncmp( charset, "utf-16", 6 ) )
+          type.charset_ = charset_utf16be;
+#endif /* WITH_UTF16 */
         else {
           type.charset_ = CHARSET_UNKNOWN;
           goto not_indexable;
@@ -298,7 +315,7 @@ mail_indexer::message_type mail_indexer::index_headers( char const *&c,
         //
         // Push the boundary onto the stack.
         //
-        boundary_stack_.push_back( boundary );
+        state( ctx ).boundary_stack.push_back( boundary );
         type.content_type_ = ct_multipart;
       } else {
         //
@@ -327,15 +344,104 @@ not_indexable:
         continue;
     }
     encoded_char_range const e( kv.value_begin, kv.value_end );
-    indexer::index_words( e, meta_id );
+    indexer::index_words( ctx, e, meta_id );
   } // while
 
   return type;
 }
 
-void mail_indexer::index_words( encoded_char_range const &e, meta_id_type ) {
+encoded_char_range mail_indexer::decode_body( index_context &ctx,
+                                             message_type const &type,
+                                             char const *begin,
+                                             char const *end,
+                                             bool with_charset ) const {
+  auto const charset = with_charset ? type.charset_ : nullptr;
+
+  char* (*decode)( char const*, char const*, char* ) = nullptr;
+#ifdef WITH_BASE64
+  if ( type.encoding_ == encoding_base64 )
+    decode = &decode_base64;
+#endif /* WITH_BASE64 */
+#ifdef WITH_QUOTED_PRINTABLE
+  if ( type.encoding_ == encoding_quoted_printable )
+    decode = &decode_quoted_printable;
+#endif /* WITH_QUOTED_PRINTABLE */
+
+  char* (*transcode)( char const*, char const*, char* ) = nullptr;
+#ifdef WITH_UTF8
+  if ( charset == charset_utf8 )
+    transcode = &transcode_utf8;
+#endif /* WITH_UTF8 */
+#ifdef WITH_UTF16
+  if ( charset == charset_utf16be )
+    transcode = &transcode_utf16be;
+  else if ( charset == charset_utf16le )
+    transcode = &transcode_utf16le;
+#endif /* WITH_UTF16 */
+
+  if ( !decode && !transcode ) {
+    return encoded_char_range(
+      begin, end, charset, type.encoding_, ctx.decoders()
+    );
+  }
+
+  //
+  // Neither decoding nor transcoding ever makes the body larger, so a buffer
+  // as large as the encoded body suffices.  The buffer is only ever grown so
+  // it's reused for all the parts of a file.
+  //
+  mail_state &s = state( ctx );
+  size_t const size = end - begin;
+  if ( size > s.decode_buf_size ) {
+    s.decode_buf.reset( new char[ size ] );
+    s.decode_buf_size = size;
+  }
+  char *const buf = s.decode_buf.get();
+
+  if ( decode ) {
+    end = (*decode)( begin, end, buf );
+    begin = buf;
+  }
+  if ( transcode ) {
+#ifdef WITH_UTF16
+    //
+    // A UTF-16 body may start with a byte order mark that overrides the
+    // byte order of the charset.
+    //
+    if ( (charset == charset_utf16be || charset == charset_utf16le) &&
+         end - begin >= 2 ) {
+      if ( begin[0] == '\xFE' && begin[1] == '\xFF' ) {
+        transcode = &transcode_utf16be;
+        begin += 2;
+      } else if ( begin[0] == '\xFF' && begin[1] == '\xFE' ) {
+        transcode = &transcode_utf16le;
+        begin += 2;
+      }
+    }
+#endif /* WITH_UTF16 */
+    //
+    // Now that the body has been decoded (if it was encoded), transcode its
+    // character set (in place, if it was decoded).
+    //
+    return encoded_char_range( buf, (*transcode)( begin, end, buf ) );
+  }
+  //
+  // Any other character set is decoded a character at a time.
+  //
+  return encoded_char_range( buf, end, charset, nullptr, ctx.decoders() );
+}
+
+void mail_indexer::index_words( index_context &ctx,
+                                encoded_char_range const &e, meta_id_type ) {
   auto c = e.begin();
-  message_type const type( index_headers( c.pos(), c.end_pos() ) );
+  message_type const type( index_headers( ctx, c.pos(), c.end_pos() ) );
+  if ( ctx.wants_title( this ) ) {
+    //
+    // The message's headers had no Subject: it has no title.  (This also
+    // prevents the Subject of any enclosed message from being the title.)
+    //
+    ctx.title( nullptr );
+  }
 
   if ( type.content_type_ == ct_unknown || type.encoding_ == Binary ) {
     //
@@ -344,33 +450,32 @@ void mail_indexer::index_words( encoded_char_range const &e, meta_id_type ) {
     return;
   }
 
-  //
-  // Create a new encoded_char_range having the same range but the
-  // Content-Transfer-Encoding given in the headers.
-  //
-  encoded_char_range const e2(
-    c.pos(), c.end_pos(), type.charset_, type.encoding_
-  );
-
   switch ( type.content_type_ ) {
 
     case ct_external_filter:
-      index_via_filter( type.filter_, e2 );
+      //
+      // Filters get the raw bytes of a decoded attachment: the character set,
+      // if any, is for the filter to deal with.
+      //
+      index_via_filter(
+        ctx, type,
+        decode_body( ctx, type, c.pos(), c.end_pos(), !type.encoding_ )
+      );
       break;
 
     case ct_message_rfc822:
-      index_words( e2 );
+      index_words( ctx, encoded_char_range( c.pos(), c.end_pos() ) );
       break;
 
     case ct_multipart:
-      index_multipart( c.pos(), c.end_pos() );
-      boundary_stack_.pop_back();
+      index_multipart( ctx, c.pos(), c.end_pos() );
+      state( ctx ).boundary_stack.pop_back();
       break;
 
 #ifdef WITH_RTF
     case ct_text_enriched: {
       static indexer &rtf = *indexer::find_indexer( "RTF" );
-      rtf.index_words( e2 );
+      rtf.index_words( ctx, decode_body( ctx, type, c.pos(), c.end_pos() ) );
       break;
     }
 #endif /* WITH_RTF */
@@ -378,29 +483,128 @@ void mail_indexer::index_words( encoded_char_range const &e, meta_id_type ) {
 #ifdef WITH_HTML
     case ct_text_html: {
       static indexer &html = *indexer::find_indexer( "HTML" );
-      html.index_words( e2 );
+      html.index_words( ctx, decode_body( ctx, type, c.pos(), c.end_pos() ) );
       break;
     }
 #endif /* WITH_HTML */
 
     case ct_text_plain:
-      indexer::index_words( e2 );
+      indexer::index_words(
+        ctx, decode_body( ctx, type, c.pos(), c.end_pos() )
+      );
       break;
 
     case ct_text_vcard:
-      index_vcard( c.pos(), c.end_pos() );
+      index_vcard( ctx, c.pos(), c.end_pos() );
       break;
 
     case ct_unknown:
       // do nothing
       break;
   } // switich
+
+  if ( e.begin_pos() == ctx.file_begin() ) {
+    //
+    // This is the top-level message: index the text of its attachments that
+    // were filtered in the background.
+    //
+    index_filtered_attachments( ctx );
+  }
+}
+
+void mail_indexer::index_filtered_attachments(
+  [[maybe_unused]] index_context &ctx ) {
+#ifdef MULTI_THREADED
+  auto &filtered_attachments = state( ctx ).filtered_attachments;
+  for ( auto const &a : filtered_attachments ) {
+    if ( a->filtered.get() ) {
+      indexer::index_words(
+        ctx, encoded_char_range( a->output.data(),
+                                 a->output.data() + a->output.size() )
+      );
+    } else if ( verbosity > 3 ) {
+      cout << " (could not filter attachment)";
+    }
+  } // for
+  filtered_attachments.clear();
+#endif /* MULTI_THREADED */
+}
+
+void mail_indexer::index_via_filter( index_context &ctx,
+                                     message_type const &type,
+                                     encoded_char_range const &e ) {
+#ifdef MULTI_THREADED
+  //
+  // Filters are slow, so execute them in the background while indexing the
+  // rest of the file.  Their text is indexed only at the end of the file so
+  // that the index doesn't depend on how long filters take.
+  //
+  static size_t const max_pending = max(
+    1u, min( thread::hardware_concurrency(), Attachment_Filter_Threads_Max )
+  );
+  auto &filtered_attachments = state( ctx ).filtered_attachments;
+  if ( filtered_attachments.size() >= max_pending )
+    filtered_attachments[ filtered_attachments.size() - max_pending ]
+      ->filtered.wait();
+
+  unique_ptr<filtered_attachment> a( new filtered_attachment );
+  a->filter_.reset( type.filter_ );
+  type.filter_ = nullptr;
+  if ( !e.decoder() && e.begin_pos() >= ctx.file_begin() &&
+       e.end_pos() <= ctx.file_end() ) {
+    //
+    // The attachment is neither encoded nor was decoded, so its bytes remain
+    // valid in the file.
+    //
+    a->input = e.begin_pos();
+    a->input_size = e.end_pos() - e.begin_pos();
+  } else {
+    //
+    // Either the attachment is encoded or it was decoded into the buffer
+    // that's reused (and possibly reallocated) for the next part while the
+    // filter is still reading it, so its bytes have to be copied.
+    //
+    a->input_buf.assign( e.begin(), e.end() );
+    a->input = a->input_buf.data();
+    a->input_size = a->input_buf.size();
+  }
+  filtered_attachment *const p = a.get();
+  p->filtered = async( launch::async, [p]() {
+    bool const filtered =
+      exec_filter( *p->filter_, p->input, p->input_size, p->output );
+    vector<char>().swap( p->input_buf );
+    return filtered;
+  } );
+  filtered_attachments.push_back( std::move( a ) );
+#else
+  vector<char> input_buf;
+  char const *input = e.begin_pos();
+  size_t size = e.end_pos() - e.begin_pos();
+  if ( e.decoder() ) {
+    input_buf.assign( e.begin(), e.end() );
+    input = input_buf.data();
+    size = input_buf.size();
+  }
+  vector<char> output;
+  if ( exec_filter( *type.filter_, input, size, output ) ) {
+    indexer::index_words(
+      ctx, encoded_char_range( output.data(), output.data() + output.size() )
+    );
+  } else if ( verbosity > 3 ) {
+    cout << " (could not filter attachment)";
+  }
+#endif /* MULTI_THREADED */
+}
+
+void mail_indexer::post_options() {
+  attachment_filters.compile();
 }
 
-bool mail_indexer::parse_header( char const *&c, char const *end,
-                                 key_value *kv ) {
-  if ( did_last_header_ )
-    return did_last_header_ = false;
+bool mail_indexer::parse_header( index_context &ctx, char const *&c,
+                                 char const *end, key_value *kv ) const {
+  bool &did_last_header = state( ctx ).did_last_header;
+  if ( did_last_header )
+    return did_last_header = false;
 
   char const *header_begin, *header_end, *nl;
 
@@ -473,7 +677,7 @@ bool mail_indexer::parse_header( char const *&c, char const *end,
   } // while
 
 last_header:
-  did_last_header_ = true;
+  did_last_header = true;
 
 more_headers:
   kv->value_end = nl;
@@ -27,12 +27,17 @@
 #include "charsets/charsets.h"
 #include "encodings/encodings.h"
 #include "filter.h"
+#include "index_context.h"
 #include "indexer.h"
+#include "pjl/mmap_file.h"
 
 // standard
 #include <memory>                       /* for unique_ptr */
 #include <string>
 #include <vector>
+#ifdef MULTI_THREADED
+#include <future>
+#endif /* MULTI_THREADED */
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -42,6 +47,10 @@
  * quoted-printable, HTML, MIME, vCard.  Header names and vCard types are
  * treated as meta names.
  *
+ * An mbox file, i.e., a file of several messages each starting with a
+ * \c "From " line, is indexed in place with each message being a separate
+ * document.
+ *
  * @sa David H. Crocker.  "RFC 822: Standard for the Format of ARPA Internet
  * Text Messages," Department of Electrical Engineering, University of
  * Delaware, August 1982.
@@ -62,9 +71,11 @@ class mail_indexer : public indexer {
 public:
   mail_indexer() : indexer( "mail" ) { }
 
-  char const* find_title( PJL::mmap_file const& ) const override;
-  void index_words( encoded_char_range const&,
+  bool find_documents( PJL::mmap_file const&,
+                       std::vector<size_t>& ) const override;
+  void index_words( index_context&, encoded_char_range const&,
                     meta_id_type = Meta_ID_None ) override;
+  void post_options() override;
 
 private:
   //
@@ -76,7 +87,34 @@ private:
   // oversight in STL, IMHO.
   //
   using boundary_stack_type = std::vector<std::string>;
-  static boundary_stack_type boundary_stack_;
+
+#ifdef MULTI_THREADED
+  /**
+   * A %filtered_attachment is an attachment whose filter is being executed in
+   * the background.
+   */
+  struct filtered_attachment {
+    std::unique_ptr<filter> filter_;
+    char const             *input;      // decoded bytes of the attachment
+    size_t                  input_size;
+    std::vector<char>       input_buf;  // copy of the bytes, if decoded
+    std::vector<char>       output;     // plain text
+    std::future<bool>       filtered;
+  };
+#endif /* MULTI_THREADED */
+
+  /**
+   * The per-file state of the mail indexer.
+   */
+  struct mail_state : index_context::module_state {
+    boundary_stack_type     boundary_stack;
+    bool                    did_last_header = false;
+    std::unique_ptr<char[]> decode_buf; // decoded body of the current part
+    size_t                  decode_buf_size = 0;
+#ifdef MULTI_THREADED
+    std::vector<std::unique_ptr<filtered_attachment>> filtered_attachments;
+#endif /* MULTI_THREADED */
+  };
 
   enum content_type {
     ct_unknown,                         // a type we don't know how to index
@@ -109,8 +147,6 @@ private:
     char const *value_begin, *value_end;
   };
 
-  static bool did_last_header_;
-
   /**
    * Compares the boundary, prefixed by \c "--", string starting at the given
    * iterator to the given string.
@@ -130,6 +166,7 @@ private:
    * determines the message type and encoding via the \c Content-Type and
    * \c Content-Transfer-Encoding headers.
    *
+   * @param ctx The context of the file being indexed.
    * @param c The pointer that must be positioned at the first character in the
    * file.  It is left after the last header.
    * @param end The pointer to the end of the file.
@@ -144,16 +181,56 @@ private:
    * Bodies," RFC 822 Extensions Working Group of the Internet Engineering Task
    * Force, November 1996.
    */
-  message_type index_headers( char const *&c, char const *end );
+  message_type index_headers( index_context &ctx, char const *&c,
+                             char const *end );
+
+  /**
+   * Gets the body of a message or attachment for indexing.  If it has a
+   * Content-Transfer-Encoding or is in UTF-8, the entire body is decoded in
+   * one shot into a per-file buffer rather than a character at a time while
+   * indexing.  The decoded body remains valid only until the next one is
+   * decoded.
+   *
+   * @param ctx The context of the file being indexed.
+   * @param type The type, character set, and encoding of the body.
+   * @param begin A pointer to the first character of the body.
+   * @param end A pointer to the end of the body.
+   * @param with_charset If \c false, the body's character set is ignored.
+   * @return Returns the range of the (possibly decoded) body.
+   */
+  encoded_char_range decode_body( index_context &ctx, message_type const &type,
+                                  char const *begin, char const *end,
+                                  bool with_charset = true ) const;
 
-  void index_multipart( char const*&, char const* );
-  void index_vcard( char const*&, char const* );
-  static void new_file();
+  void index_multipart( index_context&, char const*&, char const* );
+  void index_vcard( index_context&, char const*&, char const* );
+
+  /**
+   * Executes an attachment's filter to convert it into plain text and indexes
+   * the text.  If threads are available, the filter is executed in the
+   * background and the text is indexed by \c index_filtered_attachments().
+   *
+   * @param ctx The context of the file being indexed.
+   * @param type The type of the attachment including its filter.
+   * @param e The decoded attachment.
+   */
+  void index_via_filter( index_context &ctx, message_type const &type,
+                         encoded_char_range const &e );
+
+  /**
+   * Waits for the filters of attachments being executed in the background to
+   * finish and indexes their text in the order the attachments were
+   * encountered.
+   *
+   * @param ctx The context of the file being indexed.
+   */
+  void index_filtered_attachments( index_context &ctx );
 
   /**
    * Parses a single header and its value.  It properly handles values that are
    * folded across multiple lines.
    *
+   * @param ctx The context of the file being parsed.
    * @param c The pointer that must be positioned at the first character in a
    * header.  It is left after the last character in the value, or, if there
    * are no more headers, after the blank line marking the end of the headers.
@@ -166,7 +243,18 @@ private:
    * Text Messages," Department of Electrical Engineering, University of
    * Delaware, August 1982.
    */
-  static bool parse_header( char const *&c, char const *end, key_value *kv );
+  bool parse_header( index_context &ctx, char const *&c, char const *end,
+                     key_value *kv ) const;
+
+  /**
+   * Gets the state of this indexer for a file.
+   *
+   * @param ctx The context of the file.
+   * @return Returns said state.
+   */
+  mail_state& state( index_context &ctx ) const {
+    return ctx.state<mail_state>( this );
+  }
 };
 
 ////////// Inlines ////////////////////////////////////////////////////////////
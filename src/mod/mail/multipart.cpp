@@ -22,15 +22,21 @@
 // local
 #include "config.h"
 #include "encoded_char.h"
+#include "index_context.h"
 #include "mod_mail.h"
 #include "util.h"
 
+// standard
+#include <string>
+
 using namespace PJL;
 using namespace std;
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void mail_indexer::index_multipart( char const *&c, char const *end ) {
+void mail_indexer::index_multipart( index_context &ctx, char const *&c,
+                                    char const *end ) {
+  string const boundary( state( ctx ).boundary_stack.back() );
   char const *nl;
   //
   // Find the beginning boundary string.
@@ -38,7 +44,7 @@ void mail_indexer::index_multipart( char const *&c, char const *end ) {
   while ( (nl = find_newline( c, end )) != end ) {
     char const *const d = c;
     c = skip_newline( nl, end );
-    if ( boundary_cmp( d, nl, boundary_stack_.back().c_str() ) )
+    if ( boundary_cmp( d, nl, boundary.c_str() ) )
       break;
   } // while
   if ( nl == end )
@@ -53,16 +59,16 @@ void mail_indexer::index_multipart( char const *&c, char const *end ) {
     while ( (nl = find_newline( c, end )) != end ) {
       part_end = c;
       c = skip_newline( nl, end );
-      if ( boundary_cmp( part_end, nl, boundary_stack_.back().c_str() ) )
+      if ( boundary_cmp( part_end, nl, boundary.c_str() ) )
         break;
     } // while
 
     //
     // Index the words between the boundaries.
     //
-    encoded_char_range::decoder::reset_all();
+    ctx.reset_decoders();
     encoded_char_range const part( part_begin, part_end );
-    index_words( part );
+    index_words( ctx, part );
 
     //
     // See if the boundary string is the final one, i.e., followed by "--".
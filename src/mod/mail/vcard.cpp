@@ -23,6 +23,7 @@
 #include "config.h"
 #include "charsets/charsets.h"
 #include "encodings/encodings.h"
+#include "index_context.h"
 #include "indexer.h"
 #include "mod_mail.h"
 
@@ -33,7 +34,8 @@ using namespace std;
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void mail_indexer::index_vcard( char const *&c, char const *end ) {
+void mail_indexer::index_vcard( index_context &ctx, char const *&c,
+                                char const *end ) {
   //
   // Caveat:
   //    Nested vCards via the AGENT type are not handled properly, i.e., the
@@ -45,7 +47,7 @@ void mail_indexer::index_vcard( char const *&c, char const *end ) {
   //    1998.
   //
   key_value kv;
-  while ( parse_header( c, end, &kv ) ) {
+  while ( parse_header( ctx, c, end, &kv ) ) {
     //
     // Reuse parse_header() to parse vCard types, but trim them at semicolons.
     //
@@ -59,7 +61,7 @@ void mail_indexer::index_vcard( char const *&c, char const *end ) {
     encoded_char_range const e(
       kv.value_begin, kv.value_end, ISO_8859_1, Eight_Bit
     );
-    indexer::index_words( e, meta_id );
+    indexer::index_words( ctx, e, meta_id );
   } // while
 }
 
@@ -25,6 +25,7 @@
 #include "AssociateMeta.h"
 #include "config.h"
 #include "encoded_char.h"
+#include "index_context.h"
 #include "indexer.h"
 #include "iso8859-1.h"
 #include "TitleLines.h"
@@ -133,73 +134,8 @@ static void parse_backslash( char const *&c, char const *end ) {
 
 ////////// member functions ///////////////////////////////////////////////////
 
-char const* man_indexer::find_title( mmap_file const &file ) const {
-  unsigned  lines = 0;
-  bool      newline = true;
-
-  for ( auto c = file.begin(); c != file.end(); ) {
-    if ( newline && ++lines > num_title_lines ) {
-      //
-      // Didn't find ".SH NAME" within first num_title_lines lines of file:
-      // forget it.
-      //
-      return nullptr;
-    }
-
-    //
-    // Find the start of a macro, i.e., a line that begins with a '.' (dot).
-    //
-    if ( !(newline && *c == '.') ) {    // not macro: forget it
-      newline = *c++ == '\n';
-      continue;
-    }
-
-    //
-    // Found a macro: is it a comment?  If so, skip it.
-    //
-    if ( is_man_comment( ++c, file.end() ) )
-      continue;
-
-    //
-    // Is the macro ".SH NAME"?
-    //
-    newline = false;
-    if ( !move_if_match( c, file.end(), "SH" ) )
-      continue;
-    while ( c != file.end() && isspace( *c ) )
-      ++c;
-    if ( !move_if_match( c, file.end(), "NAME" ) )
-      continue;
-
-    //
-    // Found ".SH NAME": skip the newline to get to the beginning of the title
-    // on the next line.  The end of the title is the end of that next line.
-    //
-    c = skip_newline( find_newline( c, file.end() ), file.end() );
-    char *const title = tidy_title( c, find_newline( c, file.end() ) );
-
-    //
-    // Go through the title and process backslashed character sequences in case
-    // there are things like \fBword\fP in it so they can be stripped out.
-    //
-    char *d = title;
-    for ( c = title; *c; ++c ) {
-      if ( *c == '\\' )
-        parse_backslash( ++c, file.end() );
-      *d++ = *c;
-    } // for
-    *d = '\0';
-
-    return title;
-  } // for
-
-  //
-  // The file has less than num_title_lines lines and no .SH NAME was found.
-  //
-  return nullptr;
-}
-
-void man_indexer::index_words( encoded_char_range const &e,
+void man_indexer::index_words( index_context &ctx,
+                               encoded_char_range const &e,
                                meta_id_type meta_id ) {
   char  word[ Word_Hard_Max_Size + 1 ];
   bool  in_word = false;
@@ -244,7 +180,7 @@ void man_indexer::index_words( encoded_char_range const &e,
       // including, it.
       //
       in_word = false;
-      index_word( word, len, meta_id );
+      index_word( ctx, word, len, meta_id );
     }
 
     if ( newline && ch == '.' && meta_id == Meta_ID_None ) {
@@ -252,7 +188,7 @@ void man_indexer::index_words( encoded_char_range const &e,
       // If we're at the first character on a line and the character is a '.'
       // (the start of a macro), parse it.
       //
-      parse_man_macro( c, e.end_pos() );
+      parse_man_macro( ctx, c, e.end_pos() );
     }
 
 next_c:
@@ -266,13 +202,52 @@ next_c:
     // We ran into 'end' while still accumulating characters into a word, so
     // just index what we've got.
     //
-    index_word( word, len, meta_id );
+    index_word( ctx, word, len, meta_id );
   }
 }
 
-void man_indexer::parse_man_macro( char const *&c, char const *end ) {
+void man_indexer::parse_man_macro( index_context &ctx, char const *&c,
+                                   char const *end ) {
   if ( !move_if_match( c, end, "SH" ) )
     return;
+
+  ////////// Report the title /////////////////////////////////////////////////
+
+  if ( ctx.wants_title( this ) ) {
+    //
+    // Is the macro ".SH NAME"?
+    //
+    char const *d = c;
+    while ( d != end && isspace( *d ) )
+      ++d;
+    if ( move_if_match( d, end, "NAME" ) ) {
+      char *title = nullptr;
+      if ( ctx.newlines_before( c, num_title_lines ) < num_title_lines ) {
+        //
+        // Found the first ".SH NAME" within the first num_title_lines lines of
+        // the file: skip the newline to get to the beginning of the title on
+        // the next line.  The end of the title is the end of that next line.
+        //
+        d = skip_newline( find_newline( d, end ), end );
+        title = tidy_title( d, find_newline( d, end ) );
+
+        //
+        // Go through the title and process backslashed character sequences in
+        // case there are things like \fBword\fP in it so they can be stripped
+        // out.
+        //
+        char *t = title;
+        for ( d = title; *d; ++d ) {
+          if ( *d == '\\' )
+            parse_backslash( ++d, end );
+          *t++ = *d;
+        } // for
+        *t = '\0';
+      }
+      ctx.title( title );
+    }
+  }
+
   char const *const nl = find_newline( c, end );
   if ( !nl )
     return;
@@ -359,7 +334,7 @@ void man_indexer::parse_man_macro( char const *&c, char const *end ) {
   // Index the words in between the two .SH macros marking them as being
   // associated with the value of the current section heading name.
   //
-  index_words( encoded_char_range( begin, c ), meta_id );
+  index_words( ctx, encoded_char_range( begin, c ), meta_id );
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -35,8 +35,7 @@ class man_indexer : public indexer {
 public:
   man_indexer() : indexer( "man" ) { }
 
-  char const* find_title( PJL::mmap_file const& ) const override;
-  void index_words( encoded_char_range const&,
+  void index_words( index_context&, encoded_char_range const&,
                     meta_id_type = Meta_ID_None ) override;
 
 private:
@@ -46,11 +45,12 @@ private:
    * the end of the range and index all the words in between as being
    * associated with the section heading meta name.
    *
+   * @param ctx The context of the file being indexed.
    * @param c The iterator to use.  It must be positioned at the character
    * after the '.'; it is repositioned.
    * @param end The iterator marking the end of the file.
    */
-  void parse_man_macro( char const *&c, char const *end );
+  void parse_man_macro( index_context &ctx, char const *&c, char const *end );
 };
 
 ///////////////////////////////////////////////////////////////////////////////
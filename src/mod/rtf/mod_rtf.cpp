@@ -23,9 +23,11 @@
 #include "config.h"
 #include "mod_rtf.h"
 #include "AssociateMeta.h"
+#include "encoded_char_dispatch.h"
+#include "index_context.h"
 #include "indexer.h"
 #include "iso8859-1.h"
-#include "pjl/hash.h"
+#include "pjl/perfect_hash.h"
 #include "TitleLines.h"
 #include "word_util.h"
 
@@ -42,7 +44,7 @@ using namespace std;
  */
 unsigned const RTF_Control_Scan_Close_Max = 100;
 
-static unordered_char_ptr_set const info_group_set{
+static constexpr char const *const info_group_table[] = {
   "author",
   "category",
   "comment",
@@ -54,54 +56,37 @@ static unordered_char_ptr_set const info_group_set{
   "title",
 };
 
-///////////////////////////////////////////////////////////////////////////////
+static constexpr perfect_hash_set info_group_set{ info_group_table };
 
-char const* rtf_indexer::find_title( mmap_file const &file ) const {
-  unsigned lines = 0;
-  //
-  // Look for a title like:
-  //
-  //    {\title This is a title}
-  //
-  encoded_char_range::const_iterator c( file.begin(), file.end() );
-  for ( ; !c.at_end(); ++c ) {
-    if ( *c == '\n' && ++lines > num_title_lines ) {
-      //
-      // Didn't find \title within first num_title_lines lines of file: forget
-      // it.
-      //
-      break;
-    }
+///////////////////////////////////////////////////////////////////////////////
 
-    if ( *c == '\\' && move_if_match( ++c, "title " ) ) {
-      //
-      // Found the \title control word.
-      //
-      if ( !c.at_end() ) {
-        for ( auto const start = c.pos(); !c.at_end(); ++c ) {
-          switch ( *c ) {
-            case '}':
-              return tidy_title( start, c.pos() );
-            case '\n':
-              if ( ++lines > num_title_lines )
-                return nullptr;
-          } // switch
-        } // for
-      }
-      break;
-    }
-  } // for
-  return nullptr;
+void rtf_indexer::index_words( index_context &ctx,
+                               encoded_char_range const &e,
+                               meta_id_type meta_id ) {
+  dispatch_decoder( e, [this,&ctx,meta_id]( auto c ) {
+    index_rtf_words( ctx, c, meta_id );
+  } );
 }
 
-void rtf_indexer::index_words( encoded_char_range const &e,
-                               meta_id_type meta_id ) {
+/**
+ * Indexes the words in a range of RTF text.  This is a template so that it can
+ * be instantiated for each decoder by dispatch_decoder().
+ *
+ * @tparam CharIterator The type of iterator over the encoded characters.
+ * @param ctx The index_context to use.
+ * @param c An iterator positioned at the first character.
+ * @param meta_id The numeric ID of the meta name the words are indexed under,
+ * if any.
+ */
+template<class CharIterator>
+void rtf_indexer::index_rtf_words( index_context &ctx, CharIterator c,
+                                   meta_id_type meta_id ) {
   char  word[ Word_Hard_Max_Size + 1 ];
   char  control[ Word_Hard_Max_Size + 1 ];
   bool  in_control = false, in_word = false, restart = false;
-  int   len, control_len;
+  int   len = 0, control_len = 0;
 
-  for ( auto c = e.begin(); !c.at_end(); ) {
+  while ( !c.at_end() ) {
     char ch = iso8859_1_to_ascii( *c++ );
 
     ////////// Handle escaped characters //////////////////////////////////////
@@ -165,9 +150,24 @@ restart:
         ch = '\'';
         goto if_is_word_char;
       }
+      if ( ctx.wants_title( this ) && ::strcmp( control, "title" ) == 0 ) {
+        //
+        // Found the first "{\title This is a title}": the title is everything
+        // up to the '}' provided it's within the first num_title_lines lines
+        // of the file.
+        //
+        char const *const begin = c.pos();
+        char const *const end = static_cast<char const*>(
+          ::memchr( begin, '}', c.end_pos() - begin )
+        );
+        ctx.title(
+          end && ctx.newlines_before( end, num_title_lines ) <= num_title_lines ?
+            tidy_title( begin, end ) : nullptr
+        );
+      }
       if ( meta_id != Meta_ID_None )
         continue;
-      if ( contains( info_group_set, control ) ) {
+      if ( info_group_set.contains( control ) ) {
         if ( associate_meta ) {
           //
           // Do not index the words in the value of the info group member if
@@ -177,10 +177,11 @@ restart:
           meta_id_type const control_meta_id = find_meta( control );
           if ( control_meta_id == Meta_ID_None )
             continue;
-          auto d = c;
+          encoded_char_range::const_iterator const c2( c );
+          auto d = c2;
           if ( skip_char( &d, '}' ) ) {
-            encoded_char_range const e( c, d );
-            index_words( e, control_meta_id );
+            encoded_char_range const e( c2, d );
+            index_words( ctx, e, control_meta_id );
           }
         }
       }
@@ -196,8 +197,10 @@ restart:
     ////////// Ignore HYPERLINKs //////////////////////////////////////////////
 
     if ( ch == '{' && c.safe_deref() == 'H' ) {
-      if ( move_if_match( c, "HYPERLINK " ) ) {
-        skip_char( &c, '}', RTF_Control_Scan_Close_Max );
+      encoded_char_range::const_iterator c2( c );
+      if ( move_if_match( c2, "HYPERLINK " ) ) {
+        skip_char( &c2, '}', RTF_Control_Scan_Close_Max );
+        c = c2;
         continue;
       }
     }
@@ -229,21 +232,21 @@ if_in_word:
       // including, it.
       //
       in_word = false;
-      index_word( word, len, meta_id );
+      index_word( ctx, word, len, meta_id );
     }
 
     if ( restart ) {
       restart = false;
       goto restart;
     }
-  } // for
+  } // while
 
   if ( in_word ) {
     //
     // We ran into 'end' while still accumulating characters into a word, so
     // just index what we've got.
     //
-    index_word( word, len, meta_id );
+    index_word( ctx, word, len, meta_id );
   }
 }
 
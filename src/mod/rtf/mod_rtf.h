@@ -44,9 +44,12 @@ class rtf_indexer : public indexer {
 public:
   rtf_indexer() : indexer( "RTF" ) { }
 
-  char const* find_title( PJL::mmap_file const& ) const override;
-  void index_words( encoded_char_range const&,
-                    meta_id_type = Meta_ID_None) override;
+  void index_words( index_context&, encoded_char_range const&,
+                    meta_id_type = Meta_ID_None ) override;
+
+private:
+  template<class CharIterator>
+  void index_rtf_words( index_context&, CharIterator, meta_id_type );
 };
 
 ///////////////////////////////////////////////////////////////////////////////
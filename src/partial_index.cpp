@@ -0,0 +1,297 @@
+/*
+**      SWISH++
+**      src/partial_index.cpp
+**
+**      Copyright (C) 2026  Paul J. Lucas
+**
+**      This program is free software; you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation; either version 2 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program; if not, write to the Free Software
+**      Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+// local
+#include "config.h"
+#include "exit_codes.h"
+#include "file_list.h"
+#include "partial_index.h"
+#include "util.h"
+
+// standard
+#include <cerrno>
+#include <cstring>
+
+// zlib
+#ifdef HAVE_LIBZ
+#include <zlib.h>
+#endif /* HAVE_LIBZ */
+
+using namespace std;
+
+/**
+ * The first bytes of a compressed partial index that identify it as such.  As
+ * a \c long, they'd be far too many words for an uncompressed partial index.
+ */
+static char const Compressed_Magic[] = "SWISH++Z";
+
+/**
+ * The size of the header of a compressed partial index.
+ */
+static size_t const Compressed_Header_Size =
+  sizeof Compressed_Magic - 1 + 2 * sizeof( long ) + sizeof( off_t );
+
+#ifdef HAVE_LIBZ
+/**
+ * The number of bytes of word entries to accumulate before compressing them
+ * as a block.  A block is never split within an entry, so a block can be
+ * larger.
+ */
+static size_t const Compressed_Block_Size = 64 * 1024;
+#endif /* HAVE_LIBZ */
+
+/**
+ * Gets a value from a compressed partial index and advances past it.
+ *
+ * @tparam T The type of the value.
+ * @param p A pointer to the value that is advanced past it.
+ * @param value The value.
+ */
+template<typename T>
+inline void get_value( char const *&p, T &value ) {
+  ::memcpy( &value, p, sizeof value );
+  p += sizeof value;
+}
+
+#ifdef HAVE_LIBZ
+/**
+ * Appends a value to a compressed partial index's block table.
+ *
+ * @tparam T The type of the value.
+ * @param s The string to append to.
+ * @param value The value.
+ */
+template<typename T>
+inline void put_value( string &s, T const &value ) {
+  s.append( reinterpret_cast<char const*>( &value ), sizeof value );
+}
+#endif /* HAVE_LIBZ */
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool has_file_list( PJL::mmap_file const &index_file,
+                    index_segment const &stop_words, size_t i ) {
+  //
+  // Since stop-word entries are written contiguously and are followed by the
+  // directories, an entry has a file list only if it doesn't end right after
+  // the word.
+  //
+  index_segment const dirs( index_file, index_segment::isi_dir );
+  char const *const entry_end =
+    i + 1 < stop_words.size() ? stop_words[ i + 1 ] :
+    dirs.size() ? dirs[0] : index_file.end();
+  return stop_words[i] + ::strlen( stop_words[i] ) + 1 < entry_end;
+}
+
+bool partial_index::open( char const *path, bool segment ) {
+  path_ = path;
+  if ( !file_.open( path ) )
+    return false;
+
+  size_t const magic_len = sizeof Compressed_Magic - 1;
+  compressed_ = file_.size() >= Compressed_Header_Size &&
+    !::memcmp( file_.begin(), Compressed_Magic, magic_len );
+
+  if ( !compressed_ ) {
+    words_.set_index_file( file_, index_segment::isi_word );
+    num_words_ = words_.size();
+    if ( segment ) {
+      index_segment const stop_words( file_, index_segment::isi_stop_word );
+      for ( size_t i = 0; i < stop_words.size(); ++i )
+        if ( has_file_list( file_, stop_words, i ) )
+          frequent_words_.push_back( stop_words[i] );
+      num_words_ += frequent_words_.size();
+    }
+    raw_size_ = file_.size();
+    rewind();
+    return true;
+  }
+
+#ifdef HAVE_LIBZ
+  char const *p = file_.begin() + magic_len;
+  long num_blocks;
+  off_t block_table_offset;
+  get_value( p, num_words_ );
+  get_value( p, num_blocks );
+  get_value( p, block_table_offset );
+
+  raw_size_ = sizeof( long ) + num_words_ * sizeof( off_t );
+  blocks_.resize( num_blocks );
+  p = file_.begin() + block_table_offset;
+  for ( auto &b : blocks_ ) {
+    get_value( p, b.offset );
+    get_value( p, b.compressed_size );
+    get_value( p, b.raw_size );
+    get_value( p, b.first_word );
+    p += ::strlen( p ) + 1;             // skip first word
+    raw_size_ += b.raw_size;
+  } // for
+
+  rewind();
+  return true;
+#else
+  //
+  // Written by an index that was built with zlib: this one can't read it.
+  //
+  error_ = ENOTSUP;
+  return false;
+#endif /* HAVE_LIBZ */
+}
+
+partial_index& partial_index::operator++() {
+  if ( ++word_index_ == num_words_ ) {
+    entry_ = nullptr;
+  } else if ( !compressed_ ) {
+    next_entry();
+  } else if ( block_index_ + 1 < blocks_.size() &&
+              word_index_ == blocks_[ block_index_ + 1 ].first_word ) {
+    read_block( block_index_ + 1 );
+  } else {
+    file_list const list( entry_ );
+    entry_ += ::strlen( entry_ ) + 1 + list.bytes();
+  }
+  return *this;
+}
+
+/**
+ * Positions an uncompressed partial index at the lesser of its next word and
+ * its next frequent word.
+ */
+void partial_index::next_entry() {
+  if ( frequent_word_ < frequent_words_.size() &&
+       (word_ == words_.end() ||
+        ::strcmp( frequent_words_[ frequent_word_ ], *word_ ) < 0) ) {
+    entry_ = frequent_words_[ frequent_word_++ ];
+  } else {
+    entry_ = *word_++;
+  }
+}
+
+void partial_index::read_block( size_t i ) {
+#ifdef HAVE_LIBZ
+  block const &b = blocks_[ i ];
+  buf_.resize( b.raw_size );
+  uLongf raw_size = b.raw_size;
+  int const z_err = ::uncompress(
+    reinterpret_cast<Bytef*>( buf_.data() ), &raw_size,
+    reinterpret_cast<Bytef const*>( file_.begin() + b.offset ),
+    b.compressed_size
+  );
+  if ( z_err != Z_OK || raw_size != static_cast<uLongf>( b.raw_size ) ) {
+    ::error() << "can not decompress temp. file \"" << path_ << "\": "
+            << ::zError( z_err ) << endl;
+    ::exit( Exit_No_Open_Temp );
+  }
+  block_index_ = i;
+  entry_ = buf_.data();
+#endif /* HAVE_LIBZ */
+}
+
+void partial_index::rewind() {
+  word_index_ = 0;
+  entry_ = nullptr;
+  if ( !num_words_ )
+    return;
+  if ( compressed_ ) {
+    read_block( 0 );
+  } else {
+    word_ = words_.begin();
+    frequent_word_ = 0;
+    next_entry();
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_LIBZ
+
+compressed_partial_writer::compressed_partial_writer( ostream &o,
+                                                      long num_words ) :
+  o_( o ),
+  header_pos_( o.tellp() ),
+  num_words_( num_words )
+{
+  write_header( 0 );                    // placeholder until close()
+}
+
+void compressed_partial_writer::add( string const &entry ) {
+  if ( block_.empty() ) {
+    first_word_index_ = word_index_;
+    first_word_ = entry.c_str();
+  }
+  block_ += entry;
+  ++word_index_;
+  if ( block_.size() >= Compressed_Block_Size )
+    flush();
+}
+
+void compressed_partial_writer::close() {
+  flush();
+  off_t const block_table_offset = o_.tellp();
+  o_.write( table_.data(), table_.size() );
+  o_.seekp( header_pos_ );
+  write_header( block_table_offset );
+  o_ << assert_stream;
+}
+
+void compressed_partial_writer::flush() {
+  if ( block_.empty() )
+    return;
+
+  uLongf compressed_size = ::compressBound( block_.size() );
+  buf_.resize( compressed_size );
+  int const z_err = ::compress2(
+    buf_.data(), &compressed_size,
+    reinterpret_cast<Bytef const*>( block_.data() ), block_.size(),
+    Z_BEST_SPEED
+  );
+  if ( z_err != Z_OK ) {
+    error() << "compressing temp. file failed: " << ::zError( z_err ) << endl;
+    ::exit( Exit_No_Write_Temp );
+  }
+
+  put_value( table_, static_cast<off_t>( o_.tellp() ) );
+  put_value( table_, static_cast<long>( compressed_size ) );
+  put_value( table_, static_cast<long>( block_.size() ) );
+  put_value( table_, first_word_index_ );
+  table_.append( first_word_.c_str(), first_word_.size() + 1 );
+
+  o_.write( reinterpret_cast<char const*>( buf_.data() ), compressed_size );
+  o_ << assert_stream;
+  ++num_blocks_;
+  block_.clear();
+}
+
+void compressed_partial_writer::write_header( off_t block_table_offset ) {
+  o_.write( Compressed_Magic, sizeof Compressed_Magic - 1 );
+  o_.write( reinterpret_cast<char const*>( &num_words_ ), sizeof num_words_ );
+  o_.write( reinterpret_cast<char const*>( &num_blocks_ ), sizeof num_blocks_ );
+  o_.write(
+    reinterpret_cast<char const*>( &block_table_offset ),
+    sizeof block_table_offset
+  );
+  o_ << assert_stream;
+}
+
+#endif /* HAVE_LIBZ */
+
+///////////////////////////////////////////////////////////////////////////////
+/* vim:set et sw=2 ts=2: */
@@ -0,0 +1,262 @@
+/*
+**      SWISH++
+**      src/partial_index.h
+**
+**      Copyright (C) 2026  Paul J. Lucas
+**
+**      This program is free software; you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation; either version 2 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program; if not, write to the Free Software
+**      Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#ifndef partial_index_H
+#define partial_index_H
+
+// local
+#include "config.h"
+#include "index_segment.h"
+#include "pjl/mmap_file.h"
+
+// standard
+#include <iostream>
+#include <string>
+#include <sys/types.h>                  /* for off_t */
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A %partial_index reads the word entries (a word followed by its file list)
+ * of a partial index (or of an index segment being merged) in order.  For an
+ * index segment, the entries of the stop words that were too frequent (that
+ * also have file lists) are read in order along with those of the words.
+ *
+ * A partial index is either in the same format as the word index of a
+ * complete index, in which case it's simply memory-mapped, or compressed
+ * (see %compressed_partial_writer), in which case its blocks are decompressed
+ * one at a time.
+ */
+class partial_index {
+public:
+  using size_type = long;
+
+  partial_index() { }
+  partial_index( partial_index const& ) = delete;
+  partial_index& operator=( partial_index const& ) = delete;
+
+  /**
+   * Opens a partial index.
+   *
+   * @param path The full path of the partial index.
+   * @param segment If \c true, the partial index is an index segment.
+   * @return Returns \c true only if the partial index was opened successfully.
+   */
+  bool open( char const *path, bool segment = false );
+
+  /**
+   * Gets the error code from opening the partial index.
+   *
+   * @return Returns said code or 0 if none.
+   */
+  int error() const {
+    return file_.error() ? file_.error() : error_;
+  }
+
+  /**
+   * Gets whether the partial index is compressed.
+   *
+   * @return Returns \c true only if it is.
+   */
+  bool compressed() const {
+    return compressed_;
+  }
+
+  /**
+   * Gets the size of the partial index as written.
+   *
+   * @return Returns said size in bytes.
+   */
+  size_t file_size() const {
+    return file_.size();
+  }
+
+  /**
+   * Gets the size the partial index would have been had it not been
+   * compressed.
+   *
+   * @return Returns said size in bytes.
+   */
+  size_t raw_size() const {
+    return raw_size_;
+  }
+
+  /**
+   * Gets the number of words in the partial index.
+   *
+   * @return Returns said number.
+   */
+  size_type size() const {
+    return num_words_;
+  }
+
+  /**
+   * Positions this partial index at its first word.
+   */
+  void rewind();
+
+  /**
+   * Gets whether all the words have been read.
+   *
+   * @return Returns \c true only if they have.
+   */
+  bool at_end() const {
+    return word_index_ == num_words_;
+  }
+
+  /**
+   * Gets the current word entry.  The pointer remains valid only until this
+   * partial index is advanced.
+   *
+   * @return Returns a pointer to the current word (that is followed by its
+   * file list).
+   */
+  char const* operator*() const {
+    return entry_;
+  }
+
+  /**
+   * Advances to the next word.
+   *
+   * @return Returns \c *this.
+   */
+  partial_index& operator++();
+
+private:
+  /**
+   * A %block describes one compressed block of word entries.
+   */
+  struct block {
+    off_t     offset;                   // of compressed data in the file
+    size_type compressed_size;
+    size_type raw_size;
+    size_type first_word;               // index of the first word in it
+  };
+
+  void next_entry();
+  void read_block( size_t );
+
+  std::string         path_;
+  PJL::mmap_file      file_;
+  int                 error_ = 0;
+  bool                compressed_ = false;
+  size_type           num_words_ = 0;
+  size_type           word_index_ = 0;
+  char const         *entry_ = nullptr;
+  size_t              raw_size_ = 0;
+
+  // uncompressed
+  index_segment                 words_;
+  index_segment::const_iterator word_;  // next word
+  std::vector<char const*>      frequent_words_;
+  size_t                        frequent_word_ = 0; // next frequent word
+
+  // compressed
+  std::vector<block>  blocks_;
+  size_t              block_index_ = 0;
+  std::vector<char>   buf_;             // current decompressed block
+};
+
+/**
+ * Gets whether the entry of a stop word in an index is followed by a file
+ * list, i.e., whether the word was too frequent rather than being a stop word
+ * to begin with.  (Indices written by older versions have no file lists for
+ * stop words.)
+ *
+ * @param index_file The index file.
+ * @param stop_words The stop-word index of \a index_file.
+ * @param i The index of the stop word.
+ * @return Returns \c true only if it is.
+ */
+bool has_file_list( PJL::mmap_file const &index_file,
+                    index_segment const &stop_words, size_t i );
+
+#ifdef HAVE_LIBZ
+
+/**
+ * A %compressed_partial_writer writes a partial index in compressed form.
+ * Word entries are accumulated into blocks of whole entries and each block is
+ * compressed independently.  The format of a compressed partial index file
+ * is:
+ * \code
+ *    char  magic[8];
+ *    long  num_words;
+ *    long  num_blocks;
+ *    off_t block_table_offset;
+ *          (compressed blocks)
+ *          (block table)
+ * \endcode
+ * where each entry of the block table is:
+ * \code
+ *    off_t offset;
+ *    long  compressed_size;
+ *    long  raw_size;
+ *    long  first_word_index;
+ *    char  first_word[];               // null-terminated
+ * \endcode
+ * so a word can be found by searching the block table and decompressing only
+ * the block it's in.
+ */
+class compressed_partial_writer {
+public:
+  /**
+   * Constructs a %compressed_partial_writer and writes the header.
+   *
+   * @param o The ostream to write the partial index to.
+   * @param num_words The number of words that will be written.
+   */
+  compressed_partial_writer( std::ostream &o, long num_words );
+
+  /**
+   * Adds a word entry.
+   *
+   * @param entry The entry: a null-terminated word followed by its file list.
+   */
+  void add( std::string const &entry );
+
+  /**
+   * Writes the last block and the block table and completes the header.
+   */
+  void close();
+
+private:
+  void flush();
+  void write_header( off_t block_table_offset );
+
+  std::ostream       &o_;
+  std::streampos      header_pos_;
+  long const          num_words_;
+  long                word_index_ = 0;
+  long                first_word_index_ = 0;
+  std::string         first_word_;      // of the current block
+  std::string         block_;           // current uncompressed block
+  std::string         table_;           // block table written so far
+  long                num_blocks_ = 0;
+  std::vector<unsigned char> buf_;
+};
+
+#endif /* HAVE_LIBZ */
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif /* partial_index_H */
+/* vim:set et sw=2 ts=2: */
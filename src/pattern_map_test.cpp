@@ -0,0 +1,156 @@
+/*
+**      SWISH++
+**      src/pattern_map_test.cpp
+**
+**      Copyright (C) 2026  Paul J. Lucas
+**
+**      This program is free software; you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation; either version 2 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program; if not, write to the Free Software
+**      Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+//
+// Checks that pattern_map::find() finds the same pattern for every filename
+// whether or not the patterns have been compiled.  It's run by "make check"
+// and exits with a non-zero status if any check fails.
+//
+
+// local
+#include "config.h"
+#include "pjl/pattern_map.h"
+
+// standard
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+static char const *const patterns[] = {
+  "*.html",
+  "*.txt",
+  "*[ch]",
+  "*[*]",
+  "*\\*",
+  "README",
+  "[*]abc",
+  "[a-c]*z",
+  "[!a]*.gz",
+  "\\*x",
+  "a*b",
+  "a\\*bc",
+  "f?o*",
+  "x[!*]y",
+  "x[*]*y",
+  "x\\[*]",
+  nullptr
+};
+
+static char const *const file_names[] = {
+  "",
+  "*",
+  "*abc",
+  "*x",
+  "]abc",
+  "README",
+  "README.txt",
+  "a*bc",
+  "a.tar.gz",
+  "ab",
+  "abc",
+  "abz",
+  "axxb",
+  "b.tar.gz",
+  "cz",
+  "foo.c",
+  "fxo.h",
+  "index.html",
+  "x*",
+  "x*qy",
+  "x[]",
+  "x[q]",
+  "xqy",
+  "xy",
+  "z*",
+  nullptr
+};
+
+static int failures;
+
+/**
+ * Gets the pattern found in a map or a placeholder if none.
+ *
+ * @param map The map.
+ * @param i The iterator returned by \c find().
+ * @return Returns said pattern.
+ */
+static char const* found( pattern_map<int> const &map,
+                          pattern_map<int>::const_iterator i ) {
+  return i == map.end() ? "(none)" : i->first;
+}
+
+/**
+ * Checks that a compiled pattern map finds the same pattern as an uncompiled
+ * one for every filename.
+ *
+ * @param map The uncompiled map.
+ */
+static void check( pattern_map<int> const &map ) {
+  pattern_map<int> compiled( map );
+  compiled.compile();
+  for ( auto name = file_names; *name; ++name ) {
+    string const expected = found( map, map.find( *name ) );
+    string const actual = found( compiled, compiled.find( *name ) );
+    if ( actual != expected ) {
+      cerr << "\"" << *name << "\": compiled found \"" << actual
+           << "\"; uncompiled found \"" << expected << "\"\n";
+      ++failures;
+    }
+  } // for
+}
+
+/**
+ * Checks that a compiled pattern map having only a pattern matches a
+ * filename.
+ *
+ * @param pattern The pattern.
+ * @param file_name The filename it must match.
+ */
+static void check_matches( char const *pattern, char const *file_name ) {
+  pattern_map<int> map;
+  map.insert( pattern, 0 );
+  map.compile();
+  if ( !map.matches( file_name ) ) {
+    cerr << "\"" << pattern << "\" doesn't match \"" << file_name << "\"\n";
+    ++failures;
+  }
+}
+
+int main() {
+  pattern_map<int> all;
+  for ( auto pattern = patterns; *pattern; ++pattern ) {
+    pattern_map<int> one;
+    one.insert( *pattern, 0 );
+    check( one );
+    all.insert( *pattern, 0 );
+  } // for
+  check( all );
+
+  check_matches( "[*]abc", "*abc" );
+  check_matches( "x[!*]y", "xqy" );
+
+  return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/* vim:set et sw=2 ts=2: */
@@ -0,0 +1,175 @@
+/*
+**      PJL C++ Library
+**      flat_string_set.h
+**
+**      Copyright (C) 2026  Paul J. Lucas
+**
+**      This program is free software; you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation; either version 2 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program; if not, write to the Free Software
+**      Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#ifndef pjl_flat_string_set_H
+#define pjl_flat_string_set_H
+
+// local
+#include "config.h"
+
+// standard
+#include <cstddef>                      /* for size_t */
+#include <cstdint>
+#include <cstring>                      /* for memcmp(3) */
+#include <utility>                      /* for swap() */
+#include <vector>
+
+namespace PJL {
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A %flat_string_set is a set of C strings built at run-time that's an open-
+ * addressing hash table stored in a single array.  Each slot records the full
+ * hash and the length of its string along with the string itself, so finding
+ * a string takes one pass over it to compute both and, for all practical
+ * purposes, only one memcmp(3) against the string that actually matches.
+ *
+ * @remarks A %flat_string_set never copies the strings it contains: their
+ * memory must outlive it.
+ */
+class flat_string_set {
+public:
+  flat_string_set() { }
+
+  /**
+   * Gets whether this set contains a string.
+   *
+   * @param s The null-terminated string to check for.
+   * @return Returns \c true only if it does.
+   */
+  bool contains( char const *s ) const {
+    if ( !size_ )
+      return false;
+    size_t len;
+    std::uint64_t const h = hash( s, &len );
+    for ( size_t i = h >> shift_; ; i = (i + 1) & (slots_.size() - 1) ) {
+      slot const &t = slots_[i];
+      if ( !t.s_ )
+        return false;
+      if ( t.hash_ == h && t.len_ == len && !std::memcmp( t.s_, s, len ) )
+        return true;
+    } // for
+  }
+
+  /**
+   * Inserts a string unless the set already contains it.
+   *
+   * @param s The null-terminated string to insert.  Its memory must outlive
+   * this set.
+   * @return Returns \c true only if \a s was inserted.
+   */
+  bool insert( char const *s ) {
+    if ( 2 * (size_ + 1) > slots_.size() )
+      rehash( slots_.empty() ? Initial_Slots : 2 * slots_.size() );
+    size_t len;
+    std::uint64_t const h = hash( s, &len );
+    size_t i = h >> shift_;
+    for ( ; slots_[i].s_; i = (i + 1) & (slots_.size() - 1) ) {
+      slot const &t = slots_[i];
+      if ( t.hash_ == h && t.len_ == len && !std::memcmp( t.s_, s, len ) )
+        return false;
+    } // for
+    slots_[i] = slot{ s, len, h };
+    ++size_;
+    return true;
+  }
+
+  /**
+   * Reserves enough slots so that inserting strings won't rehash.
+   *
+   * @param n The number of strings this set will contain.
+   */
+  void reserve( size_t n ) {
+    size_t slots = Initial_Slots;
+    while ( slots < 2 * n )
+      slots *= 2;
+    if ( slots > slots_.size() )
+      rehash( slots );
+  }
+
+  /**
+   * Gets the number of strings in this set.
+   *
+   * @return Returns said number.
+   */
+  size_t size() const {
+    return size_;
+  }
+
+private:
+  static constexpr size_t Initial_Slots = 64;
+
+  struct slot {
+    char const   *s_ = nullptr;
+    size_t        len_ = 0;
+    std::uint64_t hash_ = 0;
+  };
+
+  /**
+   * Hashes a string via FNV-1a then spreads the bits via a Fibonacci
+   * multiplier so the high-order bits used for the slot depend on all of them.
+   *
+   * @param s The null-terminated string to hash.
+   * @param len A pointer to receive the length of \a s.
+   * @return Returns said hash.
+   */
+  static std::uint64_t hash( char const *s, size_t *len ) {
+    std::uint64_t h = 14695981039346656037ull;
+    char const *const begin = s;
+    for ( ; *s; ++s )
+      h = (h ^ static_cast<unsigned char>( *s )) * 1099511628211ull;
+    *len = s - begin;
+    return h * 0x9E3779B97F4A7C15ull;
+  }
+
+  /**
+   * Moves all the strings into a new array of slots.
+   *
+   * @param n The number of slots.  It must be a power of 2.
+   */
+  void rehash( size_t n ) {
+    std::vector<slot> old( n );
+    std::swap( slots_, old );
+    shift_ = 64;
+    for ( ; n > 1; n >>= 1 )
+      --shift_;
+    for ( slot const &t : old ) {
+      if ( !t.s_ )
+        continue;
+      size_t i = t.hash_ >> shift_;
+      while ( slots_[i].s_ )
+        i = (i + 1) & (slots_.size() - 1);
+      slots_[i] = t;
+    } // for
+  }
+
+  std::vector<slot> slots_;
+  size_t            size_ = 0;
+  unsigned          shift_ = 64;        // 64 - log2( slots_.size() )
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // namespace PJL
+
+#endif /* pjl_flat_string_set_H */
+/* vim:set et sw=2 ts=2: */
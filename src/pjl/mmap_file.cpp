@@ -65,6 +65,7 @@ extern "C" void max_out_limits() {
 mmap_file::mmap_file( mmap_file &&other ) noexcept :
   addr_{ std::exchange( other.addr_, nullptr ) },
   fd_{ std::exchange( other.fd_, -1 ) },
+  mapped_{ std::exchange( other.mapped_, false ) },
   size_{ std::exchange( other.size_, 0 ) },
   errno_{ std::exchange( other.errno_, 0 ) }
 {
@@ -76,6 +77,7 @@ mmap_file& mmap_file::operator=( mmap_file &&other ) noexcept {
 
     addr_  = std::exchange( other.addr_, nullptr );
     fd_    = std::exchange( other.fd_, -1 );
+    mapped_ = std::exchange( other.mapped_, false );
     size_  = std::exchange( other.size_, 0 );
     errno_ = std::exchange( other.errno_, 0 );
   }
@@ -91,7 +93,7 @@ int mmap_file::behavior( behavior_type behavior ) const {
   // bother.
   //
 #ifdef HAVE_MADVISE
-  if ( ::madvise( static_cast<caddr_t>( addr_ ), size_, behavior ) == -1 )
+  if ( mapped_ && ::madvise( static_cast<caddr_t>( addr_ ), size_, behavior ) == -1 )
     return errno_ = errno;
 #else
   (void)behavior;
@@ -101,7 +103,7 @@ int mmap_file::behavior( behavior_type behavior ) const {
 }
 
 void mmap_file::close() {
-  if ( addr_ != nullptr )
+  if ( mapped_ )
     ::munmap( addr_, size_ );
   if ( fd_ != 0 )
     ::close( fd_ );
@@ -129,6 +131,7 @@ void mmap_file::init() {
 
   addr_ = nullptr;
   fd_ = -1;
+  mapped_ = false;
   size_ = 0;
   errno_ = 0;
 }
@@ -175,6 +178,7 @@ bool mmap_file::open( char const *path, ios::openmode mode ) {
     errno_ = errno;
     return false;
   }
+  mapped_ = true;
 
   return behavior( bt_normal ) == 0;
 }
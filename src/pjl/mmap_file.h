@@ -94,6 +94,20 @@ public:
     open( path, mode );
   }
 
+  /**
+   * Constructs an %mmap_file that refers to memory already in use, e.g., a
+   * buffer, rather than to a file so that it can be processed the same way.
+   * The memory is not unmapped upon close.
+   *
+   * @param addr The address of the memory.
+   * @param size The size of the memory.
+   */
+  mmap_file( void const *addr, size_type size ) {
+    init();
+    addr_ = const_cast<void*>( addr );
+    size_ = size;
+  }
+
   mmap_file( mmap_file const& ) = delete;
   mmap_file& operator=( mmap_file const& ) = delete;
 
@@ -156,6 +170,7 @@ public:
 private:
   void       *addr_;
   int         fd_;                      // Unix file descriptor
+  bool        mapped_;                  // whether addr_ is to be unmapped
   size_type   size_;
   mutable int errno_;
 
@@ -30,6 +30,10 @@
 #include <algorithm>                    /* for find_if() */
 #include <fnmatch.h>                    /* for fnmatch(3) */
 #include <map>
+#include <string_view>
+#include <unordered_map>
+#include <utility>                      /* for pair */
+#include <vector>
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -42,6 +46,11 @@
  * above that defines <code>less&lt;char const*&gt;</code>, C-style string
  * comparisons work properly.
  *
+ * Once all patterns have been inserted, \c compile() should be called so that
+ * \c find() uses hash lookups for literal filenames and \c *suffix patterns
+ * (such as \c *.html) and calls fnmatch(3) only for the remaining patterns.
+ * Either way, \c find() returns the first pattern in map order that matches.
+ *
  * @sa International Standards Organizaion.  "ISO/IEC 9945-2: Information
  * Technology -- Portable Operating System Interface (POSIX) -- Part 2: Shell
  * and Utilities," 1993.
@@ -59,6 +68,10 @@ public:
   // find() must be overridden to use our own comparison class.
   //
   iterator find( char const *file_name ) {
+    if ( compiled_ ) {
+      char const *const pattern = compiled_find( file_name );
+      return pattern ? map_type::find( pattern ) : this->end();
+    }
     //
     // Using find_if() makes this run in O(n) instead of O(lg n), but there's
     // no choice because no ordering can be imposed on filename patterns, i.e.,
@@ -71,6 +84,10 @@ public:
   }
 
   const_iterator find( char const *file_name ) const {
+    if ( compiled_ ) {
+      char const *const pattern = compiled_find( file_name );
+      return pattern ? map_type::find( pattern ) : this->end();
+    }
     return std::find_if(
       this->begin(), this->end(), pattern_match( file_name )
     );
@@ -81,14 +98,54 @@ public:
   }
 
   void insert( char const *pattern, T const &t ) {
+    compiled_ = false;
     (*this)[pattern] = t;
   }
 
   void insert( value_type const &n ) {
+    compiled_ = false;
     map_type::insert( n );
   }
 
+  void clear() {
+    compiled_ = false;
+    map_type::clear();
+  }
+
+  /**
+   * Compiles the patterns for faster matching.  Inserting or clearing
+   * patterns afterwards reverts to matching each pattern in turn until this
+   * is called again.
+   */
+  void compile();
+
 private:
+  using size_type = typename map_type::size_type;
+  using rank_map = std::unordered_map<std::string_view,size_type>;
+
+  /**
+   * A %glob is a pattern that can't be matched by a hash lookup.  The literal
+   * characters it must begin and end with, if any, are checked before calling
+   * fnmatch(3).
+   */
+  struct glob {
+    size_type         rank;             // position in map order
+    std::string_view  prefix, suffix;
+  };
+
+  /**
+   * Characters that are special in a pattern.
+   */
+  static constexpr char const Special_Chars[] = "*?[\\";
+
+  char const* compiled_find( char const *file_name ) const;
+
+  bool                        compiled_ = false;
+  std::vector<char const*>    patterns_;          // in map order
+  rank_map                    literals_;
+  std::vector<std::pair<size_type,rank_map>> suffixes_; // by suffix length
+  std::vector<glob>           globs_;             // in map order
+
   /**
    * A %pattern_match serves as a predicate to \c find_if() above.
    */
@@ -110,6 +167,99 @@ private:
   };
 };
 
+////////// Member functions ///////////////////////////////////////////////////
+
+template<typename T>
+void pattern_map<T>::compile() {
+  patterns_.clear();
+  literals_.clear();
+  suffixes_.clear();
+  globs_.clear();
+
+  for ( auto const &node : *this ) {
+    size_type const rank = patterns_.size();
+    char const *const pattern = node.first;
+    patterns_.push_back( pattern );
+
+    std::string_view const p{ pattern };
+    auto const special = p.find_first_of( Special_Chars );
+    if ( special == std::string_view::npos ) {
+      literals_.emplace( p, rank );     // emplace: first (lowest) rank wins
+      continue;
+    }
+
+    std::string_view const rest = p.substr( special + 1 );
+    if ( p[ special ] == '*' && special == 0 &&
+         rest.find_first_of( Special_Chars ) == std::string_view::npos ) {
+      //
+      // The pattern is *suffix: it matches every filename ending in suffix.
+      //
+      auto by_len = std::find_if(
+        suffixes_.begin(), suffixes_.end(),
+        [&rest]( auto const &s ) { return s.first == rest.size(); }
+      );
+      if ( by_len == suffixes_.end() )
+        by_len = suffixes_.emplace( suffixes_.end(), rest.size(), rank_map{} );
+      by_len->second.emplace( rest, rank );
+      continue;
+    }
+
+    glob g{ rank, p.substr( 0, special ), { } };
+    //
+    // The literal characters after the last * are a suffix only if that * is
+    // a wildcard, i.e., not within a bracket expression nor escaped.  Rather
+    // than parse either, simply don't derive a suffix for a pattern having
+    // either.
+    //
+    auto const last_star = p.rfind( '*' );
+    if ( last_star != std::string_view::npos &&
+         p.find_first_of( "[\\" ) == std::string_view::npos ) {
+      std::string_view const tail = p.substr( last_star + 1 );
+      if ( tail.find_first_of( Special_Chars ) == std::string_view::npos )
+        g.suffix = tail;
+    }
+    globs_.push_back( g );
+  } // for
+
+  compiled_ = true;
+}
+
+template<typename T>
+char const* pattern_map<T>::compiled_find( char const *file_name ) const {
+  std::string_view const name{ file_name };
+  size_type best = patterns_.size();
+
+  if ( !literals_.empty() ) {
+    auto const found = literals_.find( name );
+    if ( found != literals_.end() )
+      best = found->second;
+  }
+
+  for ( auto const &[ len, suffixes ] : suffixes_ ) {
+    if ( len > name.size() )
+      continue;
+    auto const found = suffixes.find( name.substr( name.size() - len ) );
+    if ( found != suffixes.end() && found->second < best )
+      best = found->second;
+  } // for
+
+  //
+  // Only a glob that's earlier in map order than any match so far can
+  // change the result.
+  //
+  for ( auto const &g : globs_ ) {
+    if ( g.rank >= best )
+      break;
+    if ( name.starts_with( g.prefix ) && name.ends_with( g.suffix ) &&
+         !::fnmatch( patterns_[ g.rank ], file_name, 0 ) ) {
+      best = g.rank;
+      break;
+    }
+  } // for
+
+  return best < patterns_.size() ? patterns_[ best ] : nullptr;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 #endif /* pattern_map_H */
@@ -0,0 +1,326 @@
+/*
+**      PJL C++ Library
+**      perfect_hash.h
+**
+**      Copyright (C) 2026  Paul J. Lucas
+**
+**      This program is free software; you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation; either version 2 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program; if not, write to the Free Software
+**      Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#ifndef pjl_perfect_hash_H
+#define pjl_perfect_hash_H
+
+// local
+#include "config.h"
+
+// standard
+#include <algorithm>                    /* for sort() */
+#include <array>
+#include <cstddef>                      /* for size_t */
+#include <cstdint>
+#include <cstring>                      /* for memcmp(3) */
+#include <string_view>
+#include <utility>                      /* for pair */
+
+namespace PJL {
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A %perfect_hash is a minimal perfect hash function for a fixed set of keys
+ * that's computed entirely at compile-time via "hash and displace:" keys are
+ * hashed into buckets and, largest bucket first, each bucket is assigned a
+ * displacement such that all of its keys land in distinct free slots; buckets
+ * having a single key are assigned a free slot directly.  Every key therefore
+ * has a slot of its own, so finding a key takes one hash of it and one
+ * comparison against the only key that could be in its slot.
+ *
+ * @tparam N The number of keys.
+ *
+ * @sa Djamal Belazzougui, Fabiano C. Botelho, and Martin Dietzfelbinger.
+ * "Hash, displace, and compress," Proceedings of the 17th European Symposium
+ * on Algorithms, 2009.
+ */
+template<size_t N>
+class perfect_hash {
+public:
+  static_assert( N > 0 && N <= UINT16_MAX );
+
+  /**
+   * A value returned by find() when the key isn't found.
+   */
+  static constexpr size_t npos = static_cast<size_t>( -1 );
+
+  /**
+   * Computes a %perfect_hash.  If the keys aren't unique, compilation fails.
+   *
+   * @param keys The keys.  Their memory must outlive this %perfect_hash.
+   */
+  consteval explicit perfect_hash( std::array<std::string_view,N> const &keys );
+
+  /**
+   * Finds a key.
+   *
+   * @param key The null-terminated key to find.
+   * @return Returns the index of \a key in the array given to the constructor
+   * or \c npos if not found.
+   */
+  size_t find( char const *key ) const {
+    size_t len = 0;
+    std::uint64_t h = FNV_Offset_Basis;
+    for ( ; key[ len ]; ++len )
+      h = (h ^ static_cast<unsigned char>( key[ len ] )) * FNV_Prime;
+    h = mix( h );
+    std::int32_t const d = disp_[ h % N ];
+    size_t const i = index_[ d < 0 ? -d - 1 : slot( h, d ) ];
+    std::string_view const k = keys_[i];
+    return k.size() == len && !std::memcmp( k.data(), key, len ) ? i : npos;
+  }
+
+private:
+  static constexpr std::uint64_t FNV_Offset_Basis = 14695981039346656037ull;
+  static constexpr std::uint64_t FNV_Prime        = 1099511628211ull;
+
+  /**
+   * Hashes a key.
+   *
+   * @param key The key to hash.
+   * @return Returns said hash.
+   */
+  static constexpr std::uint64_t hash( std::string_view key ) {
+    std::uint64_t h = FNV_Offset_Basis;
+    for ( char const c : key )
+      h = (h ^ static_cast<unsigned char>( c )) * FNV_Prime;
+    return mix( h );
+  }
+
+  /**
+   * Mixes the bits of a hash so that all of them depend on all of the bits of
+   * the key (the finalizer of MurmurHash3).
+   *
+   * @param h The hash to mix.
+   * @return Returns the mixed hash.
+   */
+  static constexpr std::uint64_t mix( std::uint64_t h ) {
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ull;
+    h ^= h >> 33;
+    return h;
+  }
+
+  /**
+   * Gets the slot of a key in a bucket having a given displacement.
+   *
+   * @param h The hash of the key.
+   * @param d The displacement of the key's bucket.
+   * @return Returns said slot.
+   */
+  static constexpr size_t slot( std::uint64_t h, std::int32_t d ) {
+    return mix( h ^ (static_cast<std::uint64_t>( d ) * 0x9E3779B97F4A7C15ull) )
+           % N;
+  }
+
+  std::array<std::string_view,N>  keys_;
+  std::array<std::int32_t,N>      disp_{};  // displacement or -(slot + 1)
+  std::array<std::uint16_t,N>     index_{}; // slot -> index of key
+};
+
+/**
+ * A %perfect_hash_map is a read-only map from C-string keys to values of type
+ * \a T that's built entirely at compile-time and uses a perfect_hash for
+ * look-up.  It iterates in key order.
+ *
+ * @tparam T The value type.
+ * @tparam N The number of entries.
+ */
+template<typename T,size_t N>
+class perfect_hash_map {
+public:
+  using key_type = char const*;
+  using mapped_type = T;
+  using value_type = std::pair<char const*,T>;
+  using const_iterator = value_type const*;
+
+  /**
+   * Constructs a %perfect_hash_map.  If the keys aren't unique, compilation
+   * fails.
+   *
+   * @param entries The entries in any order.
+   */
+  consteval explicit perfect_hash_map( value_type const (&entries)[N] ) :
+    entries_( sorted( entries ) ),
+    hash_( keys( entries_ ) )
+  {
+  }
+
+  const_iterator begin() const  { return entries_.data(); }
+  const_iterator end() const    { return entries_.data() + N; }
+  static constexpr size_t size() { return N; }
+
+  /**
+   * Finds an entry.
+   *
+   * @param key The null-terminated key to find.
+   * @return Returns an iterator positioned at the entry or end() if not found.
+   */
+  const_iterator find( char const *key ) const {
+    size_t const i = hash_.find( key );
+    return i != perfect_hash<N>::npos ? &entries_[i] : end();
+  }
+
+private:
+  static consteval std::array<value_type,N>
+  sorted( value_type const (&entries)[N] ) {
+    std::array<value_type,N> a;
+    std::copy( entries, entries + N, a.begin() );
+    std::sort( a.begin(), a.end(),
+      []( value_type const &i, value_type const &j ) {
+        return std::string_view{ i.first } < std::string_view{ j.first };
+      }
+    );
+    return a;
+  }
+
+  static consteval std::array<std::string_view,N>
+  keys( std::array<value_type,N> const &entries ) {
+    std::array<std::string_view,N> a;
+    for ( size_t i = 0; i < N; ++i )
+      a[i] = entries[i].first;
+    return a;
+  }
+
+  std::array<value_type,N> entries_;
+  perfect_hash<N> hash_;
+};
+
+template<typename T,size_t N>
+perfect_hash_map( std::pair<char const*,T> const (&)[N] )
+  -> perfect_hash_map<T,N>;
+
+/**
+ * A %perfect_hash_set is a read-only set of C-strings that's built entirely at
+ * compile-time and uses a perfect_hash for look-up.
+ *
+ * @tparam N The number of strings.
+ */
+template<size_t N>
+class perfect_hash_set {
+public:
+  /**
+   * Constructs a %perfect_hash_set.  If the strings aren't unique, compilation
+   * fails.
+   *
+   * @param keys The strings.
+   */
+  consteval explicit perfect_hash_set( char const *const (&keys)[N] ) :
+    hash_( views( keys ) )
+  {
+  }
+
+  static constexpr size_t size() { return N; }
+
+  /**
+   * Gets whether this set contains a string.
+   *
+   * @param key The null-terminated string to check for.
+   * @return Returns \c true only if it does.
+   */
+  bool contains( char const *key ) const {
+    return hash_.find( key ) != perfect_hash<N>::npos;
+  }
+
+private:
+  static consteval std::array<std::string_view,N>
+  views( char const *const (&keys)[N] ) {
+    std::array<std::string_view,N> a;
+    for ( size_t i = 0; i < N; ++i )
+      a[i] = keys[i];
+    return a;
+  }
+
+  perfect_hash<N> hash_;
+};
+
+////////// Template member functions //////////////////////////////////////////
+
+template<size_t N> consteval
+perfect_hash<N>::perfect_hash( std::array<std::string_view,N> const &keys ) :
+  keys_( keys )
+{
+  std::array<std::uint64_t,N> h;
+  std::array<size_t,N> bucket_size{};
+  for ( size_t i = 0; i < N; ++i )
+    ++bucket_size[ (h[i] = hash( keys_[i] )) % N ];
+
+  //
+  // Order the keys by bucket, largest buckets first, since they're the
+  // hardest to place.
+  //
+  std::array<size_t,N> order;
+  for ( size_t i = 0; i < N; ++i )
+    order[i] = i;
+  std::sort( order.begin(), order.end(), [&]( size_t i, size_t j ) {
+    size_t const bi = h[i] % N, bj = h[j] % N;
+    return bucket_size[ bi ] != bucket_size[ bj ] ?
+      bucket_size[ bi ] > bucket_size[ bj ] : bi < bj;
+  } );
+
+  std::array<bool,N> used{};
+  size_t i = 0;
+  for ( ; i < N && bucket_size[ h[ order[i] ] % N ] > 1; ) {
+    size_t const b = h[ order[i] ] % N, n = bucket_size[ b ];
+    for ( size_t j = i + 1; j < i + n; ++j )
+      for ( size_t k = i; k < j; ++k )
+        if ( h[ order[j] ] == h[ order[k] ] )
+          throw "perfect_hash: duplicate key";
+
+    std::array<size_t,N> s;
+    for ( std::int32_t d = 1; ; ++d ) {
+      bool fits = true;
+      for ( size_t j = 0; fits && j < n; ++j ) {
+        s[j] = slot( h[ order[ i + j ] ], d );
+        fits = !used[ s[j] ];
+        for ( size_t k = 0; fits && k < j; ++k )
+          fits = s[k] != s[j];
+      } // for
+      if ( fits ) {
+        for ( size_t j = 0; j < n; ++j ) {
+          used[ s[j] ] = true;
+          index_[ s[j] ] = static_cast<std::uint16_t>( order[ i + j ] );
+        }
+        disp_[ b ] = d;
+        break;
+      }
+    } // for
+    i += n;
+  } // for
+
+  for ( size_t free = 0; i < N; ++i ) {
+    while ( used[ free ] )
+      ++free;
+    used[ free ] = true;
+    index_[ free ] = static_cast<std::uint16_t>( order[i] );
+    disp_[ h[ order[i] ] % N ] = -static_cast<std::int32_t>( free ) - 1;
+  } // for
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // namespace PJL
+
+#endif /* pjl_perfect_hash_H */
+/* vim:set et sw=2 ts=2: */
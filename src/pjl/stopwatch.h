@@ -0,0 +1,83 @@
+/*
+**      PJL C++ Library
+**      stopwatch.h
+**
+**      Copyright (C) 2026  Paul J. Lucas
+**
+**      This program is free software; you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation; either version 2 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program; if not, write to the Free Software
+**      Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#ifndef stopwatch_H
+#define stopwatch_H
+
+// local
+#include "config.h"
+
+// standard
+#include <chrono>
+
+namespace PJL {
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A %stopwatch measures elapsed wall-clock time using a monotonic clock.  It
+ * starts running upon construction.
+ */
+class stopwatch {
+public:
+  stopwatch() : start_{ clock::now() } { }
+
+  /**
+   * Gets the number of microseconds elapsed since construction or the last
+   * call to \c restart().
+   *
+   * @return Returns said number of microseconds.
+   */
+  unsigned long elapsed_usec() const {
+    return static_cast<unsigned long>(
+      std::chrono::duration_cast<std::chrono::microseconds>(
+        clock::now() - start_
+      ).count()
+    );
+  }
+
+  /**
+   * Restarts the stopwatch.
+   *
+   * @return Returns the number of microseconds elapsed prior to restarting.
+   */
+  unsigned long restart() {
+    clock::time_point const now = clock::now();
+    unsigned long const usec = static_cast<unsigned long>(
+      std::chrono::duration_cast<std::chrono::microseconds>(
+        now - start_
+      ).count()
+    );
+    start_ = now;
+    return usec;
+  }
+
+private:
+  using clock = std::chrono::steady_clock;
+  clock::time_point start_;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // namespace PJL
+
+#endif /* stopwatch_H */
+/* vim:set et sw=2 ts=2: */
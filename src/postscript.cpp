@@ -21,268 +21,272 @@
 
 // local
 #include "postscript.h"
-#include "pjl/hash.h"
+#include "pjl/perfect_hash.h"
 
 using namespace PJL;
-using namespace std;
 
 namespace postscript {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-unordered_char_ptr_set const& comments() {
-  static unordered_char_ptr_set const s{
-    "%%BeginSetup",
-    "%%BoundingBox",
-    "%%Creator",
-    "%%EndComments",
-    "%%Title",
-  };
-  return s;
+static constexpr char const *const comment_table[] = {
+  "%%BeginSetup",
+  "%%BoundingBox",
+  "%%Creator",
+  "%%EndComments",
+  "%%Title",
+};
+
+static constexpr char const *const operator_table[] = {
+  "aload",
+  "anchorsearch",
+  "arcn",
+  "ashow",
+  "astore",
+  "awidthshow",
+  "banddevice",
+  "bitshift",
+  "bytesavailable",
+  "cachestatus",
+  "charpath",
+  "cleardictstack",
+  "cleartomark",
+  "clippath",
+  "closefile",
+  "closepath",
+  "colorimage",
+  "concat",
+  "concatmatrix",
+  "copypage",
+  "countdictstack",
+  "countexecstack",
+  "counttomark",
+  "cshow",
+  "currentblackgeneration",
+  "currentcacheparams",
+  "currentcmykcolor",
+  "currentcolor",
+  "currentcolorrendering",
+  "currentcolorscreen",
+  "currentcolorspace",
+  "currentcolortransfer",
+  "currentdash",
+  "currentdevparams",
+  "currentdict",
+  "currentfile",
+  "currentflat",
+  "currentfont",
+  "currentglobal",
+  "currentgray",
+  "currentgstate",
+  "currenthalftone",
+  "currenthsbcolor",
+  "currentlinecap",
+  "currentlinejoin",
+  "currentlinewidth",
+  "currentmatrix",
+  "currentmiterlimit",
+  "currentobjectformat",
+  "currentoverprint",
+  "currentpacking",
+  "currentpagedevice",
+  "currentpoint",
+  "currentrgbcolor",
+  "currentscreen",
+  "currentstrokeadjust",
+  "currentsystemparams",
+  "currenttransfer",
+  "currentundercolorremoval",
+  "currentuserparams",
+  "curveto",
+  "cvi",
+  "cvlit",
+  "cvn",
+  "cvr",
+  "cvrs",
+  "cvx",
+  "def",
+  "defaultmatrix",
+  "definefont",
+  "defineresource",
+  "defineuserobject",
+  "deletefile",
+  "dict",
+  "dictstack",
+  "dtransform",
+  "dup",
+  "eoclip",
+  "eofill",
+  "erasepage",
+  "errordict",
+  "exch",
+  "exec",
+  "execform",
+  "execstack",
+  "execuserobject",
+  "executeonly",
+  "filenameforall",
+  "fileposition",
+  "findencoding",
+  "findfont",
+  "findresource",
+  "flattenpath",
+  "flushfile",
+  "FontDirectory",
+  "forall",
+  "framedevice",
+  "gcheck",
+  "getinterval",
+  "globaldict",
+  "GlobalFontDirectory",
+  "glyphshow",
+  "grestore",
+  "grestoreall",
+  "gsave",
+  "gsetstate",
+  "gstate",
+  "identmatrix",
+  "idiv",
+  "idtransform",
+  "ifelse",
+  "imagemask",
+  "ineofill",
+  "infill",
+  "initclip",
+  "initgraphics",
+  "initmatrix",
+  "instroke",
+  "inueofill",
+  "inufill",
+  "inustroke",
+  "invertmatrix",
+  "ISOLatin1Encoding",
+  "itransform",
+  "kshow",
+  "languagelevel",
+  "lineto",
+  "makefont",
+  "makepattern",
+  "maxlength",
+  "mod",
+  "moveto",
+  "mul",
+  "neg",
+  "newpath",
+  "noaccess",
+  "nulldevice",
+  "packedarray",
+  "pathbbox",
+  "pathforall",
+  "printobject",
+  "pstack",
+  "putinterval",
+  "rand",
+  "rcheck",
+  "rcurveto",
+  "readhexstring",
+  "readline",
+  "readonly",
+  "readstring",
+  "realtime",
+  "rectclip",
+  "rectfill",
+  "rectstroke",
+  "renamefile",
+  "renderbands",
+  "resetfile",
+  "resourceforall",
+  "resourcestatus",
+  "reversepath",
+  "rlineto",
+  "rmoveto",
+  "rootfont",
+  "rrand",
+  "scalefont",
+  "selectfont",
+  "serialnumber",
+  "setbbox",
+  "setblackgeneration",
+  "setcachedevice",
+  "setcachedevice2",
+  "setcachelimit",
+  "setcharwidth",
+  "setcmykcolor",
+  "setcolor",
+  "setcolorrendering",
+  "setcolorscreen",
+  "setcolorspace",
+  "setcolortransfer"
+  "setdash",
+  "setdevparams",
+  "setfileposition",
+  "setflat",
+  "setfont",
+  "setglobal",
+  "setgray",
+  "sethalftone",
+  "sethsbcolor",
+  "setlinecap",
+  "setlinejoin",
+  "setlinewidth",
+  "setmatrix",
+  "setmiterlimit",
+  "setobjectformat",
+  "setoverprint",
+  "setpagedevice",
+  "setpattern",
+  "setrgbcolor",
+  "setscreen",
+  "setstrokeadjust",
+  "setsystemparams",
+  "settransfer",
+  "setucacheparams",
+  "setundercolorremoval",
+  "setuserparams",
+  "setvmthreshold",
+  "showpage",
+  "srand",
+  "StandardEncoding",
+  "startjob",
+  "statusdict",
+  "stringwidth",
+  "strokepath",
+  "sub",
+  "systemdict",
+  "uappend",
+  "ucache",
+  "ucachestatus",
+  "ueofill",
+  "ufill",
+  "undefinefont",
+  "undefineresource",
+  "undefineuserobject",
+  "userdict",
+  "UserObjects",
+  "usertime",
+  "ustroke",
+  "ustrokepath",
+  "vmreclaim",
+  "vmstatus",
+  "wcheck",
+  "widthshow",
+  "writehexstring",
+  "writeobject",
+  "writestring",
+  "xcheck",
+  "xshow",
+  "xyshow",
+};
+
+static constexpr perfect_hash_set comment_set{ comment_table };
+static constexpr perfect_hash_set operator_set{ operator_table };
+
+bool is_comment( char const *s ) {
+  return comment_set.contains( s );
 }
 
-unordered_char_ptr_set const& operators() {
-  static unordered_char_ptr_set const s{
-    "aload",
-    "anchorsearch",
-    "arcn",
-    "ashow",
-    "astore",
-    "awidthshow",
-    "banddevice",
-    "bitshift",
-    "bytesavailable",
-    "cachestatus",
-    "charpath",
-    "cleardictstack",
-    "cleartomark",
-    "clippath",
-    "closefile",
-    "closepath",
-    "colorimage",
-    "concat",
-    "concatmatrix",
-    "copypage",
-    "countdictstack",
-    "countexecstack",
-    "counttomark",
-    "cshow",
-    "currentblackgeneration",
-    "currentcacheparams",
-    "currentcmykcolor",
-    "currentcolor",
-    "currentcolorrendering",
-    "currentcolorscreen",
-    "currentcolorspace",
-    "currentcolortransfer",
-    "currentdash",
-    "currentdevparams",
-    "currentdict",
-    "currentfile",
-    "currentflat",
-    "currentfont",
-    "currentglobal",
-    "currentgray",
-    "currentgstate",
-    "currenthalftone",
-    "currenthsbcolor",
-    "currentlinecap",
-    "currentlinejoin",
-    "currentlinewidth",
-    "currentmatrix",
-    "currentmiterlimit",
-    "currentobjectformat",
-    "currentoverprint",
-    "currentpacking",
-    "currentpagedevice",
-    "currentpoint",
-    "currentrgbcolor",
-    "currentscreen",
-    "currentstrokeadjust",
-    "currentsystemparams",
-    "currenttransfer",
-    "currentundercolorremoval",
-    "currentuserparams",
-    "curveto",
-    "cvi",
-    "cvlit",
-    "cvn",
-    "cvr",
-    "cvrs",
-    "cvx",
-    "def",
-    "defaultmatrix",
-    "definefont",
-    "defineresource",
-    "defineuserobject",
-    "deletefile",
-    "dict",
-    "dictstack",
-    "dtransform",
-    "dup",
-    "eoclip",
-    "eofill",
-    "erasepage",
-    "errordict",
-    "exch",
-    "exec",
-    "execform",
-    "execstack",
-    "execuserobject",
-    "executeonly",
-    "filenameforall",
-    "fileposition",
-    "findencoding",
-    "findfont",
-    "findresource",
-    "flattenpath",
-    "flushfile",
-    "FontDirectory",
-    "forall",
-    "framedevice",
-    "gcheck",
-    "getinterval",
-    "globaldict",
-    "GlobalFontDirectory",
-    "glyphshow",
-    "grestore",
-    "grestoreall",
-    "gsave",
-    "gsetstate",
-    "gstate",
-    "identmatrix",
-    "idiv",
-    "idtransform",
-    "ifelse",
-    "imagemask",
-    "ineofill",
-    "infill",
-    "initclip",
-    "initgraphics",
-    "initmatrix",
-    "instroke",
-    "inueofill",
-    "inufill",
-    "inustroke",
-    "invertmatrix",
-    "ISOLatin1Encoding",
-    "itransform",
-    "kshow",
-    "languagelevel",
-    "lineto",
-    "makefont",
-    "makepattern",
-    "maxlength",
-    "mod",
-    "moveto",
-    "mul",
-    "neg",
-    "newpath",
-    "noaccess",
-    "nulldevice",
-    "packedarray",
-    "pathbbox",
-    "pathforall",
-    "printobject",
-    "pstack",
-    "putinterval",
-    "rand",
-    "rcheck",
-    "rcurveto",
-    "readhexstring",
-    "readline",
-    "readonly",
-    "readstring",
-    "realtime",
-    "rectclip",
-    "rectfill",
-    "rectstroke",
-    "renamefile",
-    "renderbands",
-    "resetfile",
-    "resourceforall",
-    "resourcestatus",
-    "reversepath",
-    "rlineto",
-    "rmoveto",
-    "rootfont",
-    "rrand",
-    "scalefont",
-    "selectfont",
-    "serialnumber",
-    "setbbox",
-    "setblackgeneration",
-    "setcachedevice",
-    "setcachedevice2",
-    "setcachelimit",
-    "setcharwidth",
-    "setcmykcolor",
-    "setcolor",
-    "setcolorrendering",
-    "setcolorscreen",
-    "setcolorspace",
-    "setcolortransfer"
-    "setdash",
-    "setdevparams",
-    "setfileposition",
-    "setflat",
-    "setfont",
-    "setglobal",
-    "setgray",
-    "sethalftone",
-    "sethsbcolor",
-    "setlinecap",
-    "setlinejoin",
-    "setlinewidth",
-    "setmatrix",
-    "setmiterlimit",
-    "setobjectformat",
-    "setoverprint",
-    "setpagedevice",
-    "setpattern",
-    "setrgbcolor",
-    "setscreen",
-    "setstrokeadjust",
-    "setsystemparams",
-    "settransfer",
-    "setucacheparams",
-    "setundercolorremoval",
-    "setuserparams",
-    "setvmthreshold",
-    "showpage",
-    "srand",
-    "StandardEncoding",
-    "startjob",
-    "statusdict",
-    "stringwidth",
-    "strokepath",
-    "sub",
-    "systemdict",
-    "uappend",
-    "ucache",
-    "ucachestatus",
-    "ueofill",
-    "ufill",
-    "undefinefont",
-    "undefineresource",
-    "undefineuserobject",
-    "userdict",
-    "UserObjects",
-    "usertime",
-    "ustroke",
-    "ustrokepath",
-    "vmreclaim",
-    "vmstatus",
-    "wcheck",
-    "widthshow",
-    "writehexstring",
-    "writeobject",
-    "writestring",
-    "xcheck",
-    "xshow",
-    "xyshow",
-  };
-  return s;
+bool is_operator( char const *s ) {
+  return operator_set.contains( s );
 }
 
 ///////////////////////////////////////////////////////////////////////////////
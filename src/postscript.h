@@ -24,23 +24,29 @@
 
 // local
 #include "config.h"
-#include "pjl/hash.h"
 
 namespace postscript {
 
 ///////////////////////////////////////////////////////////////////////////////
 
 /**
- * Gets a set containing all PostScript comments.  They are used to detect the
- * start of encapsulated PostScript in files so it will not be extracted.
+ * Checks whether a string is a PostScript comment.  Comments are used to
+ * detect the start of encapsulated PostScript in files so it will not be
+ * extracted.
+ *
+ * @param s The null-terminated string to check.
+ * @return Returns \c true only if it is.
  */
-PJL::unordered_char_ptr_set const& comments();
+bool is_comment( char const *s );
 
 /**
- * Gets a set containing all the Level 2 PostScript operators that are not also
- * English words.  Their contents are not indexed.
+ * Checks whether a string is one of the Level 2 PostScript operators that are
+ * not also English words.  Their contents are not indexed.
+ *
+ * @param s The null-terminated string to check.
+ * @return Returns \c true only if it is.
  */
-PJL::unordered_char_ptr_set const& operators();
+bool is_operator( char const *s );
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -25,12 +25,13 @@
 #include "exit_codes.h"
 #include "file_list.h"
 #include "indexer.h"
-#include "IndexFile.h"
 #include "index_segment.h"
 #include "meta_id.h"
 #include "pjl/less.h"
+#include "pjl/stopwatch.h"
 #include "pjl/vlq.h"
 #include "query_node.h"
+#include "search_index.h"
 #include "stem_word.h"
 #include "StemWords.h"
 #include "token.h"
@@ -42,6 +43,7 @@
 #include <cstdlib>                      /* for exit(3) */
 #include <iostream>
 #include <ostream>
+#include <sstream>
 
 using namespace PJL;
 using namespace std;
@@ -58,15 +60,19 @@ namespace {
  * functions.
  */
 struct parse_q_args {
+  search_index const& index;
   node_pool_type& node_pool;
   token_stream&   query;
   stop_word_set&  stop_words_found;
+  query_stats*    stats;
 #ifdef WITH_WORD_POS
   bool            got_near;
 #endif /* WITH_WORD_POS */
 
-  parse_q_args( node_pool_type &p, token_stream &q, stop_word_set &s ) :
-    node_pool{ p }, query{ q }, stop_words_found{ s }
+  parse_q_args( search_index const &i, node_pool_type &p, token_stream &q,
+                stop_word_set &s, query_stats *st ) :
+    index{ i }, node_pool{ p }, query{ q }, stop_words_found{ s },
+    stats{ st }
 #ifdef WITH_WORD_POS
     , got_near( false )
 #endif /* WITH_WORD_POS */
@@ -108,10 +114,8 @@ private:
 
 } // namespace
 
-extern index_segment files, meta_names, stop_words, words;
-
 // local functions
-static void assert_index_has_word_pos_data();
+static void assert_index_has_word_pos_data( search_index const& );
 static bool parse_meta   ( parse_q_args&, parse_r_args&, parse_v_args );
 static bool parse_primary( parse_q_args&, parse_r_args&, parse_v_args );
 static bool parse_query2 ( parse_q_args&, parse_r_args&, parse_v_args );
@@ -123,16 +127,20 @@ static bool parse_relop  ( token_stream&, token::type& );
  * Parses a query.  This is merely a front-end for \c parse_query2(), but has a
  * less ugly API.
  *
+ * @param index The index to search.
  * @param query The token_stream whence the query string is extracted.
  * @param results The query results go here.
  * @param stop_words_found The set of stop-words in the query, if any.
+ * @param stats If not null, statistics about the query are accumulated here.
  * @return Returns \c true only if a query was successfully parsed.
  */
-bool parse_query( token_stream &query, search_results &results,
-                  stop_word_set &stop_words_found ) {
+bool parse_query( search_index const &index, token_stream &query,
+                  search_results &results, stop_word_set &stop_words_found,
+                  query_stats *stats ) {
   node_pool_type node_pool;
+  stopwatch timer;
 
-  parse_q_args q_args( node_pool, query, stop_words_found );
+  parse_q_args q_args( index, node_pool, query, stop_words_found, stats );
   parse_r_args r_args;
   parse_v_args v_args;
   if ( !parse_query2( q_args, r_args, v_args ) )
@@ -140,7 +148,7 @@ bool parse_query( token_stream &query, search_results &results,
 
 #ifdef WITH_WORD_POS
   if ( q_args.got_near ) {
-    assert_index_has_word_pos_data();
+    assert_index_has_word_pos_data( index );
     //
     // We got a "near" somewhere in the query: walk the tree and distirbute
     // the terms of all the near nodes.
@@ -153,7 +161,18 @@ bool parse_query( token_stream &query, search_results &results,
 #   endif
   }
 #endif /* WITH_WORD_POS */
+  if ( stats )
+    stats->parse_usec += timer.restart();
   r_args.node->eval( results );
+  if ( stats ) {
+    stats->eval_usec += timer.elapsed_usec();
+    stats->num_results = results.size();
+    if ( stats->explain ) {
+      ostringstream explanation;
+      r_args.node->explain( explanation );
+      stats->explanation = explanation.str();
+    }
+  }
   return true;
 }
 
@@ -176,18 +195,12 @@ static meta_id_type get_meta_id( index_segment::const_iterator i ) {
  * The current query has a "near" in it: check that the current index has
  * word-position data stored in order to evaluate the "near".  If it doesn't,
  * complain.
+ *
+ * @param index The index to check.
  */
-static void assert_index_has_word_pos_data() {
-  //
-  // A simple way to check that the current index has word-position data stored
-  // is to get the file_list for the first word in the index then look to see
-  // if pos_delta_ is empty: if it is, no word-position data was stored.
-  //
-  file_list const list{ words.begin() };
-  auto const file{ list.begin() };
-  if ( file->pos_deltas_.empty() ) {
-    extern IndexFile index_file_name;
-    error() << '"' << index_file_name
+static void assert_index_has_word_pos_data( search_index const &index ) {
+  if ( !index.has_word_pos_data() ) {
+    error() << '"' << index.path()
             << "\" does not contain word position data"
             << endl;
     ::exit( Exit_No_Word_Pos_Data );
@@ -343,6 +356,7 @@ static bool parse_meta( parse_q_args& q_args, parse_r_args& r_args,
     token const t2{ q_args.query };
     if ( t2 == token::tt_equal ) {      // ... followed by '='
       less<char const*> const comparator;
+      index_segment const &meta_names = q_args.index.meta_names;
       word_range const range = ::equal_range(
         meta_names.begin(), meta_names.end(), t.lower_str(), comparator
       );
@@ -439,6 +453,7 @@ static bool parse_relop( token_stream &query, token::type &relop ) {
  */
 static bool parse_primary( parse_q_args& q_args, parse_r_args& r_args,
                            parse_v_args v_args ) {
+  index_segment const &words = q_args.index.words;
   r_args.ignore = false;
   r_args.node = new empty_node;
   word_range range;
@@ -451,11 +466,16 @@ static bool parse_primary( parse_q_args& q_args, parse_r_args& r_args,
       //
       // First check to see if the word wasn't indexed either because it's not
       // an "OK" word according to the heuristics employed or because it's a
-      // stop-word.
+      // stop-word.  When stemming, a word is also a stop-word if its stem is
+      // that of one, so the stop-words have to be searched by stem instead.
       //
       if ( !is_ok_word( t.str() ) ||
-           ::binary_search(
-             stop_words.begin(), stop_words.end(), t.lower_str(), comparator
+           ( stem_words ?
+             ::binary_search(
+               q_args.index.stop_words.begin(), q_args.index.stop_words.end(),
+               t.lower_str(), comparator
+             ) :
+             q_args.index.is_stop_word( t.lower_str() )
            ) ) {
         q_args.stop_words_found.insert( t.str() );
 #       ifdef DEBUG_parse_query
@@ -525,7 +545,9 @@ static bool parse_primary( parse_q_args& q_args, parse_r_args& r_args,
       cerr << "---> end not\n";
 #     endif /* DEBUG_parse_query */
       if ( r_temp.node )
-        r_args.node = new not_node( q_args.node_pool, r_temp.node );
+        r_args.node = new not_node(
+          q_args.node_pool, r_temp.node, q_args.index.files.size()
+        );
       return true;
     }
 
@@ -547,7 +569,8 @@ static bool parse_primary( parse_q_args& q_args, parse_r_args& r_args,
   r_args.ignore = true;
   FOR_EACH_IN_PAIR( range, i ) {
     file_list const list{ i };
-    if ( is_too_frequent( list.size() ) ) {
+    if ( is_too_frequent( list.size(),
+                          q_args.index.num_frequency_files() ) ) {
       q_args.stop_words_found.insert( t.lower_str() );
 #     ifdef DEBUG_parse_query
       cerr << "---> word \"" << t.str() << "\" (ignored: too frequent)\n";
@@ -558,7 +581,10 @@ static bool parse_primary( parse_q_args& q_args, parse_r_args& r_args,
 
   if ( !r_args.ignore ) {
     r_args.node =
-      new word_node{ q_args.node_pool, t.str(), range, v_args.meta_id };
+      new word_node{
+        q_args.node_pool, t.str(), range, v_args.meta_id,
+        q_args.index.num_frequency_files(), q_args.stats
+      };
   }
   return true;
 }
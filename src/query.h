@@ -36,6 +36,8 @@
 #include <string>
 #include <utility>                      /* for pair<> */
 
+class search_index;
+
 /**
  * A %search_results contains a set of search results where the key int is a
  * file index and the value int is that file's rank.
@@ -51,6 +53,22 @@ using word_range =
 
 using stop_word_set = std::set<std::string>;
 
+/**
+ * A %query_stats contains statistics gathered while a query is parsed,
+ * evaluated, and its results output.  All times are in microseconds.
+ */
+struct query_stats {
+  unsigned long postings_decoded = 0;   // number of file entries decoded
+  size_t        bytes_touched = 0;      // bytes of file lists read
+  size_t        num_results = 0;        // number of files that matched
+  unsigned long parse_usec = 0;         // time to parse the query
+  unsigned long eval_usec = 0;          // time to evaluate the query
+  unsigned long sort_usec = 0;          // time to sort the results
+  unsigned long output_usec = 0;        // time to output the results
+  bool          explain = false;        // generate explanation?
+  std::string   explanation;            // query tree with per-node profiles
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 /**
@@ -58,15 +76,27 @@ using stop_word_set = std::set<std::string>;
  * number or percentage of files it can be in.
  *
  * @param file_count The number of files a word occurs in.
+ * @param num_files The number of files in the index.
  * @return Returns \c true only if a word is too frequent.
  */
-inline bool is_too_frequent( size_t file_count ) {
-  extern index_segment files;
+inline bool is_too_frequent( size_t file_count, size_t num_files ) {
   return  file_count > word_files_max ||
-          file_count * 100 / files.size() >= word_percent_max;
+          file_count * 100 / num_files >= word_percent_max;
 }
 
-bool parse_query( token_stream&, search_results&, stop_word_set& );
+/**
+ * Parses and evaluates a query.
+ *
+ * @param index The index to search.
+ * @param query The token_stream whence the query string is extracted.
+ * @param results The query results go here.
+ * @param stop_words_found The set of stop-words in the query, if any.
+ * @param stats If not null, statistics about the query are accumulated here.
+ * @return Returns \c true only if a query was successfully parsed.
+ */
+bool parse_query( search_index const &index, token_stream &query,
+                  search_results &results, stop_word_set &stop_words_found,
+                  query_stats *stats = nullptr );
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -24,27 +24,46 @@
 #include "query_node.h"
 #include "file_list.h"
 #include "indexer.h"
-#include "index_segment.h"
 #include "meta_id.h"
+#include "pjl/stopwatch.h"
 #include "query.h"
 #include "util.h"
 #include "WordsNear.h"
 
 // standard
 #include <cstddef>
+#include <iterator>                     /* for distance() */
 #include <ostream>
 #include <vector>
 
+using namespace PJL;
+
 using namespace std;
 
 ///////////////////////////////////////////////////////////////////////////////
 
 empty_node empty_node::singleton_;
 
-void empty_node::eval( search_results& ) {
+void empty_node::do_eval( search_results& ) {
   // Out-of-line because it's virtual.
 }
 
+void query_node::eval( search_results &results ) {
+  if ( !pool() ) {
+    //
+    // A node not in a pool is the empty_node singleton that may be evaluated
+    // concurrently by multiple threads: it therefore has no profile.
+    //
+    do_eval( results );
+    return;
+  }
+  stopwatch const timer;
+  do_eval( results );
+  profile_.eval_usec += timer.elapsed_usec();
+  profile_.num_results = results.size();
+  profile_.evaluated = true;
+}
+
 ////////// constructors ///////////////////////////////////////////////////////
 
 and_node::and_node( pool_type &p, child_node_list &nodes ) : query_node( p ) {
@@ -60,9 +79,10 @@ near_node::near_node( pool_type &p, query_node *left, query_node *right ) :
 #endif /* WITH_WORD_POS */
 
 word_node::word_node( pool_type &p, char const *word, word_range const &range,
-                      meta_id_type meta_id ) :
+                      meta_id_type meta_id, size_t num_files,
+                      query_stats *stats ) :
   query_node( p ), word_( new_strdup( word ) ), range_( range ),
-  meta_id_( meta_id )
+  meta_id_( meta_id ), num_files_( num_files ), stats_( stats )
 {
   // do nothing else
 }
@@ -129,7 +149,7 @@ query_node* query_node::visit( visitor const &v ) {
   return v( this );
 }
 
-void and_node::eval( search_results &results ) {
+void and_node::do_eval( search_results &results ) {
   //
   // Evaluate the search results for "and" by evaluating all of its child nodes
   // at the same time.  This is done to solve the weighting problem with more
@@ -222,7 +242,7 @@ void and_node::eval( search_results &results ) {
 }
 
 #ifdef WITH_WORD_POS
-void near_node::eval( search_results &results ) {
+void near_node::do_eval( search_results &results ) {
   word_node const *const node[] = {
     dynamic_cast<word_node*>( left()  ),
     dynamic_cast<word_node*>( right() )
@@ -235,28 +255,35 @@ void near_node::eval( search_results &results ) {
        node[0]->meta_id() != node[1]->meta_id() )
     return;
 
+  query_stats *const stats = node[0]->stats();
+  size_t const num_files = node[0]->num_files();
   FOR_EACH_IN_PAIR( node[0]->range(), word0 ) {
     file_list const list0( word0  );
-    if ( is_too_frequent( list0.size() ) )
+    if ( is_too_frequent( list0.size(), num_files ) ) {
+      count_postings( 0, list0.bytes(), stats );
       continue;
+    }
     FOR_EACH_IN_PAIR( node[1]->range(), word1 ) {
       file_list const list1( word1 );
-      if ( is_too_frequent( list1.size() ) )
+      if ( is_too_frequent( list1.size(), num_files ) ) {
+        count_postings( 0, list1.bytes(), stats );
         continue;
+      }
 
       file_list::const_iterator file[] = { list0.begin(), list1.begin() };
+      unsigned long decoded[] = { 1, 1 };
       while ( file[0] != list0.end() && file[1] != list1.end() ) {
 
         ////////// Words in same file with right meta ID? /////////////////////
 
         if ( file[0]->index_ < file[1]->index_ ||
             !file[0]->has_meta_id( node[0]->meta_id() ) ) {
-          ++file[0];
+          ++file[0], ++decoded[0];
           continue;
         }
         if ( file[0]->index_ > file[1]->index_ ||
             !file[1]->has_meta_id( node[1]->meta_id() ) ) {
-          ++file[1];
+          ++file[1], ++decoded[1];
           continue;
         }
 
@@ -290,7 +317,11 @@ void near_node::eval( search_results &results ) {
         } // while
 
         ++file[0], ++file[1];
+        ++decoded[0], ++decoded[1];
       } // while
+      count_postings(
+        decoded[0] + decoded[1], list0.bytes() + list1.bytes(), stats
+      );
     } // for
   } // for
 }
@@ -350,7 +381,7 @@ query_node* near_node::distributor::operator()( query_node *node ) const {
   return node;
 }
 
-void not_near_node::eval( search_results &results ) {
+void not_near_node::do_eval( search_results &results ) {
   //
   // Evaluates the search results for "not near".  This code is very similar to
   // that for near_node::eval().  The difference is that the right-hand word
@@ -364,10 +395,14 @@ void not_near_node::eval( search_results &results ) {
   if ( !node[0] )
     return;
 
+  query_stats *const stats = node[0]->stats();
+  size_t const num_files = node[0]->num_files();
   FOR_EACH_IN_PAIR( node[0]->range(), word0 ) {
     file_list const list0( word0 );
-    if ( is_too_frequent( list0.size() ) )
+    if ( is_too_frequent( list0.size(), num_files ) ) {
+      count_postings( 0, list0.bytes(), stats );
       continue;
+    }
     if ( !node[1] ) {
       //
       // If the right-hand side node isn't a word_node (i.e., it's an
@@ -377,6 +412,7 @@ void not_near_node::eval( search_results &results ) {
       for ( auto const &file : list0 )
         if ( file.has_meta_id( node[0]->meta_id() ) )
           results[ file.index_ ] += file.rank_;
+      count_postings( list0.size(), list0.bytes(), stats );
       continue;
     }
 
@@ -385,13 +421,14 @@ void not_near_node::eval( search_results &results ) {
     FOR_EACH_IN_PAIR( node[1]->range(), word1 ) {
       file_list const list1( word1 );
       file_list::const_iterator file[] = { list0.begin(), list1.begin() };
+      unsigned long decoded1 = 1;
       while ( file[0] != list0.end() ) {
         if ( file[0]->has_meta_id( node[0]->meta_id() ) ) {
           //
           // Make file[1]'s index "catch up" to file[0]'s.
           //
           while ( file[1] != list1.end() && file[1]->index_ < file[0]->index_ )
-            ++file[1];
+            ++file[1], ++decoded1;
 
           ////////// Are words in the same file? //////////////////////////////
 
@@ -431,24 +468,26 @@ void not_near_node::eval( search_results &results ) {
 found_near:
         ++file[0];
         if ( file[1] != list1.end() )
-          ++file[1];
+          ++file[1], ++decoded1;
       } // while
+      count_postings(
+        list0.size() + decoded1, list0.bytes() + list1.bytes(), stats
+      );
     } // for
   } // for
 }
 #endif /* WITH_WORD_POS */
 
-void not_node::eval( search_results &results ) {
-  extern index_segment files;
+void not_node::do_eval( search_results &results ) {
   search_results child_results;
   child_->eval( child_results );
 
-  for ( size_t i = 0; i < files.size(); ++i )
+  for ( size_t i = 0; i < num_files_; ++i )
     if ( child_results.find( i ) == child_results.end() )
       results[i] = 100;
 }
 
-void or_node::eval( search_results &left_results ) {
+void or_node::do_eval( search_results &left_results ) {
   search_results right_results;
 
   left() ->eval( left_results  );
@@ -458,17 +497,87 @@ void or_node::eval( search_results &left_results ) {
     left_results[ result.first ] += result.second;
 }
 
-void word_node::eval( search_results &results ) {
+void word_node::do_eval( search_results &results ) {
   FOR_EACH_IN_PAIR( range_, i ) {
     file_list const list( i );
-    if ( is_too_frequent( list.size() ) )
+    if ( is_too_frequent( list.size(), num_files_ ) ) {
+      count_postings( 0, list.bytes(), stats_ );
       continue;
+    }
     for ( auto const &file : list )
       if ( file.has_meta_id( meta_id_ ) )
         results[ file.index_ ] += file.rank_;
+    count_postings( list.size(), list.bytes(), stats_ );
   } // for
 }
 
+////////// explain ////////////////////////////////////////////////////////////
+
+ostream& query_node::explain_node( ostream &o, int indent,
+                                   char const *label ) const {
+  for ( int i = 0; i < indent; ++i )
+    o << "  ";
+  o << label;
+  if ( !profile_.evaluated )
+    return o << " (not evaluated)\n";
+  if ( profile_.postings_decoded || profile_.bytes_touched )
+    o << " postings=" << profile_.postings_decoded
+      << " bytes=" << profile_.bytes_touched;
+  return o << " results=" << profile_.num_results
+           << " usec=" << profile_.eval_usec << '\n';
+}
+
+void and_node::explain( ostream &o, int indent ) const {
+  explain_node( o, indent, "and" );
+  for ( auto const &child : child_nodes_ )
+    child->explain( o, indent + 1 );
+}
+
+void empty_node::explain( ostream &o, int indent ) const {
+  for ( int i = 0; i < indent; ++i )
+    o << "  ";
+  o << "empty\n";
+}
+
+#ifdef WITH_WORD_POS
+void near_node::explain( ostream &o, int indent ) const {
+  explain_node( o, indent, "near" );
+  left() ->explain( o, indent + 1 );
+  right()->explain( o, indent + 1 );
+}
+
+void not_near_node::explain( ostream &o, int indent ) const {
+  explain_node( o, indent, "not near" );
+  left() ->explain( o, indent + 1 );
+  right()->explain( o, indent + 1 );
+}
+#endif /* WITH_WORD_POS */
+
+void not_node::explain( ostream &o, int indent ) const {
+  explain_node( o, indent, "not" );
+  child_->explain( o, indent + 1 );
+}
+
+void or_node::explain( ostream &o, int indent ) const {
+  explain_node( o, indent, "or" );
+  left() ->explain( o, indent + 1 );
+  right()->explain( o, indent + 1 );
+}
+
+void word_node::explain( ostream &o, int indent ) const {
+  for ( int i = 0; i < indent; ++i )
+    o << "  ";
+  o << "word \"" << word_ << "\" words="
+    << std::distance( range_.first, range_.second );
+  if ( meta_id_ != Meta_ID_None )
+    o << " meta=" << meta_id_;
+  //
+  // The children of a near_node are never evaluated themselves: their file
+  // lists are decoded by the near_node.
+  //
+  explain_node( o, 0, "" );
+}
+
 #ifdef DEBUG_eval_query
 ////////// print //////////////////////////////////////////////////////////////
 
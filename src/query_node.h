@@ -30,9 +30,7 @@
 
 // standard
 #include <cstddef>
-#ifdef DEBUG_eval_query
 #include <ostream>
-#endif /* DEBUG_eval_query */
 #include <vector>
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -52,9 +50,36 @@ public:
     virtual query_node* operator()( query_node* ) const = 0;
   };
 
+  /**
+   * A %profile contains statistics gathered while a node is evaluated that are
+   * printed by \c explain().
+   */
+  struct profile {
+    unsigned long postings_decoded = 0; // number of file entries decoded
+    size_t        bytes_touched = 0;    // bytes of file lists read
+    size_t        num_results = 0;      // number of results produced
+    unsigned long eval_usec = 0;        // time to evaluate (inclusive)
+    bool          evaluated = false;    // was the node evaluated at all?
+  };
+
   virtual ~query_node();
 
-  virtual void eval( search_results& ) = 0;
+  /**
+   * Evaluates this node (and its child nodes, if any) recording its profile.
+   *
+   * @param results The search results go here.
+   */
+  void eval( search_results &results );
+
+  /**
+   * Prints this node and its child nodes, one per line, along with the
+   * profile of each.
+   *
+   * @param o The ostream to print to.
+   * @param indent The number of levels to indent.
+   */
+  virtual void explain( std::ostream &o, int indent = 0 ) const = 0;
+
   virtual query_node* visit( visitor const& );
 # ifdef DEBUG_eval_query
   virtual std::ostream& print( std::ostream& ) const = 0;
@@ -63,6 +88,44 @@ public:
 protected:
   query_node() { }
   query_node( pool_type &p ) : pool_object_type{ p } { }
+
+  /**
+   * Counts postings decoded and bytes of file lists read while evaluating
+   * this node.
+   *
+   * @param postings The number of postings decoded.
+   * @param bytes The number of bytes read.
+   * @param stats If not null, the query-wide statistics to add to also.
+   */
+  void count_postings( unsigned long postings, size_t bytes,
+                       query_stats *stats ) {
+    profile_.postings_decoded += postings;
+    profile_.bytes_touched += bytes;
+    if ( stats ) {
+      stats->postings_decoded += postings;
+      stats->bytes_touched += bytes;
+    }
+  }
+
+  /**
+   * Evaluates this node.
+   *
+   * @param results The search results go here.
+   */
+  virtual void do_eval( search_results &results ) = 0;
+
+  /**
+   * Prints a node's label indented followed by its profile and a newline.
+   *
+   * @param o The ostream to print to.
+   * @param indent The number of levels to indent.
+   * @param label The label of the node.
+   * @return Returns \a o.
+   */
+  std::ostream& explain_node( std::ostream &o, int indent,
+                              char const *label ) const;
+
+  profile profile_;
 };
 
 /**
@@ -84,7 +147,7 @@ public:
   const_iterator  begin() const       { return child_nodes_.begin(); }
   iterator        end()               { return child_nodes_.end(); }
   const_iterator  end() const         { return child_nodes_.end(); }
-  void            eval( search_results& );
+  void            explain( std::ostream&, int = 0 ) const override;
   query_node*     visit( visitor const& );
 # ifdef DEBUG_eval_query
   std::ostream&   print( std::ostream& ) const override;
@@ -92,6 +155,8 @@ public:
 
 protected:
   child_node_list child_nodes_;
+
+  void do_eval( search_results& ) override;
 };
 
 /**
@@ -107,13 +172,15 @@ public:
   void* operator new( size_t )              { return &singleton_; }
   void  operator delete( void*, size_t )    { /* do nothing */ }
 
-  void eval( search_results& ) override;
+  void explain( std::ostream&, int = 0 ) const override;
 # ifdef DEBUG_eval_query
   std::ostream& print( std::ostream& ) const override;
 # endif
 
 private:
   static empty_node singleton_;
+
+  void do_eval( search_results& ) override;
 };
 
 #ifdef WITH_WORD_POS
@@ -169,7 +236,7 @@ public:
    */
   query_node* distribute();
 
-  void        eval( search_results& );
+  void        explain( std::ostream&, int = 0 ) const override;
   query_node* left () const             { return left_child_ ; }
   query_node* right() const             { return right_child_; }
   query_node* visit( visitor const& );
@@ -178,6 +245,9 @@ public:
   std::ostream& print( std::ostream& ) const override;
 # endif
 
+protected:
+  void do_eval( search_results& ) override;
+
 private:
   query_node *const left_child_, *const right_child_;
 };
@@ -191,11 +261,14 @@ public:
     near_node{ pool, left, right } { }
   ~not_near_node();
 
-  void eval( search_results& );
+  void explain( std::ostream&, int = 0 ) const override;
 
 # ifdef DEBUG_eval_query
   std::ostream& print( std::ostream& ) const override;
 # endif
+
+protected:
+  void do_eval( search_results& ) override;
 };
 #endif /* WITH_WORD_POS */
 
@@ -204,12 +277,12 @@ public:
  */
 class not_node : public query_node {
 public:
-  not_node( pool_type &p, query_node *child ) :
-    query_node{ p }, child_{ child } { }
+  not_node( pool_type &p, query_node *child, size_t num_files ) :
+    query_node{ p }, child_{ child }, num_files_{ num_files } { }
   ~not_node();
 
   query_node* child() const { return child_; }
-  void        eval( search_results& );
+  void        explain( std::ostream&, int = 0 ) const override;
   query_node* visit( visitor const& );
 # ifdef DEBUG_eval_query
   std::ostream& print( std::ostream& ) const override;
@@ -217,6 +290,9 @@ public:
 
 private:
   query_node *const child_;
+  size_t const num_files_;              // number of files in the index
+
+  void do_eval( search_results& ) override;
 };
 
 /**
@@ -228,7 +304,7 @@ public:
     query_node{ p }, left_child_{ left }, right_child_{ right } { }
   ~or_node();
 
-  void        eval( search_results& );
+  void        explain( std::ostream&, int = 0 ) const override;
   query_node* left () const { return left_child_ ; }
   query_node* right() const { return right_child_; }
   query_node* visit( visitor const& );
@@ -238,6 +314,8 @@ public:
 
 private:
   query_node *const left_child_, *const right_child_;
+
+  void do_eval( search_results& ) override;
 };
 
 /**
@@ -246,12 +324,15 @@ private:
  */
 class word_node : public query_node {
 public:
-  word_node( pool_type&, char const*, word_range const&, meta_id_type );
+  word_node( pool_type&, char const*, word_range const&, meta_id_type,
+             size_t num_files, query_stats* = nullptr );
   ~word_node();
 
-  void eval( search_results& );
+  void explain( std::ostream&, int = 0 ) const override;
   meta_id_type meta_id() const { return meta_id_; }
+  size_t num_files() const { return num_files_; }
   word_range const& range() const { return range_; }
+  query_stats* stats() const { return stats_; }
 # ifdef DEBUG_eval_query
   std::ostream& print( std::ostream& ) const override;
 # endif /* DEBUG_eval_query */
@@ -260,6 +341,10 @@ private:
   char *const word_;
   word_range const range_;
   meta_id_type const meta_id_;
+  size_t const num_files_;              // number of files in the index
+  query_stats *const stats_;
+
+  void do_eval( search_results& ) override;
 };
 
 ////////// inlines ////////////////////////////////////////////////////////////
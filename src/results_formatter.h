@@ -29,6 +29,7 @@ class file_info;
 
 // standard
 #include <ostream>
+#include <string>
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -49,14 +50,24 @@ public:
    */
   virtual void pre( stop_word_set const &stop_words ) const = 0;
 
+  /**
+   * Outputs an explanation of how a query was evaluated after all other
+   * output.
+   *
+   * @param explanation The explanation, one node of the query tree per line.
+   */
+  virtual void explain( std::string const &explanation ) const = 0;
+
   /**
    * Outputs an individual search result's information: it's rank, path, and
    * title.
    *
    * @param rank The result's rank.
+   * @param dir The directory the file is in.
    * @param finfo The file_info to format.
    */
-  virtual void result( int rank, file_info const &finfo ) const = 0;
+  virtual void result( int rank, char const *dir,
+                       file_info const &finfo ) const = 0;
 
   /**
    * Outputs any trailing information.
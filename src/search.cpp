@@ -28,16 +28,22 @@
 #include "file_info.h"
 #include "file_list.h"
 #include "IndexFile.h"
+#include "index_manifest.h"
 #include "index_segment.h"
+#include "NamedIndex.h"
 #include "pjl/less.h"
-#include "pjl/mmap_file.h"
 #include "pjl/omanip.h"
 #include "pjl/option_stream.h"
+#include "pjl/stopwatch.h"
+#ifdef MULTI_THREADED
+#include "pjl/thread_pool.h"
+#endif /* MULTI_THREADED */
 #include "query.h"
 #include "ResultSeparator.h"
 #include "ResultsFormat.h"
 #include "results_formatter.h"
 #include "ResultsMax.h"
+#include "search_index.h"
 #include "StemWords.h"
 #include "token.h"
 #include "util.h"
@@ -56,6 +62,9 @@
 #include "PidFile.h"
 #include "SearchBackground.h"
 #include "SearchDaemon.h"
+#include "SlowQueryLog.h"
+#include "SlowQuerySample.h"
+#include "SlowQueryTime.h"
 #include "SocketAddress.h"
 #include "SocketFile.h"
 #include "SocketQueueSize.h"
@@ -68,17 +77,26 @@
 #endif /* WITH_SEARCH_DAEMON */
 
 // standard
-#include <algorithm>                    /* for binary_search(), etc */
+#include <algorithm>                    /* for equal_range(), etc */
 #include <cstdlib>                      /* for exit(3) */
 #include <cstring>
 #include <iostream>
-#include <iterator>
-#include <memory>                       /* for unique_ptr */
+#include <map>
+#include <memory>                       /* for shared_ptr, unique_ptr */
+#include <new>                          /* for placement new */
 #include <ostream>
+#include <sstream>
 #include <string>
 #include <sys/time.h>                   /* needed by FreeBSD systems */
 #include <time.h>                       /* needed by sys/resource.h */
 #include <sys/resource.h>               /* for RLIMIT_* */
+#ifdef MULTI_THREADED
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#endif /* MULTI_THREADED */
 #include <utility>                      /* for pair<> */
 #include <vector>
 
@@ -86,10 +104,177 @@ using namespace PJL;
 using namespace std;
 
 /**
- * A %search_result is an individual search result where the first \c int is a
- * file index and the second \c int is that file's rank.
+ * A %logical_index is one or more shards, each an independently built index,
+ * that are searched as a single index.  The files of all its shards form a
+ * single space of file indices where the files of each shard start at that
+ * shard's offset.  A segmented index is loaded as a %logical_index whose
+ * shards are its segments; files with tombstones are never results.
  */
-using search_result = pair<int,int>;
+struct logical_index {
+  vector<unique_ptr<search_index>>  shards;
+  vector<int>                       offsets;
+  vector<tombstone_set>             tombstones;
+
+  /**
+   * Gets the number of the shard containing a file.
+   *
+   * @param file The file index within the logical index.
+   * @return Returns said shard number.
+   */
+  int shard_of( int file ) const {
+    return static_cast<int>(
+      ::upper_bound( offsets.begin(), offsets.end(), file ) - offsets.begin()
+    ) - 1;
+  }
+
+  /**
+   * Gets whether a file of a shard has been deleted, i.e., has a tombstone.
+   *
+   * @param shard The shard number.
+   * @param file The file index within the shard.
+   * @return Returns \c true only if it has.
+   */
+  bool is_deleted( size_t shard, int file ) const {
+    tombstone_set const &t = tombstones[ shard ];
+    return !t.empty() && t[ file ];
+  }
+
+  /**
+   * Gets whether a word is a stop word in every shard.
+   *
+   * @param word The null-terminated, lower-case word to check.
+   * @return Returns \c true only if it is.
+   */
+  bool is_stop_word( char const *word ) const {
+    for ( auto const &shard : shards )
+      if ( !shard->is_stop_word( word ) )
+        return false;
+    return true;
+  }
+};
+
+/**
+ * A %ranked_result is an individual search result from one of possibly several
+ * indices searched.
+ */
+struct ranked_result {
+  double  rank;                         // rank normalized to [1,100]
+  int     index_no;                     // which index searched
+  int     file;                         // file index within that index
+
+  /**
+   * Orders results by descending rank.  Ties are broken by index and file so
+   * the order is the same regardless of how many results are requested.
+   */
+  friend bool operator<( ranked_result const &i, ranked_result const &j ) {
+    if ( i.rank > j.rank )
+      return true;
+    if ( j.rank > i.rank )
+      return false;
+    if ( i.index_no != j.index_no )
+      return i.index_no < j.index_no;
+    return i.file < j.file;
+  }
+};
+
+/**
+ * A %file_ref refers to a file in a particular index.
+ */
+using file_ref = pair<search_index const*,int>;
+
+#ifdef MULTI_THREADED
+/**
+ * The number of seconds an idle shard-search thread waits for a task before
+ * exiting (if more than one exists).
+ */
+static unsigned const Shard_Thread_Timeout = 30;
+
+/**
+ * A %shard_work is the work of searching all the shards of all the indices
+ * for a single query.  It's shared by the thread servicing the request and
+ * any shard_threads helping it: each repeatedly takes the next shard not yet
+ * taken and searches it.
+ */
+struct shard_work {
+  function<void(size_t)>  search_one;   // searches the ith shard
+  size_t                  num_shards;
+  atomic<size_t>          next{ 0 };    // next shard not yet taken
+  size_t                  num_done = 0; // number of shards searched
+  mutex                   done_lock;
+  condition_variable      all_done;
+
+  /**
+   * Searches shards until none remain to be taken.
+   */
+  void run() {
+    for ( size_t i; (i = next++) < num_shards; ) {
+      search_one( i );
+      lock_guard<mutex> const lock( done_lock );
+      if ( ++num_done == num_shards )
+        all_done.notify_all();
+    } // for
+  }
+
+  /**
+   * Waits until all shards have been searched.  Only then is it safe for
+   * \c search_one to refer to objects that are about to be destroyed: a
+   * helper that starts later finds no shards left and never calls it.
+   */
+  void wait() {
+    unique_lock<mutex> lock( done_lock );
+    all_done.wait( lock, [this]{ return num_done == num_shards; } );
+  }
+};
+
+/**
+ * A %shard_thread is-a thread_pool::thread that helps search the shards for
+ * a query.  Its argument is a pointer to a dynamically allocated
+ * \c shared_ptr&lt;shard_work&gt; that it deletes.
+ */
+class shard_thread : public PJL::thread_pool::thread {
+public:
+  explicit shard_thread( PJL::thread_pool &p ) :
+    PJL::thread_pool::thread{ p } { }
+
+private:
+  thread* create( PJL::thread_pool &p ) const override {
+    return new shard_thread( p );
+  }
+
+  void main( argument_type arg ) override {
+    unique_ptr<shared_ptr<shard_work>> const work{
+      static_cast<shared_ptr<shard_work>*>( arg.p )
+    };
+    (*work)->run();
+  }
+};
+
+/**
+ * Gets the pool of threads shared by all requests for searching shards: at
+ * most one per CPU.  The pool is never destroyed so that it's never destroyed
+ * out from under its threads at exit.
+ *
+ * @return Returns said pool.
+ */
+static PJL::thread_pool& shard_pool() {
+  static PJL::thread_pool *const pool = []{
+    //
+    // A thread_pool needs a prototype thread that needs its pool.
+    //
+    void *const p = ::operator new( sizeof( PJL::thread_pool ) );
+    return new( p ) PJL::thread_pool(
+      new shard_thread( *static_cast<PJL::thread_pool*>( p ) ), 1,
+      max( std::thread::hardware_concurrency(), 1u ), Shard_Thread_Timeout
+    );
+  }();
+  return *pool;
+}
+#endif /* MULTI_THREADED */
+
+/**
+ * An %index_list is the list of indices a request searches.
+ */
+using index_list = vector<logical_index const*>;
 
 //*****************************************************************************
 //
@@ -97,9 +282,9 @@ using search_result = pair<int,int>;
 //
 //*****************************************************************************
 
-index_segment       directories, files, meta_names, stop_words, words;
 IndexFile           index_file_name;
 ResultsMax          max_results;
+NamedIndex          named_indices;
 char const*         me;                         // executable name
 ResultSeparator     result_separator;
 ResultsFormat       results_format;
@@ -119,6 +304,9 @@ ThreadsMax          max_threads;
 ThreadsMin          min_threads;
 PidFile             pid_file_name;
 SearchBackground    search_background;
+SlowQueryLog        slow_query_log_name;
+SlowQuerySample     slow_query_sample;
+SlowQueryTime       slow_query_time;
 SocketAddress       socket_address;
 SocketFile          socket_file_name;
 SocketQueueSize     socket_queue_size;
@@ -128,14 +316,29 @@ User                user;
 
 void                become_daemon();
 #endif /* WITH_SEARCH_DAEMON */
-static void         dump_single_word( char const*, ostream& = cout );
-static void         dump_word_window( char const*, int, int, ostream& = cout );
-static ostream&     write_file_info( ostream&, char const* );
-
-inline omanip<char const*> index_file_info( int index ) {
-  return omanip<char const*>( write_file_info, files[ index ] );
+void                search_batch( unsigned, istream&, ostream& );
+static bool         dump_entire_index( logical_index const&, ostream& );
+static bool         dump_names( logical_index const&,
+                                index_segment search_index::*, ostream& );
+static void         dump_single_word( logical_index const&, char const*,
+                                      ostream& );
+static void         dump_word_window( logical_index const&, char const*, int,
+                                      int, ostream& );
+static void         load_index( char const*, vector<string> const& );
+static bool         select_indices( char const*, index_list&, ostream& );
+static ostream&     write_file_info( ostream&, file_ref );
+
+inline omanip<file_ref> index_file_info( search_index const &index,
+                                         int file ) {
+  return omanip<file_ref>( write_file_info, file_ref( &index, file ) );
 }
 
+/**
+ * All indices loaded keyed by either their name (for a \c NamedIndex) or the
+ * path they were loaded from.
+ */
+static map<string,logical_index> indices;
+
 ////////// main ///////////////////////////////////////////////////////////////
 
 int main( int argc, char *argv[] ) {
@@ -195,6 +398,12 @@ int main( int argc, char *argv[] ) {
 #endif /* __APPLE__ */
   )
     search_background = false;
+  if ( opt.slow_query_log_arg )
+    slow_query_log_name = opt.slow_query_log_arg;
+  if ( opt.slow_query_sample_arg )
+    slow_query_sample = opt.slow_query_sample_arg;
+  if ( opt.slow_query_time_arg )
+    slow_query_time = opt.slow_query_time_arg;
   if ( opt.socket_address_arg )
     socket_address = opt.socket_address_arg;
   if ( opt.socket_file_name_arg )
@@ -220,7 +429,7 @@ int main( int argc, char *argv[] ) {
     opt.dump_word_index_opt   ||
     opt.print_help_opt        ||
     opt.print_version_opt;
-  if ( !(argc || dump_something
+  if ( !(argc || dump_something || opt.batch_opt
 #ifdef WITH_SEARCH_DAEMON
          || daemon_type != "none"
 #endif /* WITH_SEARCH_DAEMON */
@@ -247,124 +456,259 @@ int main( int argc, char *argv[] ) {
     max_out_limit( RLIMIT_AS );         // max-out total avail. memory
 #endif /* RLIMIT_AS */
 
-  mmap_file const the_index( index_file_name );
-  if ( !the_index ) {
-    error() << "could not read index from \"" << index_file_name
-            << '"' << error_string( the_index.error() );
-    ::exit( Exit_No_Read_Index );
-  }
-  the_index.behavior( mmap_file::bt_random );
-
-  words      .set_index_file( the_index, index_segment::isi_word      );
-  stop_words .set_index_file( the_index, index_segment::isi_stop_word );
-  directories.set_index_file( the_index, index_segment::isi_dir       );
-  files      .set_index_file( the_index, index_segment::isi_file      );
-  meta_names .set_index_file( the_index, index_segment::isi_meta_name );
+  //
+  // The index file may be a comma-separated list of either index file paths or
+  // names of NamedIndex indices.  Load the former here and all of the latter
+  // below.
+  //
+  string const index_file_names( index_file_name );
+  istringstream index_file_names_stream( index_file_names );
+  for ( string path; getline( index_file_names_stream, path, ',' ); )
+    if ( !path.empty() && !named_indices.contains( path ) )
+      load_index( path.c_str(), { path } );
+  for ( auto const &[ name, paths ] : named_indices )
+    load_index( name.c_str(), paths );
 
 #ifdef WITH_SEARCH_DAEMON
   ////////// Become a daemon //////////////////////////////////////////////////
 
-  if ( !dump_something && daemon_type != "none" )
+  if ( !dump_something && !opt.batch_opt && daemon_type != "none" )
     become_daemon();                    // function does not return
 #endif /* WITH_SEARCH_DAEMON */
 
   ////////// Perform the query ////////////////////////////////////////////////
 
-  service_request( argv, opt );
+  if ( !dump_something && opt.batch_opt ) {
+    search_batch( opt.batch_threads_arg, cin, cout );
+    ::exit( Exit_Success );
+  }
+
+  //
+  // Since write errors aren't reported, service_request() failing while cout
+  // is still good means the query was malformed.
+  //
+  if ( !service_request( argv, opt ) && cout )
+    ::exit( Exit_Malformed_Query );
   ::exit( Exit_Success );
 }
 
 ////////// local functions ////////////////////////////////////////////////////
 
+/**
+ * Dumps the entire word index to standard output.  For an index having several
+ * shards, the words of all of them are merged in order and, for each word, the
+ * files of every shard it's in are listed.  Deleted files are not listed.
+ *
+ * @param index The index to dump.
+ * @param out The ostream to dump to.
+ * @return Returns \c true only if the dump succeeded.
+ */
+static bool dump_entire_index( logical_index const &index, ostream &out ) {
+  vector<index_segment::const_iterator> words;
+  for ( auto const &shard : index.shards )
+    words.push_back( shard->words.begin() );
+
+  while ( true ) {
+    //
+    // Find the least word among all the shards.
+    //
+    char const *word = nullptr;
+    for ( size_t i = 0; i < words.size(); ++i ) {
+      if ( words[i] != index.shards[i]->words.end() &&
+           (!word || ::strcmp( *words[i], word ) < 0) ) {
+        word = *words[i];
+      }
+    } // for
+    if ( !word )
+      return true;
+
+    bool dumped_word = false;
+    for ( size_t i = 0; i < words.size(); ++i ) {
+      if ( words[i] == index.shards[i]->words.end() ||
+           ::strcmp( *words[i], word ) ) {
+        continue;
+      }
+      file_list const list( words[i] );
+      for ( auto const &file : list ) {
+        if ( index.is_deleted( i, file.index_ ) )
+          continue;
+        if ( !dumped_word ) {
+          out << word << '\n';
+          dumped_word = true;
+        }
+        out << "  " << file.occurrences_ << ' '
+            << file.rank_ << result_separator
+            << index_file_info( *index.shards[i], file.index_ )
+            << '\n';
+        if ( !out )
+          return false;
+      } // for
+      ++words[i];
+    } // for
+    if ( dumped_word )
+      out << '\n';
+  } // while
+}
+
+/**
+ * Dumps either the stop words or meta names of an index to standard output.
+ * For an index having several shards, those of all of them are merged in
+ * order.
+ *
+ * @param index The index to dump from.
+ * @param segment The index_segment of each shard to dump.
+ * @param out The ostream to dump to.
+ * @return Returns \c true only if the dump succeeded.
+ */
+static bool dump_names( logical_index const &index,
+                        index_segment search_index::*segment, ostream &out ) {
+  vector<char const*> names;
+  for ( auto const &shard : index.shards ) {
+    index_segment const &shard_names = (*shard).*segment;
+    names.insert( names.end(), shard_names.begin(), shard_names.end() );
+  } // for
+  if ( index.shards.size() > 1 ) {
+    ::sort( names.begin(), names.end(), less<char const*>() );
+    names.erase(
+      ::unique( names.begin(), names.end(),
+        []( char const *a, char const *b ) { return !::strcmp( a, b ); }
+      ),
+      names.end()
+    );
+  }
+  for ( auto const &name : names ) {
+    out << name << '\n';
+    if ( !out )
+      return false;
+  } // for
+  return true;
+}
+
 /**
  * Dumps the list of files a word is in and ranks therefore to standard output.
+ * For an index having several shards, the files of every shard the word is in
+ * are listed.  Deleted files are not listed.
  *
+ * @param index The index to dump from.
  * @param word The word to have its index dumped.
  * @param out The ostream to dump to.
  */
-static void dump_single_word( char const *word, ostream &out ) {
+static void dump_single_word( logical_index const &index, char const *word,
+                              ostream &out ) {
   unique_ptr<char[]> const lower_ptr( to_lower_r( word ) );
   auto const lower_word = lower_ptr.get();
   less<char const*> const comparator;
 
-  if ( !is_ok_word( word ) ||
-    ::binary_search(
-      stop_words.begin(), stop_words.end(), lower_word, comparator
-    )
-  ) {
+  if ( !is_ok_word( word ) || index.is_stop_word( lower_word ) ) {
     out << "# ignored: " << word << endl;
     return;
   }
 
-  //
-  // Look up the word.
-  //
-  auto const range =
-    ::equal_range( words.begin(), words.end(), lower_word, comparator );
-  if ( range.first == words.end() || comparator( lower_word, *range.first ) ) {
+  bool found = false;
+  for ( size_t i = 0; i < index.shards.size(); ++i ) {
+    search_index const &shard = *index.shards[i];
+    if ( shard.is_stop_word( lower_word ) )
+      continue;
+
+    //
+    // Look up the word.
+    //
+    index_segment const &words = shard.words;
+    auto const range =
+      ::equal_range( words.begin(), words.end(), lower_word, comparator );
+    if ( range.first == words.end() || comparator( lower_word, *range.first ) )
+      continue;
+
+    file_list const list( range.first );
+    for ( auto const &file : list ) {
+      if ( index.is_deleted( i, file.index_ ) )
+        continue;
+      out << file.occurrences_ << ' '
+          << file.rank_ << result_separator
+          << index_file_info( shard, file.index_ ) << '\n';
+      if ( !out )
+        return;
+      found = true;
+    } // for
+  } // for
+
+  if ( !found ) {
     out << "# not found: " << word << endl;
     return;
   }
-
-  file_list const list( range.first );
-  for ( auto const &file : list ) {
-    out << file.occurrences_ << ' '
-        << file.rank_ << result_separator
-        << index_file_info( file.index_ ) << '\n';
-    if ( !out )
-      return;
-  } // for
   out << '\n';
 }
 
 /**
  * Dumps a "window" of words from the index around the given word to standard
- * output.
+ * output.  For an index having several shards, the window is of the words of
+ * all of them merged in order.
  *
+ * @param index The index to dump from.
  * @param word The word to dump.
  * @param window_size The number of lines the window is to contain at most.
  * @param match The number of characters to compare.
  * @param out The ostream to dump to.
  */
-static void dump_word_window( char const *word, int window_size, int match,
-                              ostream &out ) {
+static void dump_word_window( logical_index const &index, char const *word,
+                              int window_size, int match, ostream &out ) {
   unique_ptr<char[]> const lower_ptr( to_lower_r( word ) );
   auto const lower_word = lower_ptr.get();
   less<char const*> const comparator;
 
-  if ( !is_ok_word( word ) ||
-    ::binary_search(
-      stop_words.begin(), stop_words.end(), lower_word, comparator
-    )
-  ) {
+  if ( !is_ok_word( word ) || index.is_stop_word( lower_word ) ) {
     out << "# ignored: " << word << endl;
     return;
   }
 
   //
-  // Look up the word.
+  // Look up the word in every shard and gather the words around it that could
+  // be in the window: at most half the window size before it and the window
+  // size after that.
   //
-  auto range =
-    ::equal_range( words.begin(), words.end(), lower_word, comparator );
-  if ( range.first == words.end() || comparator( lower_word, *range.first ) ){
+  bool found = false;
+  vector<char const*> words;
+  for ( auto const &shard : index.shards ) {
+    index_segment const &shard_words = shard->words;
+    auto w = ::lower_bound(
+      shard_words.begin(), shard_words.end(), lower_word, comparator
+    );
+    if ( w != shard_words.end() && !comparator( lower_word, *w ) )
+      found = true;
+    int i = window_size / 2;
+    while ( w != shard_words.begin() && i-- > 0 )
+      --w;
+    int const max_words = window_size / 2 + window_size;
+    for ( i = 0; w != shard_words.end() && i < max_words; ++i )
+      words.push_back( *w++ );
+  } // for
+  if ( !found ) {
     out << "# not found: " << word << endl;
     return;
   }
+  ::sort( words.begin(), words.end(), comparator );
+  words.erase(
+    ::unique( words.begin(), words.end(),
+      []( char const *a, char const *b ) { return !::strcmp( a, b ); }
+    ),
+    words.end()
+  );
 
   //
   // Dump the window by first "backing up" half the window size, then going
   // forward.
   //
+  auto w = ::lower_bound( words.begin(), words.end(), lower_word, comparator );
   int i = window_size / 2;
-  while ( range.first != words.begin() && i-- > 0 )
-    --range.first;
-  for ( i = 0; range.first != words.end() && i < window_size; ++range.first ) {
-    int const cmp = ::strncmp( *range.first, lower_word, match );
+  while ( w != words.begin() && i-- > 0 )
+    --w;
+  for ( i = 0; w != words.end() && i < window_size; ++w ) {
+    int const cmp = ::strncmp( *w, lower_word, match );
     if ( cmp < 0 )
       continue;
     if ( cmp > 0 )
       break;
-    out << *range.first << '\n';
+    out << *w << '\n';
     if ( !out )
       return;
     ++i;
@@ -373,77 +717,205 @@ static void dump_word_window( char const *word, int window_size, int match,
 }
 
 /**
- * Parses a query, performs a search, and outputs the results.
+ * Parses a query, performs a search of one or more indices, and outputs the
+ * results.  Every shard of every index is searched concurrently.  The results
+ * of the shards of an index are merged as-is; the ranks of each index's
+ * results are normalized before the results of different indices are merged
+ * so they are comparable.  Only the top \a skip_results + \a max_results
+ * results are sorted.
  *
+ * @param indices The indices to search.
  * @param query The text of the query.
  * @param skip_results The number of initial results to skip.
  * @param max_results The maximum number of results to output.
  * @param results_format The results format.
  * @param out The ostream to print the results to.
  * @param err The ostream to print errors to.
+ * @param stats Statistics about the query are accumulated here.
  */
-static bool search( char const *query, unsigned skip_results,
-                    unsigned max_results, char const *results_format,
-                    ostream &out, ostream &err ) {
-  token_stream    query_stream( query );
-  search_results  results;
+static bool search( index_list const &indices, char const *query,
+                    unsigned skip_results, unsigned max_results,
+                    char const *results_format, ostream &out, ostream &err,
+                    query_stats *stats ) {
+  /**
+   * An %index_search contains the results of searching a single shard of an
+   * index.
+   */
+  struct index_search {
+    int             index_no;
+    int             shard_no;
+    search_results  results;
+    stop_word_set   stop_words_found;
+    query_stats     stats;
+    bool            ok;
+  };
+
+  vector<index_search> searches;
+  for ( size_t i = 0; i < indices.size(); ++i ) {
+    for ( size_t j = 0; j < indices[i]->shards.size(); ++j ) {
+      searches.emplace_back();
+      searches.back().index_no = static_cast<int>( i );
+      searches.back().shard_no = static_cast<int>( j );
+    } // for
+  } // for
+
+  auto const search_one = [&]( size_t i ) {
+    index_search &s = searches[i];
+    token_stream query_stream( query );
+    s.stats.explain = stats->explain;
+    s.ok = parse_query(
+      *indices[ s.index_no ]->shards[ s.shard_no ], query_stream, s.results,
+      s.stop_words_found, &s.stats
+    ) && query_stream.eof();
+    tombstone_set const &tombstones =
+      indices[ s.index_no ]->tombstones[ s.shard_no ];
+    if ( !tombstones.empty() ) {
+      ::erase_if( s.results, [&]( auto const &result ) {
+        return tombstones[ result.first ];
+      } );
+    }
+  };
+
+#ifdef MULTI_THREADED
+  if ( searches.size() > 1 ) {
+    //
+    // When all the shared threads are busy, the thread servicing the request
+    // searches the remaining shards itself.
+    //
+    auto const work = make_shared<shard_work>();
+    work->search_one = search_one;
+    work->num_shards = searches.size();
+    for ( size_t i = 1; i < searches.size(); ++i ) {
+      auto *const helper_work = new shared_ptr<shard_work>( work );
+      if ( !shard_pool().new_task( helper_work ) ) {
+        delete helper_work;
+        break;
+      }
+    } // for
+    work->run();
+    work->wait();
+  } else {
+    search_one( 0 );
+  }
+#else
+  for ( size_t i = 0; i < searches.size(); ++i )
+    search_one( i );
+#endif /* MULTI_THREADED */
+
+  size_t          num_results = 0;
   stop_word_set   stop_words_found;
 
-  if ( !(parse_query( query_stream, results, stop_words_found ) &&
-         query_stream.eof()) ) {
-    err << error << "malformed query\n";
-#ifdef WITH_SEARCH_DAEMON
-    if ( daemon_type != "none" )
+  for ( size_t i = 0; i < searches.size(); ++i ) {
+    index_search const &s = searches[i];
+    if ( !s.ok ) {
+      err << error << "malformed query\n";
       return false;
-#endif /* WITH_SEARCH_DAEMON */
-    ::exit( Exit_Malformed_Query );
-  }
+    }
+    num_results += s.results.size();
+    stop_words_found.insert( s.stop_words_found.begin(),
+                             s.stop_words_found.end() );
+    stats->postings_decoded += s.stats.postings_decoded;
+    stats->bytes_touched    += s.stats.bytes_touched;
+    stats->num_results      += s.stats.num_results;
+    stats->parse_usec       += s.stats.parse_usec;
+    stats->eval_usec        += s.stats.eval_usec;
+    if ( !stats->explain )
+      continue;
+    if ( searches.size() == 1 ) {
+      stats->explanation = s.stats.explanation;
+      continue;
+    }
+    //
+    // Label and indent the explanation for each index shard.
+    //
+    stats->explanation += "index \"";
+    stats->explanation += indices[ s.index_no ]->shards[ s.shard_no ]->path();
+    stats->explanation += "\"\n";
+    istringstream explanation( s.stats.explanation );
+    for ( string line; getline( explanation, line ); ) {
+      stats->explanation += "  ";
+      stats->explanation += line;
+      stats->explanation += '\n';
+    } // for
+  } // for
 
   ////////// Print the results ////////////////////////////////////////////////
 
   unique_ptr<results_formatter const> format;
   if ( to_lower( *results_format ) == 'x' /* must be "xml" */ )
-    format.reset( new xml_formatter( out, results.size() ) );
+    format.reset( new xml_formatter( out, num_results ) );
   else
-    format.reset( new classic_formatter( out, results.size() ) );
+    format.reset( new classic_formatter( out, num_results ) );
 
   format->pre( stop_words_found );
   if ( !out )
     return false;
-  if ( skip_results < results.size() && max_results ) {
-    using sorted_results_type = vector<search_result>;
-    sorted_results_type sorted;
-    sorted.reserve( results.size() );
-    ::copy( results.begin(), results.end(), ::back_inserter( sorted ) );
-    ::sort(
-      sorted.begin(), sorted.end(),
-      []( search_result const &i, search_result const &j ) {
-        return i.second > j.second;
-      }
-    );
+  if ( skip_results < num_results && max_results ) {
+    stopwatch timer;
+    //
+    // Compute the highest rank of each index across all its shards for the
+    // normalization factor.
     //
-    // Compute the highest rank and the normalization factor.
+    vector<int> highest_rank( indices.size() );
+    for ( auto const &s : searches )
+      for ( auto const &result : s.results )
+        highest_rank[ s.index_no ] =
+          max( highest_rank[ s.index_no ], result.second );
     //
-    int const highest_rank = sorted[0].second;
-    double const normalize = 100.0 / highest_rank;
+    // Select the top results by keeping a heap of the best so far whose top
+    // is the worst of those, i.e., the next to be evicted.
+    //
+    size_t const top_k = min<size_t>(
+      num_results, static_cast<size_t>( skip_results ) + max_results
+    );
+    vector<ranked_result> sorted;
+    sorted.reserve( top_k );
+    for ( auto const &s : searches ) {
+      logical_index const &index = *indices[ s.index_no ];
+      double const normalize = 100.0 / highest_rank[ s.index_no ];
+      int const offset = index.offsets[ s.shard_no ];
+      for ( auto const &result : s.results ) {
+        ranked_result const r{
+          result.second * normalize, s.index_no, offset + result.first
+        };
+        if ( sorted.size() < top_k ) {
+          sorted.push_back( r );
+          ::push_heap( sorted.begin(), sorted.end() );
+        } else if ( r < sorted.front() ) {
+          ::pop_heap( sorted.begin(), sorted.end() );
+          sorted.back() = r;
+          ::push_heap( sorted.begin(), sorted.end() );
+        }
+      } // for
+    } // for
+    ::sort_heap( sorted.begin(), sorted.end() );
+    stats->sort_usec += timer.restart();
     //
     // Print the sorted results skipping some if requested to and not exceeding
     // the maximum.
     //
     for ( auto r = sorted.begin() + skip_results;
           r != sorted.end() && max_results-- > 0 && out; ++r ) {
-      int rank = static_cast<int>( r->second * normalize );
+      int rank = static_cast<int>( r->rank );
       if ( !rank )
         rank = 1;
-      format->result(
-        rank,
-        file_info( reinterpret_cast<unsigned char const*>( files[ r->first ] ) )
+      logical_index const &logical = *indices[ r->index_no ];
+      int const shard_no = logical.shard_of( r->file );
+      search_index const &index = *logical.shards[ shard_no ];
+      file_info const fi(
+        reinterpret_cast<unsigned char const*>(
+          index.files[ r->file - logical.offsets[ shard_no ] ]
+        )
       );
+      format->result( rank, index.directories[ fi.dir_index() ], fi );
       if ( !out )
         return false;
     } // for
+    stats->output_usec += timer.elapsed_usec();
   }
   format->post();
+  if ( stats->explain )
+    format->explain( stats->explanation );
   return true;
 }
 
@@ -452,6 +924,8 @@ search_options::search_options( int *argc, char ***argv,
                                 ostream &err ) :
   bad_( false )
 {
+  batch_opt             = false;
+  batch_threads_arg     = 0;
   config_file_name_arg  = ConfigFile_Default;
   dump_entire_index_opt = false;
   dump_match_arg        = 0;
@@ -459,6 +933,7 @@ search_options::search_options( int *argc, char ***argv,
   dump_stop_words_opt   = false;
   dump_window_size_arg  = 0;
   dump_word_index_opt   = false;
+  explain_opt           = false;
   index_file_name_arg   = nullptr;
   max_results_arg       = nullptr;
   print_help_opt        = false;
@@ -482,6 +957,9 @@ search_options::search_options( int *argc, char ***argv,
   min_threads_arg       = 0;
   pid_file_name_arg     = nullptr;
   search_background_opt = false;
+  slow_query_log_arg    = nullptr;
+  slow_query_sample_arg = nullptr;
+  slow_query_time_arg   = nullptr;
   socket_address_arg    = nullptr;
   socket_file_name_arg  = nullptr;
   socket_queue_size_arg = 0;
@@ -524,6 +1002,10 @@ search_options::search_options( int *argc, char ***argv,
         dump_entire_index_opt = true;
         break;
 
+      case 'e': // Explain query evaluation.
+        explain_opt = true;
+        break;
+
       case 'f': // Word/files file maximum.
         word_files_max_arg = opt.arg();
         break;
@@ -545,6 +1027,22 @@ search_options::search_options( int *argc, char ***argv,
         index_file_name_arg = opt.arg();
         break;
 
+      case 'j': // Batch mode.
+        batch_opt = true;
+        if ( opt.arg() && *opt.arg() )
+          batch_threads_arg = atou( opt.arg(), "batch" );
+        break;
+
+#ifdef WITH_SEARCH_DAEMON
+      case 'l': // Slow-query log file.
+        slow_query_log_arg = opt.arg();
+        break;
+
+      case 'L': // Slow-query time threshold.
+        slow_query_time_arg = opt.arg();
+        break;
+#endif /* WITH_SEARCH_DAEMON */
+
       case 'm': // Max. number of results.
         max_results_arg = opt.arg();
         break;
@@ -583,6 +1081,10 @@ search_options::search_options( int *argc, char ***argv,
         if ( socket_queue_size_arg < 1 )
           socket_queue_size_arg = 1;
         break;
+
+      case 'Q': // Slow-query sample percentage.
+        slow_query_sample_arg = opt.arg();
+        break;
 #endif /* WITH_SEARCH_DAEMON */
 
       case 'r': // Number of initial results to skip.
@@ -658,10 +1160,21 @@ search_options::search_options( int *argc, char ***argv,
 }
 
 bool service_request( char *argv[], search_options const &opt, ostream &out,
-                      ostream &err ) {
+                      ostream &err, query_stats *stats ) {
+  index_list indices;
+  if ( !select_indices(
+          opt.index_file_name_arg ? opt.index_file_name_arg : index_file_name,
+          indices, err ) ) {
+    return false;
+  }
+  //
+  // Dumps are only of the first index, but of all its shards.
+  //
+  logical_index const &index = *indices.front();
+
   if ( opt.dump_window_size_arg ) {
     while ( *argv && out )
-      dump_word_window( *argv++,
+      dump_word_window( index, *argv++,
         opt.dump_window_size_arg, opt.dump_match_arg, out
       );
     return true;
@@ -669,44 +1182,18 @@ bool service_request( char *argv[], search_options const &opt, ostream &out,
 
   if ( opt.dump_word_index_opt ) {
     while ( *argv && out )
-      dump_single_word( *argv++, out );
+      dump_single_word( index, *argv++, out );
     return true;
   }
 
-  if ( opt.dump_entire_index_opt ) {
-    FOR_EACH( words, word ) {
-      out << *word << '\n';
-      file_list const list( word );
-      for ( auto const &file : list ) {
-        out << "  " << file.occurrences_ << ' '
-            << file.rank_ << result_separator
-            << index_file_info( file.index_ )
-            << '\n';
-        if ( !out )
-          return false;
-      } // for
-      out << '\n';
-    } // for
-    return true;
-  }
+  if ( opt.dump_entire_index_opt )
+    return dump_entire_index( index, out );
 
-  if ( opt.dump_stop_words_opt ) {
-    for ( auto const &word : stop_words ) {
-      out << word << '\n';
-      if ( !out )
-        return false;
-    } // for
-    return true;
-  }
+  if ( opt.dump_stop_words_opt )
+    return dump_names( index, &search_index::stop_words, out );
 
-  if ( opt.dump_meta_names_opt ) {
-    for ( auto const &meta_name : meta_names ) {
-      out << meta_name << '\n';
-      if ( !out )
-        return false;
-    } // for
-    return true;
-  }
+  if ( opt.dump_meta_names_opt )
+    return dump_names( index, &search_index::meta_names, out );
 
   if ( opt.print_help_opt ) {
     out << usage;
@@ -720,6 +1207,16 @@ bool service_request( char *argv[], search_options const &opt, ostream &out,
 
   ////////// Perform the query ////////////////////////////////////////////////
 
+  if ( !*argv ) {
+    err << error << "no query\n";
+    return false;
+  }
+
+  query_stats local_stats;
+  if ( !stats )
+    stats = &local_stats;
+  stats->explain = opt.explain_opt;
+
   //
   // Paste the rest of the command line together into a single query string.
   //
@@ -730,26 +1227,120 @@ bool service_request( char *argv[], search_options const &opt, ostream &out,
   } // while
 
   return search(
-    query.c_str(),
+    indices, query.c_str(),
     opt.skip_results_arg,
     opt.max_results_arg ? ::atoi( opt.max_results_arg ) : max_results,
     opt.results_format_arg ? opt.results_format_arg : results_format,
-    out, err
+    out, err, stats
   );
 }
 
+/**
+ * Loads an index, but only if it hasn't been loaded already.  If the index
+ * can't be loaded, prints an error message and exits.
+ *
+ * @param name The name to load the index as.
+ * @param paths The full paths of the index files of the index's shards.
+ */
+static void load_index( char const *name, vector<string> const &paths ) {
+  logical_index &index = indices[ name ];
+  if ( !index.shards.empty() )
+    return;
+  int offset = 0;
+
+  auto const add_shard = [&]( string const &path,
+                              string const &tombstones_path ) {
+    unique_ptr<search_index> shard( new search_index( path.c_str() ) );
+    if ( !*shard ) {
+      error() << "could not read index from \"" << path
+              << '"' << error_string( shard->error() );
+      ::exit( Exit_No_Read_Index );
+    }
+    tombstone_set tombstones;
+    if ( !tombstones_path.empty() &&
+         !read_tombstones( tombstones_path.c_str(), shard->files.size(),
+                           tombstones ) ) {
+      error() << "could not read tombstones from \"" << tombstones_path
+              << '"' << error_string;
+      ::exit( Exit_No_Read_Index );
+    }
+    index.offsets.push_back( offset );
+    offset += static_cast<int>( shard->files.size() );
+    index.shards.push_back( std::move( shard ) );
+    index.tombstones.push_back( std::move( tombstones ) );
+  };
+
+  for ( auto const &path : paths ) {
+    if ( !index_manifest::is_manifest( path.c_str() ) ) {
+      add_shard( path, "" );
+      continue;
+    }
+    index_manifest manifest;
+    if ( !manifest.read( path.c_str() ) || manifest.segments.empty() ) {
+      error() << "could not read index manifest from \"" << path << "\"\n";
+      ::exit( Exit_No_Read_Index );
+    }
+    for ( auto const &segment : manifest.segments ) {
+      add_shard(
+        manifest.path_of( segment.file ),
+        segment.tombstones.empty() ? "" :
+          manifest.path_of( segment.tombstones )
+      );
+    } // for
+  } // for
+
+  //
+  // Whether a word is too frequent depends on the number of files in all the
+  // shards, not just in the shard it's in.
+  //
+  if ( index.shards.size() > 1 )
+    for ( auto &shard : index.shards )
+      shard->num_frequency_files( static_cast<size_t>( offset ) );
+}
+
+/**
+ * Selects the indices a request is to search.
+ *
+ * @param names A comma-separated list of names (or paths) of loaded indices.
+ * @param list The list to append the selected indices to.
+ * @param err The ostream to print errors to.
+ * @return Returns \c true only if all the indices exist.
+ */
+static bool select_indices( char const *names, index_list &list,
+                            ostream &err ) {
+  string const s( names );
+  istringstream names_stream( s );
+  for ( string name; getline( names_stream, name, ',' ); ) {
+    if ( name.empty() )
+      continue;
+    auto const found = indices.find( name );
+    if ( found == indices.end() ) {
+      err << error << '"' << name << "\": no such index\n";
+      return false;
+    }
+    list.push_back( &found->second );
+  } // for
+  if ( list.empty() ) {
+    err << error << "no index\n";
+    return false;
+  }
+  return true;
+}
+
 /**
  * Parses a file_info from an index file and write it to an ostream.
  *
  * @param o The ostream to write to.
- * @param p A pointer to the first character containing a file_info inside an
- * index file.
+ * @param ref The index and file index within it of the file_info.
  * @return Returns \a o.
  */
-static ostream& write_file_info( ostream &o, char const *p ) {
-  file_info const fi( reinterpret_cast<unsigned char const*>( p ) );
+static ostream& write_file_info( ostream &o, file_ref ref ) {
+  search_index const &index = *ref.first;
+  file_info const fi(
+    reinterpret_cast<unsigned char const*>( index.files[ ref.second ] )
+  );
   return o
-      << directories[ fi.dir_index() ] << '/' << fi.file_name()
+      << index.directories[ fi.dir_index() ] << '/' << fi.file_name()
       << result_separator << fi.size() << result_separator
       << fi.title();
 }
@@ -767,12 +1358,18 @@ ostream& usage( ostream &o ) {
   "-c f | --config-file f    : Name of configuration file [default: " << ConfigFile_Default << "]\n"
   "-d   | --dump-words       : Dump query word indices, exit\n"
   "-D   | --dump-index       : Dump entire word index, exit\n"
+  "-e   | --explain          : Explain query evaluation [default: no]\n"
   "-f n | --word-files n     : Word/file maximum [default: infinity]\n"
   "-F f | --format f         : Results format [default: classic]\n"
 #ifdef WITH_SEARCH_DAEMON
   "-G s | --group s          : Daemon group to run as [default: " << Group_Default << "]\n"
 #endif /* WITH_SEARCH_DAEMON */
-  "-i f | --index-file f     : Name of index file [default: " << IndexFile_Default << "]\n"
+  "-i f | --index-file f     : Name(s) of index file(s) [default: " << IndexFile_Default << "]\n"
+  "-j [n] | --batch[=n]      : Search queries read from standard input using n threads [default: 1 per CPU]\n"
+#ifdef WITH_SEARCH_DAEMON
+  "-l f | --slow-query-log f : Name of file to log slow queries to [default: none]\n"
+  "-L n | --slow-query-time n: Slow query threshold in ms [default: " << SlowQueryTime_Default << "]\n"
+#endif /* WITH_SEARCH_DAEMON */
   "-m n | --max-results n    : Maximum number of results [default: " << ResultsMax_Default << "]\n"
   "-M   | --dump-meta        : Dump meta-name index, exit\n"
 #ifdef WITH_WORD_POS
@@ -786,6 +1383,7 @@ ostream& usage( ostream &o ) {
 #ifdef WITH_SEARCH_DAEMON
   "-P f | --pid-file f       : Name of file to record daemon PID in [default: none]\n"
   "-q n | --queue-size n     : Maximum queued socket connections [default: " << SocketQueueSize_Default << "]\n"
+  "-Q n | --slow-query-sample n: Percent of slow queries to log [default: " << SlowQuerySample_Default << "]\n"
 #endif /* WITH_SEARCH_DAEMON */
   "-r n | --skip-results n   : Number of initial results to skip [default: 0]\n"
   "-R s | --separator s      : Result separator string [default: \" \"]\n"
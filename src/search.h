@@ -30,6 +30,8 @@
 #include <iostream>
 #include <ostream>
 
+struct query_stats;
+
 ///////////////////////////////////////////////////////////////////////////////
 
 /**
@@ -46,6 +48,8 @@
  * option was given.
  */
 struct search_options {
+  bool        batch_opt;
+  unsigned    batch_threads_arg;
   char const *config_file_name_arg;
   bool        dump_entire_index_opt;
   int         dump_match_arg;
@@ -53,6 +57,7 @@ struct search_options {
   bool        dump_stop_words_opt;
   int         dump_window_size_arg;
   bool        dump_word_index_opt;
+  bool        explain_opt;
   char const *index_file_name_arg;
   char const *max_results_arg;
   bool        print_help_opt;
@@ -76,6 +81,9 @@ struct search_options {
   int         min_threads_arg;
   char const *pid_file_name_arg;
   bool        search_background_opt;
+  char const *slow_query_log_arg;
+  char const *slow_query_sample_arg;
+  char const *slow_query_time_arg;
   char const *socket_address_arg;
   char const *socket_file_name_arg;
   int         socket_queue_size_arg;
@@ -119,10 +127,12 @@ private:
  * @param opt The set of options specified for this request.
  * @param out The ostream to send results to.
  * @param err The ostream to send errors to.
+ * @param stats If not null, statistics about the query are accumulated here.
  */
 bool service_request( char *argv[], search_options const &opts,
                       std::ostream &out = std::cout,
-                      std::ostream &err = std::cerr );
+                      std::ostream &err = std::cerr,
+                      query_stats *stats = nullptr );
 
 /**
  * Emits the usage message to the given ostream.
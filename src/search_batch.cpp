@@ -0,0 +1,156 @@
+/*
+**      SWISH++
+**      src/search_batch.cpp
+**
+**      Copyright (C) 2026  Paul J. Lucas
+**
+**      This program is free software; you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation; either version 2 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program; if not, write to the Free Software
+**      Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+// local
+#include "config.h"
+#include "search.h"
+#include "util.h"
+
+// standard
+#include <algorithm>                    /* for max(), min() */
+#include <atomic>
+#include <iostream>
+#include <ostream>
+#include <sstream>
+#include <string>
+#ifdef MULTI_THREADED
+#include <thread>
+#endif /* MULTI_THREADED */
+#include <utility>                      /* for move() */
+#include <vector>
+
+using namespace PJL;
+using namespace std;
+
+/**
+ * The maximum number of queries read (and evaluated concurrently) before their
+ * results are written.  This bounds the amount of memory used to hold results
+ * while preserving their input order.
+ */
+static size_t const Batch_Block_Size = 256;
+
+/**
+ * The line written after the results of every query.
+ */
+static char const Batch_Separator[] = "# end\n";
+
+// local functions
+static void batch_query( string const&, ostream& );
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Reads queries, one per line, and writes their results in the same order,
+ * each followed by a separator line.  Each line may contain per-request
+ * options exactly like a request sent to the search daemon.
+ *
+ * @param threads The number of threads to evaluate queries across; if 0, one
+ * per available CPU.  If \c search was built without threads, this is ignored.
+ * @param in The istream to read queries from.
+ * @param out The ostream to write results to.
+ */
+void search_batch( unsigned threads, istream &in, ostream &out ) {
+#ifdef MULTI_THREADED
+  if ( !threads )
+    threads = max( thread::hardware_concurrency(), 1u );
+#else
+  threads = 1;
+#endif /* MULTI_THREADED */
+
+  vector<string> queries, results;
+  queries.reserve( Batch_Block_Size );
+
+  for ( ;; ) {
+    queries.clear();
+    for ( string line;
+          queries.size() < Batch_Block_Size && getline( in, line ); ) {
+      queries.push_back( std::move( line ) );
+    } // for
+    if ( queries.empty() )
+      break;
+
+    results.assign( queries.size(), string() );
+    atomic<size_t> next_query{ 0 };
+    auto const evaluate = [&]() {
+      for ( size_t i; (i = next_query++) < queries.size(); ) {
+        ostringstream query_out;
+        batch_query( queries[i], query_out );
+        results[i] = query_out.str();
+      } // for
+    };
+
+#ifdef MULTI_THREADED
+    vector<thread> helpers;
+    size_t const n_helpers = min<size_t>( threads, queries.size() ) - 1;
+    helpers.reserve( n_helpers );
+    for ( size_t i = 0; i < n_helpers; ++i )
+      helpers.emplace_back( evaluate );
+    evaluate();
+    for ( auto &helper : helpers )
+      helper.join();
+#else
+    evaluate();
+#endif /* MULTI_THREADED */
+
+    for ( auto const &result : results ) {
+      out << result << Batch_Separator;
+      if ( !out )
+        return;
+    } // for
+    out << flush;
+  } // for
+}
+
+////////// local functions ////////////////////////////////////////////////////
+
+/**
+ * Parses the options of a single batch query, performs the search, and writes
+ * the results (or any errors).
+ *
+ * @param line The line containing the options and query.
+ * @param out The ostream to write the results and errors to.
+ */
+static void batch_query( string const &line, ostream &out ) {
+#define SEARCH_DAEMON_OPTIONS_ONLY
+#include "search_options.cpp"           /* defines OPT_SPEC */
+
+  vector<char> buf( line.begin(), line.end() );
+  buf.push_back( '\0' );
+
+  char* argv_vec[ ARG_MAX ];
+  char** argv = argv_vec;
+  argv[0] = const_cast<char*>( me );
+  int argc = split_args( buf.data(), argv + 1, ARG_MAX - 1 );
+
+  if ( !argc )                          // blank line: no results
+    return;
+  if ( argc == ARG_MAX - 1 ) {
+    out << error << "more than " << ARG_MAX << " arguments" << endl;
+    return;
+  }
+  ++argc;                               // for argv[0]
+  search_options const opt( &argc, &argv, OPT_SPEC, out );
+  if ( opt )
+    service_request( argv, opt, out, out );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/* vim:set et sw=2 ts=2: */
@@ -31,6 +31,10 @@
 #include "SearchBackground.h"
 #include "SearchDaemon.h"
 #include "search_thread.h"
+#include "SlowQueryLog.h"
+#include "SlowQuerySample.h"
+#include "SlowQueryTime.h"
+#include "slow_query_log.h"
 #include "SocketAddress.h"
 #include "SocketFile.h"
 #include "SocketQueueSize.h"
@@ -294,7 +298,23 @@ void become_daemon() {
     }
     pid_file << ::getpid() << endl;
   }
+#endif /* DEBUG_threads */
+
+  //
+  // If requested, start logging slow queries.  This must be done after
+  // detaching since the log is written by a thread and threads don't survive
+  // fork(2), but before changing user since the log may be writable only by
+  // root.
+  //
+  if ( slow_query_log_name && *slow_query_log_name &&
+       !slow_query_log::start(
+          slow_query_log_name, slow_query_time, slow_query_sample
+       ) ) {
+    error() << '"' << slow_query_log_name << "\": " << error_string;
+    ::exit( Exit_No_Write_Slow_Log );
+  }
 
+#ifndef DEBUG_threads
 #ifdef __APPLE__
   if ( !launchd_cooperation ) {
 #endif /* __APPLE__ */
@@ -0,0 +1,65 @@
+/*
+**      SWISH++
+**      src/search_index.cpp
+**
+**      Copyright (C) 2026  Paul J. Lucas
+**
+**      This program is free software; you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation; either version 2 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program; if not, write to the Free Software
+**      Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+// local
+#include "config.h"
+#include "search_index.h"
+#include "file_list.h"
+#include "pjl/mmap_file.h"
+
+using namespace PJL;
+
+///////////////////////////////////////////////////////////////////////////////
+
+#ifdef WITH_WORD_POS
+bool search_index::has_word_pos_data() const {
+  //
+  // A simple way to check that the index has word-position data stored is to
+  // get the file_list for the first word in the index then look to see if
+  // pos_delta_ is empty: if it is, no word-position data was stored.
+  //
+  file_list const list{ words.begin() };
+  auto const file{ list.begin() };
+  return !file->pos_deltas_.empty();
+}
+#endif /* WITH_WORD_POS */
+
+bool search_index::open( char const *path ) {
+  path_ = path;
+  if ( !file_.open( path ) )
+    return false;
+  file_.behavior( mmap_file::bt_random );
+
+  words      .set_index_file( file_, index_segment::isi_word      );
+  stop_words .set_index_file( file_, index_segment::isi_stop_word );
+  directories.set_index_file( file_, index_segment::isi_dir       );
+  files      .set_index_file( file_, index_segment::isi_file      );
+  meta_names .set_index_file( file_, index_segment::isi_meta_name );
+
+  stop_word_set_ = flat_string_set{};
+  stop_word_set_.reserve( stop_words.size() );
+  for ( auto const &stop_word : stop_words )
+    stop_word_set_.insert( stop_word );
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/* vim:set et sw=2 ts=2: */
@@ -0,0 +1,146 @@
+/*
+**      SWISH++
+**      src/search_index.h
+**
+**      Copyright (C) 2026  Paul J. Lucas
+**
+**      This program is free software; you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation; either version 2 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program; if not, write to the Free Software
+**      Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#ifndef search_index_H
+#define search_index_H
+
+// local
+#include "config.h"
+#include "index_segment.h"
+#include "pjl/flat_string_set.h"
+#include "pjl/mmap_file.h"
+
+// standard
+#include <string>
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A %search_index is an index file mapped into memory along with the
+ * index_segment objects used to access its portions.  A %search_index is
+ * read-only once opened, so it may be searched by any number of threads
+ * concurrently.
+ */
+class search_index {
+public:
+  search_index() { }
+
+  /**
+   * Constructs a %search_index and opens it.
+   *
+   * @param path The full path of the index file to open.
+   */
+  explicit search_index( char const *path ) {
+    open( path );
+  }
+
+  search_index( search_index const& ) = delete;
+  search_index& operator=( search_index const& ) = delete;
+
+  /**
+   * Opens an index file by mapping it into memory.
+   *
+   * @param path The full path of the index file to open.
+   * @return Returns \c true only if the index file was opened successfully.
+   */
+  bool open( char const *path );
+
+  /**
+   * Gets whether this %search_index was opened successfully.
+   *
+   * @return Returns \c true only if it was.
+   */
+  explicit operator bool() const {
+    return static_cast<bool>( file_ );
+  }
+
+  /**
+   * Gets the error (if any) that occurred while opening the index file.
+   *
+   * @return Returns said error (an \c errno value).
+   */
+  int error() const {
+    return file_.error();
+  }
+
+#ifdef WITH_WORD_POS
+  /**
+   * Gets whether this index contains word-position data needed to evaluate
+   * "near" queries.
+   *
+   * @return Returns \c true only if it does.
+   */
+  bool has_word_pos_data() const;
+#endif /* WITH_WORD_POS */
+
+  /**
+   * Gets the number of files a word's file count is compared against to check
+   * whether the word is too frequent.  For a shard (or segment) of a larger
+   * index, this is the number of files in the entire index.
+   *
+   * @return Returns said number.
+   */
+  size_t num_frequency_files() const {
+    return num_frequency_files_ ? num_frequency_files_ : files.size();
+  }
+
+  /**
+   * Sets the number of files a word's file count is compared against.
+   *
+   * @param n The number of files.
+   */
+  void num_frequency_files( size_t n ) {
+    num_frequency_files_ = n;
+  }
+
+  /**
+   * Gets whether a word is a stop word.  This is faster than searching
+   * \c stop_words.
+   *
+   * @param word The null-terminated, lower-case word to check.
+   * @return Returns \c true only if it is.
+   */
+  bool is_stop_word( char const *word ) const {
+    return stop_word_set_.contains( word );
+  }
+
+  /**
+   * Gets the path of the index file.
+   *
+   * @return Returns said path.
+   */
+  char const* path() const {
+    return path_.c_str();
+  }
+
+  index_segment directories, files, meta_names, stop_words, words;
+
+private:
+  PJL::mmap_file        file_;
+  size_t                num_frequency_files_ = 0;
+  std::string           path_;
+  PJL::flat_string_set  stop_word_set_;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif /* search_index_H */
+/* vim:set et sw=2 ts=2: */
@@ -31,8 +31,10 @@ static option_stream::spec const OPT_SPEC[] = {
   { "help",           0, '?', option_stream::arg_lone, "" },
   { "dump-words",     0, 'd', "", "" },
   { "dump-index",     0, 'D', "", "" },
+  { "explain",        0, 'e', "", "" },
   { "word-files",     1, 'f', "", "" },
   { "format",         1, 'F', "", "" },
+  { "index-file",     1, 'i', "", "" },
   { "max-results",    1, 'm', "", "" },
   { "dump-meta",      0, 'M', "", "" },
 #ifdef WITH_WORD_POS
@@ -51,7 +53,7 @@ static option_stream::spec const OPT_SPEC[] = {
   // options.
   //
   { "config-file",    1, 'c', "", "" },
-  { "index-file",     1, 'i', "", "" },
+  { "batch",          2, 'j', "", "" },
 #ifdef WITH_SEARCH_DAEMON
   { "daemon-type",    1, 'b', "", "" },
 #ifdef __APPLE__
@@ -63,6 +65,9 @@ static option_stream::spec const OPT_SPEC[] = {
   { "socket-timeout", 1, 'o', "", "" },
   { "thread-timeout", 1, 'O', "", "" },
   { "queue-size",     1, 'q', "", "" },
+  { "slow-query-log", 1, 'l', "", "" },
+  { "slow-query-sample", 1, 'Q', "", "" },
+  { "slow-query-time", 1, 'L', "", "" },
   { "min-threads",    1, 't', "", "" },
   { "max-threads",    1, 'T', "", "" },
   { "socket-address", 1, 'a', "", "" },
@@ -23,43 +23,26 @@
 #include "config.h"
 #include "search_thread.h"
 #include "pjl/fdbuf.h"
+#include "pjl/stopwatch.h"
 #include "pjl/thread_pool.h"
+#include "query.h"
 #include "search.h"
+#include "slow_query_log.h"
 #include "util.h"
 
 // standard
 #include <cctype>
-#include <climits>                      /* for ARG_MAX */
 #include <cstring>
+#include <ctime>
 #include <iostream>
 #include <ostream>
+#include <string>
 #include <sys/select.h>
 #include <sys/socket.h>                 /* for recv(3) */
 #include <time.h>
 #include <sys/time.h>
 #include <unistd.h>                     /* for close(2) */
-
-/**
- * We need to know the maximum number of command-line arguments so we can split
- * a command-line string into individual arguments.  If the OS defines the
- * POSIX.1 ARG_MAX macro, see if it's insanely large (Solaris's limit is over a
- * million!) because we don't want to allocate that much space for argument
- * pointers since it would probably blow our thread stack space; however, if
- * it's small, we might as well use that number since there's no reason to
- * exceed it.
- *
- * @sa W. Richard Stevens.  "Advanced Programming in the Unix Environment,"
- * Addison-Wesley, Reading, MA, 1993.  pp. 32-40.
- */
-#define REASONABLE_ARG_MAX 50
-#ifdef ARG_MAX
-# if ARG_MAX > REASONABLE_ARG_MAX
-#   undef ARG_MAX
-# endif
-#endif /* ARG_MAX */
-#ifndef ARG_MAX
-# define ARG_MAX REASONABLE_ARG_MAX
-#endif /* ARG_MAX */
+#include <utility>                      /* for move() */
 
 using namespace PJL;
 using namespace std;
@@ -69,8 +52,12 @@ unsigned search_thread::socket_timeout;
 extern void reset_socket( int fd );
 
 // local functions
-static int  split_args( char *s, char *argv[], int arg_max );
-static bool timed_read_line( int fd, char *buf, int buf_size, int seconds );
+static std::string  join_args( char *const *begin, char *const *end );
+static void         log_if_slow( unsigned long, query_stats const&, bool,
+                                 std::string const&, char *const*,
+                                 char *const* );
+static bool         timed_read_line( int fd, char *buf, int buf_size,
+                                     int seconds );
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -100,11 +87,18 @@ void search_thread::main( argument_type arg ) {
     cerr << "query=" << buf << "\n";
 #   endif
 
-    char*   argv_vec[ ARG_MAX ];
-    char**  argv = argv_vec;
-    int     argc = split_args( buf, argv, ARG_MAX );
-    fdbuf   buf( arg.i );
-    ostream out( &buf );
+    stopwatch   timer;
+    //
+    // If the request is malformed, the slow-query log gets it verbatim since
+    // split_args() modifies it.
+    //
+    string const request{ slow_query_log::is_started() ? buf : "" };
+    char*       argv_vec[ ARG_MAX ];
+    char**      argv = argv_vec;
+    int         argc = split_args( buf, argv, ARG_MAX );
+    fdbuf       buf( arg.i );
+    ostream     out( &buf );
+    query_stats stats;
 
     if ( !argc ) {
       out << usage;
@@ -113,9 +107,12 @@ void search_thread::main( argument_type arg ) {
     } else {
       search_options const opt( &argc, &argv, OPT_SPEC, out );
       if ( opt )
-        ok = service_request( argv, opt, out, out );
+        ok = service_request( argv, opt, out, out, &stats );
     }
     out << flush;
+
+    if ( slow_query_log::is_started() )
+      log_if_slow( timer.elapsed_usec(), stats, ok, request, argv_vec, argv );
   }
 
   if ( !ok ) {
@@ -136,48 +133,55 @@ void search_thread::main( argument_type arg ) {
 }
 
 /**
- * Splits a string into individual, argv-like arguments at whitespace.
- *
- * @remarks
- * @parblock
- * This code is based on \c buf_args() in [Stevens 1993], p. 495, except that
- * it:
- *
- *    1. Is thread-safe by not using \c strtok().
- *    2. Discards leading whitespace in the buffer.
- *    3. Just does the split and doesn't call any function.
- * @endparblock
+ * Joins a range of arguments back together separated by spaces.
  *
- * @sa W. Richard Stevens.  "Advanced Programming in the Unix Environment,"
- * Addison-Wesley, Reading, MA, 1993.  p. 495.
+ * @param begin A pointer to the first argument.
+ * @param end A pointer to one past the last argument or null to join all the
+ * arguments up to the terminating null pointer.
+ * @return Returns the joined arguments.
+ */
+static string join_args( char *const *begin, char *const *end ) {
+  string s;
+  for ( ; begin != end && *begin; ++begin ) {
+    if ( !s.empty() )
+      s += ' ';
+    s += *begin;
+  } // for
+  return s;
+}
+
+/**
+ * If a request was slow, queues it to be written to the slow-query log.
  *
- * @param s The string to be split.
- * @param argv The array to deposit the pointers to arguments in.
- * @param arg_max The maximum number of argument to allow.
- * @return Upon success, returns the number of arguments; upon failure, returns
- * arg_max.
+ * @param usec The number of microseconds the request took to service.
+ * @param stats The statistics gathered while servicing the request.
+ * @param ok If \c false, the request was malformed.
+ * @param request The entire request as read.
+ * @param args A pointer to the first argument of the request (the command
+ * name).  It's used only if \a ok.
+ * @param query_args A pointer to the first non-option argument.  It's used
+ * only if \a ok.
  */
-static int split_args( char *s, char *argv[], int arg_max ) {
-  for ( ; *s && isspace( *s ); ++s )    // skip leading whitespace
-    ;
-  if ( !*s )
-    return 0;
-
-  int argc = 0;
-
-  while ( (argv[ argc++ ] = s) ) {
-    if ( argc >= arg_max - 1 )          // -1 to allow for null at end
-      return arg_max;
-    if ( (s = ::strpbrk( s, " \t\n\r" )) ) {
-      *s = '\0';
-      //
-      // We must skip *ALL* whitespace characters separating arguments.
-      //
-      while ( *++s && isspace( *s ) )
-        ;
-    }
-  } // while
-  return argc;
+static void log_if_slow( unsigned long usec, query_stats const &stats,
+                         bool ok, string const &request, char *const *args,
+                         char *const *query_args ) {
+  if ( !slow_query_log::should_log( usec ) )
+    return;
+  slow_query_log::entry e;
+  e.time = ::time( nullptr );
+  e.ok = ok;
+  e.total_usec = usec;
+  e.stats = stats;
+  if ( ok ) {
+    e.options = join_args( args + 1, query_args );
+    e.query = join_args( query_args, nullptr );
+  } else {
+    //
+    // The options may not have been parsed, so log the request as a whole.
+    //
+    e.query = request;
+  }
+  slow_query_log::log( std::move( e ) );
 }
 
 /**
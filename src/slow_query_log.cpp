@@ -0,0 +1,221 @@
+/*
+**      SWISH++
+**      src/slow_query_log.cpp
+**
+**      Copyright (C) 2026  Paul J. Lucas
+**
+**      This program is free software; you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation; either version 2 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program; if not, write to the Free Software
+**      Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+// local
+#include "config.h"
+#include "slow_query_log.h"
+#include "query.h"
+
+// standard
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>                      /* for size_t */
+#include <cstdlib>                      /* for atexit(3) */
+#include <ctime>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <utility>                      /* for move() */
+
+using namespace std;
+
+/**
+ * The maximum number of entries that may be queued before new entries are
+ * dropped.  This bounds memory use should the log file's device be slow.
+ */
+static size_t const   Queue_Max = 1000;
+
+bool slow_query_log::started_;
+
+static condition_variable           log_cond;
+static unsigned long                log_dropped;
+static ofstream                     log_file;
+static mutex                        log_mutex;
+static deque<slow_query_log::entry> log_queue;
+static unsigned long                log_threshold_usec;
+static unsigned                     log_sample_percent;
+static bool                         log_stopping;
+static thread                       log_writer;
+static atomic<unsigned long>        slow_count;
+
+////////// local functions ////////////////////////////////////////////////////
+
+/**
+ * Writes a number of microseconds as milliseconds to an ostream.
+ *
+ * @param o The ostream to write to.
+ * @param usec The number of microseconds.
+ * @return Returns \a o.
+ */
+static ostream& write_msec( ostream &o, unsigned long usec ) {
+  return o << usec / 1000 << '.' << setfill( '0' ) << setw( 3 ) << usec % 1000
+           << setfill( ' ' );
+}
+
+/**
+ * Writes a string to an ostream escaping backslashes, double quotes, and
+ * control characters so that it can be written between double quotes and
+ * never span lines.
+ *
+ * @param o The ostream to write to.
+ * @param s The string to write.
+ * @return Returns \a o.
+ */
+static ostream& write_escaped( ostream &o, string const &s ) {
+  static char const Hex_Digit[] = "0123456789ABCDEF";
+  for ( char const c : s ) {
+    switch ( c ) {
+      case '"' : o << "\\\""; break;
+      case '\\': o << "\\\\"; break;
+      case '\n': o << "\\n";  break;
+      case '\r': o << "\\r";  break;
+      case '\t': o << "\\t";  break;
+      default:
+        if ( static_cast<unsigned char>( c ) < ' ' || c == '\x7F' )
+          o << "\\x" << Hex_Digit[ (c >> 4) & 0xF ] << Hex_Digit[ c & 0xF ];
+        else
+          o << c;
+    } // switch
+  } // for
+  return o;
+}
+
+/**
+ * Writes an entry to the log file as a single line.
+ *
+ * @param o The ostream to write to.
+ * @param e The entry to write.
+ */
+static void write_entry( ostream &o, slow_query_log::entry const &e ) {
+  char time_buf[ 32 ];
+  struct tm tm_buf;
+  ::strftime(
+    time_buf, sizeof time_buf, "%Y-%m-%d %H:%M:%S",
+    ::localtime_r( &e.time, &tm_buf )
+  );
+  o << time_buf << " total=";
+  write_msec( o, e.total_usec );
+  o << " parse=";
+  write_msec( o, e.stats.parse_usec );
+  o << " eval=";
+  write_msec( o, e.stats.eval_usec );
+  o << " sort=";
+  write_msec( o, e.stats.sort_usec );
+  o << " output=";
+  write_msec( o, e.stats.output_usec );
+  o << " postings=" << e.stats.postings_decoded
+    << " bytes=" << e.stats.bytes_touched
+    << " results=" << e.stats.num_results
+    << " status=" << (e.ok ? "ok" : "error")
+    << " options=\"";
+  write_escaped( o, e.options ) << "\" query=\"";
+  write_escaped( o, e.query ) << "\"\n";
+}
+
+/**
+ * The main function of the background thread: waits for entries to be queued
+ * and writes them to the log file until stopped.
+ */
+static void log_writer_main() {
+  deque<slow_query_log::entry> entries;
+  for ( bool stopping = false; !stopping; ) {
+    unsigned long dropped;
+    {
+      unique_lock<mutex> lock( log_mutex );
+      log_cond.wait( lock, []{
+        return !log_queue.empty() || log_dropped || log_stopping;
+      } );
+      entries.swap( log_queue );
+      dropped = log_dropped;
+      log_dropped = 0;
+      stopping = log_stopping;
+    }
+    //
+    // The lock is not held while writing so that threads servicing requests
+    // can continue to queue entries.
+    //
+    for ( auto const &e : entries )
+      write_entry( log_file, e );
+    if ( dropped )
+      log_file << "# " << dropped << " entries dropped\n";
+    log_file.flush();
+    entries.clear();
+  } // for
+}
+
+////////// member functions ///////////////////////////////////////////////////
+
+void slow_query_log::log( entry &&e ) {
+  {
+    lock_guard<mutex> const lock( log_mutex );
+    if ( log_stopping )
+      return;
+    if ( log_queue.size() >= Queue_Max ) {
+      ++log_dropped;
+      return;
+    }
+    log_queue.push_back( std::move( e ) );
+  }
+  log_cond.notify_one();
+}
+
+bool slow_query_log::should_log( unsigned long usec ) {
+  if ( !started_ || usec < log_threshold_usec )
+    return false;
+  //
+  // Rather than choose randomly, log exactly sample_percent of every 100 slow
+  // requests spread evenly.
+  //
+  unsigned long const n = slow_count++;
+  return (n + 1) * log_sample_percent / 100 != n * log_sample_percent / 100;
+}
+
+bool slow_query_log::start( char const *file_name, unsigned threshold_msec,
+                            unsigned sample_percent ) {
+  log_file.open( file_name, ios::out | ios::app );
+  if ( !log_file )
+    return false;
+  log_threshold_usec = threshold_msec * 1000ul;
+  log_sample_percent = sample_percent;
+  log_writer = thread( log_writer_main );
+  //
+  // Registered after the file-scope objects above were constructed, stop()
+  // is called before they're destroyed.
+  //
+  ::atexit( &stop );
+  return started_ = true;
+}
+
+void slow_query_log::stop() {
+  {
+    lock_guard<mutex> const lock( log_mutex );
+    log_stopping = true;
+  }
+  log_cond.notify_one();
+  log_writer.join();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/* vim:set et sw=2 ts=2: */
@@ -0,0 +1,111 @@
+/*
+**      SWISH++
+**      src/slow_query_log.h
+**
+**      Copyright (C) 2026  Paul J. Lucas
+**
+**      This program is free software; you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation; either version 2 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program; if not, write to the Free Software
+**      Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#ifndef slow_query_log_H
+#define slow_query_log_H
+
+// local
+#include "config.h"
+#include "query.h"
+
+// standard
+#include <ctime>
+#include <string>
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A %slow_query_log logs search daemon requests that take longer than a given
+ * threshold to service.  Entries are queued by the threads servicing requests
+ * and written to the log file by a single background thread so that logging
+ * never blocks a request on file I/O.
+ */
+class slow_query_log {
+public:
+  /**
+   * An %entry is a single slow request to be logged.
+   */
+  struct entry {
+    std::time_t   time;                 // when the request was serviced
+    bool          ok;                   // was the request well-formed?
+    unsigned long total_usec;           // total time to service the request
+    query_stats   stats;                // per-phase statistics
+    std::string   options;              // the request's options, if any
+    std::string   query;                // the request's query (or all of it)
+  };
+
+  /**
+   * Opens the log file and starts the background thread that writes to it.
+   * This must be called after the daemon has forked, if it does.  The thread
+   * is stopped (after writing any queued entries) and joined at exit.
+   *
+   * @param file_name The name of the log file to append to.
+   * @param threshold_msec The number of milliseconds a request must take to
+   * be considered slow.
+   * @param sample_percent The percentage of slow requests to log.
+   * @return Returns \c true only if the log file was opened.
+   */
+  static bool start( char const *file_name, unsigned threshold_msec,
+                     unsigned sample_percent );
+
+  /**
+   * Gets whether the slow-query log has been started.
+   *
+   * @return Returns \c true only if it has.
+   */
+  static bool is_started() {
+    return started_;
+  }
+
+  /**
+   * Checks whether a request that took the given amount of time to service
+   * should be logged.  Only the sampled percentage of slow requests are.
+   *
+   * @param usec The number of microseconds the request took.
+   * @return Returns \c true only if the request should be logged.
+   */
+  static bool should_log( unsigned long usec );
+
+  /**
+   * Queues an entry to be written to the log by the background thread.  If
+   * the queue is full, the entry is dropped (and counted) rather than block
+   * the calling thread.
+   *
+   * @param e The entry to log.
+   */
+  static void log( entry &&e );
+
+private:
+  static bool started_;
+
+  /**
+   * Writes any queued entries, stops the background thread, and joins it.
+   * This is called via \c atexit(3).
+   */
+  static void stop();
+
+  slow_query_log() = delete;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif /* slow_query_log_H */
+/* vim:set et sw=2 ts=2: */
@@ -26,13 +26,16 @@
 #include "index_segment.h"
 #include "iso8859-1.h"
 #include "pjl/mmap_file.h"
+#include "pjl/perfect_hash.h"
 #include "swishxx-config.h"
 #include "util.h"
 #include "word_util.h"
 
 // standard
+#include <algorithm>                    /* for sort() */
 #include <cctype>
 #include <cstdlib>                      /* for exit(3) */
+#include <cstring>                      /* for strcmp(3) */
 #include <ostream>
 
 using namespace PJL;
@@ -44,332 +47,335 @@ stop_word_set      *stop_words;         // pointer to global set
 
 ///////////////////////////////////////////////////////////////////////////////
 
-stop_word_set::stop_word_set( char const *file_name ) {
-  static char const *const default_stop_word_table[] = {
-
-    // A
-
-    "about",
-    "above",
-    "according",
-    "across",
-    "actually",
-    "adj",
-    "after", "afterwards",
-    "again", "against",
-    "all",
-    "almost",
-    "alone",
-    "along",
-    "already",
-    "alright", "allright",              // not real words, but common
-    "also",
-    "although",
-    "always",
-    "among", "amongst",
-    "and",
-    "another",
-    "any", "anyhow", "anyone", "anything", "anyway", "anywhere",
-    "are", "aren", "aren't",
-    "around",
-
-    // B
-
-    "bad",
-    "became",
-    "because",
-    "become", "becomes", "becoming",
-    "been",
-    "before", "beforehand",
-    "began",
-    "begin", "beginning", "begins",
-    "behind",
-    "being",
-    "below",
-    "beside", "besides",
-    "best",
-    "better",
-    "between",
-    "beyond",
-    "billion", "billions",
-    "both",
-    "but",
-
-    // C
-
-    "came",
-    "can", "can't", "cannot",
-    "caption", "captions",
-    "come", "comes", "coming",
-    "could", "couldn", "couldn't",
-
-    // D
-
-    "did", "didn", "didn't",
-    "does", "doesn", "doesn't",
-    "don", "don't",
-    "down",
-    "during",
-
-    // E
-
-    "each",
-    "eight", "eighteen", "eighty",
-    "either",
-    "else", "elsewhere",
-    "end", "ended", "ending", "ends",
-    "enough",
-    "etc",
-    "even",
-    "ever", "every", "everyone", "everything", "everywhere",
-    "except",
-
-    // F
-
-    "far", "farther",
-    "few", "fewer",
-    "fifteen", "fifty",
-    "first", "firstly",
-    "five",
-    "for",
-    "former", "formerly",
-    "forty",
-    "found",
-    "four", "fourteen", "fourty",
-    "from",
-    "further",
-
-    // G
-
-    "good",
-    "great", "greater", "greatest",
-
-    // H
-
-    "had",
-    "half",
-    "has", "hasn", "hasn't",
-    "have", "haven", "haven't", "having",
-    "hence",
-    "her",
-    "here", "hereafter", "hereby", "herein", "hereupon",
-    "hers", "herself",
-    "him", "himself",
-    "his",
-    "how",
-    "however",
-    "hundred", "hundreds",
-
-    // I
-
-    "i.e.",
-    "inc",
-    "indeed",
-    "instead",
-    "into",
-    "isn", "isn't",
-    "its",
-    "itself",
-
-    // J
-
-    "just",
-
-    // L
-
-    "last",
-    "later",
-    "latter",
-    "least",
-    "less", "lesser",
-    "let", "lets", "let's", "letting",
-    "like", "liked", "likes",
-    "likely",
-    "likewise",
-    "ltd",
-
-    // M
-
-    "made",
-    "make", "makes", "making",
-    "many",
-    "may",
-    "maybe",
-    "meantime",
-    "meanwhile",
-    "might",
-    "million", "millions",
-    "miss",
-    "more",
-    "moreover",
-    "most", "mostly",
-    "mrs",
-    "much",
-    "must", "mustn't",
-    "my",
-    "myself",
-
-    // N
-
-    "namely",
-    "neither",
-    "never", "nevertheless",
-    "next",
-    "nine", "nineteen", "ninety",
-    "nobody",
-    "none",
-    "nonetheless",
-    "noone",
-    "nor",
-    "not",
-    "nothing",
-    "now",
-    "nowhere",
-
-    // O
-
-    "off",
-    "often",
-    "once",
-    "one",
-    "only",
-    "onto",
-    "other", "others", "otherwise",
-    "our", "ours", "ourselves",
-    "out",
-    "over",
-    "overall",
-    "own",
-
-    // P
-
-    "per",
-    "perhaps",
-
-    // R
-
-    "rather",
-    "really",
-    "recent", "recently",
-
-    // S
-
-    "same",
-    "saw",
-    "second", "seconds",
-    "see", "seen",
-    "seem", "seemed", "seeming", "seems",
-    "seven", "seventeen", "seventy",
-    "several",
-    "shall",
-    "she",
-    "should", "shouldn", "shouldn't",
-    "since",
-    "six", "sixteen", "sixty",
-    "some", "somehow", "someone", "something",
-    "sometime", "sometimes",
-    "somewhere",
-    "still",
-    "stop",
-    "such",
-
-    // T
-
-    "take", "taken", "taking",
-    "ten", "tens",
-    "than",
-    "that",
-    "the",
-    "their",
-    "them", "themselves",
-    "then",
-    "thence",
-    "there", "thereafter", "thereby", "therefore",
-    "therein", "thereupon",
-    "these",
-    "they",
-    "third", "thirteen", "thirty",
-    "this",
-    "thorough",
-    "those",
-    "though",
-    "thousand", "thousands",
-    "three",
-    "through", "throughout",
-    "thru",
-    "thus", "thusly",
-    "together",
-    "too",
-    "took",
-    "toward", "towards",
-    "trillion", "trillions",
-    "twelve",
-    "twenty",
-    "two",
-
-    // U
-
-    "under",
-    "unless",
-    "unlike", "unlikely",
-    "until",
-    "upon",
-    "us",
-    "use", "used", "uses", "using",
-    "usual", "usually",
-
-    // V
-
-    "varied", "various", "vary",
-    "very",
-    "via",
-
-    // W
-
-    "want",
-    "was", "wasn", "wasn't",
-    "way",
-    "well",
-    "were", "weren", "weren't",
-    "what", "whatever",
-    "when", "whence", "whenever",
-    "where", "whereafter", "whereas", "whereby",
-    "wherein", "whereupon", "wherever",
-    "whether",
-    "which",
-    "while",
-    "whither",
-    "who", "whoever",
-    "whole",
-    "whom", "whomever",
-    "whose",
-    "why",
-    "will",
-    "with", "within", "without",
-    "won",
-    "won't",
-    "worse",
-    "would", "wouldn", "wouldn't",
-
-    // Y
-
-    "yes",
-    "yet",
-    "you", "you'll", "your", "you're", "yours",
-    "yourself", "yourselves",
-
-    // Z
-
-    "zero",
-
-    nullptr
-  };
-
-  if ( !file_name || !*file_name ) {    // no file: use default
-    for ( auto w = default_stop_word_table; *w; ++w )
-      insert( *w );
+static constexpr char const *const default_stop_word_table[] = {
+
+  // A
+
+  "about",
+  "above",
+  "according",
+  "across",
+  "actually",
+  "adj",
+  "after", "afterwards",
+  "again", "against",
+  "all",
+  "almost",
+  "alone",
+  "along",
+  "already",
+  "alright", "allright",              // not real words, but common
+  "also",
+  "although",
+  "always",
+  "among", "amongst",
+  "and",
+  "another",
+  "any", "anyhow", "anyone", "anything", "anyway", "anywhere",
+  "are", "aren", "aren't",
+  "around",
+
+  // B
+
+  "bad",
+  "became",
+  "because",
+  "become", "becomes", "becoming",
+  "been",
+  "before", "beforehand",
+  "began",
+  "begin", "beginning", "begins",
+  "behind",
+  "being",
+  "below",
+  "beside", "besides",
+  "best",
+  "better",
+  "between",
+  "beyond",
+  "billion", "billions",
+  "both",
+  "but",
+
+  // C
+
+  "came",
+  "can", "can't", "cannot",
+  "caption", "captions",
+  "come", "comes", "coming",
+  "could", "couldn", "couldn't",
+
+  // D
+
+  "did", "didn", "didn't",
+  "does", "doesn", "doesn't",
+  "don", "don't",
+  "down",
+  "during",
+
+  // E
+
+  "each",
+  "eight", "eighteen", "eighty",
+  "either",
+  "else", "elsewhere",
+  "end", "ended", "ending", "ends",
+  "enough",
+  "etc",
+  "even",
+  "ever", "every", "everyone", "everything", "everywhere",
+  "except",
+
+  // F
+
+  "far", "farther",
+  "few", "fewer",
+  "fifteen", "fifty",
+  "first", "firstly",
+  "five",
+  "for",
+  "former", "formerly",
+  "forty",
+  "found",
+  "four", "fourteen", "fourty",
+  "from",
+  "further",
+
+  // G
+
+  "good",
+  "great", "greater", "greatest",
+
+  // H
+
+  "had",
+  "half",
+  "has", "hasn", "hasn't",
+  "have", "haven", "haven't", "having",
+  "hence",
+  "her",
+  "here", "hereafter", "hereby", "herein", "hereupon",
+  "hers", "herself",
+  "him", "himself",
+  "his",
+  "how",
+  "however",
+  "hundred", "hundreds",
+
+  // I
+
+  "i.e.",
+  "inc",
+  "indeed",
+  "instead",
+  "into",
+  "isn", "isn't",
+  "its",
+  "itself",
+
+  // J
+
+  "just",
+
+  // L
+
+  "last",
+  "later",
+  "latter",
+  "least",
+  "less", "lesser",
+  "let", "lets", "let's", "letting",
+  "like", "liked", "likes",
+  "likely",
+  "likewise",
+  "ltd",
+
+  // M
+
+  "made",
+  "make", "makes", "making",
+  "many",
+  "may",
+  "maybe",
+  "meantime",
+  "meanwhile",
+  "might",
+  "million", "millions",
+  "miss",
+  "more",
+  "moreover",
+  "most", "mostly",
+  "mrs",
+  "much",
+  "must", "mustn't",
+  "my",
+  "myself",
+
+  // N
+
+  "namely",
+  "neither",
+  "never", "nevertheless",
+  "next",
+  "nine", "nineteen", "ninety",
+  "nobody",
+  "none",
+  "nonetheless",
+  "noone",
+  "nor",
+  "not",
+  "nothing",
+  "now",
+  "nowhere",
+
+  // O
+
+  "off",
+  "often",
+  "once",
+  "one",
+  "only",
+  "onto",
+  "other", "others", "otherwise",
+  "our", "ours", "ourselves",
+  "out",
+  "over",
+  "overall",
+  "own",
+
+  // P
+
+  "per",
+  "perhaps",
+
+  // R
+
+  "rather",
+  "really",
+  "recent", "recently",
+
+  // S
+
+  "same",
+  "saw",
+  "second", "seconds",
+  "see", "seen",
+  "seem", "seemed", "seeming", "seems",
+  "seven", "seventeen", "seventy",
+  "several",
+  "shall",
+  "she",
+  "should", "shouldn", "shouldn't",
+  "since",
+  "six", "sixteen", "sixty",
+  "some", "somehow", "someone", "something",
+  "sometime", "sometimes",
+  "somewhere",
+  "still",
+  "stop",
+  "such",
+
+  // T
+
+  "take", "taken", "taking",
+  "ten", "tens",
+  "than",
+  "that",
+  "the",
+  "their",
+  "them", "themselves",
+  "then",
+  "thence",
+  "there", "thereafter", "thereby", "therefore",
+  "therein", "thereupon",
+  "these",
+  "they",
+  "third", "thirteen", "thirty",
+  "this",
+  "thorough",
+  "those",
+  "though",
+  "thousand", "thousands",
+  "three",
+  "through", "throughout",
+  "thru",
+  "thus", "thusly",
+  "together",
+  "too",
+  "took",
+  "toward", "towards",
+  "trillion", "trillions",
+  "twelve",
+  "twenty",
+  "two",
+
+  // U
+
+  "under",
+  "unless",
+  "unlike", "unlikely",
+  "until",
+  "upon",
+  "us",
+  "use", "used", "uses", "using",
+  "usual", "usually",
+
+  // V
+
+  "varied", "various", "vary",
+  "very",
+  "via",
+
+  // W
+
+  "want",
+  "was", "wasn", "wasn't",
+  "way",
+  "well",
+  "were", "weren", "weren't",
+  "what", "whatever",
+  "when", "whence", "whenever",
+  "where", "whereafter", "whereas", "whereby",
+  "wherein", "whereupon", "wherever",
+  "whether",
+  "which",
+  "while",
+  "whither",
+  "who", "whoever",
+  "whole",
+  "whom", "whomever",
+  "whose",
+  "why",
+  "will",
+  "with", "within", "without",
+  "won",
+  "won't",
+  "worse",
+  "would", "wouldn", "wouldn't",
+
+  // Y
+
+  "yes",
+  "yet",
+  "you", "you'll", "your", "you're", "yours",
+  "yourself", "yourselves",
+
+  // Z
+
+  "zero",
+};
+
+static constexpr perfect_hash_set default_stop_words{
+  default_stop_word_table
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+stop_word_set::stop_word_set( char const *file_name ) :
+  builtin_( !file_name || !*file_name )
+{
+  if ( builtin_ )
     return;
-  }
 
   mmap_file const file( file_name );
   if ( !file ) {
@@ -427,11 +433,43 @@ stop_word_set::stop_word_set( char const *file_name ) {
   } // for
 }
 
-stop_word_set::stop_word_set( mmap_file const &index_file ) {
+stop_word_set::stop_word_set( mmap_file const &index_file ) :
+  builtin_( false )
+{
   index_segment stop_words( index_file, index_segment::isi_stop_word );
+  words_.reserve( stop_words.size() );
+  list_.reserve( stop_words.size() );
   for ( auto const &stop_word : stop_words )
     insert( new_strdup( stop_word ) );
 }
 
+bool stop_word_set::contains( char const *word ) const {
+  return (builtin_ && default_stop_words.contains( word )) ||
+         words_.contains( word );
+}
+
+void stop_word_set::insert( char const *word ) {
+  if ( !(builtin_ && default_stop_words.contains( word )) &&
+       words_.insert( word ) ) {
+    list_.push_back( word );
+  }
+}
+
+size_t stop_word_set::size() const {
+  return (builtin_ ? default_stop_words.size() : 0) + list_.size();
+}
+
+vector<char const*> stop_word_set::sorted() const {
+  vector<char const*> v( list_ );
+  if ( builtin_ )
+    v.insert(
+      v.end(), default_stop_word_table, std::end( default_stop_word_table )
+    );
+  ::sort( v.begin(), v.end(), []( char const *i, char const *j ) {
+    return ::strcmp( i, j ) < 0;
+  } );
+  return v;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 /* vim:set et sw=2 ts=2: */
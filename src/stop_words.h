@@ -24,23 +24,74 @@
 
 // local
 #include "config.h"
-#include "pjl/less.h"
+#include "pjl/flat_string_set.h"
 #include "pjl/mmap_file.h"
 
 // standard
-#include <set>
+#include <cstddef>                      /* for size_t */
+#include <vector>
 
 ///////////////////////////////////////////////////////////////////////////////
 
 /**
- * A %stop_word_set is-a \c set&lt;char const*&gt.
- *
- * @remarks The only reason for having a derived class rather than a `typedef`
- * is so that we can have custom constructors.
+ * A %stop_word_set is the set of words not to index.  When no stop-word file
+ * is given, the built-in stop words are looked up via a perfect hash computed
+ * at compile-time; all other stop words (those read from a file or an index
+ * and those added later for being too frequent) are looked up via a flat hash
+ * table.  Either way, checking a word takes one hash of it and usually one
+ * comparison.
  */
-struct stop_word_set : std::set<char const*> {
+class stop_word_set {
+public:
+  /**
+   * Constructs a %stop_word_set.
+   *
+   * @param file_name The name of the file to read the stop words from or
+   * null (or the empty string) to use the built-in stop words.
+   */
   explicit stop_word_set( char const *file_name = nullptr );
+
+  /**
+   * Constructs a %stop_word_set from the stop words of an index.
+   *
+   * @param index_file The index file.
+   */
   explicit stop_word_set( PJL::mmap_file const &index_file );
+
+  /**
+   * Gets whether a word is a stop word.
+   *
+   * @param word The null-terminated, lower-case word to check.
+   * @return Returns \c true only if it is.
+   */
+  bool contains( char const *word ) const;
+
+  /**
+   * Adds a stop word unless it's already one.
+   *
+   * @param word The null-terminated, lower-case word to add.  Its memory must
+   * outlive this set.
+   */
+  void insert( char const *word );
+
+  /**
+   * Gets the number of stop words.
+   *
+   * @return Returns said number.
+   */
+  size_t size() const;
+
+  /**
+   * Gets all the stop words.
+   *
+   * @return Returns said words in sorted order.
+   */
+  std::vector<char const*> sorted() const;
+
+private:
+  bool                      builtin_;   // built-in words are stop words
+  PJL::flat_string_set      words_;     // other stop words
+  std::vector<char const*>  list_;      // other stop words in insertion order
 };
 
 extern stop_word_set* stop_words;
@@ -168,6 +168,20 @@ constexpr int   SocketQueueSize_Default     = 511;
  */
 constexpr int   SocketTimeout_Default       = 10;   // seconds
 
+/**
+ * The percentage of slow queries that are actually logged to the slow-query
+ * log.  This can be overridden either in a config. file or on the command
+ * line.
+ */
+constexpr int   SlowQuerySample_Default     = 100;  // percent
+
+/**
+ * The number of milliseconds a request must take to service before it is
+ * logged to the slow-query log (if any).  This can be overridden either in a
+ * config. file or on the command line.
+ */
+constexpr int   SlowQueryTime_Default       = 1000; // milliseconds
+
 /**
  * The minimum number of simultanous threads; this can be overridden either in
  * a config. file or on the command line.
@@ -38,7 +38,7 @@
 using namespace PJL;
 using namespace std;
 
-char_buffer_pool<128,5> lower_buf;
+thread_local char_buffer_pool<128,5> lower_buf;
 struct stat             stat_buf;       // someplace to do a stat(2) in
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -81,6 +81,29 @@ bool parse( char const *s, bool *result ) {
   return false;
 }
 
+int split_args( char *s, char *argv[], int arg_max ) {
+  for ( ; *s && isspace( *s ); ++s )    // skip leading whitespace
+    ;
+  if ( !*s )
+    return 0;
+
+  int argc = 0;
+
+  while ( (argv[ argc++ ] = s) ) {
+    if ( argc >= arg_max - 1 )          // -1 to allow for null at end
+      return arg_max;
+    if ( (s = ::strpbrk( s, " \t\n\r" )) ) {
+      *s = '\0';
+      //
+      // We must skip *ALL* whitespace characters separating arguments.
+      //
+      while ( *++s && isspace( *s ) )
+        ;
+    }
+  } // while
+  return argc;
+}
+
 char *to_lower( char *buf, char const *s ) {
   assert( buf );
   assert( s );
@@ -62,6 +62,28 @@
 #endif /* PATH_MAX */
 int const PATH_MAX = 1024;
 
+//
+// We need to know the maximum number of command-line arguments so we can split
+// a command-line string into individual arguments.  If the OS defines the
+// POSIX.1 ARG_MAX macro, see if it's insanely large (Solaris's limit is over a
+// million!) because we don't want to allocate that much space for argument
+// pointers since it would probably blow our thread stack space; however, if
+// it's small, we might as well use that number since there's no reason to
+// exceed it.
+//
+// @sa W. Richard Stevens.  "Advanced Programming in the Unix Environment,"
+// Addison-Wesley, Reading, MA, 1993.  pp. 32-40.
+//
+#define REASONABLE_ARG_MAX 50
+#ifdef ARG_MAX
+# if ARG_MAX > REASONABLE_ARG_MAX
+#   undef ARG_MAX
+# endif
+#endif /* ARG_MAX */
+#ifndef ARG_MAX
+# define ARG_MAX REASONABLE_ARG_MAX
+#endif /* ARG_MAX */
+
 extern char const  *me;
 extern struct stat  stat_buf;           // someplace to do a stat(2) in
 
@@ -151,6 +173,30 @@ inline char const* skip_newline( char const *c, char const *end ) {
   return c;
 }
 
+/**
+ * Splits a string into individual, argv-like arguments at whitespace.
+ *
+ * @remarks
+ * @parblock
+ * This code is based on \c buf_args() in [Stevens 1993], p. 495, except that
+ * it:
+ *
+ *    1. Is thread-safe by not using \c strtok().
+ *    2. Discards leading whitespace in the buffer.
+ *    3. Just does the split and doesn't call any function.
+ * @endparblock
+ *
+ * @sa W. Richard Stevens.  "Advanced Programming in the Unix Environment,"
+ * Addison-Wesley, Reading, MA, 1993.  p. 495.
+ *
+ * @param s The string to be split.
+ * @param argv The array to deposit the pointers to arguments in.
+ * @param arg_max The maximum number of argument to allow.
+ * @return Upon success, returns the number of arguments; upon failure, returns
+ * arg_max.
+ */
+int split_args( char *s, char *argv[], int arg_max );
+
 ////////// set functions //////////////////////////////////////////////////////
 
 /**
@@ -252,6 +298,10 @@ inline std::ostream& error( std::ostream &o = std::cerr ) {
   return o << me << ": error: ";
 }
 
+inline std::ostream& warning( std::ostream &o = std::cerr ) {
+  return o << me << ": warning: ";
+}
+
 inline std::ostream& error_string( std::ostream &o, int err_code ) {
   return o << ": " << std::strerror( err_code ) << std::endl;
 }
@@ -23,20 +23,171 @@
 #include "config.h"
 #include "word_util.h"
 #include "encoded_char.h"
+#include "iso8859-1.h"
 #include "swishxx-config.h"
 #include "util.h"
 
 // standard
+#include <bit>                          /* for countr_zero() */
 #include <cctype>
 #include <cstddef>
+#include <cstdint>
 #ifdef DEBUG_is_ok_word
 #include <ostream>
 #endif /* DEBUG_is_ok_word */
 
+//
+// The vectorized scan can only be used for the default set of Word_Chars that
+// is_word_char() checks for explicitly.
+//
+#if OPTIMIZE_WORD_CHARS
+# if defined( __AVX2__ )
+#   include <immintrin.h>
+#   define WITH_SIMD_WORD_CHARS 32
+# elif defined( __SSE2__ )
+#   include <emmintrin.h>
+#   define WITH_SIMD_WORD_CHARS 16
+# endif
+#endif /* OPTIMIZE_WORD_CHARS */
+
 using namespace std;
 
 ///////////////////////////////////////////////////////////////////////////////
 
+/**
+ * Whether each ISO 8859-1 character is a "word character" once converted to
+ * ASCII.
+ */
+static bool const *const word_char_map = [] {
+  static bool map[ 256 ];
+  for ( int c = 0; c < 256; ++c )
+    map[ c ] = is_word_char( iso8859_1_to_ascii( static_cast<char>( c ) ) );
+  return map;
+}();
+
+/**
+ * Checks whether an ISO 8859-1 character is a "word character" once converted
+ * to ASCII.
+ *
+ * @param c The character to be checked.
+ * @return Returns \c true only if the character is a "word character."
+ */
+inline bool is_8859_1_word_char( char c ) {
+  return word_char_map[ static_cast<unsigned char>( c ) ];
+}
+
+#ifdef WITH_SIMD_WORD_CHARS
+using simd_mask = uint32_t;
+constexpr size_t    Simd_Width = WITH_SIMD_WORD_CHARS;
+constexpr simd_mask Simd_All =
+  Simd_Width == 32 ? ~simd_mask{ 0 } : (simd_mask{ 1 } << Simd_Width) - 1;
+
+//
+// Thin wrappers around the intrinsics so the code using them is the same
+// regardless of the vector width.
+//
+#if WITH_SIMD_WORD_CHARS == 32
+using simd_vec = __m256i;
+
+inline simd_vec simd_load( char const *p ) {
+  return _mm256_loadu_si256( reinterpret_cast<simd_vec const*>( p ) );
+}
+inline simd_vec simd_set1( char c )   { return _mm256_set1_epi8( c ); }
+inline simd_vec simd_and( simd_vec a, simd_vec b ) {
+  return _mm256_and_si256( a, b );
+}
+inline simd_vec simd_or( simd_vec a, simd_vec b ) {
+  return _mm256_or_si256( a, b );
+}
+inline simd_vec simd_eq( simd_vec a, simd_vec b ) {
+  return _mm256_cmpeq_epi8( a, b );
+}
+inline simd_vec simd_gt( simd_vec a, simd_vec b ) {
+  return _mm256_cmpgt_epi8( a, b );
+}
+inline simd_mask simd_movemask( simd_vec v ) {
+  return static_cast<simd_mask>( _mm256_movemask_epi8( v ) );
+}
+#else
+using simd_vec = __m128i;
+
+inline simd_vec simd_load( char const *p ) {
+  return _mm_loadu_si128( reinterpret_cast<simd_vec const*>( p ) );
+}
+inline simd_vec simd_set1( char c )   { return _mm_set1_epi8( c ); }
+inline simd_vec simd_and( simd_vec a, simd_vec b ) {
+  return _mm_and_si128( a, b );
+}
+inline simd_vec simd_or( simd_vec a, simd_vec b ) {
+  return _mm_or_si128( a, b );
+}
+inline simd_vec simd_eq( simd_vec a, simd_vec b ) {
+  return _mm_cmpeq_epi8( a, b );
+}
+inline simd_vec simd_gt( simd_vec a, simd_vec b ) {
+  return _mm_cmpgt_epi8( a, b );
+}
+inline simd_mask simd_movemask( simd_vec v ) {
+  return static_cast<simd_mask>( _mm_movemask_epi8( v ) );
+}
+#endif /* WITH_SIMD_WORD_CHARS */
+
+/**
+ * Checks whether each of the characters in a vector is in the range [lo,hi].
+ * Characters having the high bit set are never in range.
+ *
+ * @param v The vector of characters.
+ * @param lo The lowest character in the range.
+ * @param hi The highest character in the range.
+ * @return Returns a vector having each character set to all 1 bits only if
+ * the corresponding character is in range.
+ */
+inline simd_vec simd_in_range( simd_vec v, char lo, char hi ) {
+  return simd_and( simd_gt( v, simd_set1( lo - 1 ) ),
+                   simd_gt( simd_set1( hi + 1 ), v ) );
+}
+
+/**
+ * Checks a vector's worth of characters at once for being "word characters"
+ * once converted from ISO 8859-1 to ASCII.
+ *
+ * @param c A pointer to the first character to check.  There must be at least
+ * \c Simd_Width characters.
+ * @return Returns a mask having bit \a i set only if \a c[i] is a "word
+ * character."
+ */
+static simd_mask word_char_mask( char const *c ) {
+  simd_vec const v = simd_load( c );
+  //
+  // Keep this in sync with is_word_char().
+  //
+  simd_vec const is_word = simd_or(
+    simd_or(
+      simd_in_range( simd_or( v, simd_set1( 0x20 ) ), 'a', 'z' ),
+      simd_in_range( v, '0', '9' )
+    ),
+    simd_or(
+      simd_or( simd_eq( v, simd_set1( '&'  ) ),
+               simd_eq( v, simd_set1( '\'' ) ) ),
+      simd_or( simd_eq( v, simd_set1( '-'  ) ),
+               simd_eq( v, simd_set1( '_'  ) ) )
+    )
+  );
+  simd_mask mask = simd_movemask( is_word );
+
+  //
+  // Characters having the high bit set are converted to ASCII first, so look
+  // them up individually.  They're rare in most text.
+  //
+  for ( simd_mask high = simd_movemask( v ); high; high &= high - 1 ) {
+    int const i = countr_zero( high );
+    if ( is_8859_1_word_char( c[i] ) )
+      mask |= simd_mask{ 1 } << i;
+  } // for
+  return mask;
+}
+#endif /* WITH_SIMD_WORD_CHARS */
+
 bool is_ok_word( char const *word ) {
   char const *c;
 
@@ -158,6 +309,99 @@ bool is_ok_word( char const *word ) {
   return true;
 }
 
+bool is_ok_word_to_lower( char const *word, size_t len, char *lower ) {
+  //
+  // This does the survey of the characters and the consecutive-character
+  // checks of is_ok_word() in a single pass; the results must be identical.
+  //
+  size_t digits = 0;
+  size_t puncts = 0;
+  size_t uppers = 0;
+  int    vowels = 0;
+
+  int  consec_consonants = 0;
+  int  consec_vowels = 0;
+  int  consec_same = 0;
+  int  consec_puncts = 0;
+  char last_c = '\0';
+  bool consec_ok = true;
+
+  for ( size_t i = 0; i < len; ++i ) {
+    char const c = word[i];
+    char const lc = lower[i] = tolower( c );
+
+    if ( isdigit( c ) ) {
+      ++digits;
+      consec_consonants = 0;
+      consec_vowels = 0;
+      consec_puncts = 0;
+      last_c = '\0';                    // consec_same doesn't apply to digits
+      continue;
+    }
+
+    if ( ispunct( c ) ) {
+      ++puncts;
+      if ( ++consec_puncts > Word_Max_Consec_Puncts )
+        consec_ok = false;
+      consec_consonants = 0;
+      consec_vowels = 0;
+      continue;
+    }
+
+    if ( isupper( c ) )
+      ++uppers;
+
+    if ( c == last_c ) {
+      if ( ++consec_same > Word_Max_Consec_Same )
+        consec_ok = false;
+    } else {
+      consec_same = 0;
+      last_c = c;
+    }
+
+    if ( is_vowel( lc ) ) {
+      ++vowels;
+      if ( ++consec_vowels > Word_Max_Consec_Vowels )
+        consec_ok = false;
+      consec_consonants = 0;
+      consec_puncts = 0;
+      continue;
+    }
+
+    if ( ++consec_consonants > Word_Max_Consec_Consonants )
+      consec_ok = false;
+    consec_vowels = 0;
+    consec_puncts = 0;
+  } // for
+  lower[ len ] = '\0';
+
+  if ( len && isupper( *word ) && uppers + digits + puncts == len )
+    return true;                        // potential acronym
+  return len >= Word_Min_Size && vowels >= Word_Min_Vowels && consec_ok;
+}
+
+char const* skip_non_word_chars( char const *c, char const *end ) {
+#ifdef WITH_SIMD_WORD_CHARS
+  for ( ; static_cast<size_t>( end - c ) >= Simd_Width; c += Simd_Width )
+    if ( simd_mask const mask = word_char_mask( c ) )
+      return c + countr_zero( mask );
+#endif /* WITH_SIMD_WORD_CHARS */
+  while ( c != end && !is_8859_1_word_char( *c ) )
+    ++c;
+  return c;
+}
+
+char const* skip_word_chars( char const *c, char const *end ) {
+#ifdef WITH_SIMD_WORD_CHARS
+  for ( ; static_cast<size_t>( end - c ) >= Simd_Width; c += Simd_Width )
+    if ( simd_mask const mask = ~word_char_mask( c ) & Simd_All )
+      return c + countr_zero( mask );
+#endif /* WITH_SIMD_WORD_CHARS */
+  while ( c != end && is_8859_1_word_char( *c ) )
+    ++c;
+  return c;
+}
+
 bool move_if_match( char const *&c, char const *end, char const *s,
                     bool ignore_case ) {
   auto d = c;
@@ -145,6 +145,40 @@ inline bool is_word_end_char( char c ) {
  */
 bool is_ok_word( char const *word );
 
+/**
+ * Does exactly what is_ok_word() does and also converts the word to lower
+ * case in the same pass over its characters.
+ *
+ * @param word The word to be checked.  It need not be null-terminated.
+ * @param len The length of the word.
+ * @param lower The buffer to put the null-terminated lower-case word into.  It
+ * must be at least  len + 1 characters long.  It's written even if the word
+ * should not be indexed.
+ * @return Returns \c true only if the word should be indexed.
+ */
+bool is_ok_word_to_lower( char const *word, size_t len, char *lower );
+
+/**
+ * Skips characters that are not "word characters" once converted from ISO
+ * 8859-1 to ASCII.  Where the CPU allows, many characters are checked at once.
+ *
+ * @param c A pointer to the first character to check.
+ * @param end A pointer to one past the last character to check.
+ * @return Returns a pointer to the first word character or \a end if none.
+ */
+char const* skip_non_word_chars( char const *c, char const *end );
+
+/**
+ * Skips characters that are "word characters" once converted from ISO 8859-1
+ * to ASCII.  Where the CPU allows, many characters are checked at once.
+ *
+ * @param c A pointer to the first character to check.
+ * @param end A pointer to one past the last character to check.
+ * @return Returns a pointer to the first non-word character or \a end if
+ * none.
+ */
+char const* skip_word_chars( char const *c, char const *end );
+
 /**
  * Compares a string starting at the given iterator to another.
  *
@@ -0,0 +1,197 @@
+/*
+**      SWISH++
+**      src/word_util_test.cpp
+**
+**      Copyright (C) 2026  Paul J. Lucas
+**
+**      This program is free software; you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation; either version 2 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program; if not, write to the Free Software
+**      Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+//
+// Checks that skip_word_chars() and skip_non_word_chars(), which may check
+// many characters at once, and is_ok_word_to_lower() give the same results as
+// checking one character at a time via is_word_char() and is_ok_word().  It's
+// run by "make check" and exits with a non-zero status if any check fails.
+//
+
+// local
+#include "config.h"
+#include "iso8859-1.h"
+#include "word_util.h"
+
+// standard
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+/**
+ * Lengths to check: those around the vector widths used by the scans plus
+ * some short ones handled only one character at a time.
+ */
+static size_t const lengths[] = { 0, 1, 2, 7, 15, 16, 17, 31, 32, 33, 48, 65 };
+
+/**
+ * Characters words are made of when checking is_ok_word_to_lower(): ones that
+ * are treated differently by the heuristics.
+ */
+static char const word_chars[] = "aebxAEBX09&'-_";
+
+static int failures;
+
+/**
+ * Skips characters one at a time the way the scans must.
+ *
+ * @param c A pointer to the first character to check.
+ * @param end A pointer to one past the last character to check.
+ * @param want_word If \c true, skip "word characters"; otherwise skip
+ * non-"word characters."
+ * @return Returns a pointer to the first character not skipped or \a end if
+ * none.
+ */
+static char const* ref_skip( char const *c, char const *end, bool want_word ) {
+  while ( c != end && is_word_char( iso8859_1_to_ascii( *c ) ) == want_word )
+    ++c;
+  return c;
+}
+
+/**
+ * Checks both scans over a buffer.
+ *
+ * @param buf The buffer.
+ * @param len The length of \a buf.
+ */
+static void check_skip( char const *buf, size_t len ) {
+  char const *const end = buf + len;
+  char const *const word_end = skip_word_chars( buf, end );
+  char const *const non_word_end = skip_non_word_chars( buf, end );
+  if ( word_end != ref_skip( buf, end, true ) ) {
+    cerr << "skip_word_chars(): length " << len << ": stopped at "
+         << (word_end - buf) << "; expected "
+         << (ref_skip( buf, end, true ) - buf) << '\n';
+    ++failures;
+  }
+  if ( non_word_end != ref_skip( buf, end, false ) ) {
+    cerr << "skip_non_word_chars(): length " << len << ": stopped at "
+         << (non_word_end - buf) << "; expected "
+         << (ref_skip( buf, end, false ) - buf) << '\n';
+    ++failures;
+  }
+}
+
+/**
+ * Checks the scans for every byte value at every position in buffers of
+ * every length that are otherwise all word or all non-word characters, and
+ * that are entirely the byte value.
+ */
+static void check_skips() {
+  for ( size_t const len : lengths ) {
+    for ( int b = 0; b < 256; ++b ) {
+      char const c = static_cast<char>( b );
+      check_skip( string( len, c ).data(), len );
+      for ( size_t i = 0; i < len; ++i ) {
+        for ( char const fill : { 'a', ' ' } ) {
+          string buf( len, fill );
+          buf[i] = c;
+          check_skip( buf.data(), len );
+        } // for
+      } // for
+    } // for
+  } // for
+}
+
+/**
+ * Checks that is_ok_word_to_lower() gives the same result as is_ok_word() for
+ * a word and that it converts it to lower case.
+ *
+ * @param word The word.  It must not contain null characters.
+ */
+static void check_word( string const &word ) {
+  string lower( word.size() + 1, '\1' );
+  bool const ok = is_ok_word_to_lower( word.data(), word.size(), &lower[0] );
+  if ( ok != is_ok_word( word.c_str() ) ) {
+    cerr << "is_ok_word_to_lower(\"" << word << "\"): returned " << ok
+         << "; is_ok_word() returned " << !ok << '\n';
+    ++failures;
+  }
+  for ( size_t i = 0; i <= word.size(); ++i ) {
+    char const expected = i < word.size() ? tolower( word[i] ) : '\0';
+    if ( lower[i] != expected ) {
+      cerr << "is_ok_word_to_lower(\"" << word << "\"): wrong lower case\n";
+      ++failures;
+      break;
+    }
+  } // for
+}
+
+/**
+ * Checks is_ok_word_to_lower() for every word up to a given length made of
+ * \c word_chars.
+ *
+ * @param word The word built so far.
+ * @param max_len The maximum length.
+ */
+static void check_all_words( string &word, size_t max_len ) {
+  check_word( word );
+  if ( word.size() == max_len )
+    return;
+  for ( char const *c = word_chars; *c; ++c ) {
+    word.push_back( *c );
+    check_all_words( word, max_len );
+    word.pop_back();
+  } // for
+}
+
+/**
+ * Checks is_ok_word_to_lower() for every non-null byte value in a few words
+ * and for pseudo-random words of every length.
+ */
+static void check_words() {
+  string word;
+  check_all_words( word, 5 );
+
+  for ( int b = 1; b < 256; ++b ) {
+    char const c = static_cast<char>( b );
+    for ( char const *w : { "ab?de", "AB?", "?xyz", "eeee?" } ) {
+      word = w;
+      word[ word.find( '?' ) ] = c;
+      check_word( word );
+    } // for
+  } // for
+
+  uint32_t seed = 1;
+  for ( size_t const len : lengths ) {
+    for ( int n = 0; n < 1000; ++n ) {
+      word.clear();
+      for ( size_t i = 0; i < len; ++i ) {
+        seed = seed * 1103515245 + 12345;
+        word.push_back( word_chars[ (seed >> 16) % (sizeof word_chars - 1) ] );
+      } // for
+      check_word( word );
+    } // for
+  } // for
+}
+
+int main() {
+  check_skips();
+  check_words();
+  return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/* vim:set et sw=2 ts=2: */
@@ -23,7 +23,6 @@
 #include "config.h"
 #include "xml_formatter.h"
 #include "file_info.h"
-#include "index_segment.h"
 #include "query.h"
 
 // standard
@@ -44,8 +43,6 @@ using namespace std;
 #define SEARCH_RESULTS_PHYS_URI SWISH_PHYS_URI "/" SEARCH_RESULTS
 #define SEARCH_RESULTS_XSD      SEARCH_RESULTS ".xsd"
 
-extern index_segment directories;
-
 ////////// local functions ////////////////////////////////////////////////////
 
 /**
@@ -77,6 +74,14 @@ xml_formatter::~xml_formatter() {
   // do nothing
 }
 
+void xml_formatter::explain( string const &explanation ) const {
+  //
+  // An explanation isn't part of the SearchResults DTD, so it's output as a
+  // comment after the SearchResults element.
+  //
+  out_ << "<!-- explain:\n" << explanation << "-->\n";
+}
+
 void xml_formatter::pre( stop_word_set const &stop_words ) const {
   out_ << "<?xml version=\"1.0\" encoding=\"us-ascii\"?>\n"
           "<!DOCTYPE SearchResults SYSTEM\n"
@@ -99,11 +104,11 @@ void xml_formatter::pre( stop_word_set const &stop_words ) const {
     out_ << "  <ResultList>\n";
 }
 
-void xml_formatter::result( int rank, file_info const &fi ) const {
+void xml_formatter::result( int rank, char const *dir,
+                            file_info const &fi ) const {
   out_ << "    <File>\n"
           "      <Rank>" << rank << "</Rank>\n"
-          "      <Path>"
-                  << directories[ fi.dir_index() ] << '/' << fi.file_name()
+          "      <Path>" << dir << '/' << fi.file_name()
       <<    "</Path>\n"
           "      <Size>" << fi.size() << "</Size>\n"
           "      <Title>";
@@ -29,6 +29,7 @@
 
 // standard
 #include <ostream>
+#include <string>
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -42,8 +43,10 @@ public:
     results_formatter{ o, results } { }
   virtual ~xml_formatter();
 
+  void explain( std::string const& ) const override;
   void pre( stop_word_set const& ) const override;
-  void result( int rank, file_info const& ) const override;
+  void result( int rank, char const *dir,
+               file_info const& ) const override;
   void post() const override;
 };
 
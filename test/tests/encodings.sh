@@ -1,12 +1,13 @@
+#! /bin/sh
 ##
 #       SWISH++
-#       src/mod/html/include-tidy.toml
+#       test/tests/encodings.sh
 #
 #       Copyright (C) 2026  Paul J. Lucas
 #
-#       This program is free software: you can redistribute it and/or modify
+#       This program is free software; you can redistribute it and/or modify
 #       it under the terms of the GNU General Public License as published by
-#       the Free Software Foundation, either version 3 of the License, or
+#       the Free Software Foundation; either version 2 of the Licence, or
 #       (at your option) any later version.
 #
 #       This program is distributed in the hope that it will be useful,
@@ -18,10 +19,13 @@
 #       along with this program.  If not, see <http://www.gnu.org/licenses/>.
 ##
 
-[elements.h]
-keep-includes = "pjl/less.h"
+##
+# Checks that multi-line Base64 and quoted-printable parts are decoded
+# correctly (see src/encodings_test.cpp).
+#
+# usage: encodings.sh output log
+##
 
-[entities.h]
-keep-includes = "pjl/less.h"
+encodings_test 2>> $2
 
-# vim:se et sw=2 ts=2:
+# vim:set et sw=2 ts=2:
@@ -0,0 +1,64 @@
+#! /bin/sh
+##
+#       SWISH++
+#       test/tests/index-R.sh
+#
+#       Copyright (C) 2026  Paul J. Lucas
+#
+#       This program is free software; you can redistribute it and/or modify
+#       it under the terms of the GNU General Public License as published by
+#       the Free Software Foundation; either version 2 of the Licence, or
+#       (at your option) any later version.
+#
+#       This program is distributed in the hope that it will be useful,
+#       but WITHOUT ANY WARRANTY; without even the implied warranty of
+#       MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#       GNU General Public License for more details.
+#
+#       You should have received a copy of the GNU General Public License
+#       along with this program.  If not, see <http://www.gnu.org/licenses/>.
+##
+
+##
+# Incrementally indexes into an index whose name has spaces in it after
+# deleting a file so the segmented index's manifest names both segments and a
+# tombstone file with spaces in them, and checks that it's read back.
+#
+# usage: index-I-space.sh output log
+##
+
+OUTPUT=$1
+LOG_FILE=$2
+DIR=${OUTPUT}dir
+trap "x=\$?; rm -fr $DIR; exit \$x" EXIT HUP INT TERM
+
+INDEX="$DIR/my test.index"
+mkdir $DIR $DIR/docs || exit 1
+echo 'The aardvark digs.' > $DIR/docs/aardvark.txt
+echo 'The bandicoot hops.' > $DIR/docs/bandicoot.txt
+
+index -e 'text:*.txt' -i "$INDEX" $DIR/docs > /dev/null 2>> $LOG_FILE ||
+  exit 1
+
+rm $DIR/docs/aardvark.txt
+echo 'The capybara swims.' > $DIR/docs/capybara.txt
+
+index -e 'text:*.txt' -I -i "$INDEX" $DIR/docs > /dev/null 2>> $LOG_FILE ||
+  exit 1
+[ -f "$INDEX.2" ] || exit 1
+
+for word in aardvark bandicoot capybara
+do
+  search -i "$INDEX" $word 2>> $LOG_FILE || exit 1
+done > $DIR/search.out
+
+cat > $DIR/search.exp <<END
+# results: 0
+# results: 1
+100 $DIR/docs/bandicoot.txt 20 bandicoot.txt
+# results: 1
+100 $DIR/docs/capybara.txt 20 capybara.txt
+END
+diff $DIR/search.exp $DIR/search.out >> $LOG_FILE
+
+# vim:set et sw=2 ts=2:
@@ -0,0 +1,57 @@
+#! /bin/sh
+##
+#       SWISH++
+#       test/tests/index-R.sh
+#
+#       Copyright (C) 2026  Paul J. Lucas
+#
+#       This program is free software; you can redistribute it and/or modify
+#       it under the terms of the GNU General Public License as published by
+#       the Free Software Foundation; either version 2 of the Licence, or
+#       (at your option) any later version.
+#
+#       This program is distributed in the hope that it will be useful,
+#       but WITHOUT ANY WARRANTY; without even the implied warranty of
+#       MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#       GNU General Public License for more details.
+#
+#       You should have received a copy of the GNU General Public License
+#       along with this program.  If not, see <http://www.gnu.org/licenses/>.
+##
+
+##
+# Merges two indices that both contain the same file (as it was when each was
+# built) and checks that the file is taken from the first index and that a
+# warning naming it is printed.
+#
+# usage: index-J-overlap.sh output log
+##
+
+OUTPUT=$1
+LOG_FILE=$2
+DIR=${OUTPUT}dir
+trap "x=\$?; rm -fr $DIR; exit \$x" EXIT HUP INT TERM
+
+mkdir $DIR $DIR/docs || exit 1
+echo 'Other words entirely.' > $DIR/docs/other.txt
+
+for word in aardvark zebu
+do
+  echo "The $word is here." > $DIR/docs/animal.txt
+  index -e 'text:*.txt' -i $DIR/$word.index $DIR/docs \
+    > /dev/null 2>> $LOG_FILE || exit 1
+done
+
+index -J -i $DIR/merged.index $DIR/zebu.index $DIR/aardvark.index \
+  > /dev/null 2> $DIR/merge.err || exit 1
+cat $DIR/merge.err >> $LOG_FILE
+grep -q "warning: \"$DIR/docs/animal.txt\" is in both \"$DIR/zebu.index\"" \
+  $DIR/merge.err || exit 1
+
+search -i $DIR/merged.index zebu 2>> $LOG_FILE |
+  grep -q "animal\.txt" || exit 1
+search -i $DIR/merged.index aardvark 2>> $LOG_FILE | grep -q "animal\.txt" &&
+  exit 1
+exit 0
+
+# vim:set et sw=2 ts=2:
@@ -0,0 +1,72 @@
+#! /bin/sh
+##
+#       SWISH++
+#       test/tests/index-J.sh
+#
+#       Copyright (C) 2026  Paul J. Lucas
+#
+#       This program is free software; you can redistribute it and/or modify
+#       it under the terms of the GNU General Public License as published by
+#       the Free Software Foundation; either version 2 of the Licence, or
+#       (at your option) any later version.
+#
+#       This program is distributed in the hope that it will be useful,
+#       but WITHOUT ANY WARRANTY; without even the implied warranty of
+#       MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#       GNU General Public License for more details.
+#
+#       You should have received a copy of the GNU General Public License
+#       along with this program.  If not, see <http://www.gnu.org/licenses/>.
+##
+
+##
+# Merges two independently built indices and checks that the result is the
+# same as indexing all their files in one run, in particular its stop words:
+# words that were too frequent in either index must not be stop words unless
+# they're too frequent among all the files.
+#
+# usage: index-J.sh output log
+##
+
+OUTPUT=$1
+LOG_FILE=$2
+DIR=${OUTPUT}dir
+trap "x=\$?; rm -fr $DIR; exit \$x" EXIT HUP INT TERM
+
+DATA_DIR=$srcdir/data
+mkdir $DIR $DIR/docs1 $DIR/docs2 || exit 1
+cp $DATA_DIR/Alice* $DATA_DIR/Time* $DIR/docs1 || exit 1
+cp $srcdir/tests/README.md $DIR/docs1/README.txt || exit 1
+cp $DATA_DIR/Christmas* $DATA_DIR/GNU* $DATA_DIR/Gutenberg* $DATA_DIR/Raven* \
+  $DIR/docs2 || exit 1
+
+for i in 1 2
+do
+  index -e 'text:*.txt' -Q -i $DIR/docs$i.index $DIR/docs$i \
+    > /dev/null 2>> $LOG_FILE || exit 1
+done
+index -J -i $DIR/merged.index $DIR/docs1.index $DIR/docs2.index \
+  > /dev/null 2>> $LOG_FILE || exit 1
+index -e 'text:*.txt' -i $DIR/full.index $DIR/docs1 $DIR/docs2 \
+  > /dev/null 2>> $LOG_FILE || exit 1
+
+##
+# Since the files of the merged index may be in a different order, files of
+# equal rank for a word may be listed in a different order, so each file is
+# listed along with its word and the list is sorted.
+##
+for i in docs1 merged full
+do
+  search -i $DIR/$i.index -D 2>> $LOG_FILE |
+    awk '/^[^ ]/ { word = $0; next } NF { print word, $0 }' |
+    sort > $DIR/$i.D || exit 1
+  search -i $DIR/$i.index -S > $DIR/$i.S 2>> $LOG_FILE || exit 1
+done
+
+# Some words must have been too frequent in only one of the indices.
+cmp -s $DIR/docs1.S $DIR/full.S && exit 1
+
+diff $DIR/full.D $DIR/merged.D >> $LOG_FILE &&
+diff $DIR/full.S $DIR/merged.S >> $LOG_FILE
+
+# vim:set et sw=2 ts=2:
@@ -0,0 +1,46 @@
+#! /bin/sh
+##
+#       SWISH++
+#       test/tests/index-R.sh
+#
+#       Copyright (C) 2026  Paul J. Lucas
+#
+#       This program is free software; you can redistribute it and/or modify
+#       it under the terms of the GNU General Public License as published by
+#       the Free Software Foundation; either version 2 of the Licence, or
+#       (at your option) any later version.
+#
+#       This program is distributed in the hope that it will be useful,
+#       but WITHOUT ANY WARRANTY; without even the implied warranty of
+#       MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#       GNU General Public License for more details.
+#
+#       You should have received a copy of the GNU General Public License
+#       along with this program.  If not, see <http://www.gnu.org/licenses/>.
+##
+
+##
+# Indexes with a word/file maximum with and without -Q and checks that the
+# files of too-frequent words are stored only with it, i.e., that the index is
+# smaller without it.
+#
+# usage: index-Q.sh output log
+##
+
+OUTPUT=$1
+LOG_FILE=$2
+DIR=${OUTPUT}dir
+trap "x=\$?; rm -fr $DIR; exit \$x" EXIT HUP INT TERM
+
+mkdir $DIR || exit 1
+
+for i in discarded stored
+do
+  [ $i = stored ] && Q=-Q
+  index -e 'text:*.txt' -f 3 $Q -i $DIR/$i.index $srcdir/data \
+    > /dev/null 2>> $LOG_FILE || exit 1
+done
+
+[ `wc -c < $DIR/discarded.index` -lt `wc -c < $DIR/stored.index` ]
+
+# vim:set et sw=2 ts=2:
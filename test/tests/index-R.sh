@@ -0,0 +1,65 @@
+#! /bin/sh
+##
+#       SWISH++
+#       test/tests/index-R.sh
+#
+#       Copyright (C) 2026  Paul J. Lucas
+#
+#       This program is free software; you can redistribute it and/or modify
+#       it under the terms of the GNU General Public License as published by
+#       the Free Software Foundation; either version 2 of the Licence, or
+#       (at your option) any later version.
+#
+#       This program is distributed in the hope that it will be useful,
+#       but WITHOUT ANY WARRANTY; without even the implied warranty of
+#       MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#       GNU General Public License for more details.
+#
+#       You should have received a copy of the GNU General Public License
+#       along with this program.  If not, see <http://www.gnu.org/licenses/>.
+##
+
+##
+# Rebuilds an index after changing, deleting, and adding files and checks that
+# it's the same as a full reindex, in particular its stop words: words that were
+# too frequent before must not remain stop words if they no longer are.
+#
+# usage: index-R.sh output log
+##
+
+OUTPUT=$1
+LOG_FILE=$2
+DIR=${OUTPUT}dir
+trap "x=\$?; rm -fr $DIR; exit \$x" EXIT HUP INT TERM
+
+DATA_DIR=$srcdir/data
+mkdir $DIR $DIR/docs || exit 1
+cp $DATA_DIR/*.txt $DIR/docs || exit 1
+
+index -e 'text:*.txt' -Q -i $DIR/rebuilt.index $DIR/docs \
+  > /dev/null 2>> $LOG_FILE || exit 1
+search -i $DIR/rebuilt.index -S > $DIR/before.S 2>> $LOG_FILE || exit 1
+
+rm $DIR/docs/Raven,_The.txt
+head -c 3000 $DATA_DIR/Christmas_Carol,_A.txt \
+  > $DIR/docs/Christmas_Carol,_A.txt
+cp $srcdir/tests/README.md $DIR/docs/README.txt
+
+index -e 'text:*.txt' -R -i $DIR/rebuilt.index $DIR/docs \
+  > /dev/null 2>> $LOG_FILE || exit 1
+index -e 'text:*.txt' -i $DIR/full.index $DIR/docs \
+  > /dev/null 2>> $LOG_FILE || exit 1
+
+for i in rebuilt full
+do
+  search -i $DIR/$i.index -D > $DIR/$i.D 2>> $LOG_FILE || exit 1
+  search -i $DIR/$i.index -S > $DIR/$i.S 2>> $LOG_FILE || exit 1
+done
+
+# The changes must have changed which words are too frequent.
+cmp -s $DIR/before.S $DIR/full.S && exit 1
+
+diff $DIR/full.D $DIR/rebuilt.D >> $LOG_FILE &&
+diff $DIR/full.S $DIR/rebuilt.S >> $LOG_FILE
+
+# vim:set et sw=2 ts=2:
@@ -0,0 +1,93 @@
+#! /bin/sh
+##
+#       SWISH++
+#       test/tests/index-mail-attachment.sh
+#
+#       Copyright (C) 2026  Paul J. Lucas
+#
+#       This program is free software; you can redistribute it and/or modify
+#       it under the terms of the GNU General Public License as published by
+#       the Free Software Foundation; either version 2 of the Licence, or
+#       (at your option) any later version.
+#
+#       This program is distributed in the hope that it will be useful,
+#       but WITHOUT ANY WARRANTY; without even the implied warranty of
+#       MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#       GNU General Public License for more details.
+#
+#       You should have received a copy of the GNU General Public License
+#       along with this program.  If not, see <http://www.gnu.org/licenses/>.
+##
+
+##
+# Indexes a message having a Base64-encoded attachment that's filtered (slowly)
+# followed by another Base64-encoded part and checks that the attachment's
+# words are indexed and the other part's words are indexed only once, i.e.,
+# that decoding the other part didn't clobber the attachment while it was
+# still being filtered.
+#
+# usage: index-mail-attachment.sh output log
+##
+
+OUTPUT=$1
+LOG_FILE=$2
+DIR=${OUTPUT}dir
+trap "x=\$?; rm -fr $DIR; exit \$x" EXIT HUP INT TERM
+
+mkdir $DIR $DIR/docs || exit 1
+
+cat > $DIR/slowcat <<END
+#! /bin/sh
+sleep 1
+cat
+END
+chmod +x $DIR/slowcat || exit 1
+
+echo "FilterAttachment application/x-slow $DIR/slowcat < %f > @%F.txt" \
+  > $DIR/index.conf
+
+cat > $DIR/docs/attachment.eml <<END
+From: Alice <alice@example.com>
+To: Bob <bob@example.com>
+Subject: Attachment
+MIME-Version: 1.0
+Content-Type: multipart/mixed; boundary="XYZ"
+
+--XYZ
+Content-Type: application/x-slow
+Content-Transfer-Encoding: base64
+
+VGhlIHphbnppYmFyIHF1b2trYSBhdHRhY2htZW50IHRleHQuCg==
+
+--XYZ
+Content-Type: text/plain
+Content-Transfer-Encoding: base64
+
+VGhlIHNlY29uZCBwYXJ0IG1lbnRpb25zIHdvbWJhdHMgb25seS4K
+
+--XYZ--
+END
+
+# Another message so the words above aren't in every file.
+cat > $DIR/docs/other.eml <<END
+From: Carol <carol@example.com>
+Subject: Other
+
+Nothing to see here.
+END
+
+index -c $DIR/index.conf -e 'mail:*.eml' -i $DIR/mail.index $DIR/docs \
+  > /dev/null 2>> $LOG_FILE || exit 1
+
+for word in zanzibar quokka
+do
+  search -i $DIR/mail.index $word 2>> $LOG_FILE |
+    grep -q "attachment\.eml" || exit 1
+done
+
+# The other part's words must have been indexed only once.
+OCCURRENCES=`search -i $DIR/mail.index -d wombats 2>> $LOG_FILE |
+  awk '/attachment\.eml/ { print $1 }'`
+[ "$OCCURRENCES" = 1 ]
+
+# vim:set et sw=2 ts=2:
@@ -0,0 +1,78 @@
+#! /bin/sh
+##
+#       SWISH++
+#       test/tests/index-R.sh
+#
+#       Copyright (C) 2026  Paul J. Lucas
+#
+#       This program is free software; you can redistribute it and/or modify
+#       it under the terms of the GNU General Public License as published by
+#       the Free Software Foundation; either version 2 of the Licence, or
+#       (at your option) any later version.
+#
+#       This program is distributed in the hope that it will be useful,
+#       but WITHOUT ANY WARRANTY; without even the implied warranty of
+#       MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#       GNU General Public License for more details.
+#
+#       You should have received a copy of the GNU General Public License
+#       along with this program.  If not, see <http://www.gnu.org/licenses/>.
+##
+
+##
+# Indexes a message having Base64-encoded UTF-16 parts, one little-endian with
+# a byte order mark and one big-endian without, and checks that the words of
+# both are found.
+#
+# usage: index-mail-utf16.sh output log
+##
+
+OUTPUT=$1
+LOG_FILE=$2
+DIR=${OUTPUT}dir
+trap "x=\$?; rm -fr $DIR; exit \$x" EXIT HUP INT TERM
+
+mkdir $DIR $DIR/docs || exit 1
+
+cat > $DIR/docs/utf16.eml <<END
+From: Alice <alice@example.com>
+To: Bob <bob@example.com>
+Subject: Wildlife
+MIME-Version: 1.0
+Content-Type: multipart/mixed; boundary="XYZ"
+
+--XYZ
+Content-Type: text/plain; charset="utf-16"
+Content-Transfer-Encoding: base64
+
+//5UAGgAZQAgAHAAbABhAHQAeQBwAHUAcwAgAHMAdwBpAG0AcwAgAGkAbgAgAHQAaABlACAAYgBp
+AGwAbABhAGIAbwBuAGcALgAKAA==
+
+--XYZ
+Content-Type: text/plain; charset=utf-16be
+Content-Transfer-Encoding: base64
+
+AE0AZQBlAHQAIABhAHQAIAB0AGgAZQAgAGMAYQBmAOkAIABuAGUAYQByACAAdABoAGUAIABlAGMA
+aABpAGQAbgBhACAAYgB1AHIAcgBvAHcALgAK
+
+--XYZ--
+END
+
+# Another message so the words above aren't in every file.
+cat > $DIR/docs/other.eml <<END
+From: Carol <carol@example.com>
+Subject: Other
+
+Nothing to see here.
+END
+
+index -e 'mail:*.eml' -i $DIR/mail.index $DIR/docs \
+  > /dev/null 2>> $LOG_FILE || exit 1
+
+for word in platypus billabong cafe echidna
+do
+  search -i $DIR/mail.index $word 2>> $LOG_FILE |
+    grep -q "utf16\.eml" || exit 1
+done
+
+# vim:set et sw=2 ts=2:
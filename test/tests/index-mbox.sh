@@ -0,0 +1,83 @@
+#! /bin/sh
+##
+#       SWISH++
+#       test/tests/index-mbox.sh
+#
+#       Copyright (C) 2026  Paul J. Lucas
+#
+#       This program is free software; you can redistribute it and/or modify
+#       it under the terms of the GNU General Public License as published by
+#       the Free Software Foundation; either version 2 of the Licence, or
+#       (at your option) any later version.
+#
+#       This program is distributed in the hope that it will be useful,
+#       but WITHOUT ANY WARRANTY; without even the implied warranty of
+#       MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#       GNU General Public License for more details.
+#
+#       You should have received a copy of the GNU General Public License
+#       along with this program.  If not, see <http://www.gnu.org/licenses/>.
+##
+
+##
+# Indexes an mbox file and checks that each message is found as its own
+# document; then changes a message, incrementally indexes the mbox again, and
+# checks that only the messages of the changed mbox are found, i.e., that the
+# old ones have been tombstoned.
+#
+# usage: index-mbox.sh output log
+##
+
+OUTPUT=$1
+LOG_FILE=$2
+DIR=${OUTPUT}dir
+trap "x=\$?; rm -fr $DIR; exit \$x" EXIT HUP INT TERM
+
+MBOX=$DIR/docs/inbox.mbox
+mkdir $DIR $DIR/docs || exit 1
+cp $srcdir/data/inbox.mbox $MBOX || exit 1
+
+##
+# Searches for each of the words that are only in some of the messages.
+##
+search_words() {
+  for word in pelican cormorants herons lighthouse
+  do
+    search -i $DIR/mbox.index $word 2>> $LOG_FILE || exit 1
+  done
+}
+
+index -e 'mail:*.mbox' -i $DIR/mbox.index $DIR/docs \
+  > /dev/null 2>> $LOG_FILE || exit 1
+search_words > $DIR/before.out || exit 1
+
+cat > $DIR/before.exp <<END
+# results: 2
+100 $MBOX#182 185 Re: Pelican sightings
+85 $MBOX#0 182 Pelican sightings
+# results: 1
+100 $MBOX#182 185 Re: Pelican sightings
+# results: 0
+# results: 1
+100 $MBOX#367 172 Lighthouse tour
+END
+diff $DIR/before.exp $DIR/before.out >> $LOG_FILE || exit 1
+
+sed 's/cormorants/herons/' $srcdir/data/inbox.mbox > $MBOX || exit 1
+index -I -e 'mail:*.mbox' -i $DIR/mbox.index $DIR/docs \
+  > /dev/null 2>> $LOG_FILE || exit 1
+search_words > $DIR/after.out || exit 1
+
+cat > $DIR/after.exp <<END
+# results: 2
+100 $MBOX#182 181 Re: Pelican sightings
+85 $MBOX#0 182 Pelican sightings
+# results: 0
+# results: 1
+100 $MBOX#182 181 Re: Pelican sightings
+# results: 1
+100 $MBOX#363 172 Lighthouse tour
+END
+diff $DIR/after.exp $DIR/after.out >> $LOG_FILE
+
+# vim:set et sw=2 ts=2:
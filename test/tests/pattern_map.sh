@@ -1,12 +1,13 @@
+#! /bin/sh
 ##
 #       SWISH++
-#       src/mod/id3/include-tidy.toml
+#       test/tests/pattern_map.sh
 #
 #       Copyright (C) 2026  Paul J. Lucas
 #
-#       This program is free software: you can redistribute it and/or modify
+#       This program is free software; you can redistribute it and/or modify
 #       it under the terms of the GNU General Public License as published by
-#       the Free Software Foundation, either version 3 of the License, or
+#       the Free Software Foundation; either version 2 of the Licence, or
 #       (at your option) any later version.
 #
 #       This program is distributed in the hope that it will be useful,
@@ -18,7 +19,13 @@
 #       along with this program.  If not, see <http://www.gnu.org/licenses/>.
 ##
 
-[id3v2.cpp]
-keep-includes = "pjl/less.h"
+##
+# Checks that compiled filename patterns find the same patterns as uncompiled
+# ones (see src/pattern_map_test.cpp).
+#
+# usage: pattern_map.sh output log
+##
+
+pattern_map_test 2>> $2
 
-# vim:se et sw=2 ts=2:
+# vim:set et sw=2 ts=2:
@@ -0,0 +1,64 @@
+#! /bin/sh
+##
+#       SWISH++
+#       test/tests/index-R.sh
+#
+#       Copyright (C) 2026  Paul J. Lucas
+#
+#       This program is free software; you can redistribute it and/or modify
+#       it under the terms of the GNU General Public License as published by
+#       the Free Software Foundation; either version 2 of the Licence, or
+#       (at your option) any later version.
+#
+#       This program is distributed in the hope that it will be useful,
+#       but WITHOUT ANY WARRANTY; without even the implied warranty of
+#       MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#       GNU General Public License for more details.
+#
+#       You should have received a copy of the GNU General Public License
+#       along with this program.  If not, see <http://www.gnu.org/licenses/>.
+##
+
+##
+# Incrementally indexes after deleting and adding files and checks that the
+# dumping options dump all the segments of the index but not deleted files.
+#
+# usage: search-I-d.sh output log
+##
+
+OUTPUT=$1
+LOG_FILE=$2
+DIR=${OUTPUT}dir
+trap "x=\$?; rm -fr $DIR; exit \$x" EXIT HUP INT TERM
+
+DATA_DIR=$srcdir/data
+mkdir $DIR $DIR/docs || exit 1
+cp $DATA_DIR/*.txt $DIR/docs || exit 1
+
+index -e 'text:*.txt' -i $DIR/test.index $DIR/docs \
+  > /dev/null 2>> $LOG_FILE || exit 1
+
+rm $DIR/docs/Raven,_The.txt
+echo 'The zebraword is only in the second segment.' > $DIR/docs/zebra.txt
+
+index -e 'text:*.txt' -I -i $DIR/test.index $DIR/docs \
+  > /dev/null 2>> $LOG_FILE || exit 1
+
+search -i $DIR/test.index -d nevermore zebraword > $DIR/d.out \
+  2>> $LOG_FILE || exit 1
+cat > $DIR/d.exp <<END
+# not found: nevermore
+1 50000000 $DIR/docs/zebra.txt 45 zebra.txt
+
+END
+diff $DIR/d.exp $DIR/d.out >> $LOG_FILE || exit 1
+
+search -i $DIR/test.index -D > $DIR/D.out 2>> $LOG_FILE || exit 1
+grep -q Raven $DIR/D.out && exit 1
+grep -q '^zebraword$' $DIR/D.out || exit 1
+
+search -i $DIR/test.index -w 3 zebraword > $DIR/w.out \
+  2>> $LOG_FILE || exit 1
+grep -q '^zebraword$' $DIR/w.out
+
+# vim:set et sw=2 ts=2:
@@ -1,12 +1,13 @@
+#! /bin/sh
 ##
 #       SWISH++
-#       src/mod/latex/include-tidy.toml
+#       test/tests/word_util.sh
 #
 #       Copyright (C) 2026  Paul J. Lucas
 #
-#       This program is free software: you can redistribute it and/or modify
+#       This program is free software; you can redistribute it and/or modify
 #       it under the terms of the GNU General Public License as published by
-#       the Free Software Foundation, either version 3 of the License, or
+#       the Free Software Foundation; either version 2 of the Licence, or
 #       (at your option) any later version.
 #
 #       This program is distributed in the hope that it will be useful,
@@ -18,7 +19,13 @@
 #       along with this program.  If not, see <http://www.gnu.org/licenses/>.
 ##
 
-[commands.h]
-keep-includes = "pjl/less.h"
+##
+# Checks that the word-character scans and word heuristics give the same
+# results as checking one character at a time (see src/word_util_test.cpp).
+#
+# usage: word_util.sh output log
+##
+
+word_util_test 2>> $2
 
-# vim:se et sw=2 ts=2:
+# vim:set et sw=2 ts=2: